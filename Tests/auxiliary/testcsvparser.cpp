@@ -262,6 +262,45 @@ void TestCSVParser::CSVIgnoreHasNextRow()
     }
 }
 
+void TestCSVParser::CSVStreamingRows()
+{
+    /*
+     * Test 5b. Read the same file in streaming mode. Truncated rows and rows
+     * with no matching quote are skipped, and there are no dummy rows.
+    */
+    KSParser stream_parser(test_file_name_, '#', sequence_);
+
+    int field1  = stream_parser.ColumnIndex("field1");
+    int field6  = stream_parser.ColumnIndex("field6");
+    int field7  = stream_parser.ColumnIndex("field7");
+    int field9  = stream_parser.ColumnIndex("field9");
+    int field10 = stream_parser.ColumnIndex("field10");
+    int field12 = stream_parser.ColumnIndex("field12");
+    QCOMPARE(stream_parser.ColumnIndex("no such field"), -1);
+
+    QVERIFY(stream_parser.NextRow());
+    QCOMPARE(stream_parser.StringField(field1), QString(""));
+    QCOMPARE(stream_parser.IntField(field6), 3);
+    QCOMPARE(stream_parser.StringField(field7), QString("isn't, pi"));
+    QVERIFY(stream_parser.IsEmptyField(field9));
+    QCOMPARE(stream_parser.FloatField(field10), -3.141f);
+    QVERIFY(stream_parser.FieldEquals(field12, "either"));
+
+    QVERIFY(stream_parser.NextRow());
+    QCOMPARE(stream_parser.StringField(field7), QString("isn't\"(, )\"pi"));
+
+    QVERIFY(stream_parser.NextRow());
+    bool ok = true;
+    QCOMPARE(stream_parser.IntField(field6, &ok), 0);
+    QVERIFY(!ok);
+    QCOMPARE(stream_parser.DoubleField(field10, &ok), 0.0);
+    QVERIFY(!ok);
+    QCOMPARE(stream_parser.StringField(field12), QString(""));
+
+    QVERIFY(!stream_parser.NextRow());
+    QVERIFY(!stream_parser.NextRow());
+}
+
 void TestCSVParser::CSVReadMissingFile()
 {
     /*
@@ -272,6 +311,9 @@ void TestCSVParser::CSVReadMissingFile()
     KSParser missing_parser(test_file_name_, '#', sequence_);
     QHash<QString, QVariant> row_content = missing_parser.ReadNextRow();
 
+    KSParser missing_stream_parser(test_file_name_, '#', sequence_);
+    QVERIFY(!missing_stream_parser.NextRow());
+
     for (int times = 0; times < 20; times++)
     {
         row_content = missing_parser.ReadNextRow();
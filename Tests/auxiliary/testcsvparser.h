@@ -36,6 +36,7 @@ class TestCSVParser : public QObject
     void CSVEmptyRow();
     void CSVNoRow();
     void CSVIgnoreHasNextRow();
+    void CSVStreamingRows();
     void CSVReadMissingFile();
 
   private:
@@ -148,6 +148,62 @@ void TestFWParser::NoRow()
     }
 }
 
+void TestFWParser::FWStreamingRows()
+{
+    /*
+     * Test 3b: Read the same file in streaming mode. Fields are trimmed,
+     * the short row is skipped and there are no dummy rows.
+    */
+    KSParser stream_parser(test_file_name_, '#', sequence_, widths_);
+
+    int field1  = stream_parser.ColumnIndex("field1");
+    int field4  = stream_parser.ColumnIndex("field4");
+    int field6  = stream_parser.ColumnIndex("field6");
+    int field10 = stream_parser.ColumnIndex("field10");
+    int field11 = stream_parser.ColumnIndex("field11");
+    int field12 = stream_parser.ColumnIndex("field12");
+
+    QVERIFY(stream_parser.NextRow());
+    QCOMPARE(stream_parser.StringField(field1), QString("this"));
+    QCOMPARE(stream_parser.StringField(field4), QString("exam ple"));
+    QCOMPARE(stream_parser.IntField(field6), 256);
+    QCOMPARE(stream_parser.DoubleField(field10), -3.14);
+    QVERIFY(stream_parser.IsEmptyField(field11));
+    QVERIFY(stream_parser.FieldEquals(field12, "times"));
+
+    QVERIFY(stream_parser.NextRow());
+    QVERIFY(stream_parser.IsEmptyField(field1));
+    QCOMPARE(stream_parser.IntField(field6), 0);
+    QCOMPARE(stream_parser.FloatField(field10), float(0.0));
+
+    QVERIFY(!stream_parser.NextRow());
+}
+
+void TestFWParser::FWStreamingUtf8()
+{
+    /*
+     * Test 3c: Fields are trimmed of ASCII spaces only. The bytes 0x85 and 0xA0,
+     * which are spaces in Latin-1, end the UTF-8 encodings of Å and Š.
+    */
+    QTemporaryFile utf8_file;
+    QVERIFY(utf8_file.open());
+    utf8_file.write(QString::fromUtf8("Ång Å Kuš Š\n").toUtf8());
+    utf8_file.close();
+
+    QList<QPair<QString, KSParser::DataTypes>> sequence;
+    sequence.append(qMakePair(QString("name"), KSParser::D_QSTRING));
+    sequence.append(qMakePair(QString("alias"), KSParser::D_QSTRING));
+    QList<int> widths;
+    widths.append(8);
+
+    KSParser utf8_parser(utf8_file.fileName(), '#', sequence, widths);
+
+    QVERIFY(utf8_parser.NextRow());
+    QCOMPARE(utf8_parser.StringField(utf8_parser.ColumnIndex("name")), QString::fromUtf8("Ång Å"));
+    QCOMPARE(utf8_parser.StringField(utf8_parser.ColumnIndex("alias")), QString::fromUtf8("Kuš Š"));
+    QVERIFY(!utf8_parser.NextRow());
+}
+
 void TestFWParser::FWReadMissingFile()
 {
     /*
@@ -160,6 +216,9 @@ void TestFWParser::FWReadMissingFile()
     KSParser missing_parser(test_file_name_, '#', sequence_, widths_);
     QHash<QString, QVariant> row_content = missing_parser.ReadNextRow();
 
+    KSParser missing_stream_parser(test_file_name_, '#', sequence_, widths_);
+    QVERIFY(!missing_stream_parser.NextRow());
+
     for (int times = 0; times < 20; times++)
     {
         row_content = missing_parser.ReadNextRow();
@@ -34,6 +34,8 @@ class TestFWParser : public QObject
     void MixedInputs();
     void OnlySpaceRow();
     void NoRow();
+    void FWStreamingRows();
+    void FWStreamingUtf8();
     void FWReadMissingFile();
 
   private:
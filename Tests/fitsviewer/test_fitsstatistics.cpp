@@ -0,0 +1,222 @@
+/***************************************************************************
+                test_fitsstatistics.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_fitsstatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+// A frame smaller than a tile, and one spread over several partitions of tiles, both with odd dimensions
+const QList<QSize> SIZES = { QSize(37, 23), QSize(521, 269) };
+
+struct Reference
+{
+    double min { 0 };
+    double max { 0 };
+    double mean { 0 };
+    double stddev { 0 };
+    double median { 0 };
+    QVector<double> histogram;
+};
+
+// Statistics computed the obvious way. NaN pixels are left out of the extrema, the median and the histogram, and
+// propagate to the mean and standard deviation.
+template <typename T>
+Reference naiveStatistics(const std::vector<T> &pixels, uint16_t binCount)
+{
+    Reference reference;
+
+    std::vector<double> finite;
+    long double sum = 0;
+    for (T pixel : pixels)
+    {
+        sum += pixel;
+        if (std::isfinite(static_cast<double>(pixel)))
+            finite.push_back(pixel);
+    }
+    std::sort(finite.begin(), finite.end());
+
+    reference.min    = finite.front();
+    reference.max    = finite.back();
+    reference.median = finite[finite.size() / 2];
+    reference.mean   = static_cast<double>(sum / pixels.size());
+
+    long double squares = 0;
+    for (T pixel : pixels)
+        squares += (pixel - static_cast<long double>(reference.mean)) * (pixel - static_cast<long double>(reference.mean));
+    reference.stddev = static_cast<double>(std::sqrt(squares / pixels.size()));
+
+    reference.histogram.fill(0, binCount);
+    const double binWidth = (reference.max - reference.min) / (binCount - 1);
+    for (double value : finite)
+    {
+        const int id = binWidth > 0 ? static_cast<int>(rint((value - reference.min) / binWidth)) : 0;
+        reference.histogram[qBound(0, id, binCount - 1)]++;
+    }
+
+    return reference;
+}
+
+template <typename T>
+void load(FITSData &data, const std::vector<T> &pixels, const QSize &size, uint32_t dataType)
+{
+    FITSData::Statistic stats;
+    stats.width               = size.width();
+    stats.height              = size.height();
+    stats.samples_per_channel = size.width() * size.height();
+    stats.bytesPerPixel       = sizeof(T);
+    data.restoreStatistics(stats);
+    data.setProperty("dataType", dataType);
+
+    uint8_t *buffer = new uint8_t[pixels.size() * sizeof(T)];
+    memcpy(buffer, pixels.data(), pixels.size() * sizeof(T));
+    data.setImageBuffer(buffer);
+
+    data.calculateStats(true);
+}
+
+void compareValue(const char *name, double actual, double expected, double tolerance)
+{
+    if (std::isnan(expected))
+        QVERIFY2(std::isnan(actual), qPrintable(QString("%1 is %2 instead of NaN").arg(name).arg(actual)));
+    else
+        QVERIFY2(std::fabs(actual - expected) <= tolerance * std::max(1.0, std::fabs(expected)),
+                 qPrintable(QString("%1 is %2 instead of %3").arg(name).arg(actual, 0, 'g', 17).arg(expected, 0, 'g', 17)));
+}
+
+template <typename T>
+void checkStatistics(const std::vector<T> &pixels, const QSize &size, uint32_t dataType, uint16_t binCount)
+{
+    FITSData data;
+    load(data, pixels, size, dataType);
+
+    const Reference reference = naiveStatistics(pixels, binCount);
+
+    QCOMPARE(data.getMin(), reference.min);
+    QCOMPARE(data.getMax(), reference.max);
+    QCOMPARE(data.getMedian(), reference.median);
+    compareValue("Mean", data.getMean(), reference.mean, 1e-12);
+    compareValue("Standard deviation", data.getStdDev(), reference.stddev, 1e-9);
+
+    QVector<double> histogram;
+    QVERIFY(data.getHistogram(histogram, binCount));
+    QCOMPARE(histogram, reference.histogram);
+}
+
+// Pixels spread over the whole range of T
+template <typename T>
+std::vector<T> randomPixels(const QSize &size)
+{
+    std::mt19937 generator(size.width() * size.height());
+    std::uniform_int_distribution<int> distribution(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
+
+    std::vector<T> pixels(size.width() * size.height());
+    for (T &pixel : pixels)
+        pixel = static_cast<T>(distribution(generator));
+    return pixels;
+}
+
+// Integral values of [-1000, 1000]. With 17 bins of 125 the bounds of the bins fall halfway between two
+// values, so the rounding of the fine histogram of float images does not move any value to another bin.
+std::vector<float> randomFloatPixels(const QSize &size, int nanEvery)
+{
+    std::mt19937 generator(size.width() * size.height());
+    std::uniform_int_distribution<int> distribution(-1000, 1000);
+
+    std::vector<float> pixels(size.width() * size.height());
+    for (float &pixel : pixels)
+        pixel = distribution(generator);
+
+    // Both extremes are present, whatever the size
+    pixels[1] = -1000;
+    pixels[pixels.size() - 2] = 1000;
+
+    if (nanEvery > 0)
+    {
+        for (size_t i = 0; i < pixels.size(); i += nanEvery)
+            pixels[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+
+    return pixels;
+}
+
+const uint16_t FLOAT_BINS = 17;
+}
+
+void TestFITSStatistics::testUInt8()
+{
+    for (const QSize &size : SIZES)
+    {
+        checkStatistics(randomPixels<uint8_t>(size), size, TBYTE, 32);
+        checkStatistics(randomPixels<uint8_t>(size), size, TBYTE, 256);
+    }
+}
+
+void TestFITSStatistics::testInt16()
+{
+    for (const QSize &size : SIZES)
+        checkStatistics(randomPixels<int16_t>(size), size, TSHORT, 100);
+}
+
+void TestFITSStatistics::testUInt16()
+{
+    for (const QSize &size : SIZES)
+        checkStatistics(randomPixels<uint16_t>(size), size, TUSHORT, 100);
+}
+
+void TestFITSStatistics::testFloat()
+{
+    for (const QSize &size : SIZES)
+        checkStatistics(randomFloatPixels(size, 0), size, TFLOAT, FLOAT_BINS);
+}
+
+void TestFITSStatistics::testFloatNaN()
+{
+    for (const QSize &size : SIZES)
+    {
+        // The first pixel is NaN, so the extrema cannot start from it
+        checkStatistics(randomFloatPixels(size, 97), size, TFLOAT, FLOAT_BINS);
+    }
+}
+
+void TestFITSStatistics::testConstant()
+{
+    const QSize size = SIZES.first();
+
+    FITSData data;
+    load(data, std::vector<uint16_t>(size.width() * size.height(), 1234), size, TUSHORT);
+
+    QCOMPARE(data.getMin(), 1234.0);
+    QCOMPARE(data.getMax(), 1234.0);
+    QCOMPARE(data.getMean(), 1234.0);
+    QCOMPARE(data.getStdDev(), 0.0);
+    QCOMPARE(data.getMedian(), 1234.0);
+
+    // All the pixels are in the first bin
+    QVector<double> histogram;
+    QVERIFY(data.getHistogram(histogram, 10));
+    QCOMPARE(histogram[0], static_cast<double>(size.width() * size.height()));
+    QCOMPARE(std::accumulate(histogram.begin(), histogram.end(), 0.0), histogram[0]);
+}
+
+QTEST_GUILESS_MAIN(TestFITSStatistics)
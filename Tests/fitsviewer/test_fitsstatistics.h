@@ -0,0 +1,46 @@
+/***************************************************************************
+                 test_fitsstatistics.h  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_FITSSTATISTICS_H
+#define TEST_FITSSTATISTICS_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "fitsdata.h"
+
+/**
+ * @class TestFITSStatistics
+ * @short Tests of the statistics and histogram of FITS images against a naive computation
+ */
+
+class TestFITSStatistics : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestFITSStatistics() : QObject(){};
+    ~TestFITSStatistics() override = default;
+
+  private slots:
+    void testUInt8();
+    void testInt16();
+    void testUInt16();
+    void testFloat();
+    void testFloatNaN();
+    void testConstant();
+};
+
+#endif
@@ -0,0 +1,139 @@
+/***************************************************************************
+                 test_fitswcsgrid.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_fitswcsgrid.h"
+#include "dms.h"
+
+#include <wcs.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+// A 2000x1500 frame of 3.6 arcseconds per pixel, centered 0.5 degrees east of 0h
+const int WIDTH  = 2000;
+const int HEIGHT = 1500;
+const double CRVAL_RA  = 0.5;
+const double CRVAL_DEC = 30.0;
+}
+
+void TestFITSWCSGrid::initTestCase()
+{
+    m_wcs       = new wcsprm;
+    m_wcs->flag = -1;
+    QCOMPARE(wcsini(1, 2, m_wcs), 0);
+
+    strcpy(m_wcs->ctype[0], "RA---TAN");
+    strcpy(m_wcs->ctype[1], "DEC--TAN");
+    m_wcs->crval[0] = CRVAL_RA;
+    m_wcs->crval[1] = CRVAL_DEC;
+    m_wcs->crpix[0] = WIDTH / 2.0;
+    m_wcs->crpix[1] = HEIGHT / 2.0;
+    m_wcs->cdelt[0] = -0.001;
+    m_wcs->cdelt[1] = 0.001;
+
+    QCOMPARE(wcsset(m_wcs), 0);
+}
+
+void TestFITSWCSGrid::cleanupTestCase()
+{
+    wcsfree(m_wcs);
+    delete m_wcs;
+}
+
+void TestFITSWCSGrid::testPixelToWorld()
+{
+    FITSWCSGrid grid(m_wcs, WIDTH, HEIGHT);
+
+    // Looked up coordinates are in [0, 360) on both sides of 0h, and match wcslib
+    for (int y = 0; y < HEIGHT; y += 149)
+    {
+        for (int x = 0; x < WIDTH; x += 97)
+        {
+            double ra = 0, dec = 0;
+            QVERIFY(grid.pixelToWorld(x, y, ra, dec));
+            QVERIFY(ra >= 0 && ra < 360);
+
+            double pixcrd[2] = { double(x), double(y) }, imgcrd[2], phi, theta, world[2];
+            int stat[1];
+            QCOMPARE(wcsp2s(m_wcs, 1, 2, pixcrd, imgcrd, &phi, &theta, world, stat), 0);
+
+            double dRA = std::remainder(ra - world[0], 360.0) * std::cos(dec * dms::DegToRad);
+            QVERIFY(std::abs(dRA) < FITSWCSGrid::MAX_ERROR * 0.001);
+            QVERIFY(std::abs(dec - world[1]) < FITSWCSGrid::MAX_ERROR * 0.001);
+        }
+    }
+}
+
+void TestFITSWCSGrid::testBounds()
+{
+    FITSWCSGrid grid(m_wcs, WIDTH, HEIGHT);
+
+    double minRA, maxRA, minDec, maxDec;
+    QVERIFY(grid.bounds(minRA, maxRA, minDec, maxDec));
+
+    // The range is continuous across 0h, so it starts below 0 degrees
+    QVERIFY(minRA < 0);
+    QVERIFY(maxRA > CRVAL_RA);
+    QVERIFY(maxRA - minRA < 180);
+    QVERIFY(minDec < CRVAL_DEC && maxDec > CRVAL_DEC);
+
+    // The bounds come from samples, not from the tiles
+    QCOMPARE(grid.cachedTiles(), 0);
+
+    // They agree with the coordinates of the corners
+    for (int y : { 0, HEIGHT - 1 })
+    {
+        for (int x : { 0, WIDTH - 1 })
+        {
+            double ra, dec;
+            QVERIFY(grid.pixelToWorld(x, y, ra, dec));
+            ra -= 360.0 * std::floor((ra - CRVAL_RA + 180.0) / 360.0);
+            QVERIFY(ra >= minRA - 1e-9 && ra <= maxRA + 1e-9);
+            QVERIFY(dec >= minDec - 1e-9 && dec <= maxDec + 1e-9);
+        }
+    }
+}
+
+void TestFITSWCSGrid::testGridLabels()
+{
+    FITSWCSGrid grid(m_wcs, WIDTH, HEIGHT);
+
+    double minRA, maxRA, minDec, maxDec;
+    QVERIFY(grid.bounds(minRA, maxRA, minDec, maxDec));
+
+    // Same half minute steps of RA as FITSView::drawEQGrid()
+    const double raConvert = 15 / 120.0;
+    for (int targetRA = minRA / raConvert; targetRA <= maxRA / raConvert; targetRA++)
+    {
+        dms ra = dms(targetRA * raConvert).reduce();
+
+        QVERIFY(ra.hour() >= 0 && ra.hour() < 24);
+        QVERIFY(ra.minute() >= 0 && ra.minute() < 60);
+        QVERIFY(ra.second() >= 0 && ra.second() < 60);
+
+        // The grid line half a minute west of 0h is labelled 23h 59' 30''
+        if (targetRA == -1)
+        {
+            QCOMPARE(ra.hour(), 23);
+            QCOMPARE(ra.minute(), 59);
+            QCOMPARE(ra.second(), 30);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestFITSWCSGrid)
@@ -0,0 +1,53 @@
+/***************************************************************************
+                  test_fitswcsgrid.h  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_FITSWCSGRID_H
+#define TEST_FITSWCSGRID_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#define UNIT_TEST
+
+#include "fitswcsgrid.h"
+
+struct wcsprm;
+
+/**
+ * @class TestFITSWCSGrid
+ * @short Tests of the WCS lookup grid on a frame that straddles 0h
+ */
+
+class TestFITSWCSGrid : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestFITSWCSGrid() : QObject(){};
+    ~TestFITSWCSGrid() override = default;
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testPixelToWorld();
+    void testBounds();
+    void testGridLabels();
+
+  private:
+    struct wcsprm *m_wcs { nullptr };
+};
+
+#endif
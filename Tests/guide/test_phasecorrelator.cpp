@@ -0,0 +1,144 @@
+/***************************************************************************
+               test_phasecorrelator.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_phasecorrelator.h"
+#include "imageautoguiding.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+// Shifts are recovered to a few 1e-7 pixels from Gaussian stars, which are smooth enough to be shifted exactly
+const double MAX_ERROR = 1e-5;
+
+/**
+ * Field of Gaussian stars over a flat background, away from the edges, shifted by dx columns and dy rows.
+ * The stars are the same for the same size.
+ */
+std::vector<float> starField(int n, double dx, double dy, int stride = 0)
+{
+    stride = stride > 0 ? stride : n;
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    struct Star
+    {
+        double x, y, flux;
+    };
+    std::vector<Star> stars(n / 8);
+    for (Star &star : stars)
+        star = { n * (0.2 + 0.6 * uniform(generator)), n * (0.2 + 0.6 * uniform(generator)),
+                 1000 * (0.2 + uniform(generator)) };
+
+    std::vector<float> image(static_cast<size_t>(n) * stride, 0.0f);
+    for (int y = 0; y < n; y++)
+    {
+        for (int x = 0; x < n; x++)
+        {
+            double value = 10;
+            for (const Star &star : stars)
+            {
+                double const ex = x - star.x - dx, ey = y - star.y - dy;
+                value += star.flux * std::exp(-(ex * ex + ey * ey) / (2 * 1.5 * 1.5));
+            }
+            image[y * stride + x] = value;
+        }
+    }
+
+    return image;
+}
+}
+
+void TestPhaseCorrelator::testShift_data()
+{
+    QTest::addColumn<int>("n");
+    QTest::addColumn<double>("dx");
+    QTest::addColumn<double>("dy");
+
+    for (int n : { 64, 128, 256 })
+    {
+        QTest::newRow(qPrintable(QString("%1 none").arg(n))) << n << 0.0 << 0.0;
+        QTest::newRow(qPrintable(QString("%1 subpixel").arg(n))) << n << 0.3 << -0.7;
+        QTest::newRow(qPrintable(QString("%1 quarter").arg(n))) << n << 1.25 << 0.5;
+        QTest::newRow(qPrintable(QString("%1 large").arg(n))) << n << -2.6 << 3.1;
+    }
+}
+
+void TestPhaseCorrelator::testShift()
+{
+    QFETCH(int, n);
+    QFETCH(double, dx);
+    QFETCH(double, dy);
+
+    std::vector<float> reference = starField(n, 0, 0);
+    std::vector<float> image     = starField(n, dx, dy);
+
+    // The first axis of the shift is the row index, the second one the column index
+    ImageAutoGuiding::PhaseCorrelator correlator(n);
+    correlator.setReference(reference.data());
+    QVERIFY(correlator.hasReference());
+
+    float xshift = 0, yshift = 0;
+    QVERIFY(correlator.shift(image.data(), &xshift, &yshift));
+    QVERIFY(std::abs(xshift - dy) < MAX_ERROR);
+    QVERIFY(std::abs(yshift - dx) < MAX_ERROR);
+
+    // The reference is kept between frames
+    QVERIFY(correlator.shift(reference.data(), &xshift, &yshift));
+    QVERIFY(std::abs(xshift) < MAX_ERROR);
+    QVERIFY(std::abs(yshift) < MAX_ERROR);
+
+    // Same result from the one-shot function
+    ImageAutoGuiding::ImageAutoGuiding1(reference.data(), image.data(), n, &xshift, &yshift);
+    QVERIFY(std::abs(xshift - dy) < MAX_ERROR);
+    QVERIFY(std::abs(yshift - dx) < MAX_ERROR);
+}
+
+void TestPhaseCorrelator::testStride()
+{
+    int const n = 128, stride = 200;
+
+    std::vector<float> reference = starField(n, 0, 0, stride);
+    std::vector<float> image     = starField(n, 0.4, -1.3, stride);
+
+    ImageAutoGuiding::PhaseCorrelator correlator(n);
+    correlator.setReference(reference.data(), stride);
+
+    float xshift = 0, yshift = 0;
+    QVERIFY(correlator.shift(image.data(), &xshift, &yshift, stride));
+    QVERIFY(std::abs(xshift + 1.3) < MAX_ERROR);
+    QVERIFY(std::abs(yshift - 0.4) < MAX_ERROR);
+}
+
+void TestPhaseCorrelator::testNoReference()
+{
+    std::vector<float> image = starField(64, 0, 0);
+    float xshift = 0, yshift = 0;
+
+    ImageAutoGuiding::PhaseCorrelator correlator(64);
+    QVERIFY(!correlator.hasReference());
+    QVERIFY(!correlator.shift(image.data(), &xshift, &yshift));
+
+    // Sizes that are not powers of 2 are refused
+    ImageAutoGuiding::PhaseCorrelator invalid(100);
+    invalid.setReference(image.data());
+    QVERIFY(!invalid.hasReference());
+}
+
+QTEST_GUILESS_MAIN(TestPhaseCorrelator)
@@ -0,0 +1,43 @@
+/***************************************************************************
+                test_phasecorrelator.h  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_PHASECORRELATOR_H
+#define TEST_PHASECORRELATOR_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+/**
+ * @class TestPhaseCorrelator
+ * @short Tests of the sub-pixel shifts found by the phase correlation of image guiding
+ */
+
+class TestPhaseCorrelator : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestPhaseCorrelator() : QObject(){};
+    ~TestPhaseCorrelator() override = default;
+
+  private slots:
+    void testShift_data();
+    void testShift();
+
+    void testStride();
+    void testNoReference();
+};
+
+#endif
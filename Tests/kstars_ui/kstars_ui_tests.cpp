@@ -10,6 +10,7 @@
 #include "kstars_ui_tests.h"
 #include "test_ekos.h"
 #include "test_ekos_simulator.h"
+#include "test_starhopper.h"
 
 #include "auxiliary/kspaths.h"
 #if defined(HAVE_INDI)
@@ -141,6 +142,12 @@ int main(int argc, char *argv[])
         KStarsUiTests * tc = new KStarsUiTests();
         result = QTest::qExec(tc, argc, argv);
 
+        if (!result)
+        {
+            TestStarHopper * sh = new TestStarHopper();
+            result |= QTest::qExec(sh, argc, argv);
+        }
+
 #if defined(HAVE_INDI)
         if (!result)
         {
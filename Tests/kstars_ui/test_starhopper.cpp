@@ -0,0 +1,62 @@
+/*  KStars UI tests
+    Copyright (C) 2026
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "test_starhopper.h"
+
+#include "kstars_ui_tests.h"
+
+#include "skymapcomposite.h"
+#include "starhopper.h"
+#include "skyobjects/starobject.h"
+
+#include <QtTest>
+
+TestStarHopper::TestStarHopper(QObject *parent): QObject(parent)
+{
+}
+
+void TestStarHopper::benchmarkComputePath_data()
+{
+    QTest::addColumn<QString>("source");
+    QTest::addColumn<QString>("destination");
+    QTest::addColumn<float>("fov");
+    QTest::addColumn<float>("maglim");
+
+    QTest::newRow("Vega to M 57, finder") << "Vega" << "M 57" << 5.0f << 8.0f;
+    QTest::newRow("Mirach to M 33, finder") << "Mirach" << "M 33" << 5.0f << 8.0f;
+    QTest::newRow("Alnitak to M 78, eyepiece") << "Alnitak" << "M 78" << 1.0f << 10.0f;
+    QTest::newRow("Deneb to M 39, binoculars") << "Deneb" << "M 39" << 7.0f << 9.0f;
+}
+
+void TestStarHopper::benchmarkComputePath()
+{
+    QFETCH(QString, source);
+    QFETCH(QString, destination);
+    QFETCH(float, fov);
+    QFETCH(float, maglim);
+
+    KStarsData * const data = KStars::Instance()->data();
+    SkyObject const * const src = data->skyComposite()->findByName(source);
+    SkyObject const * const dest = data->skyComposite()->findByName(destination);
+    QVERIFY(src != nullptr);
+    QVERIFY(dest != nullptr);
+
+    StarHopper hopper;
+    QList<StarObject *> *path = nullptr;
+
+    QBENCHMARK
+    {
+        delete path;
+        path = hopper.computePath(*src, *dest, fov, maglim);
+    }
+
+    QVERIFY(path != nullptr);
+    QVERIFY(!path->isEmpty());
+    delete path;
+}
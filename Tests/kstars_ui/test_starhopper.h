@@ -0,0 +1,27 @@
+/*  KStars UI tests
+    Copyright (C) 2026
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#pragma once
+
+#include <QObject>
+
+/**
+ * @class TestStarHopper
+ * Benchmarks the star hopper on fixed routes, with the catalogs loaded by the KStars instance.
+ */
+class TestStarHopper : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TestStarHopper(QObject *parent = nullptr);
+
+private slots:
+    void benchmarkComputePath_data();
+    void benchmarkComputePath();
+};
@@ -0,0 +1,46 @@
+/***************************************************************************
+               test_schedulerephemeris.h  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_SCHEDULEREPHEMERIS_H
+#define TEST_SCHEDULEREPHEMERIS_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#define UNIT_TEST
+
+#include "schedulerephemeris.h"
+
+/**
+ * @class TestSchedulerEphemeris
+ * @short Tests of the altitude searches of the scheduler ephemeris against a minute by minute search
+ */
+
+class TestSchedulerEphemeris : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestSchedulerEphemeris() : QObject(){};
+    ~TestSchedulerEphemeris() override = default;
+
+  private slots:
+    void testIndexOf();
+
+    void testFirstAtOrAbove_data();
+    void testFirstAtOrAbove();
+};
+
+#endif
@@ -0,0 +1,217 @@
+/***************************************************************************
+                test_objectnameindex.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_objectnameindex.h"
+#include "skyobjects/skyobject.h"
+#include "skyobjects/starobject.h"
+
+const SkyObject *TestObjectNameIndex::add(int type, const QString &name, int priority, const QString &longName)
+{
+    if (type == SkyObject::STAR)
+        m_Objects.emplace_back(new StarObject(0.0, 0.0, 0.0, name));
+    else
+        m_Objects.emplace_back(new SkyObject(type, 0.0, 0.0, 0.0, name, QString(), longName));
+
+    const SkyObject *object = m_Objects.back().get();
+    m_Index.insert(type, name, object, priority);
+    return object;
+}
+
+void TestObjectNameIndex::init()
+{
+    m_Index.clear();
+    m_Objects.clear();
+}
+
+void TestObjectNameIndex::cleanup()
+{
+    m_Index.clear();
+    m_Objects.clear();
+}
+
+void TestObjectNameIndex::testFind()
+{
+    const SkyObject *m31  = add(SkyObject::GALAXY, "M 31", ObjectNameIndex::DeepSkyPriority, "Andromeda Galaxy");
+    const SkyObject *vega = add(SkyObject::STAR, "Vega", ObjectNameIndex::StarPriority);
+
+    QCOMPARE(m_Index.find("M 31"), m31);
+    // Case and whitespace are ignored, and long names are aliases
+    QCOMPARE(m_Index.find("m  31 "), m31);
+    QCOMPARE(m_Index.find("andromeda galaxy"), m31);
+    QCOMPARE(m_Index.find("VEGA"), vega);
+
+    QVERIFY(m_Index.find("M 3") == nullptr);
+    QVERIFY(m_Index.find(QString()) == nullptr);
+
+    // Indexing an object again under a name it already has does not duplicate it
+    int const size = m_Index.size();
+    m_Index.insert(SkyObject::STAR, "vega", vega, ObjectNameIndex::StarPriority);
+    QCOMPARE(m_Index.size(), size);
+}
+
+void TestObjectNameIndex::testFindPrefix()
+{
+    const SkyObject *m31    = add(SkyObject::GALAXY, "M 31", ObjectNameIndex::DeepSkyPriority, "Andromeda Galaxy");
+    const SkyObject *m3     = add(SkyObject::GASEOUS_NEBULA, "M 3", ObjectNameIndex::DeepSkyPriority);
+    const SkyObject *m33    = add(SkyObject::GALAXY, "M 33", ObjectNameIndex::DeepSkyPriority);
+    const SkyObject *mars   = add(SkyObject::PLANET, "Mars", ObjectNameIndex::SolarSystemPriority);
+    const SkyObject *markab = add(SkyObject::STAR, "Markab", ObjectNameIndex::StarPriority);
+    add(SkyObject::STAR, "Vega", ObjectNameIndex::StarPriority);
+
+    // Exact match first, then shorter names, each object once
+    QVector<ObjectNameIndex::Match> matches = m_Index.findPrefix("m 3");
+    QCOMPARE(matches.size(), 3);
+    QCOMPARE(matches[0].object, m3);
+    QCOMPARE(matches[1].object, m31);
+    QCOMPARE(matches[2].object, m33);
+    QCOMPARE(matches[1].name, QString("M 31"));
+    QCOMPARE(matches[0].distance, 0);
+
+    matches = m_Index.findPrefix("MAR");
+    QCOMPARE(matches.size(), 2);
+    QCOMPARE(matches[0].object, mars);
+    QCOMPARE(matches[1].object, markab);
+
+    // Aliases are searched too, the object is returned under the alias that matched
+    matches = m_Index.findPrefix("andro");
+    QCOMPARE(matches.size(), 1);
+    QCOMPARE(matches[0].object, m31);
+    QCOMPARE(matches[0].name, QString("Andromeda Galaxy"));
+
+    QCOMPARE(m_Index.findPrefix("m", 2).size(), 2);
+    QCOMPARE(m_Index.findPrefix("m", 0).size(), 0);
+    QCOMPARE(m_Index.findPrefix("x").size(), 0);
+    QCOMPARE(m_Index.findPrefix(QString()).size(), 0);
+}
+
+void TestObjectNameIndex::testFindFuzzy()
+{
+    const SkyObject *m31   = add(SkyObject::GALAXY, "M 31", ObjectNameIndex::DeepSkyPriority, "Andromeda Galaxy");
+    const SkyObject *vega  = add(SkyObject::STAR, "Vega", ObjectNameIndex::StarPriority);
+    const SkyObject *deneb = add(SkyObject::STAR, "Deneb", ObjectNameIndex::StarPriority);
+    add(SkyObject::STAR, "Altair", ObjectNameIndex::StarPriority);
+
+    // A transposition of adjacent letters counts as one edit
+    QVector<ObjectNameIndex::Match> matches = m_Index.findFuzzy("Vgea", 1);
+    QCOMPARE(matches.size(), 1);
+    QCOMPARE(matches[0].object, vega);
+    QCOMPARE(matches[0].distance, 1);
+
+    matches = m_Index.findFuzzy("andromeda galxy");
+    QCOMPARE(matches.size(), 1);
+    QCOMPARE(matches[0].object, m31);
+    QCOMPARE(matches[0].name, QString("Andromeda Galaxy"));
+    QCOMPARE(matches[0].distance, 1);
+
+    // "Denb" is one deletion from Deneb, Vega is out of reach
+    matches = m_Index.findFuzzy("Denb", 2);
+    QCOMPARE(matches.size(), 1);
+    QCOMPARE(matches[0].object, deneb);
+
+    // Closest first
+    matches = m_Index.findFuzzy("Dega", 3);
+    QCOMPARE(matches.size(), 2);
+    QCOMPARE(matches[0].object, vega);
+    QCOMPARE(matches[0].distance, 1);
+    QCOMPARE(matches[1].object, deneb);
+    QCOMPARE(matches[1].distance, 3);
+
+    // Exact matches have distance 0
+    matches = m_Index.findFuzzy("vega", 0);
+    QCOMPARE(matches.size(), 1);
+    QCOMPARE(matches[0].distance, 0);
+
+    QCOMPARE(m_Index.findFuzzy("Dega", 3, 1).size(), 1);
+    QCOMPARE(m_Index.findFuzzy("Xyzzy", 2).size(), 0);
+}
+
+void TestObjectNameIndex::testPriority()
+{
+    // A star of the star catalog, and a star of a custom catalog with the same name. The custom catalog is searched
+    // first by SkyMapComposite::findByName(), whatever the type of the objects and the order they were indexed in.
+    const SkyObject *star   = add(SkyObject::STAR, "Tau Test", ObjectNameIndex::StarPriority);
+    const SkyObject *custom = add(SkyObject::STAR, "Tau Test", ObjectNameIndex::CustomCatalogPriority);
+    const SkyObject *planet = add(SkyObject::PLANET, "Tau Test", ObjectNameIndex::SolarSystemPriority);
+    const SkyObject *sat    = add(SkyObject::SATELLITE, "Tau Tests", ObjectNameIndex::SatellitePriority);
+
+    QCOMPARE(m_Index.find("tau test"), planet);
+
+    QVector<ObjectNameIndex::Match> matches = m_Index.findPrefix("tau");
+    QCOMPARE(matches.size(), 4);
+    QCOMPARE(matches[0].object, planet);
+    QCOMPARE(matches[1].object, custom);
+    QCOMPARE(matches[2].object, star);
+    QCOMPARE(matches[3].object, sat);
+
+    matches = m_Index.findFuzzy("tau tes", 2);
+    QCOMPARE(matches.size(), 4);
+    QCOMPARE(matches[0].object, planet);
+    QCOMPARE(matches[1].object, custom);
+    QCOMPARE(matches[2].object, star);
+    QCOMPARE(matches[3].object, sat);
+
+    m_Index.remove("Tau Test", planet);
+    QCOMPARE(m_Index.find("tau test"), custom);
+    m_Index.remove("Tau Test", custom);
+    QCOMPARE(m_Index.find("tau test"), star);
+
+    // Objects of the same component sharing a name: the most recent one wins, as in the hashes of the components
+    const SkyObject *newer = add(SkyObject::STAR, "Tau Test", ObjectNameIndex::StarPriority);
+    QCOMPARE(m_Index.find("tau test"), newer);
+}
+
+void TestObjectNameIndex::testRemove()
+{
+    const SkyObject *m31 = add(SkyObject::GALAXY, "M 31", ObjectNameIndex::DeepSkyPriority, "Andromeda Galaxy");
+    add(SkyObject::COMET, "C/2020 F3", ObjectNameIndex::SolarSystemPriority);
+    add(SkyObject::COMET, "C/2023 A3", ObjectNameIndex::SolarSystemPriority);
+
+    // Sorted names are rebuilt after a change
+    QCOMPARE(m_Index.findPrefix("c/20").size(), 2);
+
+    m_Index.removeType(SkyObject::COMET);
+    QCOMPARE(m_Index.findPrefix("c/20").size(), 0);
+    QCOMPARE(m_Index.find("M 31"), m31);
+
+    // Removing an object removes its aliases
+    m_Index.remove("M 31", m31);
+    QVERIFY(m_Index.find("andromeda galaxy") == nullptr);
+    QCOMPARE(m_Index.size(), 0);
+}
+
+void TestObjectNameIndex::testMerge()
+{
+    ObjectNameIndex other;
+
+    const SkyObject *star = add(SkyObject::STAR, "Tau Test", ObjectNameIndex::StarPriority);
+
+    m_Objects.emplace_back(new StarObject(0.0, 0.0, 0.0, "Tau Test"));
+    const SkyObject *custom = m_Objects.back().get();
+    other.insert(SkyObject::STAR, "Tau Test", custom, ObjectNameIndex::CustomCatalogPriority);
+
+    // Priorities are kept by the merge, and the sorted names are rebuilt
+    QCOMPARE(m_Index.findPrefix("tau").size(), 1);
+    m_Index.merge(other);
+    QCOMPARE(m_Index.size(), 2);
+    QCOMPARE(m_Index.find("tau test"), custom);
+
+    QVector<ObjectNameIndex::Match> matches = m_Index.findPrefix("tau");
+    QCOMPARE(matches.size(), 2);
+    QCOMPARE(matches[0].object, custom);
+    QCOMPARE(matches[1].object, star);
+}
+
+QTEST_GUILESS_MAIN(TestObjectNameIndex)
@@ -0,0 +1,59 @@
+/***************************************************************************
+                 test_objectnameindex.h  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_OBJECTNAMEINDEX_H
+#define TEST_OBJECTNAMEINDEX_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "skycomponents/objectnameindex.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * @class TestObjectNameIndex
+ * @short Tests of the exact, prefix and fuzzy name lookups of ObjectNameIndex
+ */
+
+class TestObjectNameIndex : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestObjectNameIndex() : QObject(){};
+    ~TestObjectNameIndex() override = default;
+
+  private slots:
+    void init();
+    void cleanup();
+
+    void testFind();
+    void testFindPrefix();
+    void testFindFuzzy();
+    void testPriority();
+    void testRemove();
+    void testMerge();
+
+  private:
+    /** Create an object and index it under its name */
+    const SkyObject *add(int type, const QString &name, int priority, const QString &longName = QString());
+
+    std::vector<std::unique_ptr<SkyObject>> m_Objects;
+    ObjectNameIndex m_Index;
+};
+
+#endif
@@ -0,0 +1,110 @@
+/***************************************************************************
+                   test_starblock.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_starblock.h"
+#include "ksnumbers.h"
+#include "Options.h"
+#include "skyobjects/stardata.h"
+#include "skyobjects/starobject.h"
+
+#include <cmath>
+
+namespace
+{
+// Stars of the catalog: RA in hours, Dec in degrees, proper motion in milliarcsec per year
+struct CatalogStar
+{
+    double ra, dec, pmRA, pmDec;
+};
+
+const CatalogStar catalog[] = {
+    { 0.0, 0.0, 0, 0 },
+    { 2.5301944, 89.264111, 44.2, -11.7 },       // Polaris, close to the pole so updated by StarObject
+    { 6.7524722, -16.716111, -546.0, -1223.1 },  // Sirius
+    { 14.660139, -60.833972, -3679.3, 473.7 },   // Alpha Centauri
+    { 17.963472, 4.693389, -798.6, 10328.1 },    // Barnard's star
+    { 18.615639, 38.783667, 200.9, 286.2 },      // Vega
+    { 23.999, -79.9, 12.0, -3.0 },
+    { 12.0, 79.99, -5.0, 2.0 },
+    { 9.5, -45.0, 0, 0 },
+};
+
+StarData toStarData(const CatalogStar &star)
+{
+    StarData data;
+    data.RA           = std::lround(star.ra * 1000000.0);
+    data.Dec          = std::lround(star.dec * 100000.0);
+    data.dRA          = std::lround(star.pmRA * 10.0);
+    data.dDec         = std::lround(star.pmDec * 10.0);
+    data.mag          = 500;
+    data.spec_type[0] = 'A';
+    data.spec_type[1] = '0';
+    return data;
+}
+}
+
+void TestStarBlock::initTestCase()
+{
+    // Light bending is left to StarObject by StarBlock::JITupdate()
+    Options::setUseRelativistic(false);
+}
+
+void TestStarBlock::testUpdateEquatorial_data()
+{
+    QTest::addColumn<double>("jd");
+
+    QTest::newRow("J2000") << 2451545.0;
+    QTest::newRow("1900") << 2415020.5;
+    QTest::newRow("2024") << 2460310.5;
+    QTest::newRow("2150") << 2506332.5;
+}
+
+void TestStarBlock::testUpdateEquatorial()
+{
+    QFETCH(double, jd);
+
+    const int count = sizeof(catalog) / sizeof(catalog[0]);
+    StarBlock block(count);
+
+    for (const CatalogStar &star : catalog)
+    {
+        StarData data = toStarData(star);
+        QVERIFY(block.addStar(data) != nullptr);
+    }
+    QCOMPARE(block.getStarCount(), count);
+
+    KSNumbers num(jd);
+    block.updateEquatorial(&num);
+
+    for (int i = 0; i < count; ++i)
+    {
+        StarData data = toStarData(catalog[i]);
+        StarObject reference;
+        reference.init(&data);
+        reference.updateCoords(&num);
+
+        const StarObject *star = block.star(i);
+        double dRA = std::remainder(star->ra().Degrees() - reference.ra().Degrees(), 360.0);
+
+        if (std::abs(dRA) > 1e-9 || std::abs(star->dec().Degrees() - reference.dec().Degrees()) > 1e-9)
+            qWarning() << "Star" << i << "differs by" << dRA << star->dec().Degrees() - reference.dec().Degrees();
+
+        QVERIFY(std::abs(dRA) <= 1e-9);
+        QVERIFY(std::abs(star->dec().Degrees() - reference.dec().Degrees()) <= 1e-9);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestStarBlock)
@@ -0,0 +1,46 @@
+/***************************************************************************
+                    test_starblock.h  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_STARBLOCK_H
+#define TEST_STARBLOCK_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#define UNIT_TEST
+
+#include "skycomponents/starblock.h"
+
+/**
+ * @class TestStarBlock
+ * @short Tests of the block-wise coordinate update of StarBlock against StarObject
+ */
+
+class TestStarBlock : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestStarBlock() : QObject(){};
+    ~TestStarBlock() override = default;
+
+  private slots:
+    void initTestCase();
+
+    void testUpdateEquatorial_data();
+    void testUpdateEquatorial();
+};
+
+#endif
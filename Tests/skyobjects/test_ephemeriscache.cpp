@@ -0,0 +1,156 @@
+/***************************************************************************
+                 test_ephemeriscache.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_ephemeriscache.h"
+#include "ksnumbers.h"
+#include "skyobjects/ksmoon.h"
+#include "skyobjects/ksplanet.h"
+#include "skyobjects/kspluto.h"
+#include "skyobjects/kssun.h"
+
+#include <memory>
+
+namespace
+{
+/** @return angular distance between two positions, in arcseconds */
+double separation(const dms &ra1, const dms &dec1, const dms &ra2, const dms &dec2)
+{
+    double sinRA1, cosRA1, sinDec1, cosDec1, sinRA2, cosRA2, sinDec2, cosDec2;
+    ra1.SinCos(sinRA1, cosRA1);
+    dec1.SinCos(sinDec1, cosDec1);
+    ra2.SinCos(sinRA2, cosRA2);
+    dec2.SinCos(sinDec2, cosDec2);
+
+    double const x1 = cosDec1 * cosRA1, y1 = cosDec1 * sinRA1, z1 = sinDec1;
+    double const x2 = cosDec2 * cosRA2, y2 = cosDec2 * sinRA2, z2 = sinDec2;
+
+    double const cx = y1 * z2 - z1 * y2;
+    double const cy = z1 * x2 - x1 * z2;
+    double const cz = x1 * y2 - y1 * x2;
+
+    return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), x1 * x2 + y1 * y2 + z1 * z2) / dms::DegToRad * 3600.0;
+}
+}
+
+void TestEphemerisCache::initTestCase()
+{
+    // Cache files are written to the test locations, not to the ones of the user
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestEphemerisCache::testAccuracy_data()
+{
+    QTest::addColumn<QString>("name");
+
+    // The Moon and Mercury move fastest, the Sun and Pluto use the other theories
+    QTest::newRow("Sun") << "Sun";
+    QTest::newRow("Moon") << "Moon";
+    QTest::newRow("Mercury") << "Mercury";
+    QTest::newRow("Pluto") << "Pluto";
+}
+
+void TestEphemerisCache::testAccuracy()
+{
+    QFETCH(QString, name);
+
+    std::unique_ptr<KSPlanetBase> body;
+    if (name == "Sun")
+        body.reset(new KSSun());
+    else if (name == "Moon")
+        body.reset(new KSMoon());
+    else if (name == "Pluto")
+        body.reset(new KSPluto());
+    else
+        body.reset(new KSPlanet(KSPlanetBase::MERCURY));
+
+    // Pluto is computed from orbital elements, the other bodies need the data files of their theories
+    if (name != "Pluto" && !body->loadData())
+        QSKIP("Data files of the theory are not installed.");
+
+    QVERIFY(EphemerisCache::isSupported(body.get()));
+
+    // Forty days across a block boundary
+    long double const startJD = J2000 + 30 * EphemerisCache::BLOCK_DAYS - 20;
+    long double const stopJD  = startJD + 40;
+
+    auto ephemeris = EphemerisCache::Instance()->prepare(body.get(), startJD, stopJD);
+    QVERIFY(ephemeris != nullptr);
+    QVERIFY(ephemeris->contains(startJD));
+    QVERIFY(ephemeris->contains(stopJD));
+
+    KSPlanet earth(i18n("Earth"), QString(), QColor("white"), 12756.28 /*diameter in km*/);
+    KSNumbers num(startJD);
+    double worst = 0;
+
+    // Dates between the nodes of the segments, where the fit is least constrained
+    for (long double jd = startJD; jd <= stopJD; jd += 0.0917L)
+    {
+        EphemerisCache::State state;
+        QVERIFY(ephemeris->state(jd, state));
+
+        num.updateValues(jd);
+        earth.findPosition(&num);
+        body->findPosition(&num, nullptr, nullptr, &earth);
+
+        double const error = separation(state.ra, state.dec, body->ra(), body->dec());
+        worst              = std::max(worst, error);
+
+        QVERIFY(std::fabs(state.rearth - body->rearth()) < 1e-6 * body->rearth());
+    }
+
+    qDebug() << name << "largest error" << worst << "arcseconds, estimated" << ephemeris->maxError();
+    QVERIFY(worst <= EphemerisCache::MAX_ERROR);
+}
+
+void TestEphemerisCache::testSaveLoad()
+{
+    QString const key = "TestSaveLoad";
+
+    QHash<int, std::shared_ptr<const EphemerisCache::Block>> blocks;
+    for (int index = -1; index <= 1; index++)
+    {
+        std::shared_ptr<EphemerisCache::Block> block(new EphemerisCache::Block());
+        block->segments    = 2;
+        block->degree      = 3;
+        block->segmentDays = EphemerisCache::BLOCK_DAYS / block->segments;
+        block->maxError    = 0.01 * (index + 2);
+        for (int i = 0; i < block->segments * 3 * (block->degree + 1); i++)
+            block->coefficients.append(index + i / 7.0);
+        blocks.insert(index, block);
+    }
+
+    EphemerisCache::save(key, blocks);
+
+    EphemerisCache::Body body;
+    EphemerisCache::load(key, body);
+    QFile::remove(EphemerisCache::fileName(key));
+
+    QCOMPARE(body.blocks.size(), blocks.size());
+    for (auto it = blocks.constBegin(); it != blocks.constEnd(); ++it)
+    {
+        QVERIFY(body.blocks.contains(it.key()));
+
+        const EphemerisCache::Block &saved  = *it.value();
+        const EphemerisCache::Block &loaded = *body.blocks.value(it.key());
+        QCOMPARE(loaded.segments, saved.segments);
+        QCOMPARE(loaded.degree, saved.degree);
+        QCOMPARE(loaded.segmentDays, saved.segmentDays);
+        QCOMPARE(loaded.maxError, saved.maxError);
+        QCOMPARE(loaded.coefficients, saved.coefficients);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestEphemerisCache)
@@ -0,0 +1,48 @@
+/***************************************************************************
+                  test_ephemeriscache.h  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_EPHEMERISCACHE_H
+#define TEST_EPHEMERISCACHE_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#define UNIT_TEST
+
+#include "skyobjects/ephemeriscache.h"
+
+/**
+ * @class TestEphemerisCache
+ * @short Tests of the accuracy of the cached ephemerides and of their cache files
+ */
+
+class TestEphemerisCache : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestEphemerisCache() : QObject(){};
+    ~TestEphemerisCache() override = default;
+
+  private slots:
+    void initTestCase();
+
+    void testAccuracy_data();
+    void testAccuracy();
+
+    void testSaveLoad();
+};
+
+#endif
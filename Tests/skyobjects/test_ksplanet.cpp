@@ -0,0 +1,76 @@
+/***************************************************************************
+                   test_ksplanet.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_ksplanet.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+void TestKSPlanet::testBatchEcliptic_data()
+{
+    QTest::addColumn<int>("planet");
+    QTest::addColumn<int>("count");
+
+    // -1 is the Earth, which has no entry in the PLANET enum. Odd counts leave a remainder to the vectorized loops.
+    QTest::newRow("Earth") << -1 << 37;
+    QTest::newRow("Mercury") << int(KSPlanetBase::MERCURY) << 37;
+    QTest::newRow("Jupiter") << int(KSPlanetBase::JUPITER) << 64;
+    QTest::newRow("Neptune") << int(KSPlanetBase::NEPTUNE) << 5;
+    QTest::newRow("one date") << int(KSPlanetBase::VENUS) << 1;
+    QTest::newRow("no date") << int(KSPlanetBase::MARS) << 0;
+}
+
+void TestKSPlanet::testBatchEcliptic()
+{
+    QFETCH(int, planet);
+    QFETCH(int, count);
+
+    std::unique_ptr<KSPlanet> body;
+    if (planet < 0)
+        body.reset(new KSPlanet(i18n("Earth"), QString(), QColor("white"), 12756.28 /*diameter in km*/));
+    else
+        body.reset(new KSPlanet(planet));
+
+    if (!body->loadData())
+        QSKIP("Data files of VSOP87 are not installed.");
+
+    // Dates spread over four millenia, unordered, in Julian millenia from J2000
+    std::vector<double> jm(count);
+    for (int t = 0; t < count; t++)
+        jm[t] = -2.0 + 4.0 * ((t * 7919) % 997) / 997.0;
+
+    std::vector<EclipticPosition> batch(count);
+    body->calcEcliptic(jm.data(), batch.data(), count);
+
+    for (int t = 0; t < count; t++)
+    {
+        EclipticPosition scalar;
+        body->calcEcliptic(jm[t], scalar);
+
+        // Terms are summed in another order, which only changes the last bits. The longitude grows by up to
+        // 5e4 radians over two millenia, so its last bits are worth more.
+        QVERIFY2(std::fabs(batch[t].longitude.Degrees() - scalar.longitude.Degrees()) < 1e-8,
+                 qPrintable(QString("longitude %1 instead of %2 at %3")
+                                .arg(batch[t].longitude.Degrees(), 0, 'g', 17)
+                                .arg(scalar.longitude.Degrees(), 0, 'g', 17)
+                                .arg(jm[t])));
+        QVERIFY(std::fabs(batch[t].latitude.Degrees() - scalar.latitude.Degrees()) < 1e-9);
+        QVERIFY(std::fabs(batch[t].radius - scalar.radius) < 1e-12 * scalar.radius);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestKSPlanet)
@@ -0,0 +1,42 @@
+/***************************************************************************
+                    test_ksplanet.h  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_KSPLANET_H
+#define TEST_KSPLANET_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "skyobjects/ksplanet.h"
+
+/**
+ * @class TestKSPlanet
+ * @short Tests of the evaluation of the VSOP87 series of KSPlanet at several dates at once
+ */
+
+class TestKSPlanet : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestKSPlanet() : QObject(){};
+    ~TestKSPlanet() override = default;
+
+  private slots:
+    void testBatchEcliptic_data();
+    void testBatchEcliptic();
+};
+
+#endif
@@ -0,0 +1,157 @@
+/***************************************************************************
+                  test_satellite.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_satellite.h"
+#include "geolocation.h"
+#include "skyobjects/satellitegroup.h"
+
+#include <cmath>
+#include <memory>
+
+namespace
+{
+// ISS elements of 2008 September 20, 12:25 UTC
+const QString ISS_NAME  = "ISS (ZARYA)";
+const QString ISS_LINE1 = "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+const QString ISS_LINE2 = "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+
+// Passes above 10 degrees seen from Paris, from 2008 September 20, 12:00 UTC to the next day. Rises, culminations
+// and sets were found by sampling the elevation every second, only the first pass is in a dark sky while the ISS is
+// sunlit.
+const double START_JD = 2454730.0;
+const double STOP_JD  = START_JD + 1.0;
+
+struct ExpectedPass
+{
+    double riseJD, culminationJD, setJD, maxElevation;
+    bool visible;
+};
+
+const ExpectedPass expectedPasses[] = {
+    { 2454730.328843, 2454730.330833, 2454730.332824, 53.35, true },
+    { 2454730.395081, 2454730.397072, 2454730.399062, 50.01, false },
+    { 2454730.461447, 2454730.463461, 2454730.465451, 55.60, false },
+    { 2454730.527720, 2454730.529641, 2454730.531551, 39.78, false },
+};
+
+// Rises and sets are refined to about a second
+const double TOLERANCE = 3.0 / 86400.0;
+
+GeoLocation paris()
+{
+    return GeoLocation(dms(2.35), dms(48.85), "Paris", "", "France", 1.0);
+}
+
+void comparePass(const Satellite::Pass &pass, const ExpectedPass &expected)
+{
+    QVERIFY2(std::fabs(pass.riseJD - expected.riseJD) < TOLERANCE,
+             qPrintable(QString("Rise at %1 instead of %2").arg(pass.riseJD, 0, 'f', 6).arg(expected.riseJD, 0, 'f', 6)));
+    QVERIFY2(std::fabs(pass.culminationJD - expected.culminationJD) < TOLERANCE,
+             qPrintable(QString("Culmination at %1 instead of %2")
+                            .arg(pass.culminationJD, 0, 'f', 6)
+                            .arg(expected.culminationJD, 0, 'f', 6)));
+    QVERIFY2(std::fabs(pass.setJD - expected.setJD) < TOLERANCE,
+             qPrintable(QString("Set at %1 instead of %2").arg(pass.setJD, 0, 'f', 6).arg(expected.setJD, 0, 'f', 6)));
+    QVERIFY(std::fabs(pass.maxElevation - expected.maxElevation) < 0.01);
+    QCOMPARE(pass.visible, expected.visible);
+}
+}
+
+void TestSatellite::testFindPasses()
+{
+    GeoLocation geo = paris();
+    Satellite iss(ISS_NAME, ISS_LINE1, ISS_LINE2);
+
+    QVector<Satellite::Observer> samples;
+    for (double jd = START_JD; jd <= STOP_JD; jd += 1.0 / (24 * 60))
+        samples.append(Satellite::observer(&geo, jd));
+
+    QVector<Satellite::Pass> passes = iss.findPasses(samples, &geo, 10.0);
+
+    QCOMPARE(passes.size(), 4);
+    for (int i = 0; i < passes.size(); i++)
+    {
+        QCOMPARE(passes[i].satellite, &iss);
+        comparePass(passes[i], expectedPasses[i]);
+    }
+
+    // The satellite itself is not modified
+    QVERIFY(!iss.isVisible());
+}
+
+void TestSatellite::testGroupFindPasses()
+{
+    GeoLocation geo = paris();
+
+    // No TLE file, satellites are added by hand
+    SatelliteGroup group("Test", "test_satellite.tle", QUrl());
+    group.append(new Satellite(ISS_NAME, ISS_LINE1, ISS_LINE2));
+
+    QVector<Satellite::Pass> passes = group.findPasses(&geo, START_JD, STOP_JD, 10.0, false);
+    QCOMPARE(passes.size(), 4);
+    for (int i = 0; i < passes.size(); i++)
+        comparePass(passes[i], expectedPasses[i]);
+
+    passes = group.findPasses(&geo, START_JD, STOP_JD, 10.0, true);
+    QCOMPARE(passes.size(), 1);
+    comparePass(passes[0], expectedPasses[0]);
+
+    qDeleteAll(group);
+}
+
+void TestSatellite::testGroupPositions()
+{
+    GeoLocation geo = paris();
+
+    SatelliteGroup group("Test", "test_satellite.tle", QUrl());
+    Satellite *iss   = new Satellite(ISS_NAME, ISS_LINE1, ISS_LINE2);
+    Satellite *other = new Satellite("ISS (OTHER)", ISS_LINE1, ISS_LINE2);
+    group.append(iss);
+    group.append(other);
+
+    iss->setSelected(true);
+    other->setSelected(false);
+
+    // At the culmination of the visible pass
+    Satellite::Observer observer = Satellite::observer(&geo, expectedPasses[0].culminationJD);
+    group.updateSatellitesPos(observer);
+
+    // Only the selected satellites are listed, with the position the satellite was updated to
+    QCOMPARE(group.positions().size(), 1);
+    const SatelliteGroup::SatellitePosition &position = group.positions()[0];
+    QCOMPARE(position.satellite, iss);
+    QCOMPARE(position.ra, iss->ra().Degrees());
+    QCOMPARE(position.dec, iss->dec().Degrees());
+    QCOMPARE(position.position.elevation, iss->alt().Degrees());
+    QCOMPARE(position.position.range, iss->range());
+    QCOMPARE(position.visible, iss->isVisible());
+    QVERIFY(position.visible);
+    QVERIFY(std::fabs(position.position.elevation - expectedPasses[0].maxElevation) < 0.01);
+
+    other->setSelected(true);
+    group.updateSatellitesPos(observer);
+    QCOMPARE(group.positions().size(), 2);
+    QCOMPARE(group.positions()[1].satellite, other);
+
+    iss->setSelected(false);
+    other->setSelected(false);
+    group.updateSatellitesPos(observer);
+    QCOMPARE(group.positions().size(), 0);
+
+    qDeleteAll(group);
+}
+
+QTEST_GUILESS_MAIN(TestSatellite)
@@ -0,0 +1,43 @@
+/***************************************************************************
+                   test_satellite.h  -  KStars Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_SATELLITE_H
+#define TEST_SATELLITE_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "skyobjects/satellite.h"
+
+/**
+ * @class TestSatellite
+ * @short Tests of the passes and of the positions of satellites
+ */
+
+class TestSatellite : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestSatellite() : QObject(){};
+    ~TestSatellite() override = default;
+
+  private slots:
+    void testFindPasses();
+    void testGroupFindPasses();
+    void testGroupPositions();
+};
+
+#endif
@@ -543,27 +543,35 @@ bool CatalogDB::AddCatalogContents(const QString &fname)
         skydb_.open();
         skydb_.transaction();
 
-        QHash<QString, QVariant> row_content;
-        while (catalog_text_parser.HasNextRow())
+        // Rows are read in streaming mode. Columns missing from the header have an index of -1, and read as 0 or empty.
+        const int idColumn    = catalog_text_parser.ColumnIndex("ID");
+        const int raColumn    = catalog_text_parser.ColumnIndex("RA");
+        const int decColumn   = catalog_text_parser.ColumnIndex("Dc");
+        const int typeColumn  = catalog_text_parser.ColumnIndex("Tp");
+        const int nameColumn  = catalog_text_parser.ColumnIndex("Nm");
+        const int magColumn   = catalog_text_parser.ColumnIndex("Mg");
+        const int paColumn    = catalog_text_parser.ColumnIndex("PA");
+        const int majorColumn = catalog_text_parser.ColumnIndex("Mj");
+        const int minorColumn = catalog_text_parser.ColumnIndex("Mn");
+        const int fluxColumn  = catalog_text_parser.ColumnIndex("Flux");
+
+        while (catalog_text_parser.NextRow())
         {
-            row_content = catalog_text_parser.ReadNextRow();
-
             CatalogEntryData catalog_entry;
 
-            dms read_ra(row_content["RA"].toString(), false);
-            dms read_dec(row_content["Dc"].toString(), true);
-            //qDebug()<<row_content["Nm"].toString();
+            dms read_ra(catalog_text_parser.StringField(raColumn), false);
+            dms read_dec(catalog_text_parser.StringField(decColumn), true);
             catalog_entry.catalog_name   = catalog_name;
-            catalog_entry.ID             = row_content["ID"].toInt();
-            catalog_entry.long_name      = row_content["Nm"].toString();
+            catalog_entry.ID             = catalog_text_parser.IntField(idColumn);
+            catalog_entry.long_name      = catalog_text_parser.StringField(nameColumn);
             catalog_entry.ra             = read_ra.Degrees();
             catalog_entry.dec            = read_dec.Degrees();
-            catalog_entry.type           = row_content["Tp"].toInt();
-            catalog_entry.magnitude      = row_content["Mg"].toFloat();
-            catalog_entry.position_angle = row_content["PA"].toFloat();
-            catalog_entry.major_axis     = row_content["Mj"].toFloat();
-            catalog_entry.minor_axis     = row_content["Mn"].toFloat();
-            catalog_entry.flux           = row_content["Flux"].toFloat();
+            catalog_entry.type           = catalog_text_parser.IntField(typeColumn);
+            catalog_entry.magnitude      = catalog_text_parser.FloatField(magColumn);
+            catalog_entry.position_angle = catalog_text_parser.FloatField(paColumn);
+            catalog_entry.major_axis     = catalog_text_parser.FloatField(majorColumn);
+            catalog_entry.minor_axis     = catalog_text_parser.FloatField(minorColumn);
+            catalog_entry.flux           = catalog_text_parser.FloatField(fluxColumn);
 
             _AddEntry(catalog_entry, catid);
         }
@@ -19,6 +19,20 @@
 
 #include <QDebug>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+// Fields are UTF-8, whose multi-byte sequences must not be taken for Latin-1 spaces like 0x85 or 0xA0
+inline bool isAsciiSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+}
+
 const int KSParser::EBROKEN_INT         = 0;
 const double KSParser::EBROKEN_DOUBLE   = 0.0;
 const float KSParser::EBROKEN_FLOAT     = 0.0;
@@ -237,6 +251,337 @@ QHash<QString, QVariant> KSParser::DummyRow()
     return newRow;
 }
 
+int KSParser::ColumnIndex(const QString &name) const
+{
+    for (int i = 0; i < name_type_sequence_.length(); i++)
+    {
+        if (name_type_sequence_[i].first == name)
+            return i;
+    }
+    return -1;
+}
+
+bool KSParser::OpenStream()
+{
+    stream_opened_ = true;
+
+    if (readFunctionPtr == &KSParser::DummyRow)
+        return false;
+
+    if (readFunctionPtr == &KSParser::ReadFixedWidthRow && name_type_sequence_.length() != (width_sequence_.length() + 1))
+    {
+        qWarning() << "Unequal fields and widths! Not reading " << filename_;
+        return false;
+    }
+
+    stream_file_.setFileName(filename_);
+    if (!stream_file_.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Unable to open file: " << filename_;
+        return false;
+    }
+
+    stream_size_ = stream_file_.size();
+    if (stream_size_ > 0)
+    {
+        stream_data_ = reinterpret_cast<const char *>(stream_file_.map(0, stream_size_));
+        if (stream_data_ == nullptr)
+        {
+            // Not a regular file, e.g. a resource
+            stream_buffer_ = stream_file_.readAll();
+            stream_data_   = stream_buffer_.constData();
+            stream_size_   = stream_buffer_.size();
+        }
+    }
+
+    fields_.resize(name_type_sequence_.length());
+    return true;
+}
+
+bool KSParser::NextRow()
+{
+    if (!stream_opened_ && !OpenStream())
+        return false;
+
+    while (stream_pos_ < stream_size_)
+    {
+        qint64 start = stream_pos_;
+        const char *eol =
+            static_cast<const char *>(memchr(stream_data_ + start, '\n', static_cast<size_t>(stream_size_ - start)));
+        qint64 end  = eol ? (eol - stream_data_) : stream_size_;
+        stream_pos_ = end + 1;
+        stream_line_++;
+
+        // Same line endings as QTextStream::readLine()
+        if (end > start && stream_data_[end - 1] == '\r')
+            end--;
+        // Skip the byte order mark
+        if (start == 0 && end >= 3 && memcmp(stream_data_, "\xEF\xBB\xBF", 3) == 0)
+            start = 3;
+
+        if (end > start && stream_data_[start] == comment_char_)
+            continue;
+
+        bool const valid = (readFunctionPtr == &KSParser::ReadFixedWidthRow) ? SplitFixedWidthLine(start, end) :
+                                                                               SplitCSVLine(start, end);
+        if (valid)
+        {
+            file_reader_.setLineNumber(stream_line_);
+            return true;
+        }
+    }
+
+    file_reader_.setLineNumber(stream_line_);
+    return false;
+}
+
+bool KSParser::SplitFixedWidthLine(qint64 start, qint64 end)
+{
+    int total_min_length = 0;
+    for (int width : width_sequence_)
+        total_min_length += width;
+    if (end - start < total_min_length)
+        return false;
+
+    qint64 position = start;
+    for (int i = 0; i < fields_.size(); i++)
+    {
+        // Last field runs to the end of the line
+        qint64 field_start = position;
+        qint64 field_end   = (i < width_sequence_.length()) ? position + width_sequence_[i] : end;
+        position        = field_end;
+
+        while (field_start < field_end && isAsciiSpace(stream_data_[field_start]))
+            field_start++;
+        while (field_end > field_start && isAsciiSpace(stream_data_[field_end - 1]))
+            field_end--;
+
+        fields_[i].start  = field_start;
+        fields_[i].length = static_cast<int>(field_end - field_start);
+    }
+
+    return true;
+}
+
+bool KSParser::SplitCSVLine(qint64 start, qint64 end)
+{
+    int count       = 0;
+    qint64 position = start;
+    bool more       = true;
+
+    // Same splitting as ReadCSVRow(): a field starting with a quote runs until a quote followed by the delimiter
+    while (more)
+    {
+        qint64 field_start = position, field_end;
+
+        if (position < end && stream_data_[position] == '"')
+        {
+            field_start = position + 1;
+            field_end   = field_start;
+            while (field_end < end &&
+                   !(stream_data_[field_end] == '"' && (field_end + 1 == end || stream_data_[field_end + 1] == delimiter_)))
+                field_end++;
+
+            // An unmatched quote at the end of the line is not part of the field
+            position = (field_end < end) ? field_end + 1 : end;
+            // A lone quote is an empty field
+            if (field_start == end || stream_data_[field_start] == delimiter_)
+            {
+                field_end = position = field_start;
+            }
+        }
+        else
+        {
+            field_end = position;
+            while (field_end < end && stream_data_[field_end] != delimiter_)
+                field_end++;
+            position = field_end;
+        }
+
+        if (count < fields_.size())
+        {
+            fields_[count].start  = field_start;
+            fields_[count].length = static_cast<int>(field_end - field_start);
+        }
+        count++;
+
+        more = (position < end);
+        position++;
+    }
+
+    // A single field means there is no delimiter. Incomplete rows are skipped.
+    return count > 1 && count == fields_.size();
+}
+
+QString KSParser::StringField(int column) const
+{
+    if (column < 0 || column >= fields_.size())
+        return QString();
+
+    return QString::fromUtf8(stream_data_ + fields_[column].start, fields_[column].length);
+}
+
+bool KSParser::FieldEquals(int column, const char *text) const
+{
+    if (column < 0 || column >= fields_.size())
+        return false;
+
+    size_t const length = strlen(text);
+    return static_cast<size_t>(fields_[column].length) == length &&
+           memcmp(stream_data_ + fields_[column].start, text, length) == 0;
+}
+
+bool KSParser::IsEmptyField(int column) const
+{
+    return column < 0 || column >= fields_.size() || fields_[column].length == 0;
+}
+
+int KSParser::IntField(int column, bool *ok) const
+{
+    int value     = EBROKEN_INT;
+    bool const ok_ = column >= 0 && column < fields_.size() &&
+                    ParseInt(stream_data_ + fields_[column].start, fields_[column].length, value);
+    if (ok)
+        *ok = ok_;
+    return ok_ ? value : EBROKEN_INT;
+}
+
+double KSParser::DoubleField(int column, bool *ok) const
+{
+    double value   = EBROKEN_DOUBLE;
+    bool const ok_ = column >= 0 && column < fields_.size() &&
+                     ParseDouble(stream_data_ + fields_[column].start, fields_[column].length, value);
+    if (ok)
+        *ok = ok_;
+    return ok_ ? value : EBROKEN_DOUBLE;
+}
+
+float KSParser::FloatField(int column, bool *ok) const
+{
+    bool ok_;
+    double const value = DoubleField(column, &ok_);
+
+    // Like QString::toFloat(), fail on overflow
+    if (ok_ && std::fabs(value) > std::numeric_limits<float>::max() && !std::isinf(value))
+        ok_ = false;
+    if (ok)
+        *ok = ok_;
+    return ok_ ? static_cast<float>(value) : EBROKEN_FLOAT;
+}
+
+bool KSParser::ParseInt(const char *text, int length, int &value)
+{
+    const char *p = text, *end = text + length;
+
+    while (p < end && isAsciiSpace(*p))
+        p++;
+    while (end > p && isAsciiSpace(end[-1]))
+        end--;
+
+    bool const negative = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+'))
+        p++;
+    if (p == end)
+        return false;
+
+    qint64 result = 0;
+    for (; p < end; p++)
+    {
+        if (*p < '0' || *p > '9')
+            return false;
+        result = result * 10 + (*p - '0');
+        if (result > static_cast<qint64>(std::numeric_limits<int>::max()) + 1)
+            return false;
+    }
+
+    if (negative)
+        result = -result;
+    if (result > std::numeric_limits<int>::max())
+        return false;
+
+    value = static_cast<int>(result);
+    return true;
+}
+
+bool KSParser::ParseDouble(const char *text, int length, double &value)
+{
+    // Powers of ten that are exact in double precision
+    static const double powers[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    const char *p = text, *end = text + length;
+
+    while (p < end && isAsciiSpace(*p))
+        p++;
+    while (end > p && isAsciiSpace(end[-1]))
+        end--;
+
+    const char *const trimmed = p;
+    bool const negative       = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+'))
+        p++;
+
+    quint64 mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool any_digit = false, exact = true;
+
+    for (; p < end && *p >= '0' && *p <= '9'; p++, any_digit = true)
+    {
+        if (mantissa == 0 && *p == '0')
+            continue;
+        if (++digits > 19)
+            exact = false;
+        mantissa = mantissa * 10 + (*p - '0');
+    }
+    if (p < end && *p == '.')
+    {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, any_digit = true)
+        {
+            if (mantissa == 0 && *p == '0')
+            {
+                exponent--;
+                continue;
+            }
+            if (++digits > 19)
+                exact = false;
+            mantissa = mantissa * 10 + (*p - '0');
+            exponent--;
+        }
+    }
+    if (any_digit && p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *q = p + 1;
+        bool const negative_exponent = (q < end && *q == '-');
+        if (q < end && (*q == '-' || *q == '+'))
+            q++;
+        if (q == end)
+            exact = false;
+
+        int e = 0;
+        for (; q < end && *q >= '0' && *q <= '9'; q++)
+            e = std::min(e * 10 + (*q - '0'), 10000);
+        exponent += negative_exponent ? -e : e;
+        p = q;
+    }
+
+    if (!any_digit || p != end)
+        exact = false;
+
+    // Exact operands give a correctly rounded result, otherwise leave it to Qt, e.g. for "inf" or long mantissas
+    if (exact && (mantissa == 0 || (mantissa < (Q_UINT64_C(1) << 53) && exponent >= -22 && exponent <= 22)))
+    {
+        double const m = static_cast<double>(mantissa);
+        value          = (exponent < 0) ? m / powers[-exponent] : m * powers[exponent];
+        if (negative)
+            value = -value;
+        return true;
+    }
+
+    bool ok;
+    value = QString::fromLatin1(trimmed, static_cast<int>(end - trimmed)).toDouble(&ok);
+    return ok;
+}
+
 bool KSParser::HasNextRow()
 {
     return file_reader_.hasMoreLines();
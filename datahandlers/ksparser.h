@@ -17,9 +17,12 @@
 
 #pragma once
 
+#include <QByteArray>
+#include <QFile>
 #include <QHash>
 #include <QList>
 #include <QVariant>
+#include <QVector>
 
 #include "ksfilereader.h"
 
@@ -43,6 +46,21 @@
  * In case of failure, the parser returns a Dummy Row. So if you see the
  * string "Null" in the returned QHash, it signifies the parserencountered an
  * unexpected error.
+ *
+ * Streaming mode:
+ * For large files, rows can instead be read without building a QHash and
+ * QVariants for each of them. The file is memory-mapped, and fields are
+ * located and converted in place, without any heap allocation per row.
+ * 1) initialize KSParser, then resolve the columns once:
+ *      int ra = KSParserObject.ColumnIndex("RA");
+ * 2) while (KSParserObject.NextRow()) {
+ *      double value = KSParserObject.DoubleField(ra);
+ *      ...
+ *    }
+ * Rows are validated as in ReadNextRow(), but invalid rows are skipped and
+ * no Dummy Row is returned: NextRow() returns false at the end of the file.
+ * Fixed widths are counted in bytes, which is the same as characters for
+ * ASCII data. Do not mix streaming mode and ReadNextRow() on one parser.
  **/
 class KSParser
 {
@@ -138,6 +156,51 @@ class KSParser
     // Too many warnings when const: datahandlers/ksparser.h:131:27: warning:
     // type qualifiers ignored on function return type [-Wignored-qualifiers]
 
+    /**
+     * @brief Streaming mode: Index of a column of the sequence
+     *
+     * @param name field name, as given in the sequence
+     * @return index to pass to the field accessors, -1 if there is no such column
+     **/
+    int ColumnIndex(const QString &name) const;
+
+    /**
+     * @brief Streaming mode: Moves to the next valid row of the file
+     *
+     * @return false if there are no more valid rows or the file can not be read
+     **/
+    bool NextRow();
+
+    /**
+     * @brief Streaming mode: Field of the current row as a string.
+     * Fixed width fields are trimmed, CSV fields are returned as is, like in ReadNextRow().
+     *
+     * @return the field, empty if column is -1
+     **/
+    QString StringField(int column) const;
+
+    /**
+     * @brief Streaming mode: Compares a field of the current row to a string, without conversion
+     *
+     * @param text Latin-1 text to compare with
+     * @return bool
+     **/
+    bool FieldEquals(int column, const char *text) const;
+
+    /**
+     * @return true if the field of the current row is empty, or if column is -1
+     **/
+    bool IsEmptyField(int column) const;
+
+    /**
+     * @brief Streaming mode: Numeric fields of the current row.
+     * Fields are trimmed before conversion. On failure, EBROKEN_INT, EBROKEN_FLOAT or
+     * EBROKEN_DOUBLE is returned and ok, if given, is set to false.
+     **/
+    int IntField(int column, bool *ok = nullptr) const;
+    float FloatField(int column, bool *ok = nullptr) const;
+    double DoubleField(int column, bool *ok = nullptr) const;
+
     /**
      * @brief Wrapper function for KSFileReader setProgress
      *
@@ -208,6 +271,27 @@ class KSParser
      **/
     QVariant ConvertToQVariant(const QString &input_string, const DataTypes &data_type, bool &ok);
 
+    /**
+     * @brief Maps the file for streaming mode. Falls back to reading it in memory.
+     *
+     * @return bool
+     **/
+    bool OpenStream();
+
+    /**
+     * @brief Locates the fields of a line in streaming mode
+     *
+     * @return false if the line is not a valid row
+     **/
+    bool SplitFixedWidthLine(qint64 start, qint64 end);
+    bool SplitCSVLine(qint64 start, qint64 end);
+
+    /**
+     * @brief Converts text to numbers as QString does, in the C locale
+     **/
+    static bool ParseInt(const char *text, int length, int &value);
+    static bool ParseDouble(const char *text, int length, double &value);
+
     static const bool parser_debug_mode_;
 
     KSFileReader file_reader_;
@@ -217,4 +301,21 @@ class KSParser
     QList<QPair<QString, DataTypes>> name_type_sequence_;
     QList<int> width_sequence_;
     char delimiter_ { 0 };
+
+    /** Streaming mode: file contents, mapped or read into stream_buffer_ */
+    QFile stream_file_;
+    QByteArray stream_buffer_;
+    const char *stream_data_ { nullptr };
+    qint64 stream_size_ { 0 };
+    qint64 stream_pos_ { 0 };
+    int stream_line_ { 0 };
+    bool stream_opened_ { false };
+
+    /** Streaming mode: location of each field of the current row in stream_data_ */
+    struct FieldRange
+    {
+        qint64 start;
+        int length;
+    };
+    QVector<FieldRange> fields_;
 };
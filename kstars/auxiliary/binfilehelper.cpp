@@ -23,6 +23,8 @@
 
 #include <QStandardPaths>
 
+#include <cstring>
+
 class BinFileHelper;
 
 BinFileHelper::BinFileHelper()
@@ -40,6 +42,7 @@ BinFileHelper::~BinFileHelper()
 
 void BinFileHelper::init()
 {
+    unmapFile();
     if (fileHandle)
         fclose(fileHandle);
 
@@ -95,9 +98,71 @@ FILE *BinFileHelper::openFile(const QString &fileName)
         errnum = ERR_FILEOPEN;
         return nullptr;
     }
+    filePath = FilePath;
     return fileHandle;
 }
 
+bool BinFileHelper::mapFile()
+{
+    if (mappedData)
+        return true;
+
+    if (!fileHandle)
+        return false;
+
+    mappedFile.setFileName(filePath);
+    if (!mappedFile.open(QIODevice::ReadOnly))
+        return false;
+
+    mappedSize = mappedFile.size();
+    mappedData = (mappedSize > 0) ? mappedFile.map(0, mappedSize) : nullptr;
+    if (!mappedData)
+    {
+        mappedFile.close();
+        mappedSize = 0;
+        return false;
+    }
+
+    return true;
+}
+
+void BinFileHelper::unmapFile()
+{
+    if (mappedData)
+        mappedFile.unmap(mappedData);
+    if (mappedFile.isOpen())
+        mappedFile.close();
+
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
+const uchar *BinFileHelper::mappedRange(quint32 offset, quint64 size) const
+{
+    if (!mappedData || quint64(offset) + size > quint64(mappedSize))
+        return nullptr;
+
+    return mappedData + offset;
+}
+
+bool BinFileHelper::copyRecords(char *dest, quint32 offset, quint64 size)
+{
+    if (size == 0)
+        return true;
+
+    const uchar *data = mappedRange(offset, size);
+    if (data)
+    {
+        memcpy(dest, data, size);
+        return true;
+    }
+
+    if (!fileHandle || unsigned_KDE_fseek(fileHandle, offset, SEEK_SET))
+        return false;
+
+    return fread(dest, size, 1, fileHandle) == 1;
+}
+
 enum BinFileHelper::Errors BinFileHelper::__readHeader()
 {
     qint16 endian_id, i;
@@ -287,6 +352,7 @@ bool BinFileHelper::readHeader()
 
 void BinFileHelper::closeFile()
 {
+    unmapFile();
     fclose(fileHandle);
     fileHandle = nullptr;
 }
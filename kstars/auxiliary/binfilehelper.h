@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <QFile>
 #include <QString>
 #include <QVector>
 
@@ -42,7 +43,9 @@ typedef struct dataElement
  * This class provides utility functions to handle binary data files in the format prescribed
  * by KStars. The file format is designed specifically to support data that has the form of an
  * array of structures. See data/README.fileformat for details.
- * The methods use primitive C file I/O routines defined in stdio.h to obtain efficiency
+ * The methods use primitive C file I/O routines defined in stdio.h to obtain efficiency.
+ * Optionally, the file can be memory-mapped with mapFile(), in which case readRecords()
+ * serves whole ranges of records straight out of the mapping.
  * @short Implements an interface to handle binary data files used by KStars
  * @author Akarsh Simha
  * @version 1.0
@@ -81,6 +84,44 @@ class BinFileHelper
      */
     void closeFile();
 
+    /**
+     * @short  Map the currently open file into memory
+     *
+     * Once the file is mapped, readRecords() does not need any fseek / fread calls. If the
+     * mapping fails (eg. on platforms or file systems that do not support it), readRecords()
+     * falls back to the stdio file handle.
+     * @return true if the file is mapped, false otherwise
+     */
+    bool mapFile();
+
+    /**
+     * @short  Release the memory mapping of the file, if any
+     */
+    void unmapFile();
+
+    /**
+     * @return true if the file is currently memory-mapped
+     */
+    inline bool isMapped() const { return mappedData != nullptr; }
+
+    /**
+     * @short  Read a contiguous range of records in one go
+     *
+     * If the file is memory-mapped, no byte swapping is required and the records are suitably
+     * aligned, the returned pointer points straight into the mapping and @p buffer is not touched.
+     * Otherwise the records are copied into @p buffer, either with a single memcpy from the mapping
+     * or with a single fseek / fread, and a pointer to the buffer data is returned.
+     *
+     * @note   If getByteSwap() is true, the records always end up in @p buffer, so that the caller
+     *         can swap them in bulk.
+     * @param  offset Offset of the first record in the file, in bytes
+     * @param  count  Number of records to read
+     * @param  buffer Scratch buffer used when the records cannot be used in place
+     * @return Pointer to the first of the @p count records, or nullptr if the range could not be read
+     */
+    template <typename T>
+    const T *readRecords(quint32 offset, quint32 count, QVector<T> &buffer);
+
     /**
      * @short   Get error number
      * @return  A number corresponding to the error
@@ -229,6 +270,18 @@ class BinFileHelper
      */
     enum Errors __readHeader();
 
+    /**
+     * @short  Returns a pointer to @p size bytes of the mapping, starting at @p offset
+     * @return The pointer, or nullptr if the file is not mapped or the range is out of bounds
+     */
+    const uchar *mappedRange(quint32 offset, quint64 size) const;
+
+    /**
+     * @short  Copies @p size bytes starting at @p offset in the file into @p dest
+     * @return true on success, false on a bad seek or a short read
+     */
+    bool copyRecords(char *dest, quint32 offset, quint64 size);
+
     /**
      * @short  Helper function that clears all field entries in the QVector fields
      */
@@ -241,6 +294,14 @@ class BinFileHelper
 
     /// Handle to the file.
     FILE *fileHandle { nullptr};
+    /// Full path of the currently open file
+    QString filePath;
+    /// File object backing the memory mapping
+    QFile mappedFile;
+    /// Start of the memory-mapped file, nullptr if the file is not mapped
+    uchar *mappedData { nullptr };
+    /// Size of the memory mapping in bytes
+    qint64 mappedSize { 0 };
     /// Stores offsets corresponding to each index table entry
     QVector<unsigned long> indexOffset;
     /// Stores number of records under each index table entry
@@ -278,3 +339,19 @@ class BinFileHelper
     /// Stores the version number of the file
     quint8 versionNumber { 0 };
 };
+
+template <typename T>
+const T *BinFileHelper::readRecords(quint32 offset, quint32 count, QVector<T> &buffer)
+{
+    const quint64 size = quint64(count) * sizeof(T);
+    const uchar *data  = mappedRange(offset, size);
+
+    if (data && !byteswap && reinterpret_cast<quintptr>(data) % alignof(T) == 0)
+        return reinterpret_cast<const T *>(data);
+
+    buffer.resize(count);
+    if (!copyRecords(reinterpret_cast<char *>(buffer.data()), offset, size))
+        return nullptr;
+
+    return buffer.constData();
+}
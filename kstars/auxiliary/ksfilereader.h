@@ -122,6 +122,9 @@ class KSFileReader : public QObject, public QTextStream
     /** @short returns the current line number */
     int lineNumber() const { return m_curLine; }
 
+    /** @short sets the current line number, for callers reading the file by other means than readLine() */
+    void setLineNumber(unsigned int line) { m_curLine = line; }
+
     /**
      * @short Prepares this instance to emit progress reports on how much
      * of the file has been read (in percent).
@@ -25,6 +25,7 @@
 #include "skymap.h"
 #include "skyobjects/skyobject.h"
 #include "skyobjects/deepskyobject.h"
+#include "skycomponents/objectnameindex.h"
 #include "skycomponents/starcomponent.h"
 #include "skycomponents/syncedcatalogcomponent.h"
 #include "skycomponents/skymapcomposite.h"
@@ -303,28 +304,51 @@ void FindDialog::filterList()
     filterByType();
     initSelection();
 
-    //Select the first item in the list that begins with the filter string
-    if (!SearchText.isEmpty())
+    ObjectNameIndex *nameIndex = KStarsData::Instance()->skyComposite()->nameIndex();
+
+    //Select the best ranked item in the list that begins with the filter string
+    if (!SearchText.isEmpty() && nameIndex)
     {
-        QStringList mItems = fModel->filter(QRegExp('^' + SearchText, Qt::CaseInsensitive));
-        mItems.sort();
+        QModelIndex selectItem;
 
-        if (mItems.size())
+        // Objects of other types than the filtered ones are not in the list
+        for (const auto &match : nameIndex->findPrefix(SearchText))
         {
-            QModelIndex qmi        = fModel->index(fModel->indexOf(mItems[0]));
-            QModelIndex selectItem = sortModel->mapFromSource(qmi);
-
-            if (selectItem.isValid())
+            int const row = fModel->indexOf(match.name);
+            if (row >= 0)
             {
-                ui->SearchList->selectionModel()->select(selectItem, QItemSelectionModel::ClearAndSelect);
-                ui->SearchList->scrollTo(selectItem);
-                ui->SearchList->setCurrentIndex(selectItem);
+                selectItem = sortModel->mapFromSource(fModel->index(row));
+                if (selectItem.isValid())
+                    break;
+            }
+        }
 
-                okB->setEnabled(true);
+        // If no name contains the filter string, suggest the closest names instead
+        if (sortModel->rowCount() == 0 && ui->FilterType->currentIndex() == 0)
+        {
+            QVector<QPair<QString, const SkyObject *>> suggestions;
+            for (const auto &match : nameIndex->findFuzzy(SearchText))
+                suggestions.append(QPair<QString, const SkyObject *>(match.name, match.object));
+
+            if (!suggestions.isEmpty())
+            {
+                sortModel->setFilterFixedString(QString());
+                fModel->setSkyObjectsList(suggestions);
+                selectItem = sortModel->mapFromSource(fModel->index(0));
             }
         }
-        ui->InternetSearchButton->setEnabled(!mItems.contains(
-                SearchText)); // Disable searching the internet when an exact match for SearchText exists in KStars
+
+        if (selectItem.isValid())
+        {
+            ui->SearchList->selectionModel()->select(selectItem, QItemSelectionModel::ClearAndSelect);
+            ui->SearchList->scrollTo(selectItem);
+            ui->SearchList->setCurrentIndex(selectItem);
+
+            okB->setEnabled(true);
+        }
+
+        // Disable searching the internet when an exact match for SearchText exists in KStars
+        ui->InternetSearchButton->setEnabled(nameIndex->find(SearchText) == nullptr);
     }
     else
         ui->InternetSearchButton->setEnabled(false);
@@ -299,6 +299,8 @@ void DarkLibrary::subtract(FITSData *darkData, FITSView *lightImage, FITSScale f
         darkBuffer += darkW;
     }
 
+    lightData->imageBufferChanged();
+
 #if 0
     int lightOffset = 0;
     for (int i = 0; i < lightH; i++)
@@ -98,11 +98,6 @@ cgmath::~cgmath()
 {
     delete[] drift[GUIDE_RA];
     delete[] drift[GUIDE_DEC];
-
-    foreach (float *region, referenceRegions)
-        delete[] region;
-
-    referenceRegions.clear();
 }
 
 bool cgmath::setVideoParameters(int vid_wd, int vid_ht, int binX, int binY)
@@ -528,12 +523,21 @@ void cgmath::start(void)
     // Create reference Image
     if (imageGuideEnabled)
     {
-        foreach (float *region, referenceRegions)
-            delete[] region;
+        referenceCorrelators.clear();
 
-        referenceRegions.clear();
+        FITSData *imageData = guideView->getImageData();
+        const float *imgFloat = imageData->getFloatImage();
 
-        referenceRegions = partitionImage();
+        // Keep the spectrum of each reference region, so that guide frames only need their own transform
+        if (imgFloat != nullptr)
+        {
+            foreach (const float *region, partitionImage(imgFloat))
+            {
+                std::unique_ptr<ImageAutoGuiding::PhaseCorrelator> correlator(new ImageAutoGuiding::PhaseCorrelator(regionAxis));
+                correlator->setReference(region, imageData->width());
+                referenceCorrelators.push_back(std::move(correlator));
+            }
+        }
 
         reticle_pos = Vector(0, 0, 0);
     }
@@ -564,145 +568,27 @@ void cgmath::setLostStar(bool is_lost)
     lost_star = is_lost;
 }
 
-float *cgmath::createFloatImage(FITSData *target) const
+QVector<const float *> cgmath::partitionImage(const float *image) const
 {
-    FITSData *imageData = target;
-    if (imageData == nullptr)
-        imageData = guideView->getImageData();
-
-    // #1 Convert to float array
-    // We only process 1st plane if it is a color image
-    uint32_t imgSize = imageData->width() * imageData->height();
-    float *imgFloat  = new float[imgSize];
-
-    if (imgFloat == nullptr)
-    {
-        qCritical() << "Not enough memory for float image array!";
-        return nullptr;
-    }
-
-    switch (imageData->property("dataType").toInt())
-    {
-        case TBYTE:
-        {
-            uint8_t *buffer = imageData->getImageBuffer();
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TSHORT:
-        {
-            int16_t *buffer = reinterpret_cast<int16_t *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TUSHORT:
-        {
-            uint16_t *buffer = reinterpret_cast<uint16_t *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TLONG:
-        {
-            int32_t *buffer = reinterpret_cast<int32_t *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TULONG:
-        {
-            uint32_t *buffer = reinterpret_cast<uint32_t *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TFLOAT:
-        {
-            float *buffer = reinterpret_cast<float *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TLONGLONG:
-        {
-            int64_t *buffer = reinterpret_cast<int64_t *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TDOUBLE:
-        {
-            double *buffer = reinterpret_cast<double *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        default:
-            delete[] imgFloat;
-            return nullptr;
-    }
-
-    return imgFloat;
-}
-
-QVector<float *> cgmath::partitionImage() const
-{
-    QVector<float *> regions;
+    QVector<const float *> regions;
 
     FITSData *imageData = guideView->getImageData();
 
-    float *imgFloat = createFloatImage();
-
-    if (imgFloat == nullptr)
-        return regions;
-
     const uint16_t width  = imageData->width();
     const uint16_t height = imageData->height();
 
     uint8_t xRegions = floor(width / regionAxis);
     uint8_t yRegions = floor(height / regionAxis);
-    // Find number of regions to divide the image
-    //uint8_t regions =  xRegions * yRegions;
-
-    float *regionPtr = imgFloat;
 
     for (uint8_t i = 0; i < yRegions; i++)
     {
-        for (uint8_t j = 0; j < xRegions; j++)
-        {
-            // Allocate space for one region
-            float *oneRegion = new float[regionAxis * regionAxis];
-            // Create points to region and current location of the source image in the desired region
-            float *oneRegionPtr = oneRegion, *imgFloatPtr = regionPtr + j * regionAxis;
-
-            // copy from image to region line by line
-            for (uint32_t line = 0; line < regionAxis; line++)
-            {
-                memcpy(oneRegionPtr, imgFloatPtr, regionAxis);
-                oneRegionPtr += regionAxis;
-                imgFloatPtr += width;
-            }
+        // Regions are read in place, rows of a region are width elements apart
+        const float *regionPtr = image + i * regionAxis * width;
 
-            regions.append(oneRegion);
-        }
-
-        // Move regionPtr block by (width * regionAxis) elements
-        regionPtr += width * regionAxis;
+        for (uint8_t j = 0; j < xRegions; j++)
+            regions.append(regionPtr + j * regionAxis);
     }
 
-    // We're done with imgFloat
-    delete[] imgFloat;
-
     return regions;
 }
 
@@ -727,7 +613,11 @@ Vector cgmath::findLocalStarPosition(void) const
         QVector<Vector> shifts;
         float xsum = 0, ysum = 0;
 
-        QVector<float *> imagePartition = partitionImage();
+        const float *imgFloat = imageData->getFloatImage();
+        QVector<const float *> imagePartition;
+
+        if (imgFloat != nullptr)
+            imagePartition = partitionImage(imgFloat);
 
         if (imagePartition.isEmpty())
         {
@@ -735,22 +625,17 @@ Vector cgmath::findLocalStarPosition(void) const
             return Vector(-1, -1, -1);
         }
 
-        if (imagePartition.count() != referenceRegions.count())
+        if (imagePartition.count() != static_cast<int>(referenceCorrelators.size()))
         {
-            qWarning() << "Mismatch between reference regions #" << referenceRegions.count()
+            qWarning() << "Mismatch between reference regions #" << referenceCorrelators.size()
                        << "and image partition regions #" << imagePartition.count();
-            // Clear memory in case of mis-match
-            foreach (float *region, imagePartition)
-            {
-                delete[] region;
-            }
-
             return Vector(-1, -1, -1);
         }
 
         for (uint8_t i = 0; i < imagePartition.count(); i++)
         {
-            ImageAutoGuiding::ImageAutoGuiding1(referenceRegions[i], imagePartition[i], regionAxis, &xshift, &yshift);
+            if (!referenceCorrelators[i]->shift(imagePartition[i], &xshift, &yshift, imageData->width()))
+                xshift = yshift = 0;
             Vector shift(xshift, yshift, -1);
             qCDebug(KSTARS_EKOS_GUIDE) << "Region #" << i << ": X-Shift=" << xshift << "Y-Shift=" << yshift;
 
@@ -759,18 +644,11 @@ Vector cgmath::findLocalStarPosition(void) const
             shifts.append(shift);
         }
 
-        // Delete partitions
-        foreach (float *region, imagePartition)
-        {
-            delete[] region;
-        }
-        imagePartition.clear();
-
-        float average_x = xsum / referenceRegions.count();
-        float average_y = ysum / referenceRegions.count();
+        float average_x = xsum / shifts.count();
+        float average_y = ysum / shifts.count();
 
-        float median_x = shifts[referenceRegions.count() / 2 - 1].x;
-        float median_y = shifts[referenceRegions.count() / 2 - 1].y;
+        float median_x = shifts[shifts.count() / 2 - 1].x;
+        float median_y = shifts[shifts.count() / 2 - 1].y;
 
         qCDebug(KSTARS_EKOS_GUIDE) << "Average : X-Shift=" << average_x << "Y-Shift=" << average_y;
         qCDebug(KSTARS_EKOS_GUIDE) << "Median  : X-Shift=" << median_x << "Y-Shift=" << median_y;
@@ -820,9 +698,9 @@ Vector cgmath::findLocalStarPosition(void) const
     Vector ret;
     int i, j;
     double resx, resy, mass, threshold, pval;
-    T *psrc    = nullptr;
-    T *porigin = nullptr;
-    T *pptr;
+    const T *psrc    = nullptr;
+    const T *porigin = nullptr;
+    const T *pptr;
 
     QRect trackingBox = guideView->getTrackingBox();
 
@@ -856,7 +734,7 @@ Vector cgmath::findLocalStarPosition(void) const
         return ret;
     }
 
-    T *pdata = reinterpret_cast<T *>(imageData->getImageBuffer());
+    const T *pdata = imageData->getPixels<T>();
 
     qCDebug(KSTARS_EKOS_GUIDE) << "Tracking Square " << trackingBox;
 
@@ -877,7 +755,7 @@ Vector cgmath::findLocalStarPosition(void) const
             float i0, i1, i2, i3, i4, i5, i6, i7, i8;
             int ix = 0, iy = 0;
             int xM4;
-            T *p;
+            const T *p;
             double average, fit, bestFit = 0;
             int minx = 0;
             int maxx = width;
@@ -1583,18 +1461,18 @@ QList<Edge*> cgmath::PSFAutoFind(int extraEdgeAllowance)
     int size = subW * subH;
 
     // convert to floating point
-    float *conv = createFloatImage(smoothed);
-
-    // run the PSF convolution
+    const float *smoothedFloat = smoothed->getFloatImage();
+    if (smoothedFloat == nullptr)
     {
-        float *tmp = new float[size];
-        memset(tmp, 0, size * sizeof(float));
-        psf_conv(tmp, conv, subW, subH);
-        delete [] conv;
-        // Swap
-        conv = tmp;
+        delete (smoothed);
+        return QList<Edge *>();
     }
 
+    // run the PSF convolution, into a buffer kept between calls
+    psfBuffer.assign(size, 0);
+    psf_conv(psfBuffer.data(), smoothedFloat, subW, subH);
+    const float *conv = psfBuffer.data();
+
     enum { CONV_RADIUS = 4 };
     int dw = subW;      // width of the downsampled image
     int dh = subH;     // height of the downsampled image
@@ -1761,7 +1639,6 @@ repeat:
         centers.append(center);
     }
 
-    delete [] conv;
     delete (smoothed);
 
     return centers;
@@ -22,12 +22,19 @@
 #include <QFile>
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 #include <sys/types.h>
 
 class FITSView;
 class FITSData;
 class Edge;
 
+namespace ImageAutoGuiding
+{
+class PhaseCorrelator;
+}
+
 typedef struct
 {
     int size;
@@ -180,9 +187,6 @@ class cgmath : public QObject
     template <typename T>
     Vector findLocalStarPosition(void) const;
 
-    // Creates a new float image from the guideView image data. The returned image MUST be deleted later or memory will leak.
-    float *createFloatImage(FITSData *target=nullptr) const;
-
     void do_ticks(void);
     Vector point2arcsec(const Vector &p) const;
     void process_axes(void);
@@ -245,11 +249,15 @@ class cgmath : public QObject
 
     // Image Guide
     bool imageGuideEnabled { false };
-    // Partition guideView image into NxN square regions each of size axis*axis. The returned vector contains pointers to
-    // the newly allocated square images. It MUST be deleted later by delete[] or memory will leak.
-    QVector<float *> partitionImage() const;
+    // Partition the float view of the guideView image into NxN square regions each of size axis*axis. The returned vector
+    // contains pointers to the top left corner of each region within image, rows of a region being image width apart.
+    QVector<const float *> partitionImage(const float *image) const;
     uint32_t regionAxis { 64 };
-    QVector<float *> referenceRegions;
+    // One phase correlator per region, holding the spectrum of the reference region
+    std::vector<std::unique_ptr<ImageAutoGuiding::PhaseCorrelator>> referenceCorrelators;
+
+    // PSF convolution of the image, kept between PSFAutoFind() calls
+    std::vector<float> psfBuffer;
 
     // dithering
     double ditherRate[2];
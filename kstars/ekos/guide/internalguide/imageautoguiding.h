@@ -9,6 +9,9 @@
 
 #pragma once
 
+#include <complex>
+#include <vector>
+
 // Robert Majewski
 
 // ImageAutoGuiding1 is self contained
@@ -25,4 +28,82 @@
 namespace ImageAutoGuiding
 {
 void ImageAutoGuiding1(float *ref, float *im, int n, float *xshift, float *yshift);
+
+/**
+ * @class PhaseCorrelator
+ * @short Persistent phase correlation engine for one guide region.
+ *
+ * The shift between a test image and the reference image is estimated from the slope of the phase of their
+ * cross spectrum, fitted over the low spatial frequencies only. The reference spectrum and the fit weights
+ * derived from it are computed once by setReference(), so that each guide frame only costs the transform of
+ * the test image. All buffers, bit-reversal and twiddle tables are allocated by the constructor.
+ *
+ * Only the low frequencies are needed, so the 2D transform is pruned: each row is transformed with a real FFT
+ * of half size, and only the few columns holding low frequencies are then transformed.
+ */
+class PhaseCorrelator
+{
+    public:
+        /** @param n region size, which MUST be a power of 2 */
+        explicit PhaseCorrelator(int n);
+
+        int size() const { return m_N; }
+
+        /**
+         * @brief setReference Compute and keep the spectrum of the reference image.
+         * @param ref n x n reference image
+         * @param stride distance between the rows of ref, in elements, n if 0
+         */
+        void setReference(const float *ref, int stride = 0);
+
+        bool hasReference() const { return m_HasReference; }
+
+        /**
+         * @brief shift Estimate the sub-pixel shift of a test image relative to the reference image.
+         * @param im n x n test image
+         * @param xshift shift along the first axis
+         * @param yshift shift along the second axis
+         * @param stride distance between the rows of im, in elements, n if 0
+         * @return false if there is no reference image or no low frequency power in it.
+         */
+        bool shift(const float *im, float *xshift, float *yshift, int stride = 0);
+
+    private:
+        typedef std::complex<float> Complex;
+
+        /// Low frequency bin used by the fit
+        struct Bin
+        {
+            /// Index of the row frequency, and of the column frequency
+            int row, column;
+            /// Spatial frequencies, in cycles per pixel
+            double fx, fy;
+        };
+
+        /// Computes the low frequency bins of the spectrum of an image
+        void transform(const float *image, int stride, std::vector<Complex> &spectrum);
+        /// In-place radix-2 transform of m complex values, m being n or n/2
+        void fft(Complex *data, int m, const std::vector<int> &reverse) const;
+
+        int m_N { 0 };
+        /// Number of low frequency columns to transform
+        int m_Columns { 0 };
+        std::vector<Bin> m_Bins;
+
+        /// exp(2i.pi.k/n), k in [0, n/2[
+        std::vector<Complex> m_Twiddles;
+        /// Bit reversal permutations for transforms of size n/2 and n
+        std::vector<int> m_HalfReverse, m_FullReverse;
+
+        /// Row transforms, m_Columns values per row
+        std::vector<Complex> m_Rows;
+        std::vector<Complex> m_Scratch;
+        std::vector<Complex> m_Test;
+
+        bool m_HasReference { false };
+        std::vector<Complex> m_Reference;
+        /// Power of the reference at each bin, and fit terms that only depend on the reference
+        std::vector<double> m_Power;
+        double m_Fx2Sum { 0 }, m_Fy2Sum { 0 }, m_FxFySum { 0 };
+};
 }
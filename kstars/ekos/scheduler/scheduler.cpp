@@ -20,6 +20,7 @@
 #include "mosaic.h"
 #include "Options.h"
 #include "scheduleradaptor.h"
+#include "schedulerephemeris.h"
 #include "schedulerjob.h"
 #include "skymapcomposite.h"
 #include "auxiliary/QProgressIndicator.h"
@@ -31,7 +32,10 @@
 #include <KNotifications/KNotification>
 #include <KConfigDialog>
 
+#include <QtConcurrent>
+
 #include <fitsio.h>
+#include <functional>
 #include <ekos_scheduler_debug.h>
 
 #define BAD_SCORE                -1000
@@ -1527,9 +1531,6 @@ void Scheduler::evaluateJobs()
     if (jobs.isEmpty())
         return;
 
-    /* FIXME: it is possible to evaluate jobs while KStars has a time offset, so warn the user about this */
-    QDateTime const now = KStarsData::Instance()->lt();
-
     /* Start by refreshing the number of captures already present - unneeded if not remembering job progress */
     if (Options::rememberJobProgress())
         updateCompletedJobsCount();
@@ -1537,11 +1538,17 @@ void Scheduler::evaluateJobs()
     /* Update dawn and dusk astronomical times - unconditionally in case date changed */
     calculateDawnDusk();
 
+    /* From now on, jobs are evaluated against that state, so that they may be evaluated concurrently */
+    /* FIXME: it is possible to evaluate jobs while KStars has a time offset, so warn the user about this */
+    EvaluationSnapshot const snapshot = takeEvaluationSnapshot();
+    QDateTime const now = snapshot.now;
+
     /* First, filter out non-schedulable jobs */
     /* FIXME: jobs in state JOB_ERROR should not be in the list, reorder states */
     QList<SchedulerJob *> sortedJobs = jobs;
 
     /* Then enumerate SchedulerJobs to consolidate imaging time */
+    QList<SchedulerJob *> estimatedJobs;
     foreach (SchedulerJob *job, sortedJobs)
     {
         /* Let aborted jobs be rescheduled later instead of forgetting them */
@@ -1608,17 +1615,38 @@ void Scheduler::evaluateJobs()
                 break;
         }
 
-        // -1 = Job is not estimated yet
-        // -2 = Job is estimated but time is unknown
-        // > 0  Job is estimated and time is known
+        estimatedJobs.append(job);
+    }
+
+    /* Estimate jobs that require it concurrently - loading their sequences is the costly part */
+    // -1 = Job is not estimated yet
+    // -2 = Job is estimated but time is unknown
+    // > 0  Job is estimated and time is known
+    QVector<JobEstimate> estimates;
+    foreach (SchedulerJob *job, estimatedJobs)
+    {
         if (job->getEstimatedTime() == -1)
         {
-            if (estimateJobTime(job) == false)
-            {
-                job->setState(SchedulerJob::JOB_INVALID);
-                continue;
-            }
+            JobEstimate estimate;
+            estimate.job = job;
+            estimates.append(estimate);
         }
+    }
+
+    std::function<void(JobEstimate &)> estimateFunction = [&snapshot](JobEstimate &estimate)
+    {
+        estimateJob(snapshot, estimate);
+    };
+    QtConcurrent::blockingMap(estimates, estimateFunction);
+
+    for (JobEstimate const &estimate : estimates)
+        if (applyJobEstimate(snapshot, estimate) == false)
+            estimate.job->setState(SchedulerJob::JOB_INVALID);
+
+    foreach (SchedulerJob *job, estimatedJobs)
+    {
+        if (job->getState() == SchedulerJob::JOB_INVALID)
+            continue;
 
         if (job->getEstimatedTime() == 0)
         {
@@ -1704,16 +1732,38 @@ void Scheduler::evaluateJobs()
         }
     }
 
+    /* Compute the current altitude and score of each job concurrently, they don't depend on the schedule */
+    QVector<JobScore> scores(sortedJobs.size());
+    for (int index = 0; index < sortedJobs.size(); index++)
+        scores[index].job = sortedJobs.at(index);
+
+    std::function<void(JobScore &)> scoreFunction = [&snapshot](JobScore &score)
+    {
+        score.altitude = SchedulerJob::findAltitude(score.job->getTargetCoords(), snapshot.now, &score.isSetting);
+        if (SchedulerJob::JOB_EVALUATION == score.job->getState())
+            score.score = calculateJobScore(score.job, snapshot.dawn, snapshot.dusk, snapshot.now);
+    };
+    QtConcurrent::blockingMap(scores, scoreFunction);
+
+    QHash<SchedulerJob const *, int16_t> jobScores;
+    for (JobScore const &score : scores)
+        jobScores.insert(score.job, score.score);
+
     /* If option says so, reorder by altitude and priority before sequencing */
     /* FIXME: refactor so all sorts are using the same predicates */
-    /* FIXME: use std::stable_sort as qStableSort is deprecated */
     /* FIXME: dissociate altitude and priority, it's difficult to choose which predicate to use first */
     qCInfo(KSTARS_EKOS_SCHEDULER) << "Option to sort jobs based on priority and altitude is" << Options::sortSchedulerJobs();
     if (Options::sortSchedulerJobs())
     {
-        using namespace std::placeholders;
-        std::stable_sort(sortedJobs.begin(), sortedJobs.end(),
-                         std::bind(SchedulerJob::decreasingAltitudeOrder, _1, _2, KStarsData::Instance()->lt()));
+        std::stable_sort(scores.begin(), scores.end(), [](JobScore const & a, JobScore const & b)
+        {
+            return SchedulerJob::decreasingAltitudeValueOrder(a.altitude, a.isSetting, b.altitude, b.isSetting);
+        });
+
+        sortedJobs.clear();
+        for (JobScore const &score : scores)
+            sortedJobs.append(score.job);
+
         std::stable_sort(sortedJobs.begin(), sortedJobs.end(), SchedulerJob::increasingPriorityOrder);
     }
 
@@ -1870,7 +1920,7 @@ void Scheduler::evaluateJobs()
                 }
 
                 // This job is non-movable, we're done
-                currentJob->setScore(calculateJobScore(currentJob, now));
+                currentJob->setScore(jobScores.value(currentJob));
                 currentJob->setState(SchedulerJob::JOB_SCHEDULED);
                 qCDebug(KSTARS_EKOS_SCHEDULER) << QString("Job '%1' is scheduled to start at %2, in compliance with fixed startup time requirement.")
                                                .arg(currentJob->getName())
@@ -2137,7 +2187,7 @@ void Scheduler::evaluateJobs()
 
             // ----- #9 Update score for current time and mark evaluating jobs as scheduled
 
-            currentJob->setScore(calculateJobScore(currentJob, now));
+            currentJob->setScore(jobScores.value(currentJob));
             currentJob->setState(SchedulerJob::JOB_SCHEDULED);
 
             qCDebug(KSTARS_EKOS_SCHEDULER) << QString("Job '%1' on row #%2 passed all checks after %3 attempts, will proceed at %4 for approximately %5 seconds, marking scheduled")
@@ -2225,7 +2275,7 @@ void Scheduler::evaluateJobs()
     /* Check if job can be processed right now */
     SchedulerJob * const job_to_execute = *job_to_execute_iterator;
     if (job_to_execute->getFileStartupCondition() == SchedulerJob::START_ASAP)
-        if( 0 <= calculateJobScore(job_to_execute, now))
+        if( 0 <= jobScores.value(job_to_execute))
             job_to_execute->setStartupTime(now);
 
     qCDebug(KSTARS_EKOS_SCHEDULER) << QString("Job '%1' is selected for next observation with priority #%2 and score %3.")
@@ -2273,6 +2323,11 @@ int16_t Scheduler::getWeatherScore() const
 }
 
 int16_t Scheduler::getDarkSkyScore(QDateTime const &when) const
+{
+    return getDarkSkyScore(Dawn, Dusk, when.isValid() ? when : KStarsData::Instance()->lt());
+}
+
+int16_t Scheduler::getDarkSkyScore(double dawn, double dusk, QDateTime const &when)
 {
     double const secsPerDay = 24.0 * 3600.0;
     double const minsPerDay = 24.0 * 60.0;
@@ -2284,16 +2339,15 @@ int16_t Scheduler::getDarkSkyScore(QDateTime const &when) const
     // - If observation is after dusk, score is fraction of the day from dusk to beginning of observation, as percentage.
     // - If observation is between dawn and dusk, score is BAD_SCORE.
     //
-    // If observation time is invalid, the score is calculated for the current day time.
     // Note exact dusk time is considered valid in terms of night time, and will return a positive, albeit null, score.
 
     // FIXME: Dark sky score should consider the middle of the local night as best value.
     // FIXME: Current algorithm uses the dawn and dusk of today, instead of the day of the observation.
 
-    int const earlyDawnSecs = static_cast <int> ((Dawn - static_cast <double> (Options::preDawnTime()) / minsPerDay) * secsPerDay);
-    int const dawnSecs = static_cast <int> (Dawn * secsPerDay);
-    int const duskSecs = static_cast <int> (Dusk * secsPerDay);
-    int const obsSecs = (when.isValid() ? when : KStarsData::Instance()->lt()).time().msecsSinceStartOfDay() / 1000;
+    int const earlyDawnSecs = static_cast <int> ((dawn - static_cast <double> (Options::preDawnTime()) / minsPerDay) * secsPerDay);
+    int const dawnSecs = static_cast <int> (dawn * secsPerDay);
+    int const duskSecs = static_cast <int> (dusk * secsPerDay);
+    int const obsSecs = when.time().msecsSinceStartOfDay() / 1000;
 
     int16_t score = 0;
 
@@ -2334,6 +2388,11 @@ int16_t Scheduler::getDarkSkyScore(QDateTime const &when) const
 }
 
 int16_t Scheduler::calculateJobScore(SchedulerJob const *job, QDateTime const &when) const
+{
+    return calculateJobScore(job, Dawn, Dusk, when.isValid() ? when : KStarsData::Instance()->lt());
+}
+
+int16_t Scheduler::calculateJobScore(SchedulerJob const *job, double dawn, double dusk, QDateTime const &when)
 {
     if (nullptr == job)
         return BAD_SCORE;
@@ -2348,7 +2407,7 @@ int16_t Scheduler::calculateJobScore(SchedulerJob const *job, QDateTime const &w
 
     if (job->getEnforceTwilight())
     {
-        int16_t const darkSkyScore = getDarkSkyScore(when);
+        int16_t const darkSkyScore = getDarkSkyScore(dawn, dusk, when);
 
         qCDebug(KSTARS_EKOS_SCHEDULER) << QString("Job '%1' dark sky score is %2 at %3")
                                        .arg(job->getName())
@@ -2393,6 +2452,22 @@ int16_t Scheduler::calculateJobScore(SchedulerJob const *job, QDateTime const &w
     return total;
 }
 
+Scheduler::EvaluationSnapshot Scheduler::takeEvaluationSnapshot() const
+{
+    EvaluationSnapshot snapshot;
+
+    snapshot.now                 = KStarsData::Instance()->lt();
+    snapshot.dawn                = Dawn;
+    snapshot.dusk                = Dusk;
+    snapshot.rememberJobProgress = Options::rememberJobProgress();
+    snapshot.capturedFramesCount = capturedFramesCount;
+
+    // Build the ephemeris of the day here rather than in concurrent evaluations
+    SchedulerEphemeris::forTime(KStarsDateTime(snapshot.now));
+
+    return snapshot;
+}
+
 void Scheduler::calculateDawnDusk()
 {
     KSAlmanac ksal;
@@ -4810,36 +4885,80 @@ void Scheduler::updateCompletedJobsCount(bool forced)
 }
 
 bool Scheduler::estimateJobTime(SchedulerJob *schedJob)
+{
+    EvaluationSnapshot const snapshot = takeEvaluationSnapshot();
+
+    JobEstimate estimate;
+    estimate.job = schedJob;
+    estimateJob(snapshot, estimate);
+
+    return applyJobEstimate(snapshot, estimate);
+}
+
+bool Scheduler::applyJobEstimate(EvaluationSnapshot const &snapshot, JobEstimate const &estimate)
 {
     static SchedulerJob *jobWarned = nullptr;
 
-    /* updateCompletedJobsCount(); */
+    SchedulerJob * const schedJob = estimate.job;
 
-    // Load the sequence job associated with the argument scheduler job.
-    QList<SequenceJob *> seqJobs;
-    bool hasAutoFocus = false;
-    if (loadSequenceQueue(schedJob->getSequenceFile().toLocalFile(), schedJob, seqJobs, hasAutoFocus) == false)
+    if (!estimate.valid)
     {
+        appendLogText(estimate.error);
         qCWarning(KSTARS_EKOS_SCHEDULER) << QString("Warning: Failed estimating the duration of job '%1', its sequence file is invalid.").arg(schedJob->getSequenceFile().toLocalFile());
         return false;
     }
 
+    if (estimate.hasLightFrames)
+        schedJob->setLightFramesRequired(true);
+
     // FIXME: setting in-sequence focus should be done in XML processing.
-    schedJob->setInSequenceFocus(hasAutoFocus);
+    schedJob->setInSequenceFocus(estimate.hasAutoFocus);
 
     // Stop spam of log on re-evaluation. If we display the warning once, then that's it.
-    if (schedJob != jobWarned && hasAutoFocus && !(schedJob->getStepPipeline() & SchedulerJob::USE_FOCUS))
+    if (schedJob != jobWarned && estimate.hasAutoFocus && !(schedJob->getStepPipeline() & SchedulerJob::USE_FOCUS))
     {
         appendLogText(i18n("Warning: Job '%1' has its focus step disabled, periodic and/or HFR procedures currently set in its sequence will not occur.", schedJob->getName()));
         jobWarned = schedJob;
     }
 
+    if (estimate.framesCounted)
+    {
+        schedJob->setCapturedFramesMap(estimate.capturedFramesMap);
+        schedJob->setSequenceCount(estimate.sequenceCount);
+
+        // only in case we remember the job progress, we change the completion count
+        if (snapshot.rememberJobProgress)
+            schedJob->setCompletedCount(estimate.completedCount);
+    }
+
+    schedJob->setEstimatedTime(estimate.estimatedTime);
+
+    return true;
+}
+
+void Scheduler::estimateJob(EvaluationSnapshot const &snapshot, JobEstimate &estimate)
+{
+    SchedulerJob const * const schedJob = estimate.job;
+
+    // Load the sequence job associated with the argument scheduler job.
+    QList<SequenceJob *> seqJobs;
+    bool hasAutoFocus = false;
+    if (parseSequenceQueue(schedJob->getSequenceFile().toLocalFile(), schedJob, seqJobs, hasAutoFocus, estimate.error) == false)
+        return;
+
+    estimate.valid        = true;
+    estimate.hasAutoFocus = hasAutoFocus;
+    estimate.hasLightFrames = std::any_of(seqJobs.begin(), seqJobs.end(), [](SequenceJob const * seqJob)
+    {
+        return FRAME_LIGHT == seqJob->getFrameType();
+    });
+
     /* This is the map of captured frames for this scheduler job, keyed per storage signature.
      * It will be forwarded to the Capture module in order to capture only what frames are required.
      * If option "Remember Job Progress" is disabled, this map will be empty, and the Capture module will process all requested captures unconditionally.
      */
     SchedulerJob::CapturedFramesMap capture_map;
-    bool const rememberJobProgress = Options::rememberJobProgress();
+    bool const rememberJobProgress = snapshot.rememberJobProgress;
 
     int totalSequenceCount = 0, totalCompletedCount = 0;
     double totalImagingTime  = 0;
@@ -4858,9 +4977,9 @@ bool Scheduler::estimateJobTime(SchedulerJob *schedJob)
         if (seqJob->getUploadMode() == ISD::CCD::UPLOAD_LOCAL)
         {
             qCInfo(KSTARS_EKOS_SCHEDULER) << QString("%1 duration cannot be estimated time since the sequence saves the files remotely.").arg(seqName);
-            schedJob->setEstimatedTime(-2);
+            estimate.estimatedTime = -2;
             qDeleteAll(seqJobs);
-            return true;
+            return;
         }
 
         // Note that looping jobs will have zero repeats required.
@@ -4900,7 +5019,7 @@ bool Scheduler::estimateJobTime(SchedulerJob *schedJob)
             // Retrieve cached count of completed captures for the output folder of this seqJob
             QString const signature = seqJob->getSignature();
             QString const signature_path = QFileInfo(signature).path();
-            captures_completed = capturedFramesCount[signature];
+            captures_completed = snapshot.capturedFramesCount.value(signature);
 
             qCInfo(KSTARS_EKOS_SCHEDULER) << QString("%1 sees %2 captures in output folder '%3'.").arg(seqName).arg(captures_completed).arg(signature_path);
 
@@ -5009,12 +5128,10 @@ bool Scheduler::estimateJobTime(SchedulerJob *schedJob)
         }
     }
 
-    schedJob->setCapturedFramesMap(capture_map);
-    schedJob->setSequenceCount(totalSequenceCount);
-
-    // only in case we remember the job progress, we change the completion count
-    if (rememberJobProgress)
-        schedJob->setCompletedCount(totalCompletedCount);
+    estimate.framesCounted     = true;
+    estimate.capturedFramesMap = capture_map;
+    estimate.sequenceCount     = totalSequenceCount;
+    estimate.completedCount    = totalCompletedCount;
 
     qDeleteAll(seqJobs);
 
@@ -5024,7 +5141,7 @@ bool Scheduler::estimateJobTime(SchedulerJob *schedJob)
     if (schedJob->getCompletionCondition() == SchedulerJob::FINISH_LOOP)
     {
         // We can't know estimated time if it is looping indefinitely
-        schedJob->setEstimatedTime(-2);
+        estimate.estimatedTime = -2;
 
         qCDebug(KSTARS_EKOS_SCHEDULER) << QString("Job '%1' is configured to loop until Scheduler is stopped manually, has undefined imaging time.")
                                        .arg(schedJob->getName());
@@ -5035,7 +5152,7 @@ bool Scheduler::estimateJobTime(SchedulerJob *schedJob)
     {
         // FIXME: SchedulerJob is probably doing this already
         qint64 const diff = schedJob->getStartupTime().secsTo(schedJob->getCompletionTime());
-        schedJob->setEstimatedTime(diff);
+        estimate.estimatedTime = diff;
 
         qCDebug(KSTARS_EKOS_SCHEDULER) << QString("Job '%1' has a startup time and fixed completion time, will run for %2.")
                                        .arg(schedJob->getName())
@@ -5045,8 +5162,8 @@ bool Scheduler::estimateJobTime(SchedulerJob *schedJob)
     else if (schedJob->getStartupCondition() != SchedulerJob::START_AT &&
              schedJob->getCompletionCondition() == SchedulerJob::FINISH_AT)
     {
-        qint64 const diff = KStarsData::Instance()->lt().secsTo(schedJob->getCompletionTime());
-        schedJob->setEstimatedTime(diff);
+        qint64 const diff = snapshot.now.secsTo(schedJob->getCompletionTime());
+        estimate.estimatedTime = diff;
 
         qCDebug(KSTARS_EKOS_SCHEDULER) << QString("Job '%1' has no startup time but fixed completion time, will run for %2 if started now.")
                                        .arg(schedJob->getName())
@@ -5055,7 +5172,7 @@ bool Scheduler::estimateJobTime(SchedulerJob *schedJob)
     // Rely on the estimated imaging time to determine whether this job is complete or not - this makes the estimated time null
     else if (totalImagingTime <= 0)
     {
-        schedJob->setEstimatedTime(0);
+        estimate.estimatedTime = 0;
 
         qCDebug(KSTARS_EKOS_SCHEDULER) << QString("Job '%1' will not run, complete with %2/%3 captures.")
                                        .arg(schedJob->getName()).arg(totalCompletedCount).arg(totalSequenceCount);
@@ -5063,7 +5180,7 @@ bool Scheduler::estimateJobTime(SchedulerJob *schedJob)
     // Else consolidate with step durations
     else
     {
-        if (schedJob->getLightFramesRequired())
+        if (schedJob->getLightFramesRequired() || estimate.hasLightFrames)
         {
             /* FIXME: estimation should base on actual measure of each step, eventually with preliminary data as what it used now */
             // Are we doing tracking? It takes about 30 seconds
@@ -5095,12 +5212,10 @@ bool Scheduler::estimateJobTime(SchedulerJob *schedJob)
             }
         }
         dms const estimatedTime(totalImagingTime * 15.0 / 3600.0);
-        schedJob->setEstimatedTime(totalImagingTime);
+        estimate.estimatedTime = static_cast<int64_t>(totalImagingTime);
 
         qCInfo(KSTARS_EKOS_SCHEDULER) << QString("Job '%1' estimated to take %2 to complete.").arg(schedJob->getName(), estimatedTime.toHMSString());
     }
-
-    return true;
 }
 
 void Scheduler::parkMount()
@@ -6251,14 +6366,32 @@ void Scheduler::loadProfiles()
 
 bool Scheduler::loadSequenceQueue(const QString &fileURL, SchedulerJob *schedJob, QList<SequenceJob *> &jobs,
                                   bool &hasAutoFocus)
+{
+    QString error;
+    if (!parseSequenceQueue(fileURL, schedJob, jobs, hasAutoFocus, error))
+    {
+        appendLogText(error);
+        return false;
+    }
+
+    /* Mark presence of light frames for this scheduler job */
+    if (nullptr != schedJob)
+        for (SequenceJob const *job : jobs)
+            if (FRAME_LIGHT == job->getFrameType())
+                schedJob->setLightFramesRequired(true);
+
+    return true;
+}
+
+bool Scheduler::parseSequenceQueue(const QString &fileURL, SchedulerJob const *schedJob, QList<SequenceJob *> &jobs,
+                                   bool &hasAutoFocus, QString &error)
 {
     QFile sFile;
     sFile.setFileName(fileURL);
 
     if (!sFile.open(QIODevice::ReadOnly))
     {
-        QString message = i18n("Unable to open sequence queue file '%1'", fileURL);
-        KSNotification::sorry(message, i18n("Could Not Open File"));
+        error = i18n("Unable to open sequence queue file '%1'", fileURL);
         return false;
     }
 
@@ -6285,17 +6418,19 @@ bool Scheduler::loadSequenceQueue(const QString &fileURL, SchedulerJob *schedJob
         }
         else if (errmsg[0])
         {
-            appendLogText(QString(errmsg));
+            error = QString(errmsg);
             delLilXML(xmlParser);
             qDeleteAll(jobs);
+            jobs.clear();
             return false;
         }
     }
 
+    delLilXML(xmlParser);
     return true;
 }
 
-SequenceJob *Scheduler::processJobInfo(XMLEle *root, SchedulerJob *schedJob)
+SequenceJob *Scheduler::processJobInfo(XMLEle *root, SchedulerJob const *schedJob)
 {
     XMLEle *ep    = nullptr;
     XMLEle *subEP = nullptr;
@@ -6310,13 +6445,6 @@ SequenceJob *Scheduler::processJobInfo(XMLEle *root, SchedulerJob *schedJob)
     double exposure    = 0;
     bool filterEnabled = false, expEnabled = false, tsEnabled = false;
 
-    /* Reset light frame presence flag before enumerating */
-    // JM 2018-09-14: If last sequence job is not LIGHT
-    // then scheduler job light frame is set to whatever last sequence job is
-    // so if it was non-LIGHT, this value is set to false which is wrong.
-    //if (nullptr != schedJob)
-    //    schedJob->setLightFramesRequired(false);
-
     for (ep = nextXMLEle(root, 1); ep != nullptr; ep = nextXMLEle(root, 0))
     {
         if (!strcmp(tagXMLEle(ep), "Exposure"))
@@ -6332,11 +6460,8 @@ SequenceJob *Scheduler::processJobInfo(XMLEle *root, SchedulerJob *schedJob)
         {
             frameType = QString(pcdataXMLEle(ep));
 
-            /* Record frame type and mark presence of light frames for this sequence */
-            CCDFrameType const frameEnum = frameTypes[frameType];
-            job->setFrameType(frameEnum);
-            if (FRAME_LIGHT == frameEnum && nullptr != schedJob)
-                schedJob->setLightFramesRequired(true);
+            /* Record frame type, presence of light frames is marked by the caller */
+            job->setFrameType(frameTypes[frameType]);
         }
         else if (!strcmp(tagXMLEle(ep), "Prefix"))
         {
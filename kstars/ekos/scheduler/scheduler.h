@@ -485,12 +485,67 @@ class Scheduler : public QWidget, public Ui::Scheduler
         void newTarget(const QString &);
 
     private:
+        /**
+         * @brief The EvaluationSnapshot struct holds the state job evaluation depends on. It is taken on the GUI thread,
+         * so that jobs may then be evaluated concurrently without accessing the scheduler or its widgets.
+         */
+        struct EvaluationSnapshot
+        {
+            /// Local date and time of the evaluation
+            QDateTime now;
+            /// Day fractions of dawn and dusk
+            double dawn { -1 };
+            double dusk { -1 };
+            /// Whether captures already stored count towards the completion of jobs
+            bool rememberJobProgress { false };
+            /// Count of captures already stored, keyed by storage signature
+            QMap<QString, uint16_t> capturedFramesCount;
+        };
+
+        /**
+         * @brief The JobEstimate struct holds the imaging time estimation of a job, computed against a snapshot and
+         * applied to the job on the GUI thread.
+         */
+        struct JobEstimate
+        {
+            SchedulerJob *job { nullptr };
+            /// False if the sequence of the job could not be loaded, see error
+            bool valid { false };
+            QString error;
+            bool hasAutoFocus { false };
+            bool hasLightFrames { false };
+            /// False if frames could not be counted, in which case the fields below are not applied
+            bool framesCounted { false };
+            QMap<QString, uint16_t> capturedFramesMap;
+            int sequenceCount { 0 };
+            int completedCount { 0 };
+            int64_t estimatedTime { -1 };
+        };
+
+        /**
+         * @brief The JobScore struct holds the altitude and score of a job at the time of a snapshot.
+         */
+        struct JobScore
+        {
+            SchedulerJob *job { nullptr };
+            double altitude { 0 };
+            bool isSetting { false };
+            int16_t score { 0 };
+        };
+
         /**
              * @brief evaluateJobs evaluates the current state of each objects and gives each one a score based on the constraints.
              * Given that score, the scheduler will decide which is the best job that needs to be executed.
+             * Imaging time estimations and scores are computed concurrently against a snapshot of the scheduler state,
+             * then the schedule is consolidated on the GUI thread.
              */
         void evaluateJobs();
 
+        /**
+             * @brief takeEvaluationSnapshot Capture the state job evaluation depends on, and prepare the ephemeris of the day.
+             */
+        EvaluationSnapshot takeEvaluationSnapshot() const;
+
         /**
              * @brief executeJob After the best job is selected, we call this in order to start the process that will execute the job.
              * checkJobStatus slot will be connected in order to figure the exact state of the current job each second
@@ -506,6 +561,7 @@ class Scheduler : public QWidget, public Ui::Scheduler
              * @return Dark sky score. Daylight get bad score, as well as pre-dawn to dawn.
              */
         int16_t getDarkSkyScore(QDateTime const &when = QDateTime()) const;
+        static int16_t getDarkSkyScore(double dawn, double dusk, QDateTime const &when);
 
         /**
              * @brief calculateJobScore Calculate job dark sky score, altitude score, and moon separation scores and returns the sum.
@@ -514,6 +570,7 @@ class Scheduler : public QWidget, public Ui::Scheduler
              * @return Total score
              */
         int16_t calculateJobScore(SchedulerJob const *job, QDateTime const &when = QDateTime()) const;
+        static int16_t calculateJobScore(SchedulerJob const *job, double dawn, double dusk, QDateTime const &when);
 
         /**
              * @brief getWeatherScore Get current weather condition score.
@@ -643,6 +700,20 @@ class Scheduler : public QWidget, public Ui::Scheduler
              */
         bool estimateJobTime(SchedulerJob *schedJob);
 
+        /**
+             * @brief estimateJob Estimate the imaging time of a job against a snapshot. This does not modify the job nor
+             * the scheduler, and may be called from any thread.
+             * @param snapshot state of the scheduler
+             * @param estimate estimation, whose job is set by the caller
+             */
+        static void estimateJob(EvaluationSnapshot const &snapshot, JobEstimate &estimate);
+
+        /**
+             * @brief applyJobEstimate Update a job with its imaging time estimation.
+             * @return false if the job could not be estimated
+             */
+        bool applyJobEstimate(EvaluationSnapshot const &snapshot, JobEstimate const &estimate);
+
         /**
              * @brief createJobSequence Creates a job sequence for the mosaic tool given the prefix and output dir. The currently selected sequence file is modified
              * and a new version given the supplied parameters are saved to the output directory
@@ -675,9 +746,12 @@ class Scheduler : public QWidget, public Ui::Scheduler
             */
         void updateCompletedJobsCount(bool forced = false);
 
-        SequenceJob *processJobInfo(XMLEle *root, SchedulerJob *schedJob);
+        static SequenceJob *processJobInfo(XMLEle *root, SchedulerJob const *schedJob);
         bool loadSequenceQueue(const QString &fileURL, SchedulerJob *schedJob, QList<SequenceJob *> &jobs,
                                bool &hasAutoFocus);
+        /// Thread-safe part of loadSequenceQueue, which does not update the job and reports failures in error
+        static bool parseSequenceQueue(const QString &fileURL, SchedulerJob const *schedJob, QList<SequenceJob *> &jobs,
+                                       bool &hasAutoFocus, QString &error);
         int getCompletedFiles(const QString &path, const QString &seqPrefix);
 
         // retrieve the guiding status
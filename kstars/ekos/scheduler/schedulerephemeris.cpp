@@ -0,0 +1,276 @@
+/*  Ekos Scheduler Ephemeris
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "schedulerephemeris.h"
+
+#include "ephemeriscache.h"
+#include "geolocation.h"
+#include "kstarsdata.h"
+#include "ksmoon.h"
+#include "kssun.h"
+#include "skypoint.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cmath>
+
+#include <ekos_scheduler_debug.h>
+
+namespace
+{
+// Tables kept around, enough for the night being scheduled and the searches spilling over the next one
+const int MAX_TABLES = 3;
+
+QMutex tablesMutex;
+QList<std::shared_ptr<const SchedulerEphemeris>> tables;
+double tablesLatitude { 0 }, tablesLongitude { 0 };
+
+double reduceHours(double hours)
+{
+    return hours - 24.0 * std::floor(hours / 24.0);
+}
+}
+
+std::shared_ptr<const SchedulerEphemeris> SchedulerEphemeris::forTime(const KStarsDateTime &lt)
+{
+    GeoLocation * const geo = KStarsData::Instance()->geo();
+
+    // Tables start at local noon, so that a night is never split between two tables
+    KStarsDateTime start(lt.date(), QTime(12, 0, 0), Qt::LocalTime);
+    if (lt.time() < QTime(12, 0, 0))
+        start = start.addDays(-1);
+
+    QMutexLocker locker(&tablesMutex);
+
+    if (geo->lat()->Degrees() != tablesLatitude || geo->lng()->Degrees() != tablesLongitude)
+    {
+        tables.clear();
+        tablesLatitude  = geo->lat()->Degrees();
+        tablesLongitude = geo->lng()->Degrees();
+    }
+
+    // Move the table to the front, so that the least recently used one is evicted first
+    for (int i = 0; i < tables.size(); i++)
+    {
+        if (tables[i]->start() == start)
+        {
+            tables.move(i, 0);
+            return tables.first();
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::shared_ptr<const SchedulerEphemeris> table(new SchedulerEphemeris(start, geo));
+
+    qCDebug(KSTARS_EKOS_SCHEDULER) << QString("Computed ephemeris table for %1 in %2 ms.")
+                                   .arg(start.toString(Qt::ISODate))
+                                   .arg(timer.elapsed());
+
+    tables.prepend(table);
+    while (tables.size() > MAX_TABLES)
+        tables.removeLast();
+
+    return table;
+}
+
+SchedulerEphemeris::SchedulerEphemeris(const KStarsDateTime &start, const GeoLocation *geo)
+    : m_Start(start), m_Numbers(geo->LTtoUT(start.addSecs(12 * 60 * 60)).djd())
+{
+    geo->lat()->SinCos(m_SinLat, m_CosLat);
+
+    // Use our own Sun and Moon, the ones of the sky map must keep the coordinates of the displayed time
+    KSSun sun;
+    KSMoon moon;
+    sun.loadData();
+    moon.loadData();
+
+    // Nutation and precession change by well under an arcsecond during a day, so one set of numbers is enough
+    // for the targets. The Sun and Moon move fast enough to need their own.
+    KSNumbers numbers(m_Numbers.julianDay());
+
+    // The table runs until the next local noon, which is 23 or 25 hours away when daylight saving time
+    // starts or ends during the night
+    KStarsDateTime const next(start.date().addDays(1), QTime(12, 0, 0), Qt::LocalTime);
+    int const minutes = static_cast<int>(start.msecsTo(next) / 60000);
+
+    // The Sun and Moon are interpolated from their ephemerides, shared by the tables of the following nights
+    long double const startJD = geo->LTtoUT(start).djd();
+    long double const endJD   = startJD + minutes / (24.0L * 60.0L);
+    auto sunEphemeris         = EphemerisCache::Instance()->prepare(&sun, startJD, endJD);
+    auto moonEphemeris        = EphemerisCache::Instance()->prepare(&moon, startJD, endJD);
+
+    m_Samples.resize(minutes + 1);
+    for (int i = 0; i < m_Samples.size(); i++)
+    {
+        KStarsDateTime const ut = geo->LTtoUT(start.addSecs(60 * i));
+        CachingDms const LST(geo->GSTtoLST(ut.gst()));
+        Sample &s = m_Samples[i];
+
+        numbers.updateValues(ut.djd());
+
+        if (!sunEphemeris || !sun.findCachedPosition(*sunEphemeris, &numbers, geo->lat(), &LST))
+            sun.updateCoords(&numbers, true, geo->lat(), &LST, true);
+        sun.EquatorialToHorizontal(&LST, geo->lat());
+
+        if (!moonEphemeris || !moon.findCachedPosition(*moonEphemeris, &numbers, geo->lat(), &LST))
+            moon.updateCoords(&numbers, true, geo->lat(), &LST, true);
+        moon.findPhase(&sun);
+        moon.EquatorialToHorizontal(&LST, geo->lat());
+
+        double sinRA, cosRA, sinDec, cosDec;
+        moon.ra().SinCos(sinRA, cosRA);
+        moon.dec().SinCos(sinDec, cosDec);
+
+        s.lst       = LST.Hours();
+        s.sunAlt    = sun.alt().Degrees();
+        s.moonAlt   = moon.alt().Degrees();
+        s.moonIllum = moon.illum();
+        s.moonX     = cosDec * cosRA;
+        s.moonY     = cosDec * sinRA;
+        s.moonZ     = sinDec;
+    }
+}
+
+double SchedulerEphemeris::indexOf(const KStarsDateTime &lt) const
+{
+    return m_Start.msecsTo(lt) / 60000.0;
+}
+
+const SchedulerEphemeris::Sample &SchedulerEphemeris::sample(double index) const
+{
+    int const i = static_cast<int>(std::lround(index));
+    return m_Samples[std::max(0, std::min(i, m_Samples.size() - 1))];
+}
+
+dms SchedulerEphemeris::LST(double index) const
+{
+    // Sidereal time is linear in time, so interpolating between samples is exact
+    int i = static_cast<int>(std::floor(index));
+    i     = std::max(0, std::min(i, m_Samples.size() - 2));
+
+    double const lst0 = m_Samples[i].lst;
+    double const step = reduceHours(m_Samples[i + 1].lst - lst0);
+
+    return dms(reduceHours(lst0 + (index - i) * step) * 15.0);
+}
+
+SchedulerEphemeris::Target SchedulerEphemeris::target(const SkyPoint &catalogCoords) const
+{
+    SkyPoint p;
+    p.setRA0(catalogCoords.ra0());
+    p.setDec0(catalogCoords.dec0());
+    p.updateCoordsNow(&m_Numbers);
+
+    Target t;
+    t.ra  = p.ra();
+    t.dec = p.dec();
+    t.dec.SinCos(t.sinDec, t.cosDec);
+
+    double sinRA, cosRA;
+    t.ra.SinCos(sinRA, cosRA);
+    t.x = t.cosDec * cosRA;
+    t.y = t.cosDec * sinRA;
+    t.z = t.sinDec;
+
+    return t;
+}
+
+double SchedulerEphemeris::hourAngle(const Target &t, double index) const
+{
+    return reduceHours(LST(index).Hours() - t.ra.Hours());
+}
+
+double SchedulerEphemeris::altitude(const Target &t, double index) const
+{
+    double const HA     = hourAngle(t, index) * 15.0 * dms::DegToRad;
+    double const sinAlt = t.sinDec * m_SinLat + t.cosDec * m_CosLat * std::cos(HA);
+
+    return std::asin(std::max(-1.0, std::min(1.0, sinAlt))) / dms::DegToRad;
+}
+
+double SchedulerEphemeris::moonSeparation(const Target &t, double index) const
+{
+    Sample const &s = sample(index);
+
+    double const cx = t.y * s.moonZ - t.z * s.moonY;
+    double const cy = t.z * s.moonX - t.x * s.moonZ;
+    double const cz = t.x * s.moonY - t.y * s.moonX;
+
+    return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), t.x * s.moonX + t.y * s.moonY + t.z * s.moonZ) /
+           dms::DegToRad;
+}
+
+int SchedulerEphemeris::firstAtOrAbove(const Target &t, double threshold, double from, int minutes) const
+{
+    if (minutes < 0)
+        return -1;
+    if (threshold <= altitude(t, from))
+        return 0;
+
+    // Finds the first minute at or above the threshold in ]lo,hi], provided altitude is monotonic on [lo,hi]
+    // and below the threshold at lo
+    auto bisect = [&](int lo, int hi) -> int
+    {
+        if (altitude(t, from + hi) < threshold)
+            return -1;
+
+        while (hi - lo > 1)
+        {
+            int const mid = (lo + hi) / 2;
+            if (threshold <= altitude(t, from + mid))
+                hi = mid;
+            else
+                lo = mid;
+        }
+        return hi;
+    };
+
+    // Invariant: altitude at lo is below the threshold
+    for (int lo = 0; lo < minutes;)
+    {
+        int const hi = std::min(lo + SCAN_STEP, minutes);
+
+        // Altitude changes direction at the meridian and anti-meridian, which are 12 hours apart, so there
+        // is at most one of them in a bracket. Locate the last minute before it, if any.
+        double const ha   = hourAngle(t, from + lo);
+        double const rate = reduceHours(hourAngle(t, from + hi) - ha) / (hi - lo);
+        double const turn = 12.0 * (std::floor(ha / 12.0) + 1);
+        int const last    = (ha + rate * (hi - lo) >= turn) ?
+                            std::min(hi - 1, lo + static_cast<int>(std::floor((turn - ha) / rate))) : -1;
+
+        int start = lo;
+        if (last >= lo)
+        {
+            if (last > lo)
+            {
+                int const found = bisect(lo, last);
+                if (found >= 0)
+                    return found;
+            }
+            if (threshold <= altitude(t, from + last + 1))
+                return last + 1;
+            start = last + 1;
+        }
+
+        if (start < hi)
+        {
+            int const found = bisect(start, hi);
+            if (found >= 0)
+                return found;
+        }
+
+        lo = hi;
+    }
+
+    return -1;
+}
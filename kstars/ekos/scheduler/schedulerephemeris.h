@@ -0,0 +1,133 @@
+/*  Ekos Scheduler Ephemeris
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#pragma once
+
+#include "dms.h"
+#include "ksnumbers.h"
+#include "kstarsdatetime.h"
+
+#include <QVector>
+
+#include <memory>
+
+class GeoLocation;
+class SkyPoint;
+
+/**
+ * @class SchedulerEphemeris
+ * @short Per-night ephemeris table shared by all scheduler jobs.
+ *
+ * Finding when a job target crosses its altitude constraint used to mean recomputing nutation,
+ * precession, sidereal time and the Moon for every minute of the next 24 hours, for every job, on
+ * every evaluation. This table samples the local sidereal time, the Moon and the Sun once per minute
+ * for the current site, from one local noon to the next, 23 or 25 hours apart when daylight saving time
+ * changes. Jobs then only need the apparent place of their target, after which altitudes are a few
+ * multiplications away and crossings are found by bisection on the table.
+ *
+ * Tables are built on demand by forTime() and shared until the site changes. The three most recently used
+ * tables are kept.
+ */
+class SchedulerEphemeris
+{
+  public:
+    /** @short Apparent place of a target for the day covered by a table. */
+    struct Target
+    {
+        dms ra, dec;
+        double sinDec { 0 }, cosDec { 1 };
+        /** Unit vector, for angular distances */
+        double x { 1 }, y { 0 }, z { 0 };
+    };
+
+    /**
+     * @brief forTime Get the table covering a local date and time, for the current geographic location.
+     * @param lt local date and time
+     * @return shared table, never null
+     */
+    static std::shared_ptr<const SchedulerEphemeris> forTime(const KStarsDateTime &lt);
+
+    /** @return local time of the first sample */
+    const KStarsDateTime &start() const { return m_Start; }
+
+    /** @return local time of the last sample */
+    KStarsDateTime end() const { return m_Start.addSecs(60 * (m_Samples.size() - 1)); }
+
+    /** @return number of samples, one per minute */
+    int size() const { return m_Samples.size(); }
+
+    /** @return offset of a local time from start(), in minutes, not necessarily within the table */
+    double indexOf(const KStarsDateTime &lt) const;
+
+    /** @return apparent place of a target with J2000 coordinates, valid throughout the table */
+    Target target(const SkyPoint &catalogCoords) const;
+
+    /** @return altitude in degrees of a target at a (fractional) sample index */
+    double altitude(const Target &t, double index) const;
+
+    /** @return hour angle in hours, in [0, 24[, of a target at a (fractional) sample index */
+    double hourAngle(const Target &t, double index) const;
+
+    /** @return true if the target passed the meridian, i.e. is setting, at a (fractional) sample index */
+    bool isSetting(const Target &t, double index) const { return hourAngle(t, index) < 12.0; }
+
+    /** @return local sidereal time at a (fractional) sample index */
+    dms LST(double index) const;
+
+    /** @return altitude of the Moon at the nearest sample, in degrees */
+    double moonAltitude(double index) const { return sample(index).moonAlt; }
+
+    /** @return illuminated fraction of the Moon at the nearest sample */
+    double moonIllumination(double index) const { return sample(index).moonIllum; }
+
+    /** @return angular distance between a target and the Moon at the nearest sample, in degrees */
+    double moonSeparation(const Target &t, double index) const;
+
+    /** @return altitude of the Sun at the nearest sample, in degrees */
+    double sunAltitude(double index) const { return sample(index).sunAlt; }
+
+    /**
+     * @brief firstAtOrAbove Find the first minute at which a target is at or above an altitude.
+     * The interval is scanned in coarse steps. Bracketed crossings are then narrowed down by bisection,
+     * after splitting the bracket at the meridian and anti-meridian where altitude changes direction.
+     * @param t the target
+     * @param altitude altitude threshold in degrees
+     * @param from (fractional) sample index to start from
+     * @param minutes number of minutes after from to consider
+     * @return the number of minutes after from, or -1 if the target stays below the threshold
+     */
+    int firstAtOrAbove(const Target &t, double altitude, double from, int minutes) const;
+
+  private:
+#ifdef UNIT_TEST
+    friend class TestSchedulerEphemeris;
+#endif
+
+    struct Sample
+    {
+        /** Local sidereal time, in hours */
+        double lst { 0 };
+        double moonAlt { 0 };
+        double moonIllum { 0 };
+        /** Unit vector towards the (topocentric) Moon */
+        double moonX { 1 }, moonY { 0 }, moonZ { 0 };
+        double sunAlt { 0 };
+    };
+
+    SchedulerEphemeris(const KStarsDateTime &start, const GeoLocation *geo);
+
+    const Sample &sample(double index) const;
+
+    /** Coarse scan step of firstAtOrAbove(), in samples */
+    static const int SCAN_STEP = 16;
+
+    KStarsDateTime m_Start;
+    KSNumbers m_Numbers;
+    double m_SinLat { 0 }, m_CosLat { 1 };
+    QVector<Sample> m_Samples;
+};
@@ -11,14 +11,19 @@
 
 #include "dms.h"
 #include "kstarsdata.h"
-#include "skymapcomposite.h"
+#include "ksutils.h"
 #include "Options.h"
 #include "scheduler.h"
+#include "schedulerephemeris.h"
+#include "skyobject.h"
 
 #include <knotification.h>
 
 #include <QTableWidgetItem>
 
+#include <algorithm>
+#include <cmath>
+
 #include <ekos_scheduler_debug.h>
 
 #define BAD_SCORE -1000
@@ -26,7 +31,6 @@
 
 SchedulerJob::SchedulerJob()
 {
-    moon = dynamic_cast<KSMoon *>(KStarsData::Instance()->skyComposite()->findByName(i18n("Moon")));
 }
 
 void SchedulerJob::setName(const QString &value)
@@ -703,6 +707,11 @@ bool SchedulerJob::decreasingAltitudeOrder(SchedulerJob const *job1, SchedulerJo
                         findAltitude(job2->getTargetCoords(), when, &B_is_setting) :
                         job2->altitudeAtStartup;
 
+    return decreasingAltitudeValueOrder(altA, A_is_setting, altB, B_is_setting);
+}
+
+bool SchedulerJob::decreasingAltitudeValueOrder(double altA, bool A_is_setting, double altB, bool B_is_setting)
+{
     // Sort with the setting target first
     if (A_is_setting && !B_is_setting)
         return true;
@@ -720,7 +729,6 @@ bool SchedulerJob::increasingStartupTimeOrder(SchedulerJob const *job1, Schedule
 
 int16_t SchedulerJob::getAltitudeScore(QDateTime const &when) const
 {
-    // FIXME: block calculating target coordinates at a particular time is duplicated in several places
     GeoLocation *geo = KStarsData::Instance()->geo();
 
     // Retrieve the argument date/time, or fall back to current time - don't use QDateTime's timezone!
@@ -728,20 +736,11 @@ int16_t SchedulerJob::getAltitudeScore(QDateTime const &when) const
                           Qt::UTC == when.timeSpec() ? geo->UTtoLT(KStarsDateTime(when)) : when :
                           KStarsData::Instance()->lt());
 
-    // Create a sky object with the target catalog coordinates
-    SkyPoint const target = getTargetCoords();
-    SkyObject o;
-    o.setRA0(target.ra0());
-    o.setDec0(target.dec0());
-
-    // Update RA/DEC of the target for the current fraction of the day
-    KSNumbers numbers(ltWhen.djd());
-    o.updateCoordsNow(&numbers);
-
-    // Compute local sidereal time for the current fraction of the day, calculate altitude
-    CachingDms const LST = geo->GSTtoLST(geo->LTtoUT(ltWhen).gst());
-    o.EquatorialToHorizontal(&LST, geo->lat());
-    double const altitude = o.alt().Degrees();
+    // Calculate altitude of the target from the ephemeris of the day
+    auto const ephemeris = SchedulerEphemeris::forTime(ltWhen);
+    auto const target = ephemeris->target(getTargetCoords());
+    double const index = ephemeris->indexOf(ltWhen);
+    double const altitude = ephemeris->altitude(target, index);
 
     double const SETTING_ALTITUDE_CUTOFF = Options::settingAltitudeCutoff();
     int16_t score = BAD_SCORE - 1;
@@ -759,16 +758,10 @@ int16_t SchedulerJob::getAltitudeScore(QDateTime const &when) const
             score = BAD_SCORE;
         // Else if setting and under altitude cutoff, job would end soon after starting, bad score
         // FIXME: half bad score when under altitude cutoff risk getting positive again
-        else
+        else if (ephemeris->isSetting(target, index))
         {
-            double offset = LST.Hours() - o.ra().Hours();
-            if (24.0 <= offset)
-                offset -= 24.0;
-            else if (offset < 0.0)
-                offset += 24.0;
-            if (0.0 <= offset && offset < 12.0)
-                if (altitude - SETTING_ALTITUDE_CUTOFF < getMinAltitude())
-                    score = BAD_SCORE / 2;
+            if (altitude - SETTING_ALTITUDE_CUTOFF < getMinAltitude())
+                score = BAD_SCORE / 2;
         }
     }
     // If not constrained but below minimum hard altitude, set score to 10% of altitude value
@@ -792,7 +785,6 @@ int16_t SchedulerJob::getAltitudeScore(QDateTime const &when) const
 
 int16_t SchedulerJob::getMoonSeparationScore(QDateTime const &when) const
 {
-    // FIXME: block calculating target coordinates at a particular time is duplicated in several places
     GeoLocation *geo = KStarsData::Instance()->geo();
 
     // Retrieve the argument date/time, or fall back to current time - don't use QDateTime's timezone!
@@ -800,35 +792,23 @@ int16_t SchedulerJob::getMoonSeparationScore(QDateTime const &when) const
                           Qt::UTC == when.timeSpec() ? geo->UTtoLT(KStarsDateTime(when)) : when :
                           KStarsData::Instance()->lt());
 
-    // Create a sky object with the target catalog coordinates
-    SkyPoint const target = getTargetCoords();
-    SkyObject o;
-    o.setRA0(target.ra0());
-    o.setDec0(target.dec0());
-
-    // Update RA/DEC of the target for the current fraction of the day
-    KSNumbers numbers(ltWhen.djd());
-    o.updateCoordsNow(&numbers);
+    // Retrieve target and moon positions from the ephemeris of the day
+    auto const ephemeris = SchedulerEphemeris::forTime(ltWhen);
+    auto const target = ephemeris->target(getTargetCoords());
+    double const index = ephemeris->indexOf(ltWhen);
 
-    // Update moon
-    //ut = geo->LTtoUT(ltWhen);
-    //KSNumbers ksnum(ut.djd()); // BUG: possibly LT.djd() != UT.djd() because of translation
-    //LST = geo->GSTtoLST(ut.gst());
-    CachingDms LST = geo->GSTtoLST(geo->LTtoUT(ltWhen).gst());
-    moon->updateCoords(&numbers, true, geo->lat(), &LST, true);
-
-    double const moonAltitude = moon->alt().Degrees();
+    double const moonAltitude = ephemeris->moonAltitude(index);
 
     // Lunar illumination %
-    double const illum = moon->illum() * 100.0;
+    double const illum = ephemeris->moonIllumination(index) * 100.0;
 
     // Moon/Sky separation p
-    double const separation = moon->angularDistanceTo(&o).Degrees();
+    double const separation = ephemeris->moonSeparation(target, index);
 
     // Zenith distance of the moon
     double const zMoon = (90 - moonAltitude);
     // Zenith distance of target
-    double const zTarget = (90 - o.alt().Degrees());
+    double const zTarget = (90 - ephemeris->altitude(target, index));
 
     int16_t score = 0;
 
@@ -868,36 +848,15 @@ int16_t SchedulerJob::getMoonSeparationScore(QDateTime const &when) const
 
 double SchedulerJob::getCurrentMoonSeparation() const
 {
-    // FIXME: block calculating target coordinates at a particular time is duplicated in several places
-    GeoLocation *geo = KStarsData::Instance()->geo();
-
-    // Retrieve the argument date/time, or fall back to current time - don't use QDateTime's timezone!
-    KStarsDateTime ltWhen(KStarsData::Instance()->lt());
-
-    // Create a sky object with the target catalog coordinates
-    SkyPoint const target = getTargetCoords();
-    SkyObject o;
-    o.setRA0(target.ra0());
-    o.setDec0(target.dec0());
-
-    // Update RA/DEC of the target for the current fraction of the day
-    KSNumbers numbers(ltWhen.djd());
-    o.updateCoordsNow(&numbers);
-
-    // Update moon
-    //ut = geo->LTtoUT(ltWhen);
-    //KSNumbers ksnum(ut.djd()); // BUG: possibly LT.djd() != UT.djd() because of translation
-    //LST = geo->GSTtoLST(ut.gst());
-    CachingDms LST = geo->GSTtoLST(geo->LTtoUT(ltWhen).gst());
-    moon->updateCoords(&numbers, true, geo->lat(), &LST, true);
+    KStarsDateTime const ltWhen(KStarsData::Instance()->lt());
 
     // Moon/Sky separation p
-    return moon->angularDistanceTo(&o).Degrees();
+    auto const ephemeris = SchedulerEphemeris::forTime(ltWhen);
+    return ephemeris->moonSeparation(ephemeris->target(getTargetCoords()), ephemeris->indexOf(ltWhen));
 }
 
 QDateTime SchedulerJob::calculateAltitudeTime(QDateTime const &when) const
 {
-    // FIXME: block calculating target coordinates at a particular time is duplicated in several places
     GeoLocation *geo = KStarsData::Instance()->geo();
 
     // Retrieve the argument date/time, or fall back to current time - don't use QDateTime's timezone!
@@ -905,51 +864,49 @@ QDateTime SchedulerJob::calculateAltitudeTime(QDateTime const &when) const
                           Qt::UTC == when.timeSpec() ? geo->UTtoLT(KStarsDateTime(when)) : when :
                           KStarsData::Instance()->lt());
 
-    // Create a sky object with the target catalog coordinates
-    SkyPoint const target = getTargetCoords();
-    SkyObject o;
-    o.setRA0(target.ra0());
-    o.setDec0(target.dec0());
-
-    // Calculate the UT at the argument time
-    KStarsDateTime const ut = geo->LTtoUT(ltWhen);
-
     double const SETTING_ALTITUDE_CUTOFF = Options::settingAltitudeCutoff();
 
     // Within the next 24 hours, search when the job target matches the altitude and moon constraints
-    for (unsigned int minute = 0; minute < 24 * 60; minute++)
+    int minute = 0;
+    while (minute < 24 * 60)
     {
+        KStarsDateTime const ltSearch(ltWhen.addSecs(minute * 60));
+
+        // Search the ephemeris of the day up to its end, then continue with the next one
+        auto const ephemeris = SchedulerEphemeris::forTime(ltSearch);
+        auto const target = ephemeris->target(getTargetCoords());
+        double const index = ephemeris->indexOf(ltSearch);
+        int const span = std::min(24 * 60 - 1 - minute, static_cast<int>(std::floor(ephemeris->size() - 1 - index)));
+
+        int const found = ephemeris->firstAtOrAbove(target, getMinAltitude(), index, span);
+        if (found < 0)
+        {
+            // Always move forward, even if the search time is not covered by the table
+            minute += std::max(span, 0) + 1;
+            continue;
+        }
+
+        minute += found;
         KStarsDateTime const ltOffset(ltWhen.addSecs(minute * 60));
+        double const altitude = ephemeris->altitude(target, index + found);
 
-        // Update RA/DEC of the target for the current fraction of the day
-        KSNumbers numbers(ltOffset.djd());
-        o.updateCoordsNow(&numbers);
+        // Don't test proximity to dawn in this situation, we only cater for altitude here
 
-        // Compute local sidereal time for the current fraction of the day, calculate altitude
-        CachingDms const LST = geo->GSTtoLST(geo->LTtoUT(ltOffset).gst());
-        o.EquatorialToHorizontal(&LST, geo->lat());
-        double const altitude = o.alt().Degrees();
+        // Continue searching if Moon separation is not good enough
+        if (0 < getMinMoonSeparation() && getMoonSeparationScore(ltOffset) < 0)
+        {
+            minute++;
+            continue;
+        }
 
-        if (getMinAltitude() <= altitude)
+        // Continue searching if target is setting and under the cutoff
+        if (ephemeris->isSetting(target, index + found) && altitude - SETTING_ALTITUDE_CUTOFF < getMinAltitude())
         {
-            // Don't test proximity to dawn in this situation, we only cater for altitude here
-
-            // Continue searching if Moon separation is not good enough
-            if (0 < getMinMoonSeparation() && getMoonSeparationScore(ltOffset) < 0)
-                continue;
-
-            // Continue searching if target is setting and under the cutoff
-            double offset = LST.Hours() - o.ra().Hours();
-            if (24.0 <= offset)
-                offset -= 24.0;
-            else if (offset < 0.0)
-                offset += 24.0;
-            if (0.0 <= offset && offset < 12.0)
-                if (altitude - SETTING_ALTITUDE_CUTOFF < getMinAltitude())
-                    continue;
-
-            return ltOffset;
+            minute++;
+            continue;
         }
+
+        return ltOffset;
     }
 
     return QDateTime();
@@ -1007,8 +964,6 @@ QDateTime SchedulerJob::calculateCulmination(QDateTime const &when) const
 
 double SchedulerJob::findAltitude(const SkyPoint &target, const QDateTime &when, bool * is_setting, bool debug)
 {
-    // FIXME: block calculating target coordinates at a particular time is duplicated in several places
-
     GeoLocation * const geo = KStarsData::Instance()->geo();
 
     // Retrieve the argument date/time, or fall back to current time - don't use QDateTime's timezone!
@@ -1016,41 +971,27 @@ double SchedulerJob::findAltitude(const SkyPoint &target, const QDateTime &when,
                           Qt::UTC == when.timeSpec() ? geo->UTtoLT(KStarsDateTime(when)) : when :
                           KStarsData::Instance()->lt());
 
-    // Create a sky object with the target catalog coordinates
-    SkyObject o;
-    o.setRA0(target.ra0());
-    o.setDec0(target.dec0());
-
-    // Update RA/DEC of the target for the current fraction of the day
-    KSNumbers numbers(ltWhen.djd());
-    o.updateCoordsNow(&numbers);
-
-    // Calculate alt/az coordinates using KStars instance's geolocation
-    CachingDms const LST = geo->GSTtoLST(geo->LTtoUT(ltWhen).gst());
-    o.EquatorialToHorizontal(&LST, geo->lat());
-
-    // Hours are reduced to [0,24[, meridian being at 0
-    double offset = LST.Hours() - o.ra().Hours();
-    if (24.0 <= offset)
-        offset -= 24.0;
-    else if (offset < 0.0)
-        offset += 24.0;
-    bool const passed_meridian = 0.0 <= offset && offset < 12.0;
+    // Calculate altitude of the target from the ephemeris of the day
+    auto const ephemeris = SchedulerEphemeris::forTime(ltWhen);
+    auto const t = ephemeris->target(target);
+    double const index = ephemeris->indexOf(ltWhen);
+    double const altitude = ephemeris->altitude(t, index);
+    bool const passed_meridian = ephemeris->isSetting(t, index);
 
     if (debug)
         qCDebug(KSTARS_EKOS_SCHEDULER) << QString("When:%9 LST:%8 RA:%1 RA0:%2 DEC:%3 DEC0:%4 alt:%5 setting:%6 HA:%7")
-                                       .arg(o.ra().toHMSString())
-                                       .arg(o.ra0().toHMSString())
-                                       .arg(o.dec().toHMSString())
-                                       .arg(o.dec0().toHMSString())
-                                       .arg(o.alt().Degrees())
+                                       .arg(t.ra.toHMSString())
+                                       .arg(target.ra0().toHMSString())
+                                       .arg(t.dec.toHMSString())
+                                       .arg(target.dec0().toHMSString())
+                                       .arg(altitude)
                                        .arg(passed_meridian ? "yes" : "no")
-                                       .arg(o.ra().Hours())
-                                       .arg(LST.toHMSString())
+                                       .arg(t.ra.Hours())
+                                       .arg(ephemeris->LST(index).toHMSString())
                                        .arg(ltWhen.toString("HH:mm:ss"));
 
     if (is_setting)
         *is_setting = passed_meridian;
 
-    return o.alt().Degrees();
+    return altitude;
 }
@@ -13,11 +13,9 @@
 
 #include <QUrl>
 #include <QMap>
-#include "ksmoon.h"
 
 class QTableWidgetItem;
 class QLabel;
-class KSMoon;
 
 class dms;
 
@@ -378,6 +376,9 @@ class SchedulerJob
      */
     static bool decreasingAltitudeOrder(SchedulerJob const *a, SchedulerJob const *b, QDateTime const &when = QDateTime());
 
+    /** @brief Same predicate as above, with altitudes and setting states already known. */
+    static bool decreasingAltitudeValueOrder(double altA, bool A_is_setting, double altB, bool B_is_setting);
+
     /** @brief Compare ::SchedulerJob instances based on startup time.
      * @todo This is a qSort predicate, deprecated in QT5.
      * @arg a, b are ::SchedulerJob instances to compare.
@@ -499,7 +500,4 @@ private:
     bool lightFramesRequired { false };
 
     QMap<QString, uint16_t> capturedFramesMap;
-
-    /// Pointer to Moon object
-    KSMoon *moon { nullptr };
 };
@@ -20,7 +20,6 @@
 #include "fitsdata.h"
 
 #include "sep/sep.h"
-#include "fpack.h"
 
 #include "kstarsdata.h"
 #include "ksutils.h"
@@ -33,10 +32,14 @@
 #include <QImage>
 #include <QtConcurrent>
 #include <QImageReader>
+#include <QMutex>
+#include <QThread>
 
 #if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
 #include <wcshdr.h>
 #include <wcsfix.h>
+
+#include "fitswcsgrid.h"
 #endif
 
 #ifndef KSTARS_LITE
@@ -45,6 +48,11 @@
 
 #include <cfloat>
 #include <cmath>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 #include <fits_debug.h>
 
@@ -64,6 +72,44 @@ const QString FITSData::m_TemporaryPath = QStandardPaths::writableLocation(QStan
 #define LOW_EDGE_CUTOFF_2  10
 #define MINIMUM_EDGE_LIMIT 2
 
+// Float conversion buffers released by FITSData instances, for reuse by the next frames
+namespace
+{
+const int MAX_POOLED_FLOAT_IMAGES = 2;
+
+QMutex floatImagePoolMutex;
+QList<std::vector<float>> floatImagePool;
+
+void releaseFloatImage(std::vector<float> &image)
+{
+    if (image.capacity() == 0)
+        return;
+
+    QMutexLocker locker(&floatImagePoolMutex);
+    if (floatImagePool.size() >= MAX_POOLED_FLOAT_IMAGES)
+        floatImagePool.removeFirst();
+    floatImagePool.append(std::vector<float>());
+    floatImagePool.last().swap(image);
+}
+
+void acquireFloatImage(std::vector<float> &image, size_t size)
+{
+    QMutexLocker locker(&floatImagePoolMutex);
+    for (int i = floatImagePool.size() - 1; i >= 0; i--)
+    {
+        if (floatImagePool[i].capacity() >= size)
+        {
+            image.swap(floatImagePool[i]);
+            floatImagePool.removeAt(i);
+            break;
+        }
+    }
+    locker.unlock();
+
+    image.resize(size);
+}
+}
+
 bool greaterThan(Edge * s1, Edge * s2)
 {
     //return s1->width > s2->width;
@@ -86,7 +132,7 @@ FITSData::FITSData(const FITSData * other)
     this->m_Mode = other->m_Mode;
     this->m_DataType = other->m_DataType;
     this->m_Channels = other->m_Channels;
-    memcpy(&stats, &(other->stats), sizeof(stats));
+    stats = other->stats;
     m_ImageBuffer = new uint8_t[stats.samples_per_channel * m_Channels * stats.bytesPerPixel];
     memcpy(m_ImageBuffer, other->m_ImageBuffer, stats.samples_per_channel * m_Channels * stats.bytesPerPixel);
 }
@@ -97,6 +143,11 @@ FITSData::~FITSData()
 
     clearImageBuffers();
 
+#if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
+    // The grid refers to m_wcs
+    m_WCSGrid.reset();
+#endif
+
 #ifdef HAVE_WCSLIB
     if (m_wcs != nullptr)
         wcsvfree(&m_nwcs, &m_wcs);
@@ -105,8 +156,6 @@ FITSData::~FITSData()
     if (starCenters.count() > 0)
         qDeleteAll(starCenters);
 
-    delete[] wcs_coord;
-
     if (objList.count() > 0)
         qDeleteAll(objList);
 
@@ -180,6 +229,28 @@ bool fitsOpenError(int status, const QString &message, bool silent)
     qCCritical(KSTARS_FITS) << errMessage;
     return false;
 }
+
+// Moves to the HDU holding the image. This is the primary HDU, unless it is empty as in
+// tile-compressed files, which keep the image in the first extension.
+int locateImageHDU(fitsfile *fptr, int *status)
+{
+    int naxis = 0, hdutype = 0;
+
+    if (fits_movabs_hdu(fptr, 1, &hdutype, status) || fits_get_img_dim(fptr, &naxis, status) || naxis > 0)
+        return *status;
+
+    if (fits_movabs_hdu(fptr, 2, &hdutype, status))
+    {
+        // No extension, let the caller report the empty primary HDU
+        *status = 0;
+        return fits_movabs_hdu(fptr, 1, &hdutype, status);
+    }
+
+    if (hdutype != IMAGE_HDU)
+        *status = NOT_IMAGE;
+
+    return *status;
+}
 }
 
 bool FITSData::privateLoad(void *fits_buffer, size_t fits_buffer_size, bool silent)
@@ -190,32 +261,6 @@ bool FITSData::privateLoad(void *fits_buffer, size_t fits_buffer_size, bool sile
 
     m_isTemporary = m_Filename.startsWith(m_TemporaryPath);
 
-    if (fits_buffer == nullptr && m_Filename.endsWith(".fz"))
-    {
-        // Store so we don't lose.
-        m_compressedFilename = m_Filename;
-
-        QString uncompressedFile = QDir::tempPath() + QString("/%1").arg(QUuid::createUuid().toString().remove(QRegularExpression("[-{}]")));
-        fpstate	fpvar;
-        fp_init (&fpvar);
-        if (fp_unpack(m_Filename.toLatin1().data(), uncompressedFile.toLatin1().data(), fpvar) < 0)
-        {
-            errMessage = i18n("Failed to unpack compressed fits");
-            if (!silent)
-                KSNotification::error(errMessage, i18n("FITS Open"));
-            qCCritical(KSTARS_FITS) << errMessage;
-            return false;
-        }
-
-        // Remove compressed .fz if it was temporary
-        if (m_isTemporary && autoRemoveTemporaryFITS)
-            QFile::remove(m_Filename);
-
-        m_Filename = uncompressedFile;
-        m_isTemporary = true;
-        m_isCompressed = true;
-    }
-
     if (fits_buffer == nullptr)
     {
         // Use open diskfile as it does not use extended file names which has problems opening
@@ -237,9 +282,14 @@ bool FITSData::privateLoad(void *fits_buffer, size_t fits_buffer_size, bool sile
             stats.size = fits_buffer_size;
     }
 
-    if (fits_movabs_hdu(fptr, 1, IMAGE_HDU, &status))
+    if (locateImageHDU(fptr, &status))
         return fitsOpenError(status, i18n("Could not locate image HDU."), silent);
 
+    // Tile-compressed images (.fz) are read like any other image: cfitsio decompresses the tiles
+    // straight into the image buffer below, without an intermediate file.
+    m_isCompressed = fits_is_compressed_image(fptr, &status) == 1;
+    m_compressedFilename = m_isCompressed ? m_Filename : QString();
+
     if (fits_get_img_param(fptr, 3, &(stats.bitpix), &(stats.ndim), naxes, &status))
         return fitsOpenError(status, i18n("FITS file open error (fits_get_img_param)."), silent);
 
@@ -543,52 +593,71 @@ void FITSData::clearImageBuffers()
     delete[] m_ImageBuffer;
     m_ImageBuffer = nullptr;
     //m_BayerBuffer = nullptr;
+
+    m_FloatImageValid = false;
+    releaseFloatImage(m_FloatImage);
 }
 
 void FITSData::calculateStats(bool refresh)
 {
-    // Calculate min max
-    calculateMinMax(refresh);
+    for (int n = 0; n < 3; n++)
+    {
+        stats.min[n] = 1.0E30;
+        stats.max[n] = -1.0E30;
+        stats.histogram[n].clear();
+    }
 
-    // Get standard deviation and mean in one run
+    // Min, max, mean, standard deviation, histogram and median in one pass
     switch (m_DataType)
     {
         case TBYTE:
-            runningAverageStdDev<uint8_t>();
+            calculateStats<uint8_t>();
             break;
 
         case TSHORT:
-            runningAverageStdDev<int16_t>();
+            calculateStats<int16_t>();
             break;
 
         case TUSHORT:
-            runningAverageStdDev<uint16_t>();
+            calculateStats<uint16_t>();
             break;
 
         case TLONG:
-            runningAverageStdDev<int32_t>();
+            calculateStats<int32_t>();
             break;
 
         case TULONG:
-            runningAverageStdDev<uint32_t>();
+            calculateStats<uint32_t>();
             break;
 
         case TFLOAT:
-            runningAverageStdDev<float>();
+            calculateStats<float>();
             break;
 
         case TLONGLONG:
-            runningAverageStdDev<int64_t>();
+            calculateStats<int64_t>();
             break;
 
         case TDOUBLE:
-            runningAverageStdDev<double>();
+            calculateStats<double>();
             break;
 
         default:
             return;
     }
 
+    // Unless refreshing, the data range of the header prevails over the measured one, unless both are zero
+    int status = 0;
+    double dataMin = 0, dataMax = 0;
+    if (fptr != nullptr && !refresh &&
+            fits_read_key_dbl(fptr, "DATAMIN", &dataMin, nullptr, &status) == 0 &&
+            fits_read_key_dbl(fptr, "DATAMAX", &dataMax, nullptr, &status) == 0 &&
+            !(dataMin == 0 && dataMax == 0))
+    {
+        stats.min[0] = dataMin;
+        stats.max[0] = dataMax;
+    }
+
     // FIXME That's not really SNR, must implement a proper solution for this value
     stats.SNR = stats.mean[0] / stats.stddev[0];
 
@@ -597,209 +666,256 @@ void FITSData::calculateStats(bool refresh)
         starsSearched = false;
 }
 
-int FITSData::calculateMinMax(bool refresh)
+namespace
 {
-    int status, nfound = 0;
-
-    status = 0;
-
-    if ((fptr != nullptr) && !refresh)
-    {
-        if (fits_read_key_dbl(fptr, "DATAMIN", &(stats.min[0]), nullptr, &status) == 0)
-            nfound++;
-
-        if (fits_read_key_dbl(fptr, "DATAMAX", &(stats.max[0]), nullptr, &status) == 0)
-            nfound++;
-
-        // If we found both keywords, no need to calculate them, unless they are both zeros
-        if (nfound == 2 && !(stats.min[0] == 0 && stats.max[0] == 0))
-            return 0;
-    }
-
-    stats.min[0] = 1.0E30;
-    stats.max[0] = -1.0E30;
-
-    stats.min[1] = 1.0E30;
-    stats.max[1] = -1.0E30;
+// Pixels processed at once: each tile is read from memory once, and from cache by the loops after the first one
+const uint32_t STATISTICS_TILE_SIZE = 16384;
+// Size of the sample giving the median and histogram of images with more than 16 bits per pixel
+const uint32_t STATISTICS_MAX_SAMPLES = 1000000;
+// Bins of the fine histogram of images with more than 16 bits per pixel
+const int STATISTICS_HISTOGRAM_BINS = 65536;
+
+// Statistics of consecutive tiles of a channel, merged with the others once all are done
+struct StatisticsPartition
+{
+    uint32_t start { 0 };
+    uint32_t end { 0 };
+    double min { 0 };
+    double max { 0 };
+    double mean { 0 };
+    // Sum of the squared deviations from the mean
+    double m2 { 0 };
+    uint32_t count { 0 };
+    QVector<uint32_t> histogram;
+    std::vector<double> samples;
+};
+
+// Merges the moments of a set of values into those of another set (Chan et al.)
+void mergeMoments(double &mean, double &m2, uint32_t &count, double otherMean, double otherM2, uint32_t otherCount)
+{
+    if (otherCount == 0)
+        return;
 
-    stats.min[2] = 1.0E30;
-    stats.max[2] = -1.0E30;
+    const double total = static_cast<double>(count) + otherCount;
+    const double delta = otherMean - mean;
+    mean += delta * otherCount / total;
+    m2 += otherM2 + delta * delta * count * otherCount / total;
+    count += otherCount;
+}
 
-    switch (m_DataType)
+// Moments of a tile of 8 or 16 bits integers, from exact integer sums. The loop has no branch, and the extrema
+// are kept in local variables rather than written through the references. GCC vectorizes it with the cost model
+// of -O3 only, which kstars/CMakeLists.txt enables for this file.
+template <typename T>
+void tileMoments(const T *tile, uint32_t count, T &min, T &max, double &mean, double &m2, std::true_type)
+{
+    T low = min, high = max;
+    int64_t sum = 0, squares = 0;
+    for (uint32_t i = 0; i < count; i++)
     {
-        case TBYTE:
-            calculateMinMax<uint8_t>();
-            break;
-
-        case TSHORT:
-            calculateMinMax<int16_t>();
-            break;
-
-        case TUSHORT:
-            calculateMinMax<uint16_t>();
-            break;
-
-        case TLONG:
-            calculateMinMax<int32_t>();
-            break;
-
-        case TULONG:
-            calculateMinMax<uint32_t>();
-            break;
-
-        case TFLOAT:
-            calculateMinMax<float>();
-            break;
-
-        case TLONGLONG:
-            calculateMinMax<int64_t>();
-            break;
-
-        case TDOUBLE:
-            calculateMinMax<double>();
-            break;
-
-        default:
-            break;
+        low = std::min(low, tile[i]);
+        high = std::max(high, tile[i]);
+        sum += tile[i];
+        squares += static_cast<int64_t>(tile[i]) * tile[i];
     }
+    min = low;
+    max = high;
 
-    //qDebug() << "DATAMIN: " << stats.min << " - DATAMAX: " << stats.max;
-    return 0;
+    mean = static_cast<double>(sum) / count;
+    m2 = std::max(0.0, squares - mean * sum);
 }
 
+// Moments of a tile of other types, the deviations being summed while the tile is in cache
 template <typename T>
-QPair<T, T> FITSData::getParitionMinMax(uint32_t start, uint32_t stride)
+void tileMoments(const T *tile, uint32_t count, T &min, T &max, double &mean, double &m2, std::false_type)
 {
-    auto * buffer = reinterpret_cast<T *>(m_ImageBuffer);
-    T min = std::numeric_limits<T>::max();
-    T max = std::numeric_limits<T>::min();
-
-    uint32_t end = start + stride;
+    T low = min, high = max;
+    double sum = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        low = std::min(low, tile[i]);
+        high = std::max(high, tile[i]);
+        sum += tile[i];
+    }
+    min = low;
+    max = high;
 
-    for (uint32_t i = start; i < end; i++)
+    const double average = sum / count;
+    double squares = 0;
+    for (uint32_t i = 0; i < count; i++)
     {
-        if (buffer[i] < min)
-            min = buffer[i];
-        else if (buffer[i] > max)
-            max = buffer[i];
+        const double deviation = tile[i] - average;
+        squares += deviation * deviation;
     }
 
-    return qMakePair(min, max);
+    mean = average;
+    m2 = squares;
+}
 }
 
 template <typename T>
-void FITSData::calculateMinMax()
+void FITSData::calculateStats()
 {
-    T min = std::numeric_limits<T>::max();
-    T max = std::numeric_limits<T>::min();
-
-    // Create N threads
-    const uint8_t nThreads = 16;
+    // 8 and 16 bits images get an exact histogram, with one bin per value. Others get the histogram of a sample,
+    // binned once the range is known.
+    typedef std::integral_constant<bool, std::is_integral<T>::value && sizeof(T) <= 2> Exact;
+    const int exactBins = Exact::value ? 1 << (8 * sizeof(T)) : 0;
+    const int exactOrigin = Exact::value ? static_cast<int>(std::numeric_limits<T>::lowest()) : 0;
+    const uint32_t samples = stats.samples_per_channel;
+    const uint32_t weight = (Exact::value || samples <= STATISTICS_MAX_SAMPLES) ? 1 : samples / STATISTICS_MAX_SAMPLES;
+
+    const uint32_t nThreads = std::max(1, QThread::idealThreadCount());
+    const uint32_t tiles = (samples + STATISTICS_TILE_SIZE - 1) / STATISTICS_TILE_SIZE;
+    // Partitions are not too small, as merging their histograms costs as much as counting 65536 pixels
+    const uint32_t tilesPerPartition = std::max<uint32_t>(8, (tiles + nThreads - 1) / nThreads);
 
     for (int n = 0; n < m_Channels; n++)
     {
-        uint32_t cStart = n * stats.samples_per_channel;
-
-        // Calculate how many elements we process per thread
-        uint32_t tStride = stats.samples_per_channel / nThreads;
-
-        // Calculate the final stride since we can have some left over due to division above
-        uint32_t fStride = tStride + (stats.samples_per_channel - (tStride * nThreads));
+        const T * const channel = reinterpret_cast<const T *>(m_ImageBuffer) + n * samples;
 
-        // Start location for inspecting elements
-        uint32_t tStart = cStart;
-
-        // List of futures
-        QList<QFuture<QPair<T, T>>> futures;
-
-        for (int i = 0; i < nThreads; i++)
+        QVector<StatisticsPartition> partitions;
+        for (uint32_t tile = 0; tile < tiles; tile += tilesPerPartition)
         {
-            // Run threads
-            futures.append(QtConcurrent::run(this, &FITSData::getParitionMinMax<T>, tStart, (i == (nThreads - 1)) ? fStride : tStride));
-            tStart += tStride;
+            StatisticsPartition partition;
+            partition.start = tile * STATISTICS_TILE_SIZE;
+            partition.end   = std::min(samples, (tile + tilesPerPartition) * STATISTICS_TILE_SIZE);
+            partitions.append(partition);
         }
 
-        // Now wait for results
-        for (int i = 0; i < nThreads; i++)
+        std::function<void(StatisticsPartition &)> accumulate = [&](StatisticsPartition & partition)
         {
-            QPair<T, T> result = futures[i].result();
-            if (result.first < min)
-                min = result.first;
-            if (result.second > max)
-                max = result.second;
-        }
+            T min = std::numeric_limits<T>::max();
+            T max = std::numeric_limits<T>::lowest();
 
-        stats.min[n] = min;
-        stats.max[n] = max;
-    }
-}
+            if (Exact::value)
+                partition.histogram.fill(0, exactBins);
+            else
+                partition.samples.reserve((partition.end - partition.start) / weight + 1);
 
-template <typename T>
-QPair<double, double> FITSData::getSquaredSumAndMean(uint32_t start, uint32_t stride)
-{
-    uint32_t m_n       = 2;
-    double m_oldM = 0, m_newM = 0, m_oldS = 0, m_newS = 0;
+            for (uint32_t start = partition.start; start < partition.end; start += STATISTICS_TILE_SIZE)
+            {
+                const uint32_t count = std::min(partition.end - start, STATISTICS_TILE_SIZE);
+                const T * const tile = channel + start;
 
-    auto * buffer = reinterpret_cast<T *>(m_ImageBuffer);
-    uint32_t end = start + stride;
+                double mean = 0, m2 = 0;
+                tileMoments(tile, count, min, max, mean, m2, Exact());
+                mergeMoments(partition.mean, partition.m2, partition.count, mean, m2, count);
 
-    for (uint32_t i = start; i < end; i++)
-    {
-        m_newM = m_oldM + (buffer[i] - m_oldM) / m_n;
-        m_newS = m_oldS + (buffer[i] - m_oldM) * (buffer[i] - m_newM);
+                if (Exact::value)
+                {
+                    uint32_t * const histogram = partition.histogram.data();
+                    for (uint32_t i = 0; i < count; i++)
+                        histogram[static_cast<int>(tile[i]) - exactOrigin]++;
+                }
+                else
+                {
+                    // NaN and infinite pixels have no place in the histogram or the median
+                    for (uint32_t i = (start + weight - 1) / weight * weight; i < start + count; i += weight)
+                        if (std::isfinite(static_cast<double>(channel[i])))
+                            partition.samples.push_back(channel[i]);
+                }
+            }
 
-        m_oldM = m_newM;
-        m_oldS = m_newS;
-        m_n++;
-    }
+            partition.min = min;
+            partition.max = max;
+        };
 
-    return qMakePair<double, double>(m_newM, m_newS);
-}
+        QtConcurrent::blockingMap(partitions, accumulate);
 
-template <typename T>
-void FITSData::runningAverageStdDev()
-{
-    // Create N threads
-    const uint8_t nThreads = 16;
+        double min = 1.0E30, max = -1.0E30, mean = 0, m2 = 0;
+        uint32_t count = 0;
+        QVector<uint32_t> histogram(Exact::value ? exactBins : STATISTICS_HISTOGRAM_BINS, 0);
+        std::vector<double> sample;
 
-    for (int n = 0; n < m_Channels; n++)
-    {
-        uint32_t cStart = n * stats.samples_per_channel;
-
-        // Calculate how many elements we process per thread
-        uint32_t tStride = stats.samples_per_channel / nThreads;
+        for (const StatisticsPartition &partition : partitions)
+        {
+            min = std::min(min, partition.min);
+            max = std::max(max, partition.max);
+            mergeMoments(mean, m2, count, partition.mean, partition.m2, partition.count);
 
-        // Calculate the final stride since we can have some left over due to division above
-        uint32_t fStride = tStride + (stats.samples_per_channel - (tStride * nThreads));
+            if (Exact::value)
+            {
+                for (int i = 0; i < exactBins; i++)
+                    histogram[i] += partition.histogram[i];
+            }
+            else
+                sample.insert(sample.end(), partition.samples.begin(), partition.samples.end());
+        }
 
-        // Start location for inspecting elements
-        uint32_t tStart = cStart;
+        stats.min[n]    = min;
+        stats.max[n]    = max;
+        stats.mean[n]   = mean;
+        stats.stddev[n] = count > 0 ? sqrt(m2 / count) : 0;
+        stats.median[n] = 0;
+        stats.histogramWeight[n] = weight;
 
-        // List of futures
-        QList<QFuture<QPair<double, double>>> futures;
+        if (Exact::value)
+        {
+            // Exact median, the upper one for an even number of pixels
+            stats.histogramOrigin[n] = exactOrigin;
+            stats.histogramScale[n]  = 1;
 
-        for (int i = 0; i < nThreads; i++)
+            uint32_t cumulative = 0;
+            for (int i = 0; i < exactBins; i++)
+            {
+                cumulative += histogram[i];
+                if (cumulative > count / 2)
+                {
+                    stats.median[n] = exactOrigin + i;
+                    break;
+                }
+            }
+        }
+        else if (!sample.empty())
         {
-            // Run threads
-            futures.append(QtConcurrent::run(this, &FITSData::getSquaredSumAndMean<T>, tStart, (i == (nThreads - 1)) ? fStride : tStride));
-            tStart += tStride;
+            // Bin over the range of the finite samples, min and max may include infinities
+            const auto range  = std::minmax_element(sample.begin(), sample.end());
+            const double low  = *range.first;
+            const double high = *range.second;
+            stats.histogramOrigin[n] = low;
+            stats.histogramScale[n]  = high > low ? (STATISTICS_HISTOGRAM_BINS - 1) / (high - low) : 1;
+
+            for (double value : sample)
+            {
+                const int bin = static_cast<int>(rint((value - low) * stats.histogramScale[n]));
+                histogram[qBound(0, bin, STATISTICS_HISTOGRAM_BINS - 1)]++;
+            }
+
+            // Median of the sample, exact unless the channel has more than STATISTICS_MAX_SAMPLES pixels
+            auto middle = sample.begin() + sample.size() / 2;
+            std::nth_element(sample.begin(), middle, sample.end());
+            stats.median[n] = *middle;
         }
 
-        double mean = 0, squared_sum = 0;
+        stats.histogram[n] = histogram;
+    }
+}
 
-        // Now wait for results
-        for (int i = 0; i < nThreads; i++)
-        {
-            QPair<double, double> result = futures[i].result();
-            mean += result.first;
-            squared_sum += result.second;
-        }
+bool FITSData::getHistogram(QVector<double> &frequency, uint16_t binCount, uint8_t channel) const
+{
+    const QVector<uint32_t> &fine = stats.histogram[channel];
+    if (fine.isEmpty() || binCount == 0)
+        return false;
 
-        double variance = squared_sum / stats.samples_per_channel;
+    frequency.fill(0, binCount);
 
-        stats.mean[n]   = mean / nThreads;
-        stats.stddev[n] = sqrt(variance);
+    const double min = stats.min[channel];
+    const double binWidth = binCount > 1 ? (stats.max[channel] - min) / (binCount - 1) : 0;
+    const double origin = stats.histogramOrigin[channel];
+    const double scale = stats.histogramScale[channel];
+    const double weight = stats.histogramWeight[channel];
+
+    for (int i = 0; i < fine.size(); i++)
+    {
+        if (fine[i] == 0)
+            continue;
+
+        int id = binWidth > 0 ? static_cast<int>(rint((origin + i / scale - min) / binWidth)) : 0;
+        id = qBound(0, id, binCount - 1);
+        frequency[id] += fine[i] * weight;
     }
+
+    return true;
 }
 
 void FITSData::setMinMax(double newMin, double newMax, uint8_t channel)
@@ -813,7 +929,8 @@ bool FITSData::parseHeader()
     char * header = nullptr;
     int status = 0, nkeys = 0;
 
-    if (fits_hdr2str(fptr, 0, nullptr, 0, &header, &nkeys, &status))
+    // For tile-compressed images, the keywords are those of the uncompressed image
+    if (fits_convert_hdr2str(fptr, 0, nullptr, 0, &header, &nkeys, &status))
     {
         fits_report_error(stderr, status);
         free(header);
@@ -1872,6 +1989,85 @@ double FITSData::getHFR(int x, int y)
     return -1;
 }
 
+namespace
+{
+// Rows of a channel filtered by one thread
+struct FilterBand
+{
+    uint32_t channel { 0 };
+    uint32_t firstRow { 0 };
+    uint32_t endRow { 0 };
+};
+
+// Splits the channels of an image in bands of rows, a few per thread to balance the load
+QVector<FilterBand> filterBands(uint32_t channels, uint32_t height)
+{
+    const uint32_t count = 4 * std::max(1, QThread::idealThreadCount());
+    const uint32_t rows = std::max<uint32_t>(16, (height + count - 1) / count);
+
+    QVector<FilterBand> bands;
+    for (uint32_t n = 0; n < channels; n++)
+    {
+        for (uint32_t row = 0; row < height; row += rows)
+        {
+            FilterBand band;
+            band.channel  = n;
+            band.firstRow = row;
+            band.endRow   = std::min(height, row + rows);
+            bands.append(band);
+        }
+    }
+
+    return bands;
+}
+
+template <typename T>
+inline void sortPair(T &a, T &b)
+{
+    const T low = std::min(a, b);
+    b = std::max(a, b);
+    a = low;
+}
+
+// Median filter of a row, from the rows above, at and below it padded with one pixel on each side.
+// The median of 9 uses the 19 exchanges of the optimal sorting network, without branches. The rows do not
+// overlap and x is a size_t, so the compiler can prove that x + 1 and x + 2 do not wrap. GCC vectorizes the loop
+// with the cost model of -O3 only, which kstars/CMakeLists.txt enables for this file.
+template <typename T>
+void median3x3Row(const T * __restrict above, const T * __restrict current, const T * __restrict below,
+                  T * __restrict output, size_t width)
+{
+    for (size_t x = 0; x < width; x++)
+    {
+        T p0 = above[x], p1 = above[x + 1], p2 = above[x + 2];
+        T p3 = current[x], p4 = current[x + 1], p5 = current[x + 2];
+        T p6 = below[x], p7 = below[x + 1], p8 = below[x + 2];
+
+        sortPair(p1, p2);
+        sortPair(p4, p5);
+        sortPair(p7, p8);
+        sortPair(p0, p1);
+        sortPair(p3, p4);
+        sortPair(p6, p7);
+        sortPair(p1, p2);
+        sortPair(p4, p5);
+        sortPair(p7, p8);
+        sortPair(p0, p3);
+        sortPair(p5, p8);
+        sortPair(p4, p7);
+        sortPair(p3, p6);
+        sortPair(p1, p4);
+        sortPair(p2, p5);
+        sortPair(p4, p7);
+        sortPair(p4, p2);
+        sortPair(p6, p4);
+        sortPair(p4, p2);
+
+        output[x] = p4;
+    }
+}
+}
+
 void FITSData::applyFilter(FITSScale type, uint8_t * image, QVector<double> * min, QVector<double> * max)
 {
     if (type == FITS_NONE)
@@ -2017,6 +2213,9 @@ void FITSData::applyFilter(FITSScale type, uint8_t * image, QVector<double> * mi
             return;
     }
 
+    // The image may have been filtered in place
+    imageBufferChanged();
+
     if (min != nullptr)
         *min = dataMin;
     if (max != nullptr)
@@ -2044,10 +2243,6 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
         max[i] = (*targetMax)[i] > std::numeric_limits<T>::max() ? std::numeric_limits<T>::max() : (*targetMax)[i];
     }
 
-
-    // Create N threads
-    const uint8_t nThreads = 16;
-
     uint32_t width  = stats.width;
     uint32_t height = stats.height;
 
@@ -2063,8 +2258,6 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
         case FITS_SQRT:
         case FITS_HIGH_PASS:
         {
-            // List of futures
-            QList<QFuture<void>> futures;
             QVector<double> coeff(3);
 
             if (type == FITS_LOG)
@@ -2078,74 +2271,49 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
                     coeff[i] = max[i] / sqrt(max[i]);
             }
 
-            for (int n = 0; n < m_Channels; n++)
+            if (type == FITS_HIGH_PASS)
             {
-                if (type == FITS_HIGH_PASS)
+                for (int n = 0; n < m_Channels; n++)
                     min[n] = stats.mean[n];
+            }
 
-                uint32_t cStart = n * stats.samples_per_channel;
-
-                // Calculate how many elements we process per thread
-                uint32_t tStride = stats.samples_per_channel / nThreads;
-
-                // Calculate the final stride since we can have some left over due to division above
-                uint32_t fStride = tStride + (stats.samples_per_channel - (tStride * nThreads));
-
-                T * runningBuffer = image + cStart;
+            // Each thread transforms whole rows in place
+            std::function<void(FilterBand &)> filterBand = [&](FilterBand & band)
+            {
+                const int n = band.channel;
+                const T low = min[n], high = max[n];
+                const double c = coeff[n];
+                T * const begin = image + n * stats.samples_per_channel + band.firstRow * width;
+                T * const end = image + n * stats.samples_per_channel + band.endRow * width;
 
                 if (type == FITS_LOG)
                 {
-                    for (int i = 0; i < nThreads; i++)
-                    {
-                        // Run threads
-                        futures.append(QtConcurrent::map(runningBuffer, (runningBuffer + ((i == (nThreads - 1)) ? fStride : tStride)), [min, max, coeff, n](T & a)
-                        {
-                            a = qBound(min[n], static_cast<T>(round(coeff[n] * std::log(1 + qBound(min[n], a, max[n])))), max[n]);
-                        }));
-
-                        runningBuffer += tStride;
-                    }
+                    for (T * a = begin; a < end; a++)
+                        *a = qBound(low, static_cast<T>(round(c * std::log(1 + qBound(low, *a, high)))), high);
                 }
                 else if (type == FITS_SQRT)
                 {
-                    for (int i = 0; i < nThreads; i++)
-                    {
-                        // Run threads
-                        futures.append(QtConcurrent::map(runningBuffer, (runningBuffer + ((i == (nThreads - 1)) ? fStride : tStride)), [min, max, coeff, n](T & a)
-                        {
-                            a = qBound(min[n], static_cast<T>(round(coeff[n] * a)), max[n]);
-                        }));
-                    }
-
-                    runningBuffer += tStride;
+                    for (T * a = begin; a < end; a++)
+                        *a = qBound(low, static_cast<T>(round(c * *a)), high);
                 }
                 else
                 {
-                    for (int i = 0; i < nThreads; i++)
-                    {
-                        // Run threads
-                        futures.append(QtConcurrent::map(runningBuffer, (runningBuffer + ((i == (nThreads - 1)) ? fStride : tStride)), [min, max, n](T & a)
-                        {
-                            a = qBound(min[n], a, max[n]);
-                        }));
-                        runningBuffer += tStride;
-                    }
+                    for (T * a = begin; a < end; a++)
+                        *a = std::min(std::max(*a, low), high);
                 }
-            }
+            };
 
-            for (int i = 0; i < nThreads * m_Channels; i++)
-                futures[i].waitForFinished();
+            QVector<FilterBand> bands = filterBands(m_Channels, height);
+            QtConcurrent::blockingMap(bands, filterBand);
 
             if (calcStats)
             {
+                calculateStats<T>();
                 for (int i = 0; i < 3; i++)
                 {
                     stats.min[i] = min[i];
                     stats.max[i] = max[i];
                 }
-                //if (type != FITS_AUTO && type != FITS_LINEAR)
-                runningAverageStdDev<T>();
-                //QtConcurrent::run(this, &FITSData::runningAverageStdDev<T>);
             }
         }
         break;
@@ -2159,101 +2327,91 @@ void FITSData::applyFilter(FITSScale type, uint8_t * targetImage, QVector<double
             if (!histogram->isConstructed())
                 histogram->constructHistogram();
 
-            T bufferVal                    = 0;
-            QVector<uint32_t> cumulativeFreq = histogram->getCumulativeFrequency();
+            const QVector<uint32_t> cumulativeFreq = histogram->getCumulativeFrequency();
+            const double coeff = 255.0 / (height * width);
 
-            double coeff = 255.0 / (height * width);
-            uint32_t row = 0;
-            uint32_t index = 0;
-
-            for (int i = 0; i < m_Channels; i++)
+            std::function<void(FilterBand &)> equalizeBand = [&](FilterBand & band)
             {
-                uint32_t offset = i * stats.samples_per_channel;
-                for (uint32_t j = 0; j < height; j++)
-                {
-                    row = offset + j * width;
-                    for (uint32_t k = 0; k < width; k++)
-                    {
-                        index     = k + row;
-                        bufferVal = (image[index] - min[i]) / histogram->getBinWidth(i);
-
-                        if (bufferVal >= cumulativeFreq.size())
-                            bufferVal = cumulativeFreq.size() - 1;
+                const int n = band.channel;
+                const double binWidth = histogram->getBinWidth(n);
+                T * const begin = image + n * stats.samples_per_channel + band.firstRow * width;
+                T * const end = image + n * stats.samples_per_channel + band.endRow * width;
 
-                        image[index] = qBound(min[i], static_cast<T>(round(coeff * cumulativeFreq[bufferVal])), max[i]);
-                    }
+                for (T * a = begin; a < end; a++)
+                {
+                    const int bin = qBound(0, static_cast<int>((*a - min[n]) / binWidth), cumulativeFreq.size() - 1);
+                    *a = qBound(min[n], static_cast<T>(round(coeff * cumulativeFreq[bin])), max[n]);
                 }
-            }
+            };
+
+            QVector<FilterBand> bands = filterBands(m_Channels, height);
+            QtConcurrent::blockingMap(bands, equalizeBand);
 #endif
         }
         if (calcStats)
             calculateStats(true);
         break;
 
-        // Based on http://www.librow.com/articles/article-1
         case FITS_MEDIAN:
         {
-            uint8_t BBP      = stats.bytesPerPixel;
-            auto * extension = new T[(width + 2) * (height + 2)];
-            //   Check memory allocation
-            if (!extension)
-                return;
-            //   Create image extension
-            for (uint32_t ch = 0; ch < m_Channels; ch++)
+            // 3x3 median with replicated edges, in place. Each band keeps a copy of the rows around the one it filters,
+            // and the rows bordering the other bands are saved before any is modified.
+            const uint32_t paddedWidth = width + 2;
+            QVector<FilterBand> bands = filterBands(m_Channels, height);
+
+            // Copy of a row of the original image, with its edge pixels replicated
+            auto padRow = [&](const T * row, T * padded)
             {
-                uint32_t offset = ch * stats.samples_per_channel;
-                uint32_t N = width, M = height;
+                memcpy(padded + 1, row, width * sizeof(T));
+                padded[0] = row[0];
+                padded[width + 1] = row[width - 1];
+            };
 
-                for (uint32_t i = 0; i < M; ++i)
+            std::vector<T> borders(bands.size() * 2 * paddedWidth);
+            for (int i = 0; i < bands.size(); i++)
+            {
+                const T * const channel = image + bands[i].channel * stats.samples_per_channel;
+                const uint32_t above = bands[i].firstRow > 0 ? bands[i].firstRow - 1 : 0;
+                const uint32_t below = std::min(bands[i].endRow, height - 1);
+                padRow(channel + above * width, borders.data() + 2 * i * paddedWidth);
+                padRow(channel + below * width, borders.data() + (2 * i + 1) * paddedWidth);
+            }
+
+            const FilterBand * const firstBand = bands.constData();
+            std::function<void(FilterBand &)> medianBand = [&](FilterBand & band)
+            {
+                const int i = &band - firstBand;
+                T * const channel = image + band.channel * stats.samples_per_channel;
+
+                // Rolling window of the original rows above, at and below the current row
+                std::vector<T> lines(3 * paddedWidth);
+                T * above = lines.data();
+                T * current = above + paddedWidth;
+                T * below = current + paddedWidth;
+
+                memcpy(above, borders.data() + 2 * i * paddedWidth, paddedWidth * sizeof(T));
+                padRow(channel + band.firstRow * width, current);
+
+                for (uint32_t y = band.firstRow; y < band.endRow; y++)
                 {
-                    memcpy(extension + (N + 2) * (i + 1) + 1, image + (N * i) + offset, N * BBP);
-                    extension[(N + 2) * (i + 1)]     = image[N * i + offset];
-                    extension[(N + 2) * (i + 2) - 1] = image[N * (i + 1) - 1 + offset];
+                    if (y + 1 >= band.endRow)
+                        memcpy(below, borders.data() + (2 * i + 1) * paddedWidth, paddedWidth * sizeof(T));
+                    else
+                        padRow(channel + (y + 1) * width, below);
+
+                    median3x3Row(above, current, below, channel + y * width, width);
+
+                    T * const recycled = above;
+                    above = current;
+                    current = below;
+                    below = recycled;
                 }
-                //   Fill first line of image extension
-                memcpy(extension, extension + N + 2, (N + 2) * BBP);
-                //   Fill last line of image extension
-                memcpy(extension + (N + 2) * (M + 1), extension + (N + 2) * M, (N + 2) * BBP);
-                //   Call median filter implementation
-
-                N = width + 2;
-                M = height + 2;
-
-                //   Move window through all elements of the image
-                for (uint32_t m = 1; m < M - 1; ++m)
-                    for (uint32_t n = 1; n < N - 1; ++n)
-                    {
-                        //   Pick up window elements
-                        int k = 0;
-                        float window[9];
-
-                        memset(&window[0], 0, 9 * sizeof(float));
-                        for (uint32_t j = m - 1; j < m + 2; ++j)
-                            for (uint32_t i = n - 1; i < n + 2; ++i)
-                                window[k++] = extension[j * N + i];
-                        //   Order elements (only half of them)
-                        for (uint32_t j = 0; j < 5; ++j)
-                        {
-                            //   Find position of minimum element
-                            int mine = j;
-                            for (uint32_t l = j + 1; l < 9; ++l)
-                                if (window[l] < window[mine])
-                                    mine = l;
-                            //   Put found minimum element in its place
-                            const float temp = window[j];
-                            window[j]        = window[mine];
-                            window[mine]     = temp;
-                        }
-                        //   Get result - the middle element
-                        image[(m - 1) * (N - 2) + n - 1 + offset] = window[4];
-                    }
-            }
+            };
 
-            //   Free memory
-            delete[] extension;
+            QtConcurrent::blockingMap(bands, medianBand);
 
             if (calcStats)
-                runningAverageStdDev<T>();
+                calculateStats<T>();
         }
         break;
 
@@ -2328,13 +2486,14 @@ bool FITSData::checkForWCS()
     int nkeyrec, nreject;
 
     // Free wcs before re-use
+    m_WCSGrid.reset();
     if (m_wcs != nullptr)
     {
         wcsvfree(&m_nwcs, &m_wcs);
         m_wcs = nullptr;
     }
 
-    if (fits_hdr2str(fptr, 1, nullptr, 0, &header, &nkeyrec, &status))
+    if (fits_convert_hdr2str(fptr, 1, nullptr, 0, &header, &nkeyrec, &status))
     {
         char errmsg[512];
         fits_get_errstatus(status, errmsg);
@@ -2391,6 +2550,7 @@ bool FITSData::loadWCS()
         return true;
     }
 
+    m_WCSGrid.reset();
     if (m_wcs != nullptr)
     {
         wcsvfree(&m_nwcs, &m_wcs);
@@ -2403,10 +2563,8 @@ bool FITSData::loadWCS()
     char * header;
     int nkeyrec, nreject, nwcs, stat[2];
     double imgcrd[2], phi = 0, pixcrd[2], theta = 0, world[2];
-    int w  = width();
-    int h = height();
 
-    if (fits_hdr2str(fptr, 1, nullptr, 0, &header, &nkeyrec, &status))
+    if (fits_convert_hdr2str(fptr, 1, nullptr, 0, &header, &nkeyrec, &status))
     {
         char errmsg[512];
         fits_get_errstatus(status, errmsg);
@@ -2448,40 +2606,8 @@ bool FITSData::loadWCS()
         return false;
     }
 
-    delete[] wcs_coord;
-
-    wcs_coord = new wcs_point[w * h];
-
-    if (wcs_coord == nullptr)
-    {
-        wcsvfree(&m_nwcs, &m_wcs);
-        m_wcs = nullptr;
-        lastError = "Not enough memory for WCS data!";
-        return false;
-    }
-
-    wcs_point * p = wcs_coord;
-
-    for (int i = 0; i < h; i++)
-    {
-        for (int j = 0; j < w; j++)
-        {
-            pixcrd[0] = j;
-            pixcrd[1] = i;
-
-            if ((status = wcsp2s(m_wcs, 1, 2, &pixcrd[0], &imgcrd[0], &phi, &theta, &world[0], &stat[0])) != 0)
-            {
-                lastError = QString("wcsp2s error %1: %2.").arg(status).arg(wcs_errmsg[status]);
-            }
-            else
-            {
-                p->ra  = world[0];
-                p->dec = world[1];
-
-                p++;
-            }
-        }
-    }
+    // Pixel coordinates are only computed when they are looked up
+    m_WCSGrid.reset(new FITSWCSGrid(m_wcs, width(), height()));
 
     findObjectsInImage(&world[0], phi, theta, &imgcrd[0], &pixcrd[0], &stat[0]);
 
@@ -2546,6 +2672,19 @@ bool FITSData::pixelToWCS(const QPointF &wcsPixelPoint, SkyPoint &wcsCoord)
         return false;
     }
 
+    if (m_WCSGrid)
+    {
+        if (!m_WCSGrid->pixelToWorld(wcsPixelPoint.x(), wcsPixelPoint.y(), world[0], world[1]))
+        {
+            lastError = i18n("Pixel has no valid world coordinates.");
+            return false;
+        }
+
+        wcsCoord.setRA0(world[0] / 15.0);
+        wcsCoord.setDec0(world[1]);
+        return true;
+    }
+
     pixcrd[0] = wcsPixelPoint.x();
     pixcrd[1] = wcsPixelPoint.y();
 
@@ -2568,6 +2707,25 @@ bool FITSData::pixelToWCS(const QPointF &wcsPixelPoint, SkyPoint &wcsCoord)
 #endif
 }
 
+bool FITSData::wcsBounds(double &minRA, double &maxRA, double &minDec, double &maxDec)
+{
+#if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
+    if (!m_WCSGrid)
+    {
+        lastError = i18n("No world coordinate systems found.");
+        return false;
+    }
+
+    return m_WCSGrid->bounds(minRA, maxRA, minDec, maxDec);
+#else
+    Q_UNUSED(minRA);
+    Q_UNUSED(maxRA);
+    Q_UNUSED(minDec);
+    Q_UNUSED(maxDec);
+    return false;
+#endif
+}
+
 #if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
 void FITSData::findObjectsInImage(double world[], double phi, double theta, double imgcrd[], double pixcrd[],
                                   int stat[])
@@ -2595,20 +2753,12 @@ void FITSData::findObjectsInImage(double world[], double phi, double theta, doub
 
     SkyMapComposite * map = KStarsData::Instance()->skyComposite();
 
-    wcs_point * wcs_coord = getWCSCoord();
-    if (wcs_coord != nullptr)
+    SkyPoint p1, p2;
+    if (m_WCSGrid && pixelToWCS(QPointF(0, 0), p1) && pixelToWCS(QPointF(w - 1, h - 1), p2))
     {
-        int size = w * h;
-
         objList.clear();
 
-        SkyPoint p1;
-        p1.setRA0(dms(wcs_coord[0].ra));
-        p1.setDec0(dms(wcs_coord[0].dec));
         p1.updateCoordsNow(num);
-        SkyPoint p2;
-        p2.setRA0(dms(wcs_coord[size - 1].ra));
-        p2.setDec0(dms(wcs_coord[size - 1].dec));
         p2.updateCoordsNow(num);
         QList<SkyObject *> list = map->findObjectsInArea(p1, p2);
 
@@ -2620,6 +2770,7 @@ void FITSData::findObjectsInImage(double world[], double phi, double theta, doub
                     type == SkyObject::SATELLITE)
             {
                 //DO NOT DISPLAY, at least for now, because these things move and change.
+                continue;
             }
 
             int x = -100;
@@ -2967,6 +3118,7 @@ bool FITSData::rotFITS(int rotate, int mirror)
 
     delete[] m_ImageBuffer;
     m_ImageBuffer = rotimage;
+    imageBufferChanged();
 
     return true;
 }
@@ -3263,6 +3415,76 @@ void FITSData::setImageBuffer(uint8_t * buffer)
 {
     delete[] m_ImageBuffer;
     m_ImageBuffer = buffer;
+    imageBufferChanged();
+}
+
+void FITSData::imageBufferChanged()
+{
+    m_FloatImageValid = false;
+}
+
+const float * FITSData::getFloatImage()
+{
+    if (m_ImageBuffer == nullptr)
+        return nullptr;
+
+    if (m_DataType == TFLOAT)
+        return reinterpret_cast<const float *>(m_ImageBuffer);
+
+    if (m_FloatImageValid)
+        return m_FloatImage.data();
+
+    if (m_FloatImage.capacity() < stats.samples_per_channel)
+    {
+        releaseFloatImage(m_FloatImage);
+        acquireFloatImage(m_FloatImage, stats.samples_per_channel);
+    }
+    else
+        m_FloatImage.resize(stats.samples_per_channel);
+
+    switch (m_DataType)
+    {
+        case TBYTE:
+            convertToFloat<uint8_t>();
+            break;
+
+        case TSHORT:
+            convertToFloat<int16_t>();
+            break;
+
+        case TUSHORT:
+            convertToFloat<uint16_t>();
+            break;
+
+        case TLONG:
+            convertToFloat<int32_t>();
+            break;
+
+        case TULONG:
+            convertToFloat<uint32_t>();
+            break;
+
+        case TLONGLONG:
+            convertToFloat<int64_t>();
+            break;
+
+        case TDOUBLE:
+            convertToFloat<double>();
+            break;
+
+        default:
+            return nullptr;
+    }
+
+    m_FloatImageValid = true;
+    return m_FloatImage.data();
+}
+
+template <typename T>
+void FITSData::convertToFloat()
+{
+    const T * buffer = getPixels<T>();
+    std::copy(buffer, buffer + stats.samples_per_channel, m_FloatImage.begin());
 }
 
 bool FITSData::checkDebayer()
@@ -3367,6 +3589,8 @@ bool FITSData::debayer()
     //        }
     //    }
 
+    imageBufferChanged();
+
     switch (m_DataType)
     {
         case TBYTE:
@@ -3562,75 +3786,102 @@ void FITSData::sobel(QVector<float> &gradient, QVector<float> &direction)
     gradient.resize(stats.samples_per_channel);
     direction.resize(stats.samples_per_channel);
 
-    for (int y = 0; y < stats.height; y++)
+    const int width = stats.width, height = stats.height;
+    const T * const image = reinterpret_cast<T *>(m_ImageBuffer);
+    float * const gradientData = gradient.data();
+    float * const directionData = direction.data();
+
+    // Both kernels are separable: rows are differentiated ([-1 0 1]) and smoothed ([1 2 1]) horizontally once,
+    // then combined vertically three at a time. Each thread handles a band of rows, keeping the passes of three rows.
+    std::function<void(FilterBand &)> sobelBand = [&](FilterBand & band)
     {
-        size_t yOffset    = y * stats.width;
-        const T * grayLine = reinterpret_cast<T *>(m_ImageBuffer) + yOffset;
+        std::vector<double> passes(6 * width);
+        double * diff[3] = { passes.data(), passes.data() + width, passes.data() + 2 * width };
+        double * smooth[3] = { passes.data() + 3 * width, passes.data() + 4 * width, passes.data() + 5 * width };
+
+        // Edge rows and columns are replicated
+        auto horizontalPass = [&](int y, double * diffLine, double * smoothLine)
+        {
+            const T * grayLine = image + qBound(0, y, height - 1) * width;
+            for (int x = 0; x < width; x++)
+            {
+                int x_m1 = x < 1 ? x : x - 1;
+                int x_p1 = x >= width - 1 ? x : x + 1;
 
-        const T * grayLine_m1 = y < 1 ? grayLine : grayLine - stats.width;
-        const T * grayLine_p1 = y >= stats.height - 1 ? grayLine : grayLine + stats.width;
+                diffLine[x]   = static_cast<double>(grayLine[x_p1]) - grayLine[x_m1];
+                smoothLine[x] = static_cast<double>(grayLine[x_m1]) + 2.0 * grayLine[x] + grayLine[x_p1];
+            }
+        };
 
-        float * gradientLine  = gradient.data() + yOffset;
-        float * directionLine = direction.data() + yOffset;
+        horizontalPass(static_cast<int>(band.firstRow) - 1, diff[0], smooth[0]);
+        horizontalPass(band.firstRow, diff[1], smooth[1]);
 
-        for (int x = 0; x < stats.width; x++)
+        for (int y = band.firstRow; y < static_cast<int>(band.endRow); y++)
         {
-            int x_m1 = x < 1 ? x : x - 1;
-            int x_p1 = x >= stats.width - 1 ? x : x + 1;
-
-            int gradX = grayLine_m1[x_p1] + 2 * grayLine[x_p1] + grayLine_p1[x_p1] - grayLine_m1[x_m1] -
-                        2 * grayLine[x_m1] - grayLine_p1[x_m1];
-
-            int gradY = grayLine_m1[x_m1] + 2 * grayLine_m1[x] + grayLine_m1[x_p1] - grayLine_p1[x_m1] -
-                        2 * grayLine_p1[x] - grayLine_p1[x_p1];
-
-            gradientLine[x] = qAbs(gradX) + qAbs(gradY);
-
-            /* Gradient directions are classified in 4 possible cases
-             *
-             * dir 0
-             *
-             * x x x
-             * - - -
-             * x x x
-             *
-             * dir 1
-             *
-             * x x /
-             * x / x
-             * / x x
-             *
-             * dir 2
-             *
-             * \ x x
-             * x \ x
-             * x x \
-             *
-             * dir 3
-             *
-             * x | x
-             * x | x
-             * x | x
-             */
-            if (gradX == 0 && gradY == 0)
-                directionLine[x] = 0;
-            else if (gradX == 0)
-                directionLine[x] = 3;
-            else
-            {
-                qreal a = 180. * atan(qreal(gradY) / gradX) / M_PI;
+            horizontalPass(y + 1, diff[2], smooth[2]);
+
+            float * gradientLine  = gradientData + y * width;
+            float * directionLine = directionData + y * width;
 
-                if (a >= -22.5 && a < 22.5)
+            for (int x = 0; x < width; x++)
+            {
+                int gradX = diff[0][x] + 2 * diff[1][x] + diff[2][x];
+                int gradY = smooth[0][x] - smooth[2][x];
+
+                gradientLine[x] = qAbs(gradX) + qAbs(gradY);
+
+                /* Gradient directions are classified in 4 possible cases
+                 *
+                 * dir 0
+                 *
+                 * x x x
+                 * - - -
+                 * x x x
+                 *
+                 * dir 1
+                 *
+                 * x x /
+                 * x / x
+                 * / x x
+                 *
+                 * dir 2
+                 *
+                 * \ x x
+                 * x \ x
+                 * x x \
+                 *
+                 * dir 3
+                 *
+                 * x | x
+                 * x | x
+                 * x | x
+                 */
+                if (gradX == 0 && gradY == 0)
                     directionLine[x] = 0;
-                else if (a >= 22.5 && a < 67.5)
-                    directionLine[x] = 2;
-                else if (a >= -67.5 && a < -22.5)
-                    directionLine[x] = 1;
-                else
+                else if (gradX == 0)
                     directionLine[x] = 3;
+                else
+                {
+                    qreal a = 180. * atan(qreal(gradY) / gradX) / M_PI;
+
+                    if (a >= -22.5 && a < 22.5)
+                        directionLine[x] = 0;
+                    else if (a >= 22.5 && a < 67.5)
+                        directionLine[x] = 2;
+                    else if (a >= -67.5 && a < -22.5)
+                        directionLine[x] = 1;
+                    else
+                        directionLine[x] = 3;
+                }
             }
+
+            std::rotate(diff, diff + 1, diff + 3);
+            std::rotate(smooth, smooth + 1, smooth + 3);
         }
-    }
+    };
+
+    QVector<FilterBand> bands = filterBands(1, height);
+    QtConcurrent::blockingMap(bands, sobelBand);
 }
 
 int FITSData::partition(int width, int height, QVector<float> &gradient, QVector<int> &ids)
@@ -3983,15 +4234,13 @@ bool FITSData::injectWCS(const QString &newWCSFile, double orientation, double r
         return false;
     }
 
-    if (fits_movabs_hdu(fptr, 1, &exttype, &status))
-    {
-        fits_get_errstatus(status, errMsg);
-        lastError = QString(errMsg);
-        fits_report_error(stderr, status);
-        return false;
-    }
+    // A tile-compressed image is written uncompressed, in the primary HDU of the new file
+    if (m_isCompressed)
+        fits_img_decompress(fptr, new_fptr, &status);
+    else if (fits_movabs_hdu(fptr, 1, &exttype, &status) == 0)
+        fits_copy_file(fptr, new_fptr, 1, 1, 1, &status);
 
-    if (fits_copy_file(fptr, new_fptr, 1, 1, 1, &status))
+    if (status)
     {
         fits_get_errstatus(status, errMsg);
         lastError = QString(errMsg);
@@ -4019,6 +4268,7 @@ bool FITSData::injectWCS(const QString &newWCSFile, double orientation, double r
 
     m_Filename = newWCSFile;
     m_isTemporary = true;
+    m_isCompressed = false;
 
     fptr = new_fptr;
 
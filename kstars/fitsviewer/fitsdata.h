@@ -35,6 +35,10 @@
 #include <QObject>
 #include <QRect>
 #include <QVariant>
+#include <QVector>
+
+#include <memory>
+#include <vector>
 
 #ifndef KSTARS_LITE
 #include <kxmlguiwindow.h>
@@ -51,12 +55,7 @@ class QProgressDialog;
 class SkyObject;
 class SkyPoint;
 class FITSHistogram;
-
-typedef struct
-{
-    float ra;
-    float dec;
-} wcs_point;
+class FITSWCSGrid;
 
 class Edge
 {
@@ -132,6 +131,12 @@ class FITSData : public QObject
             double mean[3] = {0};
             double stddev[3] = {0};
             double median[3] = {0};
+            /// Fine histogram of each channel, bin i counting the values closest to histogramOrigin + i / histogramScale
+            QVector<uint32_t> histogram[3];
+            double histogramOrigin[3] = {0};
+            double histogramScale[3] = {0};
+            /// Number of pixels each count of the histogram stands for, when it is built from a sample
+            uint32_t histogramWeight[3] = {1, 1, 1};
             double SNR { 0 };
             int bitpix { 8 };
             int bytesPerPixel { 1 };
@@ -173,6 +178,29 @@ class FITSData : public QObject
         void clearImageBuffers();
         void setImageBuffer(uint8_t *buffer);
         uint8_t *getImageBuffer();
+        /**
+         * @brief imageBufferChanged Must be called after modifying in place the buffer returned by getImageBuffer(),
+         * so that the views derived from it, such as getFloatImage(), are refreshed.
+         */
+        void imageBufferChanged();
+
+        /**
+         * @brief getPixels Typed, read-only access to the image buffer.
+         * @return pointer to the first pixel. T MUST match the dataType property.
+         */
+        template <typename T>
+        const T *getPixels() const
+        {
+            return reinterpret_cast<const T *>(m_ImageBuffer);
+        }
+
+        /**
+         * @brief getFloatImage First channel of the image as floats, e.g. for guiding. Float images are returned as is.
+         * Other types are converted on first use and the conversion is kept until the image buffer changes. Conversion
+         * buffers are recycled between FITSData instances, so that consecutive frames of the same size do not allocate.
+         * @return width() x height() floats owned by this object, or nullptr if there is no image or the type is unsupported.
+         */
+        const float *getFloatImage();
 
         // Statistics
         void saveStatistics(Statistic &other);
@@ -233,6 +261,17 @@ class FITSData : public QObject
             return stats.median[channel];
         }
 
+        /**
+         * @brief getHistogram Histogram of a channel between its minimum and maximum, built from the fine histogram
+         * computed by calculateStats() along with the other statistics, without reading the image again.
+         * @param frequency receives the number of pixels of each bin, values below or above the range are counted in
+         * the first or last bin
+         * @param binCount number of bins, the first centered on the minimum and the last on the maximum
+         * @param channel channel
+         * @return false if the statistics were not calculated
+         */
+        bool getHistogram(QVector<double> &frequency, uint16_t binCount, uint8_t channel = 0) const;
+
         int getBytesPerPixel() const
         {
             return stats.bytesPerPixel;
@@ -319,7 +358,7 @@ class FITSData : public QObject
         {
             return HasWCS;
         }
-        // Load WCS data
+        // Load WCS data. World coordinates of pixels are computed lazily, see FITSWCSGrid.
         bool loadWCS();
         // Is WCS Image loaded?
         bool isWCSLoaded()
@@ -327,11 +366,6 @@ class FITSData : public QObject
             return WCSLoaded;
         }
 
-        wcs_point *getWCSCoord()
-        {
-            return wcs_coord;
-        }
-
         /**
              * @brief wcsToPixel Given J2000 (RA0,DE0) coordinates. Find in the image the corresponding pixel coordinates.
              * @param wcsCoord Coordinates of target
@@ -349,6 +383,16 @@ class FITSData : public QObject
              */
         bool pixelToWCS(const QPointF &wcsPixelPoint, SkyPoint &wcsCoord);
 
+        /**
+             * @brief wcsBounds Range of J2000 world coordinates covered by the image. Requires loadWCS().
+             * @param minRA Minimum RA in degrees
+             * @param maxRA Maximum RA in degrees. RA is continuous across the image, so it may exceed 360.
+             * @param minDec Minimum declination in degrees
+             * @param maxDec Maximum declination in degrees
+             * @return True if successful, false otherwise.
+             */
+        bool wcsBounds(double &minRA, double &maxRA, double &minDec, double &maxDec);
+
         /**
              * @brief injectWCS Add WCS keywords to file
              * @param orientation Solver orientation, degrees E of N.
@@ -444,7 +488,6 @@ class FITSData : public QObject
         bool privateLoad(void *fits_buffer, size_t fits_buffer_size, bool silent);
         void rotWCSFITS(int angle, int mirror);
         bool checkCollision(Edge *s1, Edge *s2);
-        int calculateMinMax(bool refresh = false);
         bool checkDebayer();
         void readWCSKeys();
 
@@ -471,17 +514,12 @@ class FITSData : public QObject
         template <typename T>
         int findOneStar(const QRect &boundary);
 
+        /* Calculate min, max, mean, standard deviation, histogram and median of each channel in one pass */
         template <typename T>
-        void calculateMinMax();
+        void calculateStats();
 
         template <typename T>
-        QPair<T, T> getParitionMinMax(uint32_t start, uint32_t stride);
-
-        /* Calculate running average & standard deviation using Welford’s method for computing variance */
-        template <typename T>
-        void runningAverageStdDev();
-        template <typename T>
-        QPair<double, double> getSquaredSumAndMean(uint32_t start, uint32_t stride);
+        void convertToFloat();
 
         // Sobel detector by Gonzalo Exequiel Pedone
         template <typename T>
@@ -508,6 +546,10 @@ class FITSData : public QObject
         uint8_t *m_ImageBuffer { nullptr };
         /// Above buffer size in bytes
         uint32_t m_ImageBufferSize { 0 };
+        /// First channel of the image buffer converted to float, see getFloatImage()
+        std::vector<float> m_FloatImage;
+        /// Does m_FloatImage hold the current image buffer?
+        bool m_FloatImageValid { false };
         /// Is this a temporary file or one loaded from disk?
         bool m_isTemporary { false };
         /// is this file compress (.fits.fz)?
@@ -537,8 +579,10 @@ class FITSData : public QObject
         /// How many times the image was flipped vertically?
         int flipVCounter { 0 };
 
-        /// Pointer to WCS coordinate data, if any.
-        wcs_point *wcs_coord { nullptr };
+#if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
+        /// Lazily computed pixel to world coordinate lookup, if WCS data is loaded.
+        std::unique_ptr<FITSWCSGrid> m_WCSGrid;
+#endif
         /// WCS Struct
         struct wcsprm *m_wcs
         {
@@ -20,8 +20,12 @@
 
 #include <KMessageBox>
 
+#include <QDir>
 #include <QtConcurrent>
+#include <cstring>
+#include <functional>
 #include <type_traits>
+#include <vector>
 #include <zlib.h>
 
 histogramUI::histogramUI(QDialog * parent) : QDialog(parent)
@@ -136,59 +140,9 @@ void FITSHistogram::showEvent(QShowEvent * event)
 void FITSHistogram::constructHistogram()
 {
     FITSData * imageData = tab->getView()->getImageData();
-
-    isGUISynced = false;
-
-    switch (imageData->property("dataType").toInt())
-    {
-        case TBYTE:
-            constructHistogram<uint8_t>();
-            break;
-
-        case TSHORT:
-            constructHistogram<int16_t>();
-            break;
-
-        case TUSHORT:
-            constructHistogram<uint16_t>();
-            break;
-
-        case TLONG:
-            constructHistogram<int32_t>();
-            break;
-
-        case TULONG:
-            constructHistogram<uint32_t>();
-            break;
-
-        case TFLOAT:
-            constructHistogram<float>();
-            break;
-
-        case TLONGLONG:
-            constructHistogram<int64_t>();
-            break;
-
-        case TDOUBLE:
-            constructHistogram<double>();
-            break;
-
-        default:
-            break;
-    }
-
-    m_Constructed = true;
-    if (isVisible())
-        syncGUI();
-}
-
-template <typename T> void FITSHistogram::constructHistogram()
-{
-    FITSData * imageData = tab->getView()->getImageData();
-    uint16_t width = imageData->width(), height = imageData->height();
     uint8_t channels = imageData->channels();
 
-    auto * buffer = reinterpret_cast<T *>(imageData->getImageBuffer());
+    isGUISynced = false;
 
     double min, max;
     for (int i = 0 ; i < 3; i++)
@@ -198,150 +152,47 @@ template <typename T> void FITSHistogram::constructHistogram()
         FITSMax[i] = max;
     }
 
-    uint32_t samples = width * height;
-    const uint32_t sampleBy = samples > 1000000 ? samples / 1000000 : 1;
-
     //binCount = static_cast<uint16_t>(sqrt(samples));
     binCount = qMin(FITSMax[0] - FITSMin[0], 400.0);
     if (binCount <= 0)
         binCount = 400;
 
-    for (int n = 0; n < channels; n++)
-    {
-        intensity[n].fill(0, binCount);
-        frequency[n].fill(0, binCount);
-        cumulativeFrequency[n].fill(0, binCount);
-        binWidth[n] = (FITSMax[n] - FITSMin[n]) / (binCount - 1);
-        // Initialize the median to 0 in case the computation below fails.
-        imageData->setMedian(0, n);
-    }
-
-    QVector<QFuture<void>> futures;
-
-    for (int n = 0; n < channels; n++)
-    {
-        futures.append(QtConcurrent::run([ = ]()
-        {
-            for (int i = 0; i < binCount; i++)
-                intensity[n][i] = FITSMin[n] + (binWidth[n] * i);
-        }));
-    }
+    const bool cutoffSpikes = ui->hideSaturated->isChecked();
 
+    // The frequencies come from the histogram FITSData computed with its other statistics, including the median,
+    // so the image is not read again.
     for (int n = 0; n < channels; n++)
     {
-        futures.append(QtConcurrent::run([ = ]()
-        {
-            uint32_t offset = n * samples;
-
-            for (uint32_t i = 0; i < samples; i += sampleBy)
-            {
-                int32_t id = rint((buffer[i + offset] - FITSMin[n]) / binWidth[n]);
-                if (id < 0)
-                    id = 0;
-                frequency[n][id] += sampleBy;
-            }
-         }));
-    }
+        binWidth[n] = (FITSMax[n] - FITSMin[n]) / (binCount - 1);
 
-    for (QFuture<void> future : futures)
-        future.waitForFinished();
+        intensity[n].fill(0, binCount);
+        for (int i = 0; i < binCount; i++)
+            intensity[n][i] = FITSMin[n] + (binWidth[n] * i);
 
-    futures.clear();
+        if (!imageData->getHistogram(frequency[n], binCount, n))
+            frequency[n].fill(0, binCount);
 
-    for (int n = 0; n < channels; n++)
-    {
-        futures.append(QtConcurrent::run([ = ]()
+        cumulativeFrequency[n].fill(0, binCount);
+        uint32_t accumulator = 0;
+        for (int i = 0; i < binCount; i++)
         {
-            uint32_t accumulator = 0;
-            for (int i = 0; i < binCount; i++)
-            {
-                accumulator += frequency[n][i];
-                cumulativeFrequency[n].replace(i, accumulator);
-            }
-        }));
-    }
-
-    for (QFuture<void> future : futures)
-        future.waitForFinished();
-
-    futures.clear();
+            accumulator += frequency[n][i];
+            cumulativeFrequency[n].replace(i, accumulator);
+        }
 
-    for (int n = 0; n < channels; n++)
-    {
-        futures.append(QtConcurrent::run([ = ]()
+        if (cutoffSpikes)
         {
-            double median[3] = {0};
-            const bool cutoffSpikes = ui->hideSaturated->isChecked();
-            const uint32_t halfCumulative = cumulativeFrequency[n][binCount - 1] / 2;
-
-            // Find which bin contains the median.
-            int median_bin = -1;
+            QVector<double> sortedFreq = frequency[n];
+            std::sort(sortedFreq.begin(), sortedFreq.end());
+            double cutoff = sortedFreq[binCount * 0.99];
             for (int i = 0; i < binCount; i++)
             {
-                if (cumulativeFrequency[n][i] > halfCumulative)
-                {
-                    median_bin = i;
-                    break;
-                }
-            }
-
-            if (median_bin >= 0)
-            {
-                // The number of items in the median bin
-                const uint32_t median_bin_size = frequency[n][median_bin] / sampleBy;
-                if (median_bin_size > 0)
-                {
-                    // The median is this element inside the sorted median_bin;
-                    const uint32_t samples_before_median_bin = median_bin == 0 ? 0 : cumulativeFrequency[n][median_bin - 1];
-                    uint32_t median_position = (halfCumulative - samples_before_median_bin) / sampleBy;
-
-                    if (median_position >= median_bin_size)
-                        median_position = median_bin_size - 1;
-                    if (median_position >= 0 && median_position < median_bin_size)
-                    {
-                        // Fill a vector with the values in the median bin (sampled by sampleBy).
-                        std::vector<T> median_bin_samples(median_bin_size);
-                        uint32_t upto = 0;
-                        const uint32_t offset = n * samples;
-                        for (uint32_t i = 0; i < samples; i += sampleBy)
-                        {
-                            if (upto >= median_bin_size) break;
-                            const int32_t id = rint((buffer[i + offset] - FITSMin[n]) / binWidth[n]);
-                            if (id == median_bin)
-                                median_bin_samples[upto++] = buffer[i + offset];
-                        }
-                        // Get the Nth value using N = the median position.
-                        if (upto > 0)
-                        {
-                            if (median_position >= upto) median_position = upto - 1;
-                            std::nth_element(median_bin_samples.begin(), median_bin_samples.begin() + median_position,
-                                             median_bin_samples.begin() + upto);
-                            median[n] = median_bin_samples[median_position];
-                        }
-                    }
-                }
-            }
-
-            imageData->setMedian(median[n], n);
-
-            if (cutoffSpikes)
-            {
-                QVector<double> sortedFreq = frequency[n];
-                std::sort(sortedFreq.begin(), sortedFreq.end());
-                double cutoff = sortedFreq[binCount * 0.99];
-                for (int i = 0; i < binCount; i++)
-                {
-                    if (frequency[n][i] >= cutoff)
-                        frequency[n][i] = cutoff;
-                }
+                if (frequency[n][i] >= cutoff)
+                    frequency[n][i] = cutoff;
             }
-
-        }));
+        }
     }
 
-    for (QFuture<void> future : futures)
-        future.waitForFinished();
-
     // Custom index to indicate the overall contrast of the image
     if (cumulativeFrequency[RED_CHANNEL][binCount / 4] > 0)
         JMIndex = cumulativeFrequency[RED_CHANNEL][binCount / 8] / cumulativeFrequency[RED_CHANNEL][binCount / 4];
@@ -356,6 +207,10 @@ template <typename T> void FITSHistogram::constructHistogram()
         sliderTick  << fabs(FITSMax[n] - FITSMin[n]) / 99.0;
         sliderScale << 99.0 / (FITSMax[n] - FITSMin[n] - sliderTick[n]);
     }
+
+    m_Constructed = true;
+    if (isVisible())
+        syncGUI();
 }
 
 void FITSHistogram::syncGUI()
@@ -518,58 +373,99 @@ FITSHistogramCommand::FITSHistogramCommand(QWidget * parent,
     max = lmax;
 }
 
+namespace
+{
+// Bytes of the image per delta tile, compressed independently and in parallel
+const uint32_t DELTA_TILE_BYTES = 256 * 1024;
+
+// Commands holding a delta in memory, oldest first, and the memory of their deltas
+QList<FITSHistogramCommand *> deltaCommands;
+qint64 deltaCommandsMemory = 0;
+}
+
 FITSHistogramCommand::~FITSHistogramCommand()
 {
-    delete[] delta;
+    releaseDelta();
+}
+
+void FITSHistogramCommand::releaseDelta()
+{
+    deltaCommands.removeOne(this);
+    deltaCommandsMemory -= deltaMemory;
+    deltaMemory = 0;
+    deltaTiles.clear();
+    deltaFile.reset();
+    hasDelta = false;
 }
 
 bool FITSHistogramCommand::calculateDelta(const uint8_t * buffer)
 {
     FITSData * imageData = tab->getView()->getImageData();
 
-    uint8_t * image_buffer = imageData->getImageBuffer();
-    int totalPixels =
-        imageData->width() * imageData->height() * imageData->channels();
-    unsigned long totalBytes = totalPixels * imageData->getBytesPerPixel();
+    const uint8_t * image_buffer = imageData->getImageBuffer();
+    const size_t totalBytes = static_cast<size_t>(imageData->width()) * imageData->height() * imageData->channels() *
+                              imageData->getBytesPerPixel();
 
-    auto * raw_delta = new uint8_t[totalBytes];
+    releaseDelta();
 
-    if (raw_delta == nullptr)
+    QVector<DeltaTile> tiles;
+    for (size_t offset = 0; offset < totalBytes; offset += DELTA_TILE_BYTES)
     {
-        qWarning() << "Error! not enough memory to create image delta" << endl;
-        return false;
+        DeltaTile tile;
+        tile.offset = offset;
+        tile.size   = std::min<size_t>(DELTA_TILE_BYTES, totalBytes - offset);
+        tiles.append(tile);
     }
 
-    for (unsigned int i = 0; i < totalBytes; i++)
-        raw_delta[i] = buffer[i] ^ image_buffer[i];
+    // Tiles the command did not change are skipped, the others are compressed for speed rather than size
+    std::function<void(DeltaTile &)> compressTile = [&](DeltaTile & tile)
+    {
+        const uint8_t * before = buffer + tile.offset;
+        const uint8_t * after  = image_buffer + tile.offset;
 
-    compressedBytes = sizeof(uint8_t) * totalBytes + totalBytes / 64 + 16 + 3;
-    delete[] delta;
-    delta = new uint8_t[compressedBytes];
+        if (memcmp(before, after, tile.size) == 0)
+            return;
 
-    if (delta == nullptr)
-    {
-        delete[] raw_delta;
-        qCCritical(KSTARS_FITS)
-                << "FITSHistogram Error: Ran out of memory compressing delta";
-        return false;
-    }
+        std::vector<uint8_t> raw_delta(tile.size);
+        for (uint32_t i = 0; i < tile.size; i++)
+            raw_delta[i] = before[i] ^ after[i];
+
+        uLongf compressedBytes = compressBound(tile.size);
+        tile.data.resize(compressedBytes);
+
+        if (compress2(reinterpret_cast<Bytef *>(tile.data.data()), &compressedBytes, raw_delta.data(), tile.size,
+                      Z_BEST_SPEED) != Z_OK)
+            tile.failed = true;
+        else
+            tile.data.resize(compressedBytes);
+    };
 
-    int r = compress2(delta, &compressedBytes, raw_delta, totalBytes, 5);
+    QtConcurrent::blockingMap(tiles, compressTile);
 
-    if (r != Z_OK)
+    for (const DeltaTile &tile : tiles)
     {
-        delete[] raw_delta;
-        /* this should NEVER happen */
-        qCCritical(KSTARS_FITS)
-                << "FITSHistogram Error: Failed to compress raw_delta";
-        return false;
+        if (tile.failed)
+        {
+            /* this should NEVER happen */
+            qCCritical(KSTARS_FITS) << "FITSHistogram Error: Failed to compress raw_delta";
+            return false;
+        }
+
+        if (tile.data.isEmpty() == false)
+        {
+            deltaTiles.append(tile);
+            deltaMemory += tile.data.size();
+        }
     }
 
-    // qDebug() << "compressed bytes size " << compressedBytes << " bytes" <<
-    // endl;
+    hasDelta = true;
+    deltaCommands.append(this);
+    deltaCommandsMemory += deltaMemory;
+
+    qCDebug(KSTARS_FITS) << "FITSHistogram: delta of" << deltaTiles.size() << "tiles out of" << tiles.size() << "," <<
+                         deltaMemory << "bytes";
 
-    delete[] raw_delta;
+    enforceDeltaMemoryLimit();
 
     return true;
 }
@@ -580,47 +476,119 @@ bool FITSHistogramCommand::reverseDelta()
     FITSData * imageData = image->getImageData();
     uint8_t * image_buffer = (imageData->getImageBuffer());
 
-    int totalPixels =
-        imageData->width() * imageData->height() * imageData->channels();
-    unsigned long totalBytes = totalPixels * imageData->getBytesPerPixel();
+    // Deltas saved to disk are read back for the time of the reversal only
+    QVector<DeltaTile> tiles = deltaTiles;
+    if (deltaFile)
+    {
+        for (DeltaTile &tile : tiles)
+        {
+            if (deltaFile->seek(tile.fileOffset))
+                tile.data = deltaFile->read(tile.fileSize);
+            if (tile.data.size() != tile.fileSize)
+            {
+                qCCritical(KSTARS_FITS) << "FITSHistogram Error: Failed to read delta from" << deltaFile->fileName();
+                return false;
+            }
+        }
+    }
+
+    // All tiles are uncompressed before the image is touched, so that it is never left partially reversed
+    std::function<void(DeltaTile &)> uncompressTile = [&](DeltaTile & tile)
+    {
+        QByteArray raw_delta(static_cast<int>(tile.size), Qt::Uninitialized);
+        uLongf rawBytes = tile.size;
+
+        if (uncompress(reinterpret_cast<Bytef *>(raw_delta.data()), &rawBytes,
+                       reinterpret_cast<const Bytef *>(tile.data.constData()), tile.data.size()) != Z_OK ||
+                rawBytes != tile.size)
+        {
+            tile.failed = true;
+            return;
+        }
+
+        tile.data = raw_delta;
+    };
 
-    auto * output_image = new uint8_t[totalBytes];
+    QtConcurrent::blockingMap(tiles, uncompressTile);
 
-    if (output_image == nullptr)
+    for (const DeltaTile &tile : tiles)
     {
-        qWarning() << "Error! not enough memory to create output image" << endl;
-        return false;
+        if (tile.failed)
+        {
+            qCCritical(KSTARS_FITS) << "FITSHistogram compression error in reverseDelta()";
+            return false;
+        }
     }
 
-    auto * raw_delta = new uint8_t[totalBytes];
+    // The XOR with the delta swaps the tile between its states before and after the command, in place
+    std::function<void(DeltaTile &)> reverseTile = [&](DeltaTile & tile)
+    {
+        const uint8_t * raw_delta = reinterpret_cast<const uint8_t *>(tile.data.constData());
+        uint8_t * output = image_buffer + tile.offset;
+        for (uint32_t i = 0; i < tile.size; i++)
+            output[i] ^= raw_delta[i];
+    };
+
+    QtConcurrent::blockingMap(tiles, reverseTile);
+
+    imageData->imageBufferChanged();
 
-    if (raw_delta == nullptr)
+    return true;
+}
+
+bool FITSHistogramCommand::spillDelta()
+{
+    if (deltaFile || hasDelta == false)
+        return true;
+
+    std::unique_ptr<QTemporaryFile> file(new QTemporaryFile(QDir::tempPath() + "/fitsundoXXXXXX"));
+    if (!file->open())
     {
-        delete[] output_image;
-        qWarning() << "Error! not enough memory to create image delta" << endl;
+        qCWarning(KSTARS_FITS) << "FITSHistogram: Unable to open" << file->fileName() << "to save undo history";
         return false;
     }
 
-    int r = uncompress(raw_delta, &totalBytes, delta, compressedBytes);
-    if (r != Z_OK)
+    for (DeltaTile &tile : deltaTiles)
     {
-        qCCritical(KSTARS_FITS)
-                << "FITSHistogram compression error in reverseDelta()";
-        delete[] output_image;
-        delete[] raw_delta;
-        return false;
+        tile.fileOffset = file->pos();
+        tile.fileSize   = tile.data.size();
+        if (file->write(tile.data) != tile.data.size())
+        {
+            qCWarning(KSTARS_FITS) << "FITSHistogram: Unable to write undo history to" << file->fileName();
+            return false;
+        }
     }
 
-    for (unsigned int i = 0; i < totalBytes; i++)
-        output_image[i] = raw_delta[i] ^ image_buffer[i];
+    if (!file->flush())
+        return false;
 
-    imageData->setImageBuffer(output_image);
+    for (DeltaTile &tile : deltaTiles)
+        tile.data = QByteArray();
 
-    delete[] raw_delta;
+    deltaFile = std::move(file);
+    deltaCommands.removeOne(this);
+    deltaCommandsMemory -= deltaMemory;
+    deltaMemory = 0;
 
     return true;
 }
 
+void FITSHistogramCommand::enforceDeltaMemoryLimit()
+{
+    const qint64 limit = static_cast<qint64>(Options::fITSUndoMemoryLimit()) * 1024 * 1024;
+
+    // The most recent delta stays in memory, whatever its size
+    while (deltaCommandsMemory > limit && deltaCommands.size() > 1)
+    {
+        FITSHistogramCommand * oldest = deltaCommands.first();
+        qCDebug(KSTARS_FITS) << "FITSHistogram: saving" << oldest->deltaMemory << "bytes of undo history to disk";
+
+        // Keep the delta in memory if it cannot be saved, rather than loop forever
+        if (!oldest->spillDelta())
+            deltaCommands.removeFirst();
+    }
+}
+
 void FITSHistogramCommand::redo()
 {
     FITSView * image = tab->getView();
@@ -634,16 +602,17 @@ void FITSHistogramCommand::redo()
 
     QApplication::setOverrideCursor(Qt::WaitCursor);
 
-    if (delta != nullptr)
+    if (hasDelta)
     {
         FITSData::Statistic prevStats;
         imageData->saveStatistics(prevStats);
 
-        reverseDelta();
-
-        imageData->restoreStatistics(stats);
-
-        stats = prevStats;
+        // The image is left untouched if the delta cannot be reversed, so are its statistics
+        if (reverseDelta())
+        {
+            imageData->restoreStatistics(stats);
+            stats = prevStats;
+        }
     }
     else
     {
@@ -717,16 +686,17 @@ void FITSHistogramCommand::undo()
 
     QApplication::setOverrideCursor(Qt::WaitCursor);
 
-    if (delta != nullptr)
+    if (hasDelta)
     {
         FITSData::Statistic prevStats;
         imageData->saveStatistics(prevStats);
 
-        reverseDelta();
-
-        imageData->restoreStatistics(stats);
-
-        stats = prevStats;
+        // The image is left untouched if the delta cannot be reversed, so are its statistics
+        if (reverseDelta())
+        {
+            imageData->restoreStatistics(stats);
+            stats = prevStats;
+        }
     }
     else
     {
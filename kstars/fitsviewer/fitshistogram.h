@@ -15,8 +15,11 @@
 #include "ui_fitshistogramui.h"
 
 #include <QDialog>
+#include <QTemporaryFile>
 #include <QUndoCommand>
 
+#include <memory>
+
 class QMouseEvent;
 
 class FITSTab;
@@ -73,8 +76,6 @@ class FITSHistogram : public QDialog
         void resizePlot();
 
     private:
-        template <typename T>
-        void constructHistogram();
         double cutMin;
         double cutMax;
 
@@ -116,15 +117,39 @@ class FITSHistogramCommand : public QUndoCommand
         virtual QString text() const;
 
     private:
+        /** @short XOR of a tile of the image before and after the command, compressed */
+        struct DeltaTile
+        {
+            /// Position and size of the tile in the image buffer, in bytes
+            size_t offset { 0 };
+            uint32_t size { 0 };
+            /// Compressed delta, empty while spilled to deltaFile
+            QByteArray data;
+            /// Position and size of the compressed delta in deltaFile
+            qint64 fileOffset { 0 };
+            int fileSize { 0 };
+            bool failed { false };
+        };
+
         bool calculateDelta(const uint8_t * buffer);
         bool reverseDelta();
 
+        /** Save the delta to a temporary file and release its memory */
+        bool spillDelta();
+        void releaseDelta();
+
+        /** Spill the oldest deltas of all commands until their memory fits the FITSUndoMemoryLimit option */
+        static void enforceDeltaMemoryLimit();
+
         FITSData::Statistic stats;
         FITSHistogram * histogram { nullptr };
         FITSScale type;
         QVector<double> min, max;
 
-        unsigned char * delta { nullptr };
-        unsigned long compressedBytes { 0 };
+        /// Tiles that changed, the others are not stored
+        QVector<DeltaTile> deltaTiles;
+        bool hasDelta { false };
+        qint64 deltaMemory { 0 };
+        std::unique_ptr<QTemporaryFile> deltaFile;
         FITSTab * tab { nullptr };
 };
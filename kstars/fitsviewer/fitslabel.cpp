@@ -26,6 +26,8 @@
 #include "indi/indilistener.h"
 #endif
 
+#include <QPainter>
+#include <QPaintEvent>
 #include <QScrollBar>
 #include <QToolTip>
 
@@ -154,17 +156,12 @@ void FITSLabel::mouseMoveEvent(QMouseEvent *e)
 
     if (view_data->hasWCS() && view->getCursorMode() != FITSView::selectCursor)
     {
-        int index = x + y * width;
+        SkyPoint wcsCoord;
 
-        wcs_point *wcs_coord = view_data->getWCSCoord();
-
-        if (wcs_coord)
+        if (view_data->isWCSLoaded() && view_data->pixelToWCS(QPointF(x, y), wcsCoord))
         {
-            if (index > size)
-                return;
-
-            ra.setD(wcs_coord[index].ra);
-            dec.setD(wcs_coord[index].dec);
+            ra  = wcsCoord.ra0();
+            dec = wcsCoord.dec0();
 
             emit newStatus(QString("%1 , %2").arg(ra.toHMSString(), dec.toDMSString()), FITS_WCS);
         }
@@ -218,24 +215,24 @@ void FITSLabel::mousePressEvent(QMouseEvent *e)
         FITSData *view_data = view->getImageData();
         if (view_data->hasWCS())
         {
-            wcs_point *wcs_coord = view_data->getWCSCoord();
-            if (wcs_coord)
-            {
-                double x, y;
-                x = round(e->x() / scale);
-                y = round(e->y() / scale);
+            double x, y;
+            x = round(e->x() / scale);
+            y = round(e->y() / scale);
 
-                x         = KSUtils::clamp(x, 1.0, width);
-                y         = KSUtils::clamp(y, 1.0, height);
-                int index = x + y * width;
+            x = KSUtils::clamp(x, 1.0, width);
+            y = KSUtils::clamp(y, 1.0, height);
+
+            SkyPoint wcsCoord;
+            if (view_data->isWCSLoaded() && view_data->pixelToWCS(QPointF(x, y), wcsCoord))
+            {
                 if (KMessageBox::Continue == KMessageBox::warningContinueCancel(
                             nullptr,
-                            "Slewing to Coordinates: \nRA: " + dms(wcs_coord[index].ra).toHMSString() +
-                            "\nDec: " + dms(wcs_coord[index].dec).toDMSString(),
+                            "Slewing to Coordinates: \nRA: " + wcsCoord.ra0().toHMSString() +
+                            "\nDec: " + wcsCoord.dec0().toDMSString(),
                             i18n("Continue Slew"), KStandardGuiItem::cont(),
                             KStandardGuiItem::cancel(), "continue_slew_warning"))
                 {
-                    centerTelescope(wcs_coord[index].ra / 15.0, wcs_coord[index].dec);
+                    centerTelescope(wcsCoord.ra0().Hours(), wcsCoord.dec0().Degrees());
                     view->setCursorMode(view->lastMouseMode);
                     view->updateScopeButton();
                 }
@@ -316,6 +313,15 @@ void FITSLabel::mouseDoubleClickEvent(QMouseEvent *e)
     return;
 }
 
+/**
+Only the part of the frame that is exposed gets rendered, at the zoom of the view.
+ */
+void FITSLabel::paintEvent(QPaintEvent *e)
+{
+    QPainter painter(this);
+    view->drawFrame(&painter, e->rect());
+}
+
 void FITSLabel::centerTelescope(double raJ2000, double decJ2000)
 {
 #ifdef HAVE_INDI
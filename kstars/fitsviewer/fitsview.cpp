@@ -35,6 +35,9 @@
 #include <QApplication>
 #include <QGestureEvent>
 
+#include <functional>
+#include <limits>
+
 #define BASE_OFFSET    50
 #define ZOOM_DEFAULT   100.0f
 #define ZOOM_MIN       10
@@ -69,35 +72,147 @@ void ComputeGBStretchParams(const StretchParams &newParams, StretchParams* param
     params->blue.midtones = std::max(params->blue.midtones, 0.0f);
 }
 
+// Levels of the display pyramid stop once both dimensions fit in this many pixels.
+constexpr int PYRAMID_MIN_SIZE = 256;
+// Rows of the display image stretched together when only part of it is painted.
+constexpr int DISPLAY_BAND_ROWS = 256;
+// Output rows processed by one task when reducing a pyramid level.
+constexpr int PYRAMID_BAND_ROWS = 64;
+
+struct PyramidBand
+{
+    int firstRow;
+    int endRow;
+};
+
+// Halve a stretched 8-bit display image with a 2x2 box filter. The source is either a
+// grey Format_Indexed8 image with an identity palette or a Format_RGB32 image, which
+// is what initDisplayImage() produces. Odd trailing rows and columns are clamped.
+QImage reduceDisplayImage(const QImage &source)
+{
+    const int srcWidth  = source.width();
+    const int srcHeight = source.height();
+    const int width     = (srcWidth + 1) / 2;
+    const int height    = (srcHeight + 1) / 2;
+    const bool indexed  = source.format() == QImage::Format_Indexed8;
+
+    QImage reduced(width, height, source.format());
+    if (indexed)
+        reduced.setColorTable(source.colorTable());
+
+    QVector<PyramidBand> bands;
+    for (int row = 0; row < height; row += PYRAMID_BAND_ROWS)
+        bands.append({row, std::min(row + PYRAMID_BAND_ROWS, height)});
+
+    // Take the scan line pointers up front so that worker threads never detach the images.
+    const uchar *srcBits = source.constBits();
+    const int srcStride  = source.bytesPerLine();
+    uchar *dstBits       = reduced.bits();
+    const int dstStride  = reduced.bytesPerLine();
+
+    std::function<void(PyramidBand &)> reduceBand = [ = ](PyramidBand & band)
+    {
+        for (int y = band.firstRow; y < band.endRow; y++)
+        {
+            const int y0 = 2 * y;
+            const int y1 = std::min(y0 + 1, srcHeight - 1);
+
+            if (indexed)
+            {
+                const uchar *row0 = srcBits + y0 * srcStride;
+                const uchar *row1 = srcBits + y1 * srcStride;
+                uchar *out        = dstBits + y * dstStride;
+                for (int x = 0; x < width; x++)
+                {
+                    const int x0 = 2 * x;
+                    const int x1 = std::min(x0 + 1, srcWidth - 1);
+                    out[x] = static_cast<uchar>((row0[x0] + row0[x1] + row1[x0] + row1[x1] + 2) >> 2);
+                }
+            }
+            else
+            {
+                const QRgb *row0 = reinterpret_cast<const QRgb *>(srcBits + y0 * srcStride);
+                const QRgb *row1 = reinterpret_cast<const QRgb *>(srcBits + y1 * srcStride);
+                QRgb *out        = reinterpret_cast<QRgb *>(dstBits + y * dstStride);
+                for (int x = 0; x < width; x++)
+                {
+                    const int x0 = 2 * x;
+                    const int x1 = std::min(x0 + 1, srcWidth - 1);
+                    const QRgb a = row0[x0], b = row0[x1], c = row1[x0], d = row1[x1];
+                    out[x] = qRgb((qRed(a) + qRed(b) + qRed(c) + qRed(d) + 2) >> 2,
+                                  (qGreen(a) + qGreen(b) + qGreen(c) + qGreen(d) + 2) >> 2,
+                                  (qBlue(a) + qBlue(b) + qBlue(c) + qBlue(d) + 2) >> 2);
+                }
+            }
+        }
+    };
+
+    QtConcurrent::blockingMap(bands, reduceBand);
+    return reduced;
+}
+
+// Build the reduced levels of the display pyramid. Element i is the stretched image
+// halved i + 1 times; the full resolution level is the source itself and is not stored.
+QVector<QImage> buildDisplayPyramid(QImage source)
+{
+    QVector<QImage> levels;
+
+    if (source.format() != QImage::Format_Indexed8 && source.format() != QImage::Format_RGB32)
+        return levels;
+
+    while (source.width() > PYRAMID_MIN_SIZE || source.height() > PYRAMID_MIN_SIZE)
+    {
+        source = reduceDisplayImage(source);
+        levels.append(source);
+    }
+
+    return levels;
+}
+
+// Create an 8-bit display image, grey for one channel and RGB for three.
+QImage createDisplayImage(const QSize &size, int channels)
+{
+    if (channels != 1)
+        return QImage(size, QImage::Format_RGB32);
+
+    QImage image(size, QImage::Format_Indexed8);
+    image.setColorCount(256);
+    for (int i = 0; i < 256; i++)
+        image.setColor(i, qRgb(i, i, i));
+    return image;
+}
+
 }  // namespace
 
-// Runs the stretch checking the variables to see which parameters to use.
-// We call stretch even if we're not stretching, as the stretch code still
+// Chooses the stretch parameters checking the variables to see which ones to use.
+// We stretch even if we're not stretching, as the stretch code still
 // converts the image to the uint8 output image which will be displayed.
 // In that case, it will use an identity stretch.
-void FITSView::doStretch(FITSData *data, QImage *outputImage)
+void FITSView::chooseStretchParams()
 {
-    if (outputImage->isNull())
-        return;
-    Stretch stretch(static_cast<int>(data->width()),
-                    static_cast<int>(data->height()),
-                    data->channels(), data->property("dataType").toInt());
-
-    StretchParams tempParams;
     if (!stretchImage)
-        tempParams = StretchParams();  // Keeping it linear
+        displayParams = StretchParams();  // Keeping it linear
     else if (autoStretch)
     {
         // Compute new auto-stretch params.
-        stretchParams = stretch.computeParams(data->getImageBuffer());
-        tempParams = stretchParams;
+        Stretch stretch(static_cast<int>(imageData->width()),
+                        static_cast<int>(imageData->height()),
+                        imageData->channels(), imageData->property("dataType").toInt());
+        stretchParams = stretch.computeParams(imageData->getImageBuffer());
+        displayParams = stretchParams;
     }
     else
         // Use the existing stretch params.
-        tempParams = stretchParams;
+        displayParams = stretchParams;
+}
 
-    stretch.setParams(tempParams);
-    stretch.run(data->getImageBuffer(), outputImage, sampling);
+Stretch FITSView::displayStretch() const
+{
+    Stretch stretch(static_cast<int>(imageData->width()),
+                    static_cast<int>(imageData->height()),
+                    imageData->channels(), imageData->property("dataType").toInt());
+    stretch.setParams(displayParams);
+    return stretch;
 }
 
 // Store stretch parameters, and turn on stretching if it isn't already on.
@@ -167,6 +282,8 @@ FITSView::FITSView(QWidget * parent, FITSMode fitsMode, FITSScale filterType) :
 
     connect(&fitsWatcher, &QFutureWatcher<bool>::finished, this, &FITSView::loadInFrame);
 
+    connect(&renditionWatcher, &QFutureWatcher<DisplayRendition>::finished, this, &FITSView::loadRendition);
+
     image_frame->setMouseTracking(true);
     setCursorMode(
         selectCursor); //This is the default mode because the Focus and Align FitsViews should not be in dragMouse mode
@@ -185,6 +302,7 @@ FITSView::~FITSView()
 {
     fitsWatcher.waitForFinished();
     wcsWatcher.waitForFinished();
+    renditionWatcher.waitForFinished();
     delete (imageData);
 }
 
@@ -384,7 +502,6 @@ bool FITSView::processData()
         QTimer::singleShot(100, this, SLOT(viewStarProfile()));
     }
 
-    scaledImage = QImage();
     updateFrame();
     return true;
 }
@@ -549,10 +666,17 @@ bool FITSView::rescale(FITSZoom type)
             break;
     }
 
+    // Only the stretch parameters are chosen here. The pixels are stretched as they are painted, and the
+    // whole frame on a worker thread, so that a new stretch costs the viewport rather than the frame.
     initDisplayImage();
-    image_frame->setScaledContents(true);
-    doStretch(imageData, &rawImage);
-    scaledImage = QImage();
+    chooseStretchParams();
+    displayGeneration++;
+    renditionComplete = false;
+    stretchedBands.fill(false, (rawImage.height() + DISPLAY_BAND_ROWS - 1) / DISPLAY_BAND_ROWS);
+    previewImage = QImage();
+    previewStep  = 0;
+    pyramid.clear();
+    startRendition();
     setWidget(image_frame.get());
 
     // This is needed by fitstab, even if the zoom doesn't change, to change the stretch UI.
@@ -636,31 +760,69 @@ int FITSView::filterStars()
 
 void FITSView::updateFrame()
 {
-    bool ok = false;
-
     if (toggleStretchAction)
         toggleStretchAction->setChecked(stretchImage);
 
-    if (currentZoom != ZOOM_DEFAULT)
+    // The frame is rendered by drawFrame(), only where the label is painted
+    image_frame->resize(currentWidth, currentHeight);
+    image_frame->update();
+}
+
+// Paint the part of the zoomed frame in region, given in the coordinates of the label, then the overlays.
+// Zoomed out, the frame comes from the smallest pyramid level that still covers the zoomed size, or from a
+// coarse preview until the worker thread has stretched the whole frame. Otherwise the bands of rows under the
+// region are stretched on the spot if they are not yet.
+void FITSView::drawFrame(QPainter *painter, const QRect &region)
+{
+    if (rawImage.isNull() || currentWidth == 0 || currentHeight == 0)
+        return;
+
+    const QRect target = region.intersected(QRect(0, 0, currentWidth, currentHeight));
+    if (!target.isEmpty())
     {
-        // Only scale when necessary
-        if (scaledImage.isNull() || currentWidth != lastWidth || currentHeight != lastHeight)
+        // Pixels of rawImage per pixel of the zoomed frame
+        const double scaleX = rawImage.width() / static_cast<double>(currentWidth);
+        const double scaleY = rawImage.height() / static_cast<double>(currentHeight);
+        const QRectF source(target.x() * scaleX, target.y() * scaleY, target.width() * scaleX, target.height() * scaleY);
+        const int step = static_cast<int>(std::min(scaleX, scaleY));
+
+        if (renditionComplete && currentZoom < ZOOM_DEFAULT)
         {
-            scaledImage = rawImage.scaled(currentWidth, currentHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-            lastWidth = currentWidth;
-            lastHeight = currentHeight;
+            const QImage *image = &rawImage;
+            for (const QImage &level : pyramid)
+            {
+                if (level.width() < currentWidth || level.height() < currentHeight)
+                    break;
+                image = &level;
+            }
+
+            const double reductionX = image->width() / static_cast<double>(rawImage.width());
+            const double reductionY = image->height() / static_cast<double>(rawImage.height());
+            painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+            painter->drawImage(QRectF(target), *image,
+                               QRectF(source.x() * reductionX, source.y() * reductionY,
+                                      source.width() * reductionX, source.height() * reductionY));
         }
-        ok = displayPixmap.convertFromImage(scaledImage);
-    }
-    else
-        ok = displayPixmap.convertFromImage(rawImage);
+        else if (step > 1)
+        {
+            if (previewImage.isNull() || previewStep > step)
+                stretchPreview(step);
 
-    if (!ok)
-        return;
+            painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+            painter->drawImage(QRectF(target), previewImage,
+                               QRectF(source.x() / previewStep, source.y() / previewStep,
+                                      source.width() / previewStep, source.height() / previewStep));
+        }
+        else
+        {
+            stretchRows(static_cast<int>(source.top()), static_cast<int>(std::ceil(source.bottom())) + 1);
 
-    QPainter painter(&displayPixmap);
+            painter->setRenderHint(QPainter::SmoothPixmapTransform, currentZoom != ZOOM_DEFAULT);
+            painter->drawImage(QRectF(target), rawImage, source);
+        }
+    }
 
-    drawOverlay(&painter);
+    drawOverlay(painter);
 
     if (starFilter.used())
     {
@@ -668,19 +830,142 @@ void FITSView::updateFrame()
         int const innerRadius = std::lround(diagonal * starFilter.innerRadius);
         int const outerRadius = std::lround(diagonal * starFilter.outerRadius);
         QPoint const center(currentWidth / 2, currentHeight / 2);
-        painter.save();
-        painter.setPen(QPen(Qt::blue, 1, Qt::DashLine));
-        painter.setOpacity(0.7);
-        painter.setBrush(QBrush(Qt::transparent));
-        painter.drawEllipse(center, outerRadius, outerRadius);
-        painter.setBrush(QBrush(Qt::blue, Qt::FDiagPattern));
-        painter.drawEllipse(center, innerRadius, innerRadius);
-        painter.restore();
+        painter->save();
+        painter->setPen(QPen(Qt::blue, 1, Qt::DashLine));
+        painter->setOpacity(0.7);
+        painter->setBrush(QBrush(Qt::transparent));
+        painter->drawEllipse(center, outerRadius, outerRadius);
+        painter->setBrush(QBrush(Qt::blue, Qt::FDiagPattern));
+        painter->drawEllipse(center, innerRadius, innerRadius);
+        painter->restore();
     }
+}
 
-    image_frame->setPixmap(displayPixmap);
+// Stretch the bands of rows of rawImage between firstRow and endRow that are not stretched yet
+void FITSView::stretchRows(int firstRow, int endRow)
+{
+    if (renditionComplete || imageData == nullptr)
+        return;
 
-    image_frame->resize(currentWidth, currentHeight);
+    const int firstBand = std::max(0, firstRow) / DISPLAY_BAND_ROWS;
+    const int endBand   = std::min((std::min(endRow, rawImage.height()) + DISPLAY_BAND_ROWS - 1) / DISPLAY_BAND_ROWS,
+                                   stretchedBands.size());
+
+    for (int band = firstBand; band < endBand; band++)
+    {
+        if (stretchedBands[band])
+            continue;
+
+        // Consecutive bands are stretched at once
+        int last = band;
+        while (last + 1 < endBand && !stretchedBands[last + 1])
+            last++;
+
+        // Detach here rather than in the threads stretching the rows
+        rawImage.bits();
+
+        Stretch stretch = displayStretch();
+        stretch.run(imageData->getImageBuffer(), &rawImage, sampling, band * DISPLAY_BAND_ROWS,
+                    std::min((last + 1) * DISPLAY_BAND_ROWS, rawImage.height()));
+
+        for (int i = band; i <= last; i++)
+            stretchedBands[i] = true;
+        band = last;
+    }
+}
+
+// Stretch one pixel of rawImage out of step in each direction, as a preview of the zoomed out frame
+void FITSView::stretchPreview(int step)
+{
+    const int previewSampling = step * sampling;
+
+    previewImage = createDisplayImage(QSize((imageData->width() + previewSampling - 1) / previewSampling,
+                                            (imageData->height() + previewSampling - 1) / previewSampling),
+                                      imageData->channels());
+    previewStep = step;
+
+    Stretch stretch = displayStretch();
+    stretch.run(imageData->getImageBuffer(), &previewImage, previewSampling);
+}
+
+// Stretch the whole frame and build its pyramid on a worker thread. A single rendition runs at a time:
+// if the stretch changes meanwhile, the next one starts when the running one is done.
+void FITSView::startRendition()
+{
+    if (renditionWatcher.isRunning() || imageData == nullptr || imageData->getImageBuffer() == nullptr)
+        return;
+
+    // The worker thread stretches a copy of the image buffer, which may change or go away before it is done
+    const qint64 bufferSize = static_cast<qint64>(imageData->width()) * imageData->height() * imageData->channels() *
+                              imageData->getBytesPerPixel();
+    if (bufferSize > std::numeric_limits<int>::max())
+        return;
+
+    const QByteArray buffer(reinterpret_cast<const char *>(imageData->getImageBuffer()), static_cast<int>(bufferSize));
+    const Stretch stretch     = displayStretch();
+    const uint32_t generation = displayGeneration;
+    const QSize size          = rawImage.size();
+    const int channels        = imageData->channels();
+    const int step            = sampling;
+
+    renditionWatcher.setFuture(QtConcurrent::run([ = ]() -> DisplayRendition
+    {
+        DisplayRendition rendition;
+        rendition.generation = generation;
+        rendition.image      = createDisplayImage(size, channels);
+
+        // The stretch only reads its input
+        Stretch worker = stretch;
+        worker.run(reinterpret_cast<uint8_t *>(const_cast<char *>(buffer.constData())), &rendition.image, step);
+
+        rendition.pyramid = buildDisplayPyramid(rendition.image);
+        return rendition;
+    }));
+}
+
+void FITSView::loadRendition()
+{
+    const DisplayRendition rendition = renditionWatcher.result();
+
+    // Start over if the stretch or the image changed in the meantime
+    if (rendition.generation != displayGeneration)
+    {
+        startRendition();
+        return;
+    }
+
+    rawImage          = rendition.image;
+    pyramid           = rendition.pyramid;
+    renditionComplete = true;
+    previewImage      = QImage();
+    previewStep       = 0;
+
+    // Replace the preview with the smooth rendition, the bands stretched so far are already identical
+    if (image_frame != nullptr && currentZoom < ZOOM_DEFAULT)
+        image_frame->update();
+}
+
+QImage FITSView::getDisplayImage() const
+{
+    if (renditionComplete || rawImage.isNull() || imageData == nullptr)
+        return rawImage;
+
+    // Wait for the worker thread if it is stretching the current frame
+    QFuture<DisplayRendition> future = renditionWatcher.future();
+    future.waitForFinished();
+    if (future.resultCount() > 0 && future.result().generation == displayGeneration)
+        return future.result().image;
+
+    // Otherwise stretch it here, without touching the state of the view as this may run on any thread
+    QImage image    = createDisplayImage(rawImage.size(), imageData->channels());
+    Stretch stretch = displayStretch();
+    stretch.run(imageData->getImageBuffer(), &image, sampling);
+    return image;
+}
+
+QPixmap FITSView::getDisplayPixmap() const
+{
+    return image_frame->grab();
 }
 
 void FITSView::ZoomDefault()
@@ -939,28 +1224,13 @@ void FITSView::drawEQGrid(QPainter * painter)
 
     if (imageData->hasWCS())
     {
-        wcs_point * wcs_coord = imageData->getWCSCoord();
-        if (wcs_coord != nullptr)
-        {
-            int size      = image_width * image_height;
-            double maxRA  = -1000;
-            double minRA  = 1000;
-            double maxDec = -1000;
-            double minDec = 1000;
+        double maxRA  = -1000;
+        double minRA  = 1000;
+        double maxDec = -1000;
+        double minDec = 1000;
 
-            for (int i = 0; i < (size); i++)
-            {
-                double ra  = wcs_coord[i].ra;
-                double dec = wcs_coord[i].dec;
-                if (ra > maxRA)
-                    maxRA = ra;
-                if (ra < minRA)
-                    minRA = ra;
-                if (dec > maxDec)
-                    maxDec = dec;
-                if (dec < minDec)
-                    minDec = dec;
-            }
+        if (imageData->wcsBounds(minRA, maxRA, minDec, maxDec))
+        {
             auto minDecMinutes = (int)(minDec * 12); //This will force the Dec Scale to 5 arc minutes in the loop
             auto maxDecMinutes = (int)(maxDec * 12);
 
@@ -1038,15 +1308,17 @@ void FITSView::drawEQGrid(QPainter * painter)
                     QPointF pt = getPointForGridLabel();
                     if (pt.x() != -100)
                     {
+                        // The RA range of images that straddle 0h extends below 0 or above 360 degrees
+                        dms ra = dms(target).reduce();
                         if (maxDec > 50 || maxDec < -50)
                             painter->drawText(pt.x(), pt.y(),
-                                              QString::number(dms(target).hour()) + "h " +
-                                              QString::number(dms(target).minute()) + '\'');
+                                              QString::number(ra.hour()) + "h " +
+                                              QString::number(ra.minute()) + '\'');
                         else
                             painter->drawText(pt.x() - 20, pt.y(),
-                                              QString::number(dms(target).hour()) + "h " +
-                                              QString::number(dms(target).minute()) + "' " +
-                                              QString::number(dms(target).second()) + "''");
+                                              QString::number(ra.hour()) + "h " +
+                                              QString::number(ra.minute()) + "' " +
+                                              QString::number(ra.second()) + "''");
                     }
                 }
             }
@@ -1552,18 +1824,7 @@ void FITSView::initDisplayImage()
     int w = (imageData->width() + sampling - 1) / sampling;
     int h = (imageData->height() + sampling - 1) / sampling;
 
-    if (imageData->channels() == 1)
-    {
-        rawImage = QImage(w, h, QImage::Format_Indexed8);
-
-        rawImage.setColorCount(256);
-        for (int i = 0; i < 256; i++)
-            rawImage.setColor(i, qRgb(i, i, i));
-    }
-    else
-    {
-        rawImage = QImage(w, h, QImage::Format_RGB32);
-    }
+    rawImage = createDisplayImage(QSize(w, h), imageData->channels());
 }
 
 /**
@@ -87,14 +87,15 @@ class FITSView : public QScrollArea
         {
             return currentZoom;
         }
-        QImage getDisplayImage() const
-        {
-            return rawImage;
-        }
-        const QPixmap &getDisplayPixmap() const
-        {
-            return displayPixmap;
-        }
+        /**
+         * @brief getDisplayImage The stretched image of the whole frame, waiting for the worker thread to finish it
+         * or stretching it if needed.
+         */
+        QImage getDisplayImage() const;
+        /**
+         * @brief getDisplayPixmap The whole zoomed frame with its overlays, rendered on demand.
+         */
+        QPixmap getDisplayPixmap() const;
 
         // Tracking square
         void setTrackingBoxEnabled(bool enable);
@@ -277,6 +278,11 @@ class FITSView : public QScrollArea
         bool pointIsInImage(QPointF pt, bool scaled);
 
         void loadInFrame();
+        void loadRendition();
+        void startRendition();
+        void drawFrame(QPainter *painter, const QRect &region);
+        void stretchRows(int firstRow, int endRow);
+        void stretchPreview(int step);
 
         /// WCS Future Watcher
         QFutureWatcher<bool> wcsWatcher;
@@ -291,7 +297,16 @@ class FITSView : public QScrollArea
 
     private:
         bool processData();
-        void doStretch(FITSData *data, QImage *outputImage);
+        void chooseStretchParams();
+        Stretch displayStretch() const;
+
+        // Stretched image of the whole frame and its reduced levels, computed on a worker thread
+        struct DisplayRendition
+        {
+            uint32_t generation { 0 };
+            QImage image;
+            QVector<QImage> pyramid;
+        };
 
         QLabel *noImageLabel { nullptr };
         QPixmap noImage;
@@ -302,19 +317,25 @@ class FITSView : public QScrollArea
 
         /// Current width due to zoom
         uint16_t currentWidth { 0 };
-        uint16_t lastWidth { 0 };
         /// Current height due to zoom
         uint16_t currentHeight { 0 };
-        uint16_t lastHeight { 0 };
         /// Image zoom factor
         const double zoomFactor;
 
-        // Original full-size image
+        // Original full-size image. Until the rendition of the whole frame is complete, only the bands of
+        // rows flagged in stretchedBands are stretched.
         QImage rawImage;
-        // Scaled images
-        QImage scaledImage;
-        // Actual pixmap after all the overlays
-        QPixmap displayPixmap;
+        QVector<bool> stretchedBands;
+        // Coarse stretch of one pixel out of previewStep, shown zoomed out until the rendition is complete
+        QImage previewImage;
+        int previewStep { 0 };
+        // Reduced levels of rawImage, each half the size of the previous one
+        QVector<QImage> pyramid;
+        // Number of the current stretch, and whether rawImage and pyramid hold its rendition
+        uint32_t displayGeneration { 0 };
+        bool renditionComplete { false };
+        /// Rendition Future Watcher
+        QFutureWatcher<DisplayRendition> renditionWatcher;
 
         bool firstLoad { true };
         bool markStars { false };
@@ -336,6 +357,8 @@ class FITSView : public QScrollArea
 
         // Params for stretching image.
         StretchParams stretchParams;
+        // Params of the stretch being displayed, identity when the image is not stretched.
+        StretchParams displayParams;
 
         // Resolution for display. Sampling=2 means display every other sample.
         int sampling { 1 };
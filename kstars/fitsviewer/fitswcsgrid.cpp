@@ -0,0 +1,328 @@
+/***************************************************************************
+                          fitswcsgrid.cpp  -  FITS Image
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "fitswcsgrid.h"
+
+#include <wcs.h>
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <fits_debug.h>
+
+const int FITSWCSGrid::TILE_SIZE;
+const int FITSWCSGrid::MAX_STEP;
+constexpr double FITSWCSGrid::MAX_ERROR;
+
+namespace
+{
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+// Angle between two unit vectors in radians, accurate for small angles too
+double angleBetween(double x1, double y1, double z1, double x2, double y2, double z2)
+{
+    double cx = y1 * z2 - z1 * y2;
+    double cy = z1 * x2 - x1 * z2;
+    double cz = x1 * y2 - y1 * x2;
+
+    return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), x1 * x2 + y1 * y2 + z1 * z2);
+}
+
+// Converts a (not necessarily normalized) vector to RA and Dec in degrees, with RA within 180 degrees of ra0
+void toWorld(double x, double y, double z, double ra0, double &ra, double &dec)
+{
+    ra  = std::atan2(y, x) * 180.0 / M_PI;
+    dec = std::atan2(z, std::sqrt(x * x + y * y)) * 180.0 / M_PI;
+
+    ra -= 360.0 * std::floor((ra - ra0 + 180.0) / 360.0);
+}
+}
+
+FITSWCSGrid::FITSWCSGrid(struct wcsprm *wcs, int width, int height) : m_wcs(wcs), m_Width(width), m_Height(height)
+{
+    m_TilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    m_TilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    m_Tiles.resize(m_TilesX * m_TilesY);
+}
+
+FITSWCSGrid::~FITSWCSGrid()
+{
+    if (m_CachedTiles > 0)
+        qCDebug(KSTARS_FITS) << "WCS grid computed" << m_CachedTiles << "of" << m_Tiles.size() << "tiles";
+}
+
+int FITSWCSGrid::cachedTiles() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_CachedTiles;
+}
+
+bool FITSWCSGrid::pixelToWorld(double x, double y, double &ra, double &dec)
+{
+    if (x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+        return evaluate(x, y, ra, dec);
+
+    int tx = static_cast<int>(x) / TILE_SIZE;
+    int ty = static_cast<int>(y) / TILE_SIZE;
+
+    QMutexLocker locker(&m_Mutex);
+    const Tile *t = tile(tx, ty);
+
+    double u = (x - tx * TILE_SIZE) / t->step;
+    double v = (y - ty * TILE_SIZE) / t->step;
+    int i    = std::min(static_cast<int>(u), t->nodes - 2);
+    int j    = std::min(static_cast<int>(v), t->nodes - 2);
+    double s = u - i;
+    double r = v - j;
+
+    int n00 = j * t->nodes + i;
+    int n10 = n00 + 1;
+    int n01 = n00 + t->nodes;
+    int n11 = n01 + 1;
+
+    double w00 = (1 - s) * (1 - r), w10 = s * (1 - r), w01 = (1 - s) * r, w11 = s * r;
+
+    double px = w00 * t->x[n00] + w10 * t->x[n10] + w01 * t->x[n01] + w11 * t->x[n11];
+    double py = w00 * t->y[n00] + w10 * t->y[n10] + w01 * t->y[n01] + w11 * t->y[n11];
+    double pz = w00 * t->z[n00] + w10 * t->z[n10] + w01 * t->z[n01] + w11 * t->z[n11];
+
+    locker.unlock();
+
+    // One of the surrounding nodes has no valid coordinates, ask wcslib about this very pixel
+    if (std::isnan(px) || std::isnan(py) || std::isnan(pz))
+        return evaluate(x, y, ra, dec);
+
+    toWorld(px, py, pz, 180.0, ra, dec);
+    return true;
+}
+
+bool FITSWCSGrid::bounds(double &minRA, double &maxRA, double &minDec, double &maxDec)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    if (!m_BoundsValid)
+    {
+        // The extremes of the coordinates are on the edges of the image, unless a pole is in it. Sample the edges
+        // finely and the inside coarsely, without building any tile.
+        std::vector<double> pixcrd, x, y, z;
+        auto addSample = [&pixcrd](double px, double py)
+        {
+            pixcrd.push_back(px);
+            pixcrd.push_back(py);
+        };
+
+        const double right = m_Width - 1, bottom = m_Height - 1;
+        for (int i = 0; i < m_Width - 1; i += MAX_STEP)
+        {
+            addSample(i, 0);
+            addSample(i, bottom);
+        }
+        for (int j = 0; j < m_Height - 1; j += MAX_STEP)
+        {
+            addSample(0, j);
+            addSample(right, j);
+        }
+        addSample(right, bottom);
+        for (int j = TILE_SIZE; j < m_Height - 1; j += TILE_SIZE)
+            for (int i = TILE_SIZE; i < m_Width - 1; i += TILE_SIZE)
+                addSample(i, j);
+
+        evaluate(pixcrd, x, y, z);
+
+        // Keep RA continuous across the image, even if it straddles 0h
+        double ra0 = m_wcs->crval[0];
+
+        m_MinRA  = m_MinDec = std::numeric_limits<double>::max();
+        m_MaxRA  = m_MaxDec = -std::numeric_limits<double>::max();
+
+        for (size_t n = 0; n < x.size(); n++)
+        {
+            if (std::isnan(x[n]))
+                continue;
+
+            double ra, dec;
+            toWorld(x[n], y[n], z[n], ra0, ra, dec);
+
+            m_MinRA  = std::min(m_MinRA, ra);
+            m_MaxRA  = std::max(m_MaxRA, ra);
+            m_MinDec = std::min(m_MinDec, dec);
+            m_MaxDec = std::max(m_MaxDec, dec);
+        }
+
+        // An image containing a pole covers all right ascensions, up to that pole
+        for (double pole : { 90.0, -90.0 })
+        {
+            double world[2] = { ra0, pole }, phi, theta, imgcrd[2], pixel[2];
+            int stat[1];
+
+            if (m_MinRA > m_MaxRA || wcss2p(m_wcs, 1, 2, world, &phi, &theta, imgcrd, pixel, stat) != 0)
+                continue;
+
+            if (pixel[0] >= 0 && pixel[0] <= right && pixel[1] >= 0 && pixel[1] <= bottom)
+            {
+                m_MinRA  = ra0 - 180.0;
+                m_MaxRA  = ra0 + 180.0;
+                m_MinDec = std::min(m_MinDec, pole);
+                m_MaxDec = std::max(m_MaxDec, pole);
+            }
+        }
+
+        m_BoundsValid = true;
+    }
+
+    minRA  = m_MinRA;
+    maxRA  = m_MaxRA;
+    minDec = m_MinDec;
+    maxDec = m_MaxDec;
+
+    return m_MinRA <= m_MaxRA;
+}
+
+const FITSWCSGrid::Tile *FITSWCSGrid::tile(int tx, int ty)
+{
+    std::unique_ptr<Tile> &t = m_Tiles[ty * m_TilesX + tx];
+
+    if (!t)
+    {
+        t.reset(new Tile());
+        buildTile(tx, ty, *t);
+        m_CachedTiles++;
+    }
+
+    return t.get();
+}
+
+void FITSWCSGrid::buildTile(int tx, int ty, Tile &t)
+{
+    const double x0 = tx * TILE_SIZE;
+    const double y0 = ty * TILE_SIZE;
+    std::vector<double> pixcrd, cx, cy, cz;
+
+    for (int step = MAX_STEP; ; step /= 2)
+    {
+        int n = TILE_SIZE / step + 1;
+
+        pixcrd.resize(2 * n * n);
+        for (int j = 0; j < n; j++)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                pixcrd[2 * (j * n + i)]     = x0 + i * step;
+                pixcrd[2 * (j * n + i) + 1] = y0 + j * step;
+            }
+        }
+
+        t.step  = step;
+        t.nodes = n;
+        evaluate(pixcrd, t.x, t.y, t.z);
+
+        if (step == 1)
+            break;
+
+        // Check the interpolated coordinates at the center of every cell against wcslib
+        int m = n - 1;
+
+        pixcrd.resize(2 * m * m);
+        for (int j = 0; j < m; j++)
+        {
+            for (int i = 0; i < m; i++)
+            {
+                pixcrd[2 * (j * m + i)]     = x0 + (i + 0.5) * step;
+                pixcrd[2 * (j * m + i) + 1] = y0 + (j + 0.5) * step;
+            }
+        }
+        evaluate(pixcrd, cx, cy, cz);
+
+        double maxError = 0;
+        for (int j = 0; j < m; j++)
+        {
+            for (int i = 0; i < m; i++)
+            {
+                int n00 = j * n + i, n10 = n00 + 1, n01 = n00 + n, n11 = n01 + 1;
+                int c   = j * m + i;
+
+                double px = t.x[n00] + t.x[n10] + t.x[n01] + t.x[n11];
+                double py = t.y[n00] + t.y[n10] + t.y[n01] + t.y[n11];
+                double pz = t.z[n00] + t.z[n10] + t.z[n01] + t.z[n11];
+                double norm = std::sqrt(px * px + py * py + pz * pz);
+
+                if (std::isnan(norm) || std::isnan(cx[c]) || norm == 0)
+                    continue;
+
+                // Pixel scale of this cell, from the distance between its nodes
+                double scale = angleBetween(t.x[n00], t.y[n00], t.z[n00], t.x[n11], t.y[n11], t.z[n11]) /
+                               (M_SQRT2 * step);
+                if (scale <= 0)
+                    continue;
+
+                double error = angleBetween(px / norm, py / norm, pz / norm, cx[c], cy[c], cz[c]) / scale;
+                maxError     = std::max(maxError, error);
+            }
+        }
+
+        if (maxError <= MAX_ERROR)
+            break;
+    }
+}
+
+void FITSWCSGrid::evaluate(const std::vector<double> &pixcrd, std::vector<double> &x, std::vector<double> &y,
+                           std::vector<double> &z)
+{
+    int count = static_cast<int>(pixcrd.size() / 2);
+    std::vector<double> imgcrd(2 * count), world(2 * count), phi(count), theta(count);
+    std::vector<int> stat(count);
+
+    x.assign(count, NaN);
+    y.assign(count, NaN);
+    z.assign(count, NaN);
+
+    // Status 8 only means that some of the pixels are invalid, which stat tells us about
+    int status = wcsp2s(m_wcs, count, 2, pixcrd.data(), imgcrd.data(), phi.data(), theta.data(), world.data(),
+                        stat.data());
+    if (status != 0 && status != WCSERR_BAD_PIX)
+    {
+        qCWarning(KSTARS_FITS) << "wcsp2s error" << status << ":" << wcs_errmsg[status];
+        return;
+    }
+
+    for (int k = 0; k < count; k++)
+    {
+        if (stat[k] != 0)
+            continue;
+
+        double ra  = world[2 * k] * M_PI / 180.0;
+        double dec = world[2 * k + 1] * M_PI / 180.0;
+
+        x[k] = std::cos(dec) * std::cos(ra);
+        y[k] = std::cos(dec) * std::sin(ra);
+        z[k] = std::sin(dec);
+    }
+}
+
+bool FITSWCSGrid::evaluate(double px, double py, double &ra, double &dec)
+{
+    int stat[1];
+    double pixcrd[2] = { px, py }, imgcrd[2], world[2], phi, theta;
+
+    if (wcsp2s(m_wcs, 1, 2, pixcrd, imgcrd, &phi, &theta, world, stat) != 0)
+        return false;
+
+    ra  = world[0] - 360.0 * std::floor(world[0] / 360.0);
+    dec = world[1];
+    return true;
+}
@@ -0,0 +1,110 @@
+/***************************************************************************
+                          fitswcsgrid.h  -  FITS Image
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QMutex>
+
+#include <memory>
+#include <vector>
+
+struct wcsprm;
+
+/**
+ * @class FITSWCSGrid
+ * @short Lazily evaluated pixel to world coordinate lookup for a FITS image.
+ *
+ * Evaluating wcsp2s() for every pixel of a large frame takes seconds and a lot of memory. Instead, the image
+ * is split into tiles of TILE_SIZE x TILE_SIZE pixels. The first time a pixel of a tile is looked up, wcsp2s()
+ * is evaluated on a coarse grid of nodes covering the tile, and the coordinates of the pixels in between are
+ * interpolated bilinearly on the unit sphere. Only the tiles that are actually looked up are computed and kept.
+ *
+ * Bilinear interpolation errs the most at the center of a grid cell. When a tile is built, its node spacing
+ * is halved until the interpolated coordinates at the center of every cell are within MAX_ERROR pixels of
+ * the exact wcsp2s() result. For the smooth distortions of real optics this keeps the lookup error below
+ * MAX_ERROR pixels everywhere in the image. Tiles
+ * with strong distortion get a finer grid, down to one node per pixel, where no interpolation is left.
+ *
+ * The grid does not own the wcsprm struct, which must outlive it.
+ */
+class FITSWCSGrid
+{
+    public:
+        /// Edge length of a tile in pixels
+        static const int TILE_SIZE = 256;
+        /// Coarsest node spacing in pixels. Must divide TILE_SIZE.
+        static const int MAX_STEP = 32;
+        /// Maximum interpolation error, in pixels
+        static constexpr double MAX_ERROR = 0.05;
+
+        FITSWCSGrid(struct wcsprm *wcs, int width, int height);
+        ~FITSWCSGrid();
+
+        /**
+         * @brief pixelToWorld Look up the J2000 world coordinates of a pixel.
+         * Pixels outside the image are passed to wcsp2s() directly.
+         * @param x pixel X coordinate, in the same convention as FITSData::pixelToWCS()
+         * @param y pixel Y coordinate
+         * @param ra returns the right ascension in degrees, in the range [0, 360)
+         * @param dec returns the declination in degrees
+         * @return True if the pixel has valid world coordinates, false otherwise.
+         */
+        bool pixelToWorld(double x, double y, double &ra, double &dec);
+
+        /**
+         * @brief bounds Range of right ascension and declination covered by the image, in degrees.
+         * The range is computed once from samples along the edges of the image and a coarse grid inside it,
+         * without building any tile, and covers all right ascensions if a pole is in the image. Right ascension
+         * is kept within 180 degrees of the reference pixel, so it may be negative or exceed 360 degrees for
+         * images that straddle 0h.
+         * @return True if at least one pixel of the image has valid world coordinates.
+         */
+        bool bounds(double &minRA, double &maxRA, double &minDec, double &maxDec);
+
+        /** @return number of tiles computed so far */
+        int cachedTiles() const;
+
+    private:
+        struct Tile
+        {
+            /// Node spacing in pixels
+            int step { 0 };
+            /// Number of nodes along each side
+            int nodes { 0 };
+            /// Unit vectors of the nodes, row by row. NaN where wcsp2s() failed.
+            std::vector<double> x, y, z;
+        };
+
+        const Tile *tile(int tx, int ty);
+        void buildTile(int tx, int ty, Tile &t);
+
+        /// Evaluates wcsp2s() on (x, y) pixel pairs. Returns unit vectors, NaN for invalid pixels.
+        void evaluate(const std::vector<double> &pixcrd, std::vector<double> &x, std::vector<double> &y,
+                      std::vector<double> &z);
+        bool evaluate(double px, double py, double &ra, double &dec);
+
+        struct wcsprm *m_wcs { nullptr };
+        int m_Width { 0 };
+        int m_Height { 0 };
+        int m_TilesX { 0 };
+        int m_TilesY { 0 };
+
+        std::vector<std::unique_ptr<Tile>> m_Tiles;
+        int m_CachedTiles { 0 };
+        mutable QMutex m_Mutex;
+
+        bool m_BoundsValid { false };
+        double m_MinRA { 0 }, m_MaxRA { 0 }, m_MinDec { 0 }, m_MaxDec { 0 };
+};
@@ -54,10 +54,12 @@ T median(T *values, int size, int sampleBy)
 // The extension parameters are not used.
 // Sampling is applied to the output (that is, with sampling=2, we compute every other output
 // sample both in width and height, so the output would have about 4X fewer pixels.
+// Only the output rows first_row to end_row - 1 are computed.
 template <typename T>
 void stretchOneChannel(T *input_buffer, QImage *output_image,
                        const StretchParams& stretch_params, 
-                       int input_range, int image_height, int image_width, int sampling)
+                       int input_range, int image_height, int image_width, int sampling,
+                       int first_row, int end_row)
 {
   QVector<QFuture<void>> futures;
 
@@ -82,7 +84,7 @@ void stretchOneChannel(T *input_buffer, QImage *output_image,
   const float k2 = ((2 * midtones) - 1) * hsRangeFactor / maxInput;
   
   // Increment the input index by the sampling, the output index increments by 1.
-  for (int j = 0, jout = 0; j < image_height; j+=sampling, jout++)
+  for (int j = first_row * sampling, jout = first_row; j < image_height && jout < end_row; j+=sampling, jout++)
   {
     futures.append(QtConcurrent::run([ = ]()
     {
@@ -113,10 +115,12 @@ void stretchOneChannel(T *input_buffer, QImage *output_image,
 // is stored fully, then the green, then the blue.
 // Sampling is applied to the output (that is, with sampling=2, we compute every other output
 // sample both in width and height, so the output would have about 4X fewer pixels.
+// Only the output rows firstRow to endRow - 1 are computed.
 template <typename T>
 void stretchThreeChannels(T *inputBuffer, QImage *outputImage,
                           const StretchParams& stretchParams, 
-                          int inputRange, int imageHeight, int imageWidth, int sampling)
+                          int inputRange, int imageHeight, int imageWidth, int sampling,
+                          int firstRow, int endRow)
 {
   QVector<QFuture<void>> futures;
 
@@ -158,7 +162,7 @@ void stretchThreeChannels(T *inputBuffer, QImage *outputImage,
   
   const int size = imageWidth * imageHeight;
   
-  for (int j = 0, jout = 0; j < imageHeight; j+=sampling, jout++)
+  for (int j = firstRow * sampling, jout = firstRow; j < imageHeight && jout < endRow; j+=sampling, jout++)
   {
     futures.append(QtConcurrent::run([ = ]()
     {
@@ -211,14 +215,15 @@ void stretchThreeChannels(T *inputBuffer, QImage *outputImage,
 template <typename T>
 void stretchChannels(T *input_buffer, QImage *output_image,
                        const StretchParams& stretch_params, 
-                     int input_range, int image_height, int image_width, int num_channels, int sampling)
+                     int input_range, int image_height, int image_width, int num_channels, int sampling,
+                     int first_row, int end_row)
 {
     if (num_channels == 1)
       stretchOneChannel(input_buffer, output_image, stretch_params, input_range,
-                        image_height, image_width, sampling);
+                        image_height, image_width, sampling, first_row, end_row);
     else if (num_channels == 3)
       stretchThreeChannels(input_buffer, output_image, stretch_params, input_range,
-                           image_height, image_width, sampling);
+                           image_height, image_width, sampling, first_row, end_row);
 }
   
 // See section 8.5.7 in above link  https://pixinsight.com/doc/docs/XISF-1.0-spec/XISF-1.0-spec.html
@@ -317,6 +322,11 @@ Stretch::Stretch(int width, int height, int channels, int data_type)
 }
 
 void Stretch::run(uint8_t *input, QImage *outputImage, int sampling)
+{
+    run(input, outputImage, sampling, 0, outputImage->height());
+}
+
+void Stretch::run(uint8_t *input, QImage *outputImage, int sampling, int firstRow, int endRow)
 {
     Q_ASSERT(outputImage->width() == (image_width + sampling - 1) / sampling);
     Q_ASSERT(outputImage->height() == (image_height + sampling - 1) / sampling);
@@ -326,31 +336,31 @@ void Stretch::run(uint8_t *input, QImage *outputImage, int sampling)
     {
         case TBYTE:
             stretchChannels(reinterpret_cast<uint8_t*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, firstRow, endRow);
             break;
         case TSHORT:
             stretchChannels(reinterpret_cast<short*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, firstRow, endRow);
             break;
         case TUSHORT:
             stretchChannels(reinterpret_cast<unsigned short*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, firstRow, endRow);
             break;
         case TLONG:
             stretchChannels(reinterpret_cast<long*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, firstRow, endRow);
             break;
         case TFLOAT:
             stretchChannels(reinterpret_cast<float*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, firstRow, endRow);
             break;
         case TLONGLONG:
             stretchChannels(reinterpret_cast<long long*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, firstRow, endRow);
             break;
         case TDOUBLE:
             stretchChannels(reinterpret_cast<double*>(input), outputImage, params,
-                            input_range, image_height, image_width, image_channels, sampling);
+                            input_range, image_height, image_width, image_channels, sampling, firstRow, endRow);
             break;
         default:
         break;
@@ -83,6 +83,13 @@ class Stretch
          */
         void run(uint8_t *input, QImage *output_image, int sampling=1);
 
+        /**
+         * @brief run Same as above, restricted to some rows of output_image.
+         * @param first_row first row of output_image to compute
+         * @param end_row row of output_image following the last one to compute
+         */
+        void run(uint8_t *input, QImage *output_image, int sampling, int first_row, int end_row);
+
  private:
         // Adjusts input_range for float and double types.
         void recalculateInputRange(uint8_t *input);
@@ -139,13 +139,12 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
   bool freeImage = false;
 
   m_HEALpix->getCornerPoints(level, pix, cornerSkyCoords);
-  bool isVisible = false;
+  bool cornerVisible[4];
 
-  for (int i=0; i < 4; i++)
-  {
-      cornerScreenCoords[i] = m_projector->toScreen(&cornerSkyCoords[i]);
-      isVisible |= m_projector->checkVisibility(&cornerSkyCoords[i]);
-  }  
+  m_projector->toScreenBatch(cornerSkyCoords, 4, cornerScreenCoords);
+  m_projector->checkVisibilityBatch(cornerSkyCoords, 4, cornerVisible);
+
+  bool isVisible = cornerVisible[0] || cornerVisible[1] || cornerVisible[2] || cornerVisible[3];
 
   //if (SKPLANECheckFrustumToPolygon(trfGetFrustum(), pts, 4))
   // Is the right way to do this?
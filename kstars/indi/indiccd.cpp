@@ -102,6 +102,71 @@ bool WriteImageFileInternal(const QString &filename, char *buffer, const size_t
     return true;
 }
 
+#ifdef HAVE_CFITSIO
+// Internal function to write a FITS blob to disk as a tile-compressed (.fz) file.
+bool WriteCompressedImageFileInternal(const QString &filename, char *buffer, const size_t size,
+                                      const QString &filter)
+{
+    int status = 0;
+    fitsfile *input = nullptr, *output = nullptr;
+    void *memory = buffer;
+    size_t memorySize = size;
+
+    if (fits_open_memfile(&input, filename.toLatin1().data(), READONLY, &memory, &memorySize, 0, nullptr, &status) ||
+            fits_movabs_hdu(input, 1, nullptr, &status))
+    {
+        fits_report_error(stderr, status);
+        status = 0;
+        fits_close_file(input, &status);
+        qCCritical(KSTARS_INDI) << "ISD:CCD Error: Unable to read FITS blob for " << filename;
+        return false;
+    }
+
+    // Replace the empty file reserved by generateFilename()
+    QFile::remove(filename);
+
+    // Compress in tiles of one row, as fpack does, with its default lossless algorithm.
+    // cfitsio creates an empty primary HDU and stores the image in the first extension.
+    // Tiles are compressed one after the other: cfitsio appends them to the heap of a single binary table through
+    // one fitsfile handle, which may not be shared between threads. This runs on the file writing thread, so it
+    // overlaps the next exposure rather than delaying it.
+    if (fits_create_diskfile(&output, filename.toLatin1(), &status) ||
+            fits_set_compression_type(output, RICE_1, &status) ||
+            fits_img_compress(input, output, &status))
+    {
+        fits_report_error(stderr, status);
+        status = 0;
+        if (output != nullptr)
+            fits_delete_file(output, &status);
+        status = 0;
+        fits_close_file(input, &status);
+        qCCritical(KSTARS_INDI) << "ISD:CCD Error: Unable to compress " << filename;
+        return false;
+    }
+
+    if (filter.isEmpty() == false)
+    {
+        QString filt(filter);
+        filt.replace(' ', '_');
+        fits_update_key_str(output, "FILTER", filt.toLatin1().data(), QString("Filter name").toLatin1().data(), &status);
+    }
+
+    fits_close_file(output, &status);
+    fits_close_file(input, &status);
+    if (status)
+    {
+        fits_report_error(stderr, status);
+        return false;
+    }
+
+    QFile(filename).setPermissions(QFileDevice::ReadUser |
+                                   QFileDevice::WriteUser |
+                                   QFileDevice::ReadGroup |
+                                   QFileDevice::ReadOther);
+    return true;
+}
+#endif
+
 // Internal function to write a temporary file image blob to disk.
 bool writeTempImageFile(const QString &format, char * buffer, size_t size, QString *filename)
 {
@@ -1481,8 +1546,15 @@ bool CCD::writeImageFile(const QString &filename, IBLOB *bp, bool is_fits)
         // Copy memory, and write file on a separate thread.
         // Probably too late to return an error if the file couldn't write.
         memcpy(fileWriteBuffer, bp->blob, bp->size);
-        fileWriteThread = QtConcurrent::run(WriteImageFileInternal, fileWriteFilename,
-                                            fileWriteBuffer, bp->size, is_fits, filter);
+#ifdef HAVE_CFITSIO
+        // Compression runs on the writing thread too, so it does not delay the next exposure
+        if (filename.endsWith(".fz"))
+            fileWriteThread = QtConcurrent::run(WriteCompressedImageFileInternal, fileWriteFilename,
+                                                fileWriteBuffer, bp->size, filter);
+        else
+#endif
+            fileWriteThread = QtConcurrent::run(WriteImageFileInternal, fileWriteFilename,
+                                                fileWriteBuffer, bp->size, is_fits, filter);
         filter = "";
     }
     else
@@ -1584,7 +1656,13 @@ void CCD::processBLOB(IBLOB *bp)
     // Create file name for others
     else
     {
-        if (!generateFilename(format, targetChip->isBatchMode(), &filename) ||
+        QString fileFormat = format;
+#ifdef HAVE_CFITSIO
+        // Captured FITS are saved tile-compressed if requested, see writeImageFile()
+        if (BType == BLOB_FITS && Options::compressCapturedFITS() && format.endsWith(".fz") == false)
+            fileFormat.append(".fz");
+#endif
+        if (!generateFilename(fileFormat, targetChip->isBatchMode(), &filename) ||
                 !writeImageFile(filename, bp, BType == BLOB_FITS))
         {
             emit BLOBUpdated(nullptr);
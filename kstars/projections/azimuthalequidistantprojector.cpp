@@ -44,6 +44,13 @@ double AzimuthalEquidistantProjector::projectionK(double x) const
     return ((crad != 0) ? crad / sin(crad) : 1); // This handles the 0/0 case. The limit of x / sin(x) is 1 as x -> 0.
 }
 
+ArrayXd AzimuthalEquidistantProjector::projectionKBatch(const ArrayXd &x) const
+{
+    ArrayXd crad = x.acos();
+    // This handles the 0/0 case. The limit of x / sin(x) is 1 as x -> 0.
+    return (crad != 0).select(crad / crad.sin(), 1.0);
+}
+
 double AzimuthalEquidistantProjector::projectionL(double x) const
 {
     return x;
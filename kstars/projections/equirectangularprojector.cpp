@@ -71,6 +71,43 @@ Vector2f EquirectangularProjector::toScreenVec(const SkyPoint *o, bool oRefract,
     return p;
 }
 
+void EquirectangularProjector::toScreenBatch(const double *lon, const double *lat, int count, float *x, float *y,
+                                             bool oRefract, bool *onVisibleHemisphere) const
+{
+    if (count <= 0)
+        return;
+
+    Map<const ArrayXd> Lon(lon, count);
+    ArrayXd Y = Map<const ArrayXd>(lat, count);
+    ArrayXd dX;
+
+    oRefract &= m_vp.useRefraction;
+    if (m_vp.useAltAz)
+    {
+        if (oRefract)
+        {
+            for (int i = 0; i < count; ++i)
+                Y[i] = SkyPoint::refract(Y[i] / dms::DegToRad) * dms::DegToRad; //account for atmospheric refraction
+        }
+        dX = m_vp.focus->az().radians() - Lon;
+        Map<ArrayXf>(y, count) = (0.5 * m_vp.height - m_vp.zoomFactor * (Y - m_vp.focus->alt().radians())).cast<float>();
+    }
+    else
+    {
+        dX = Lon - m_vp.focus->ra().radians();
+        Map<ArrayXf>(y, count) = (0.5 * m_vp.height - m_vp.zoomFactor * (Y - m_vp.focus->dec().radians())).cast<float>();
+    }
+
+    // Same as KSUtils::reduceAngle(dX, -dms::PI, dms::PI)
+    dX -= 2.0 * dms::PI * ((dX + dms::PI) / (2.0 * dms::PI)).floor();
+
+    Map<ArrayXf> X(x, count);
+    X = (0.5 * m_vp.width - m_vp.zoomFactor * dX).cast<float>();
+
+    if (onVisibleHemisphere)
+        Map<Array<bool, Dynamic, 1>>(onVisibleHemisphere, count) = (X > 0) && (X < m_vp.width);
+}
+
 SkyPoint EquirectangularProjector::fromScreen(const QPointF &p, dms *LST, const dms *lat) const
 {
     SkyPoint result;
@@ -36,6 +36,9 @@ class EquirectangularProjector : public Projector
     double radius() const override;
     bool unusablePoint(const QPointF &p) const override;
     Vector2f toScreenVec(const SkyPoint *o, bool oRefract = true, bool *onVisibleHemisphere = nullptr) const override;
+    using Projector::toScreenBatch;
+    void toScreenBatch(const double *lon, const double *lat, int count, float *x, float *y, bool oRefract = true,
+                       bool *onVisibleHemisphere = nullptr) const override;
     SkyPoint fromScreen(const QPointF &p, dms *LST, const dms *lat) const override;
     QVector<Vector2f> groundPoly(SkyPoint *labelpoint = nullptr, bool *drawLabel = nullptr) const override;
     void updateClipPoly() override;
@@ -39,6 +39,11 @@ double LambertProjector::projectionK(double x) const
     return sqrt(2.0 / (1.0 + x));
 }
 
+ArrayXd LambertProjector::projectionKBatch(const ArrayXd &x) const
+{
+    return (2.0 / (1.0 + x)).sqrt();
+}
+
 double LambertProjector::projectionL(double x) const
 {
     return 2.0 * asin(0.5 * x);
@@ -36,6 +36,7 @@ class LambertProjector : public Projector
     Projection type() const override;
     double radius() const override;
     double projectionK(double x) const override;
+    ArrayXd projectionKBatch(const ArrayXd &x) const override;
     double projectionL(double x) const override;
 };
 
@@ -40,6 +40,11 @@ double OrthographicProjector::projectionK(double x) const
     return 1.0;
 }
 
+ArrayXd OrthographicProjector::projectionKBatch(const ArrayXd &x) const
+{
+    return ArrayXd::Ones(x.size());
+}
+
 double OrthographicProjector::projectionL(double x) const
 {
     return asin(x);
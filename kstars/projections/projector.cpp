@@ -558,3 +558,149 @@ Vector2f Projector::toScreenVec(const SkyPoint *o, bool oRefract, bool *onVisibl
 #endif
     return Vector2f(x, y);
 }
+
+ArrayXd Projector::projectionKBatch(const ArrayXd &x) const
+{
+    ArrayXd k(x.size());
+    for (Index i = 0; i < x.size(); ++i)
+        k[i] = projectionK(x[i]);
+    return k;
+}
+
+void Projector::toScreenBatch(const double *lon, const double *lat, int count, float *x, float *y, bool oRefract,
+                              bool *onVisibleHemisphere) const
+{
+    if (count <= 0)
+        return;
+
+    Map<const ArrayXd> Lon(lon, count);
+    ArrayXd Y = Map<const ArrayXd>(lat, count);
+    ArrayXd dX;
+
+    oRefract &= m_vp.useRefraction;
+    if (m_vp.useAltAz)
+    {
+        if (oRefract)
+        {
+            for (int i = 0; i < count; ++i)
+                Y[i] = SkyPoint::refract(Y[i] / dms::DegToRad) * dms::DegToRad; //account for atmospheric refraction
+        }
+        dX = m_vp.focus->az().radians() - Lon;
+    }
+    else
+        dX = Lon - m_vp.focus->ra().radians();
+
+    Array<bool, Dynamic, 1> finite = Y.isFinite() && dX.isFinite();
+
+    // Same as KSUtils::reduceAngle(dX, -dms::PI, dms::PI)
+    dX -= 2.0 * dms::PI * ((dX + dms::PI) / (2.0 * dms::PI)).floor();
+
+    ArrayXd sindX = dX.sin(), cosdX = dX.cos();
+    ArrayXd sinY = Y.sin(), cosY = Y.cos();
+
+    //c is the cosine of the angular distance from the center
+    ArrayXd c = m_sinY0 * sinY + m_cosY0 * cosY * cosdX;
+    ArrayXd k = projectionKBatch(c);
+
+    double origX = m_vp.width / 2;
+    double origY = m_vp.height / 2;
+
+    ArrayXd px = origX - m_vp.zoomFactor * k * cosY * sindX;
+    ArrayXd py = origY - m_vp.zoomFactor * k * (m_cosY0 * sinY - m_sinY0 * cosY * cosdX);
+#ifdef KSTARS_LITE
+    double skyRotation = SkyMapLite::Instance()->getSkyRotation();
+    if (skyRotation != 0)
+    {
+        dms rotation(skyRotation);
+        double cosT, sinT;
+
+        rotation.SinCos(sinT, cosT);
+
+        ArrayXd rx = px - origX, ry = py - origY;
+        px = origX + rx * cosT - ry * sinT;
+        py = origY + rx * sinT + ry * cosT;
+    }
+#endif
+
+    // Like toScreenVec(), map points with invalid coordinates to the origin
+    Map<ArrayXf>(x, count) = finite.select(px, 0.0).cast<float>();
+    Map<ArrayXf>(y, count) = finite.select(py, 0.0).cast<float>();
+
+    if (onVisibleHemisphere)
+        Map<Array<bool, Dynamic, 1>>(onVisibleHemisphere, count) = finite && (c > cosMaxFieldAngle());
+}
+
+void Projector::toScreenBatch(const SkyPoint *points, int count, QPointF *screen, bool oRefract,
+                              bool *onVisibleHemisphere) const
+{
+    if (count <= 0)
+        return;
+
+    ArrayXd lon(count), lat(count);
+    ArrayXf x(count), y(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        lon[i] = m_vp.useAltAz ? points[i].az().radians() : points[i].ra().radians();
+        lat[i] = m_vp.useAltAz ? points[i].alt().radians() : points[i].dec().radians();
+    }
+
+    toScreenBatch(lon.data(), lat.data(), count, x.data(), y.data(), oRefract, onVisibleHemisphere);
+
+    for (int i = 0; i < count; ++i)
+        screen[i] = QPointF(x[i], y[i]);
+}
+
+void Projector::checkVisibilityBatch(const double *lon, const double *lat, const double *alt, int count,
+                                     bool *visible) const
+{
+    if (count <= 0)
+        return;
+
+    Map<const ArrayXd> Lon(lon, count), Lat(lat, count);
+    Map<Array<bool, Dynamic, 1>> result(visible, count);
+    ArrayXd dY;
+
+    // See checkVisibility() for the reasoning behind these heuristics
+    if (m_vp.useAltAz)
+        dY = ((Lat - m_vp.focus->alt().radians()) / dms::DegToRad).abs() - 2.;
+    else
+        dY = ((Lat - m_vp.focus->dec().radians()) / dms::DegToRad).abs();
+
+    if (m_isPoleVisible)
+        dY *= 0.75; //increase effective FOV when pole visible.
+
+    result = (dY <= m_fov);
+
+    if (!m_isPoleVisible)
+    {
+        double focusLon = m_vp.useAltAz ? m_vp.focus->az().radians() : m_vp.focus->ra().radians();
+        ArrayXd dX      = ((Lon - focusLon) / dms::DegToRad).abs();
+
+        dX     = (dX > 180.0).select(360.0 - dX, dX); // take shorter distance around sky
+        result = result && (dX < m_xrange);
+    }
+
+    if (m_vp.fillGround)
+    {
+        Map<const ArrayXd> Alt(alt ? alt : lat, count);
+        result = result && (Alt / dms::DegToRad >= -1.0);
+    }
+}
+
+void Projector::checkVisibilityBatch(const SkyPoint *points, int count, bool *visible) const
+{
+    if (count <= 0)
+        return;
+
+    ArrayXd lon(count), lat(count), alt(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        lon[i] = m_vp.useAltAz ? points[i].az().radians() : points[i].ra().radians();
+        lat[i] = m_vp.useAltAz ? points[i].alt().radians() : points[i].dec().radians();
+        alt[i] = points[i].alt().radians();
+    }
+
+    checkVisibilityBatch(lon.data(), lat.data(), alt.data(), count, visible);
+}
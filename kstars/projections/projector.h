@@ -80,6 +80,9 @@ class Projector
     /** Update cached values for projector */
     void setViewParams(const ViewParams &p);
 
+    /** @return the ViewParams this projector was set up with */
+    const ViewParams &viewParams() const { return m_vp; }
+
     enum Projection
     {
         Lambert,
@@ -139,6 +142,33 @@ class Projector
      */
     QPointF toScreen(const SkyPoint *o, bool oRefract = true, bool *onVisibleHemisphere = nullptr) const;
 
+    /**
+     * @short Batch version of toScreenVec()
+     *
+     * Projects @p count points at once. The coordinates are given as contiguous arrays, in the
+     * coordinate system of the view: azimuth and unrefracted altitude if the map uses horizontal
+     * coordinates, RA and Dec otherwise. The default implementation evaluates the same expressions
+     * as toScreenVec() on whole arrays, with the projection-specific part in projectionKBatch().
+     *
+     * @param lon longitudes (azimuth or RA) in radians
+     * @param lat latitudes (altitude or Dec) in radians
+     * @param count number of points
+     * @param x output screen x coordinates
+     * @param y output screen y coordinates
+     * @param oRefract true = use Options::useRefraction() value, false = do not use refraction
+     * @param onVisibleHemisphere optional output mask, set to true for points on the visible
+     *   part of the celestial sphere
+     */
+    virtual void toScreenBatch(const double *lon, const double *lat, int count, float *x, float *y,
+                               bool oRefract = true, bool *onVisibleHemisphere = nullptr) const;
+
+    /**
+     * @short Batch version of toScreen() for an array of SkyPoints
+     * @see toScreenBatch()
+     */
+    void toScreenBatch(const SkyPoint *points, int count, QPointF *screen, bool oRefract = true,
+                       bool *onVisibleHemisphere = nullptr) const;
+
     /**
      * @short Determine RA, Dec coordinates of the pixel at (dx, dy), which are the
      * screen pixel coordinate offsets from the center of the Sky pixmap.
@@ -212,6 +242,25 @@ class Projector
      */
     bool checkVisibility(const SkyPoint *p) const;
 
+    /**
+     * @short Batch version of checkVisibility()
+     *
+     * Applies the same heuristics as checkVisibility() to @p count points at once.
+     * @param lon longitudes (azimuth or RA, depending on the view) in radians
+     * @param lat latitudes (altitude or Dec, depending on the view) in radians
+     * @param alt altitudes in radians, used to hide points below the ground. May be nullptr if the
+     *   map uses horizontal coordinates, in which case @p lat is used.
+     * @param count number of points
+     * @param visible output mask, set to true for points that are likely to be visible
+     */
+    void checkVisibilityBatch(const double *lon, const double *lat, const double *alt, int count, bool *visible) const;
+
+    /**
+     * @short Batch version of checkVisibility() for an array of SkyPoints
+     * @see checkVisibilityBatch()
+     */
+    void checkVisibilityBatch(const SkyPoint *points, int count, bool *visible) const;
+
     /**
      * Determine the on-screen position angle of a SkyPont with recept with NCP.
      * This is the object's sky position angle (w.r.t. North).
@@ -264,6 +313,13 @@ class Projector
      */
     virtual double projectionK(double x) const { return x; }
 
+    /**
+     * Batch version of projectionK(), used by toScreenBatch(). Projections should override
+     * this with an array expression that the compiler can vectorize.
+     * The default implementation calls projectionK() for each element.
+     */
+    virtual ArrayXd projectionKBatch(const ArrayXd &x) const;
+
     /**
      * This function handles some of the projection-specific code.
      * @see toScreen()
@@ -187,7 +187,7 @@ void AsteroidsComponent::loadDataFromText()
 
         // Add name to the list of object names
         objectNames(SkyObject::ASTEROID).append(name);
-        objectLists(SkyObject::ASTEROID).append(QPair<QString, const SkyObject *>(name, new_asteroid));
+        addToLists(SkyObject::ASTEROID, name, new_asteroid);
     }
 }
 
@@ -232,27 +232,9 @@ void AsteroidsComponent::draw(SkyPainter *skyp)
 #endif
 }
 
-SkyObject *AsteroidsComponent::objectNearest(SkyPoint *p, double &maxrad)
+bool AsteroidsComponent::isSearchable(SkyObject *o)
 {
-    SkyObject *oBest = nullptr;
-
-    if (!selected())
-        return nullptr;
-
-    for (auto o : m_ObjectList)
-    {
-        if (!((dynamic_cast<KSAsteroid*>(o)->toDraw())))
-            continue;
-
-        double r = o->angularDistanceTo(p).Degrees();
-        if (r < maxrad)
-        {
-            oBest  = o;
-            maxrad = r;
-        }
-    }
-
-    return oBest;
+    return static_cast<KSAsteroid *>(o)->toDraw();
 }
 
 void AsteroidsComponent::updateDataFile(bool isAutoUpdate)
@@ -312,6 +294,7 @@ void AsteroidsComponent::downloadReady()
 #endif
     // Reload asteroids
     loadData(true);
+    invalidateIndex();
 
 #ifdef KSTARS_LITE
     KStarsLite::Instance()->data()->setFullTimeUpdate();
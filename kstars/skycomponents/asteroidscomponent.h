@@ -51,7 +51,6 @@ class AsteroidsComponent : public QObject, public SolarSystemListComponent,
 
         void draw(SkyPainter *skyp) override;
         bool selected() override;
-        SkyObject *objectNearest(SkyPoint *p, double &maxrad) override;
 
         void updateDataFile(bool isAutoUpdate = false);
 
@@ -61,6 +60,10 @@ class AsteroidsComponent : public QObject, public SolarSystemListComponent,
         void downloadReady();
         void downloadError(const QString &errorString);
 
+    protected:
+        /** Asteroids too faint to be drawn cannot be picked either */
+        bool isSearchable(SkyObject *o) override;
+
     private:
         void loadDataFromText() override;
 
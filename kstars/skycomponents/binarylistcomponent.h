@@ -214,7 +214,7 @@ void  BinaryListComponent<T, Component>::loadDataFromBinary(QFile &binfile)
         parent->appendListObject(new_object);
         // Add name to the list of object names
         parent->objectNames(T::TYPE).append(new_object->name());
-        parent->objectLists(T::TYPE).append(QPair<QString, const SkyObject *>(new_object->name(), new_object));
+        parent->addToLists(T::TYPE, new_object->name(), new_object);
     }
     binfile.close();
 }
@@ -263,6 +263,6 @@ void  BinaryListComponent<T, Component>::clearData()
     parent->m_ObjectList.clear();
     parent->m_ObjectHash.clear();
 
-    parent->objectLists(T::TYPE).clear();
+    parent->clearLists(T::TYPE);
     parent->objectNames(T::TYPE).clear();
 }
@@ -19,7 +19,10 @@
 
 #include "catalogdata.h"
 #include "kstarsdata.h"
+#include "objectnameindex.h"
+#include "skymesh.h"
 #include "skypainter.h"
+#include "htmesh/MeshIterator.h"
 #include "skyobjects/starobject.h"
 #include "skyobjects/deepskyobject.h"
 
@@ -27,6 +30,7 @@ CatalogComponent::CatalogComponent(SkyComposite *parent, const QString &catname,
                                    bool callLoadData)
     : ListComponent(parent), m_catName(catname), m_Showerrs(showerrs), m_ccIndex(index)
 {
+    m_skyMesh = SkyMesh::Instance();
     if (callLoadData)
         loadData();
 }
@@ -66,6 +70,10 @@ void CatalogComponent::_loadData(bool includeCatalogDesignation)
 
     KStarsData::Instance()->catalogdb()->GetAllObjects(m_catName, m_ObjectList, names, this, includeCatalogDesignation);
 
+    m_ObjectIndex.clear();
+    for (auto obj : m_ObjectList)
+        appendIndex(obj);
+
     for (const auto &name : names)
     {
         if (name.first <= SkyObject::TYPE_UNKNOWN)
@@ -126,12 +134,12 @@ void CatalogComponent::_loadData(bool includeCatalogDesignation)
 
             if (!dupName)
             {
-                objectLists(obj->type()).append(QPair<QString, const SkyObject *>(name, obj));
+                addToLists(obj->type(), name, obj);
             }
 
             if (!longname.isEmpty() && !dupLongname && name != longname)
             {
-                objectLists(obj->type()).append(QPair<QString, const SkyObject *>(longname, obj));
+                addToLists(obj->type(), longname, obj);
             }
         }
     }
@@ -147,45 +155,66 @@ void CatalogComponent::_loadData(bool includeCatalogDesignation)
     m_catFluxUnit = loaded_catalog_data.fluxunit;
 }
 
-void CatalogComponent::update(KSNumbers *)
+void CatalogComponent::appendIndex(SkyObject *obj)
 {
-    if (selected())
+    m_ObjectIndex[m_skyMesh->index(obj)].append(obj);
+}
+
+void CatalogComponent::removeIndex(SkyObject *obj)
+{
+    auto it = m_ObjectIndex.find(m_skyMesh->index(obj));
+    if (it == m_ObjectIndex.end())
+        return;
+
+    it->removeAll(obj);
+    if (it->isEmpty())
+        m_ObjectIndex.erase(it);
+}
+
+void CatalogComponent::updateObject(SkyObject *obj, KStarsData *data)
+{
+    // We either have stars, or deep sky objects
+    if (obj->type() == 0)
     {
-        KStarsData *data = KStarsData::Instance();
-        foreach (SkyObject *obj, m_ObjectList)
+        StarObject *so = static_cast<StarObject *>(obj);
+        if (so->updateID != data->updateID())
         {
-            DeepSkyObject *dso = dynamic_cast<DeepSkyObject *>(obj);
-            StarObject *so     = dynamic_cast<StarObject *>(obj);
-            Q_ASSERT(dso || so); // We either have stars, or deep sky objects
-            if (dso)
+            so->updateID = data->updateID();
+            if (so->updateNumID != data->updateNumID())
             {
-                // Update the deep sky object if need be
-                if (dso->updateID != data->updateID())
-                {
-                    dso->updateID = data->updateID();
-                    if (dso->updateNumID != data->updateNumID())
-                    {
-                        dso->updateCoords(data->updateNum());
-                    }
-                    dso->EquatorialToHorizontal(data->lst(), data->geo()->lat());
-                }
+                so->updateCoords(data->updateNum());
             }
-            else
+            so->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+        }
+    }
+    else
+    {
+        // Do exactly the same thing for deep sky objects
+        DeepSkyObject *dso = static_cast<DeepSkyObject *>(obj);
+        if (dso->updateID != data->updateID())
+        {
+            dso->updateID = data->updateID();
+            if (dso->updateNumID != data->updateNumID())
             {
-                // Do exactly the same thing for stars
-                if (so->updateID != data->updateID())
-                {
-                    so->updateID = data->updateID();
-                    if (so->updateNumID != data->updateNumID())
-                    {
-                        so->updateCoords(data->updateNum());
-                    }
-                    so->EquatorialToHorizontal(data->lst(), data->geo()->lat());
-                }
+                dso->updateCoords(data->updateNum());
             }
+            dso->EquatorialToHorizontal(data->lst(), data->geo()->lat());
         }
+    }
+}
+
+void CatalogComponent::update(KSNumbers *)
+{
+#ifdef KSTARS_LITE
+    // SyncedCatalogItem draws every object of the catalog
+    if (selected())
+    {
+        KStarsData *data = KStarsData::Instance();
+        for (auto obj : m_ObjectList)
+            updateObject(obj, data);
         this->updateID = data->updateID();
     }
+#endif
 }
 
 void CatalogComponent::draw(SkyPainter *skyp)
@@ -196,34 +225,73 @@ void CatalogComponent::draw(SkyPainter *skyp)
     skyp->setBrush(Qt::NoBrush);
     skyp->setPen(QColor(m_catColor));
 
-    // Check if the coordinates have been updated
-    if (updateID != KStarsData::Instance()->updateID())
-        update(nullptr);
+    KStarsData *data = KStarsData::Instance();
 
     //Draw Custom Catalog objects
-    // FIXME: Improve using HTM!
-    foreach (SkyObject *obj, m_ObjectList)
+    MeshIterator region(m_skyMesh, DRAW_BUF);
+    while (region.hasNext())
     {
-        if (obj->type() == 0)
+        auto it = m_ObjectIndex.constFind(region.next());
+        if (it == m_ObjectIndex.constEnd())
+            continue;
+
+        for (SkyObject *obj : *it)
         {
-            StarObject *starobj = static_cast<StarObject *>(obj);
-            // FIXME SKYPAINTER
-            skyp->drawPointSource(starobj, starobj->mag(), starobj->spchar());
+            // Check if the coordinates have been updated
+            updateObject(obj, data);
+
+            if (obj->type() == 0)
+            {
+                StarObject *starobj = static_cast<StarObject *>(obj);
+                // FIXME SKYPAINTER
+                skyp->drawPointSource(starobj, starobj->mag(), starobj->spchar());
+            }
+            else
+            {
+                // FIXME: this PA calc is totally different from the one that was
+                // in DeepSkyComponent which is now in SkyPainter .... O_o
+                //      --hdevalence
+                // PA for Deep-Sky objects is 90 + PA because major axis is
+                // horizontal at PA=0
+                // double pa = 90. + map->findPA( dso, o.x(), o.y() );
+                //
+                // ^ Not sure if above is still valid -- asimha 2016/08/16
+                DeepSkyObject *dso = static_cast<DeepSkyObject *>(obj);
+                skyp->drawDeepSkyObject(dso, true);
+            }
         }
-        else
+    }
+}
+
+SkyObject *CatalogComponent::objectNearest(SkyPoint *p, double &maxrad)
+{
+    if (!selected())
+        return nullptr;
+
+    KStarsData *data = KStarsData::Instance();
+    SkyObject *oBest = nullptr;
+
+    MeshIterator region(m_skyMesh, OBJ_NEAREST_BUF);
+    while (region.hasNext())
+    {
+        auto it = m_ObjectIndex.constFind(region.next());
+        if (it == m_ObjectIndex.constEnd())
+            continue;
+
+        for (SkyObject *obj : *it)
         {
-            // FIXME: this PA calc is totally different from the one that was
-            // in DeepSkyComponent which is now in SkyPainter .... O_o
-            //      --hdevalence
-            // PA for Deep-Sky objects is 90 + PA because major axis is
-            // horizontal at PA=0
-            // double pa = 90. + map->findPA( dso, o.x(), o.y() );
-            //
-            // ^ Not sure if above is still valid -- asimha 2016/08/16
-            DeepSkyObject *dso = static_cast<DeepSkyObject *>(obj);
-            skyp->drawDeepSkyObject(dso, true);
+            updateObject(obj, data);
+
+            double r = obj->angularDistanceTo(p).Degrees();
+            if (r < maxrad)
+            {
+                oBest  = obj;
+                maxrad = r;
+            }
         }
     }
+
+    return oBest;
 }
 
 bool CatalogComponent::getVisibility()
@@ -231,6 +299,11 @@ bool CatalogComponent::getVisibility()
     return (Options::showCatalog().at(m_ccIndex) > 0) ? true : false;
 }
 
+int CatalogComponent::namePriority() const
+{
+    return ObjectNameIndex::CustomCatalogPriority;
+}
+
 bool CatalogComponent::selected()
 {
     // Do not draw / update custom catalogs if show deep-sky is turned off, even if they are chosen.
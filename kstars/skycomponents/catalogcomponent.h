@@ -22,6 +22,9 @@
 
 struct stat;
 
+class KStarsData;
+class SkyMesh;
+
 /**
  * @class CatalogComponent
  * Represents a custom user-defined catalog.
@@ -47,12 +50,24 @@ class CatalogComponent : public ListComponent
 
     /**
      * @short Draw custom catalog objects on the sky map.
+     * Only the objects in the trixels of the current aperture are drawn, and their coordinates
+     * are updated just in time.
      * @p psky Reference to the QPainter on which to paint
      */
     void draw(SkyPainter *skyp) override;
 
+    /**
+     * @short Update the coordinates of all objects.
+     * Only KStars Lite needs it, the sky map updates the objects it draws or searches just in time.
+     */
     void update(KSNumbers *num) override;
 
+    /**
+     * @short Find the object nearest to a point, among the trixels of the OBJ_NEAREST_BUF aperture.
+     * @see SkyComponent::objectNearest()
+     */
+    SkyObject *objectNearest(SkyPoint *p, double &maxrad) override;
+
     /** @return the name of the catalog */
     inline QString name() const { return m_catName; }
 
@@ -77,6 +92,8 @@ class CatalogComponent : public ListComponent
     /** @see SyncedCatalogItem */
     quint32 getUpdateID() { return updateID; }
 
+    int namePriority() const override;
+
     /**
      * @brief Returns true if this catalog is to be drawn
      * Overridden from SkyComponent::selected
@@ -91,10 +108,23 @@ class CatalogComponent : public ListComponent
     /** @short Load data into custom catalog */
     virtual void _loadData(bool includeCatalogDesignation);
 
+    /** @short Add an object of m_ObjectList to the trixel index */
+    void appendIndex(SkyObject *obj);
+
+    /** @short Remove an object from the trixel index */
+    void removeIndex(SkyObject *obj);
+
+    /** @short Update the coordinates of an object if the sky map time or location changed since it was last updated */
+    void updateObject(SkyObject *obj, KStarsData *data);
+
     // FIXME: There seems to be no way to remove catalogs from the program. -- asimha
 
     QString m_catName, m_catColor, m_catFluxFreq, m_catFluxUnit;
     bool m_Showerrs { false };
     int m_ccIndex { 0 };
     quint32 updateID { 0 };
+
+    SkyMesh *m_skyMesh { nullptr };
+    /** Objects of m_ObjectList by trixel of their catalog coordinates */
+    QHash<Trixel, QVector<SkyObject *>> m_ObjectIndex;
 };
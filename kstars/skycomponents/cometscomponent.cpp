@@ -95,9 +95,10 @@ void CometsComponent::loadData()
 
     qDeleteAll(m_ObjectList);
     m_ObjectList.clear();
+    invalidateIndex();
 
     objectNames(SkyObject::COMET).clear();
-    objectLists(SkyObject::COMET).clear();
+    clearLists(SkyObject::COMET);
 
     QList<QPair<QString, KSParser::DataTypes>> sequence;
     sequence.append(qMakePair(QString("full name"), KSParser::D_QSTRING));
@@ -179,7 +180,7 @@ void CometsComponent::loadData()
 
         // Add *short* name to the list of object names
         objectNames(SkyObject::COMET).append(com->name());
-        objectLists(SkyObject::COMET).append(QPair<QString, const SkyObject *>(com->name(), com));
+        addToLists(SkyObject::COMET, com->name(), com);
     }
 }
 
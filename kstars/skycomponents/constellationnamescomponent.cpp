@@ -19,6 +19,7 @@
 
 #include "ksfilereader.h"
 #include "kstarsdata.h"
+#include "objectnameindex.h"
 #include "Options.h"
 #include "skylabeler.h"
 #ifndef KSTARS_LITE
@@ -27,12 +28,11 @@
 #include "projections/projector.h"
 #include "skycomponents/culturelist.h"
 
-#include <QtConcurrent>
 
 ConstellationNamesComponent::ConstellationNamesComponent(SkyComposite *parent, CultureList *cultures)
     : ListComponent(parent)
 {
-    QtConcurrent::run(this, &ConstellationNamesComponent::loadData, cultures);
+    loadData(cultures);
 }
 
 void ConstellationNamesComponent::loadData(CultureList *cultures)
@@ -96,11 +96,16 @@ void ConstellationNamesComponent::loadData(CultureList *cultures)
 
             //Add name to the list of object names
             objectNames(SkyObject::CONSTELLATION).append(name);
-            objectLists(SkyObject::CONSTELLATION).append(QPair<QString, const SkyObject *>(name, o));
+            addToLists(SkyObject::CONSTELLATION, name, o);
         }
     }
 }
 
+int ConstellationNamesComponent::namePriority() const
+{
+    return ObjectNameIndex::ConstellationPriority;
+}
+
 bool ConstellationNamesComponent::selected()
 {
 #ifndef KSTARS_LITE
@@ -69,6 +69,8 @@ class ConstellationNamesComponent : public ListComponent
     /** @short Return true if we are using localized constellation names */
     inline bool isLocalCNames() { return localCNames; }
 
+    int namePriority() const override;
+
     bool selected() override;
 
     void loadData(CultureList *cultures);
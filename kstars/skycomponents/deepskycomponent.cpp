@@ -21,6 +21,7 @@
 #include "kspaths.h"
 #include "kstarsdata.h"
 #include "kstars_debug.h"
+#include "objectnameindex.h"
 #include "Options.h"
 #include "skylabeler.h"
 #ifndef KSTARS_LITE
@@ -32,6 +33,60 @@
 #include "projections/projector.h"
 #include "skyobjects/deepskyobject.h"
 
+#include <QCryptographicHash>
+#include <QSaveFile>
+
+#include <cstring>
+
+namespace
+{
+// Binary snapshot of the parsed ngcic.dat, see DeepSkyComponent::loadCache()
+const char CACHE_MAGIC[8] = { 'K', 'S', 'N', 'G', 'C', 'I', 'C', 0 };
+// Bump when the layout of the cache or the parsing of ngcic.dat changes
+const quint32 CACHE_VERSION = 1;
+
+struct CacheHeader
+{
+    char magic[8];
+    quint32 version;
+    // QSysInfo::ByteOrder of the machine that wrote the cache
+    quint32 byteOrder;
+    // Size and level of the sky mesh the trixels were computed with
+    quint32 meshSize;
+    quint32 meshLevel;
+    quint32 count;
+    // Size of the string table, in UTF-16 code units
+    quint32 stringsSize;
+    // MD5 of ngcic.dat
+    char checksum[16];
+};
+
+struct CacheRecord
+{
+    // J2000 coordinates in degrees
+    double ra;
+    double dec;
+    float mag;
+    float a;
+    float b;
+    qint32 type;
+    qint32 pa;
+    qint32 pgc;
+    qint32 ugc;
+    qint32 trixel;
+    // Offsets in the string table. Strings are stored as their length followed by their UTF-16 code units.
+    quint32 name;
+    quint32 name2;
+    quint32 longname;
+    quint32 cat;
+    quint32 hasName;
+    quint32 reserved;
+};
+
+Q_STATIC_ASSERT(sizeof(CacheHeader) == 48);
+Q_STATIC_ASSERT(sizeof(CacheRecord) == 72);
+}
+
 DeepSkyComponent::DeepSkyComponent(SkyComposite *parent) : SkyComponent(parent)
 {
     m_skyMesh = SkyMesh::Instance();
@@ -61,6 +116,11 @@ DeepSkyComponent::~DeepSkyComponent()
         delete m_labelList[i];
 }
 
+int DeepSkyComponent::namePriority() const
+{
+    return ObjectNameIndex::DeepSkyPriority;
+}
+
 bool DeepSkyComponent::selected()
 {
     return Options::showDeepSky();
@@ -72,11 +132,44 @@ void DeepSkyComponent::update(KSNumbers *)
 
 void DeepSkyComponent::loadData()
 {
-    KStarsData *data = KStarsData::Instance();
     //Check whether we need to concatenate a split NGC/IC catalog
     //(i.e., if user has downloaded the Steinicke catalog)
     mergeSplitFiles();
 
+    QString file_name = KSPaths::locate(QStandardPaths::GenericDataLocation, QString("ngcic.dat"));
+    QString cache_name = KSPaths::writableLocation(QStandardPaths::GenericDataLocation) + "ngcic.cache";
+
+    QByteArray checksum;
+    QFile file(file_name);
+    if (file.open(QIODevice::ReadOnly))
+    {
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        hash.addData(&file);
+        checksum = hash.result();
+    }
+
+    if (!checksum.isEmpty() && loadCache(cache_name, checksum))
+    {
+        for (auto &list : objectNames())
+            list.removeDuplicates();
+        return;
+    }
+
+    QVector<CatalogEntry> entries;
+    parseCatalog(file_name, entries);
+
+    for (auto &entry : entries)
+        appendObject(entry);
+
+    for (auto &list : objectNames())
+        list.removeDuplicates();
+
+    if (!checksum.isEmpty())
+        writeCache(cache_name, checksum, entries);
+}
+
+void DeepSkyComponent::parseCatalog(const QString &file_name, QVector<CatalogEntry> &entries)
+{
     QList<QPair<QString, KSParser::DataTypes>> sequence;
     QList<int> widths;
     sequence.append(qMakePair(QString("Flag"), KSParser::D_QSTRING));
@@ -145,20 +238,38 @@ void DeepSkyComponent::loadData()
     sequence.append(qMakePair(QString("Longname"), KSParser::D_QSTRING));
     //No width to be appended for last sequence object
 
-    QString file_name = KSPaths::locate(QStandardPaths::GenericDataLocation, QString("ngcic.dat"));
     KSParser deep_sky_parser(file_name, '#', sequence, widths);
 
     deep_sky_parser.SetProgress(i18n("Loading NGC/IC objects"), 13444, 10);
     qCInfo(KSTARS) << "Loading NGC/IC objects";
 
-    QHash<QString, QVariant> row_content;
-    while (deep_sky_parser.HasNextRow())
+    // Rows are read in streaming mode, columns are resolved once
+    const int flagColumn     = deep_sky_parser.ColumnIndex("Flag");
+    const int idColumn       = deep_sky_parser.ColumnIndex("ID");
+    const int suffixColumn   = deep_sky_parser.ColumnIndex("suffix");
+    const int raHColumn      = deep_sky_parser.ColumnIndex("RA_H");
+    const int raMColumn      = deep_sky_parser.ColumnIndex("RA_M");
+    const int raSColumn      = deep_sky_parser.ColumnIndex("RA_S");
+    const int decSignColumn  = deep_sky_parser.ColumnIndex("D_Sign");
+    const int decDColumn     = deep_sky_parser.ColumnIndex("Dec_d");
+    const int decMColumn     = deep_sky_parser.ColumnIndex("Dec_m");
+    const int decSColumn     = deep_sky_parser.ColumnIndex("Dec_s");
+    const int bMagColumn     = deep_sky_parser.ColumnIndex("BMag");
+    const int typeColumn     = deep_sky_parser.ColumnIndex("type");
+    const int aColumn        = deep_sky_parser.ColumnIndex("a");
+    const int bColumn        = deep_sky_parser.ColumnIndex("b");
+    const int paColumn       = deep_sky_parser.ColumnIndex("pa");
+    const int pgcColumn      = deep_sky_parser.ColumnIndex("PGC");
+    const int otherCatColumn = deep_sky_parser.ColumnIndex("other cat");
+    const int other1Column   = deep_sky_parser.ColumnIndex("other1");
+    const int messrColumn    = deep_sky_parser.ColumnIndex("Messr");
+    const int messrNumColumn = deep_sky_parser.ColumnIndex("MessrNum");
+    const int longnameColumn = deep_sky_parser.ColumnIndex("Longname");
+
+    while (deep_sky_parser.NextRow())
     {
-        row_content = deep_sky_parser.ReadNextRow();
-
-        QString iflag;
         QString cat;
-        iflag = row_content["Flag"].toString().mid(0, 1); //check for NGC/IC catalog flag
+        //check for NGC/IC catalog flag
         /*
         Q_ASSERT(iflag == "I" || iflag == "N" || iflag == " ");
         // (spacetime): ^ Why an assert? Change in implementation of ksparser
@@ -169,31 +280,30 @@ void DeepSkyComponent::loadData()
         float mag(1000.0);
         int type, ingc, imess(-1), pa;
         int pgc, ugc;
-        QString ss, name, name2, longname;
+        QString name, name2, longname;
         QString cat2;
 
         // Designation
-        if (iflag == "I")
+        if (deep_sky_parser.FieldEquals(flagColumn, "I"))
             cat = "IC";
-        else if (iflag == "N")
+        else if (deep_sky_parser.FieldEquals(flagColumn, "N"))
             cat = "NGC";
 
-        ingc = row_content["ID"].toInt(); // NGC/IC catalog number
+        ingc = deep_sky_parser.IntField(idColumn); // NGC/IC catalog number
         if (ingc == 0)
             cat.clear(); //object is not in NGC or IC catalogs
 
-        QString suffix = row_content["suffix"].toString(); // multipliticity suffixes, eg: the 'A' in NGC 4945A
+        QString suffix = deep_sky_parser.StringField(suffixColumn); // multipliticity suffixes, eg: the 'A' in NGC 4945A
 
         //Q_ASSERT(suffix.isEmpty() || (suffix.isEmpty() == false && suffix.at(0) > 0x40 && suffix.at(0) < 0x7B));
 
         //coordinates
-        int rah     = row_content["RA_H"].toInt();
-        int ram     = row_content["RA_M"].toInt();
-        double ras  = row_content["RA_S"].toDouble();
-        QString sgn = row_content["D_Sign"].toString();
-        int dd      = row_content["Dec_d"].toInt();
-        int dm      = row_content["Dec_m"].toInt();
-        int ds      = row_content["Dec_s"].toInt();
+        int rah     = deep_sky_parser.IntField(raHColumn);
+        int ram     = deep_sky_parser.IntField(raMColumn);
+        double ras  = deep_sky_parser.FloatField(raSColumn);
+        int dd      = deep_sky_parser.IntField(decDColumn);
+        int dm      = deep_sky_parser.IntField(decMColumn);
+        int ds      = deep_sky_parser.IntField(decSColumn);
 
         if (!((0.0 <= rah && rah < 24.0) || (0.0 <= ram && ram < 60.0) || (0.0 <= ras && ras < 60.0) ||
               (0.0 <= dd && dd <= 90.0) || (0.0 <= dm && dm < 60.0) || (0.0 <= ds && ds < 60.0)))
@@ -208,43 +318,41 @@ void DeepSkyComponent::loadData()
             continue;
 
         //B magnitude
-        ss = row_content["BMag"].toString();
-        if (ss.isEmpty())
+        if (deep_sky_parser.IsEmptyField(bMagColumn))
         {
             mag = 99.9f;
         }
         else
         {
-            mag = ss.toFloat();
+            mag = deep_sky_parser.FloatField(bMagColumn);
         }
 
         //object type
-        type = row_content["type"].toInt();
+        type = deep_sky_parser.IntField(typeColumn);
 
         //major and minor axes
-        float a = row_content["a"].toFloat();
-        float b = row_content["b"].toFloat();
+        float a = deep_sky_parser.FloatField(aColumn);
+        float b = deep_sky_parser.FloatField(bColumn);
 
         //position angle.  The catalog PA is zero when the Major axis
         //is horizontal.  But we want the angle measured from North, so
         //we set PA = 90 - pa.
-        ss = row_content["pa"].toString();
-        if (ss.isEmpty())
+        if (deep_sky_parser.IsEmptyField(paColumn))
         {
             pa = 90;
         }
         else
         {
-            pa = 90 - ss.toInt();
+            pa = 90 - deep_sky_parser.IntField(paColumn);
         }
 
         //PGC number
-        pgc = row_content["PGC"].toInt();
+        pgc = deep_sky_parser.IntField(pgcColumn);
 
         //UGC number
-        if (row_content["other cat"].toString().trimmed() == "UGC")
+        if (deep_sky_parser.FieldEquals(otherCatColumn, "UGC"))
         {
-            ugc = row_content["other1"].toString().toInt();
+            ugc = deep_sky_parser.IntField(other1Column);
         }
         else
         {
@@ -252,23 +360,23 @@ void DeepSkyComponent::loadData()
         }
 
         //Messier number
-        if (row_content["Messr"].toString().trimmed() == "M")
+        if (deep_sky_parser.FieldEquals(messrColumn, "M"))
         {
             cat2 = cat;
             if (ingc == 0)
                 cat2.clear();
             cat   = 'M';
-            imess = row_content["MessrNum"].toInt();
+            imess = deep_sky_parser.IntField(messrNumColumn);
         }
 
-        longname = row_content["Longname"].toString();
+        longname = deep_sky_parser.StringField(longnameColumn);
 
         dms r;
         //r.setH(rah, ram, int(ras));
         r.setH(rah+ram/60.0+ras/3600.0);
         dms d(dd, dm, ds);
 
-        if (sgn == "-")
+        if (deep_sky_parser.FieldEquals(decSignColumn, "-"))
         {
             d.setD(-1.0 * d.Degrees());
         }
@@ -299,82 +407,265 @@ void DeepSkyComponent::loadData()
             if (!longname.isEmpty())
                 name = longname;
             else
-            {
                 hasName = false;
-                name    = i18n("Unnamed Object");
-            }
         }
 
-        name = i18nc("object name (optional)", name.toLatin1().constData());
+        CatalogEntry entry;
+        entry.type     = (type == 0) ? 1 : type; //Make sure we use CATALOG_STAR, not STAR
+        entry.ra       = r.Degrees();
+        entry.dec      = d.Degrees();
+        entry.mag      = mag;
+        entry.a        = a;
+        entry.b        = b;
+        entry.pa       = pa;
+        entry.pgc      = pgc;
+        entry.ugc      = ugc;
+        entry.name     = name;
+        entry.name2    = name2;
+        entry.longname = longname;
+        entry.cat      = cat;
+        entry.hasName  = hasName;
+        entries.append(entry);
+
+        deep_sky_parser.ShowProgress();
+    }
+}
+
+void DeepSkyComponent::appendObject(CatalogEntry &entry)
+{
+    KStarsData *data = KStarsData::Instance();
+
+    QString name     = entry.hasName ? entry.name : i18n("Unnamed Object");
+    QString longname = entry.longname;
+    const QString &name2 = entry.name2;
+    const bool hasName   = entry.hasName;
+    const int type       = entry.type;
+
+    name = i18nc("object name (optional)", name.toLatin1().constData());
+    if (!longname.isEmpty())
+        longname = i18nc("object name (optional)", longname.toLatin1().constData());
+
+    // create new deepskyobject
+    DeepSkyObject *o = new DeepSkyObject(type, dms(entry.ra), dms(entry.dec), entry.mag, name, name2, longname,
+                                         entry.cat, entry.a, entry.b, entry.pa, entry.pgc, entry.ugc);
+    o->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+
+    // Add the name(s) to the nameHash for fast lookup -jbb
+    if (hasName)
+    {
+        nameHash[name.toLower()] = o;
         if (!longname.isEmpty())
-            longname = i18nc("object name (optional)", longname.toLatin1().constData());
+            nameHash[longname.toLower()] = o;
+        if (!name2.isEmpty())
+            nameHash[name2.toLower()] = o;
+    }
 
-        // create new deepskyobject
-        DeepSkyObject *o = nullptr;
-        if (type == 0)
-            type = 1; //Make sure we use CATALOG_STAR, not STAR
-        o = new DeepSkyObject(type, r, d, mag, name, name2, longname, cat, a, b, pa, pgc, ugc);
-        o->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+    // Entries read from the cache come with their trixel
+    if (entry.trixel < 0)
+        entry.trixel = m_skyMesh->index(o);
+    Trixel trixel = entry.trixel;
 
-        // Add the name(s) to the nameHash for fast lookup -jbb
-        if (hasName)
-        {
-            nameHash[name.toLower()] = o;
-            if (!longname.isEmpty())
-                nameHash[longname.toLower()] = o;
-            if (!name2.isEmpty())
-                nameHash[name2.toLower()] = o;
-        }
+    //Assign object to general DeepSkyObjects list,
+    //and a secondary list based on its catalog.
+    m_DeepSkyList.append(o);
+    appendIndex(o, &m_DeepSkyIndex, trixel);
+
+    if (o->isCatalogM())
+    {
+        m_MessierList.append(o);
+        appendIndex(o, &m_MessierIndex, trixel);
+    }
+    else if (o->isCatalogNGC())
+    {
+        m_NGCList.append(o);
+        appendIndex(o, &m_NGCIndex, trixel);
+    }
+    else if (o->isCatalogIC())
+    {
+        m_ICList.append(o);
+        appendIndex(o, &m_ICIndex, trixel);
+    }
+    else
+    {
+        m_OtherList.append(o);
+        appendIndex(o, &m_OtherIndex, trixel);
+    }
 
-        Trixel trixel = m_skyMesh->index(o);
+    // JM: VERY INEFFICIENT. Disabling for now until we figure out how to deal with dups. QSet?
+    //if ( ! name.isEmpty() && !objectNames(type).contains(name))
+    if (!name.isEmpty())
+    {
+        objectNames(type).append(name);
+        addToLists(type, name, o);
+    }
 
-        //Assign object to general DeepSkyObjects list,
-        //and a secondary list based on its catalog.
-        m_DeepSkyList.append(o);
-        appendIndex(o, &m_DeepSkyIndex, trixel);
+    //Add long name to the list of object names
+    //if ( ! longname.isEmpty() && longname != name  && !objectNames(type).contains(longname))
+    if (!longname.isEmpty() && longname != name)
+    {
+        objectNames(type).append(longname);
+        addToLists(type, longname, o);
+    }
+}
 
-        if (o->isCatalogM())
-        {
-            m_MessierList.append(o);
-            appendIndex(o, &m_MessierIndex, trixel);
-        }
-        else if (o->isCatalogNGC())
-        {
-            m_NGCList.append(o);
-            appendIndex(o, &m_NGCIndex, trixel);
-        }
-        else if (o->isCatalogIC())
-        {
-            m_ICList.append(o);
-            appendIndex(o, &m_ICIndex, trixel);
-        }
-        else
-        {
-            m_OtherList.append(o);
-            appendIndex(o, &m_OtherIndex, trixel);
-        }
+bool DeepSkyComponent::loadCache(const QString &file_name, const QByteArray &checksum)
+{
+    QFile file(file_name);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < static_cast<qint64>(sizeof(CacheHeader)))
+        return false;
+
+    // Records and strings are read in place, the file is unmapped when it is closed
+    const uchar *data = file.map(0, file.size());
+    if (data == nullptr)
+        return false;
+
+    CacheHeader header;
+    memcpy(&header, data, sizeof(CacheHeader));
+
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+        header.byteOrder != static_cast<quint32>(QSysInfo::ByteOrder) ||
+        header.meshSize != static_cast<quint32>(m_skyMesh->size()) ||
+        header.meshLevel != static_cast<quint32>(m_skyMesh->level()) ||
+        checksum != QByteArray::fromRawData(header.checksum, sizeof(header.checksum)))
+    {
+        qCInfo(KSTARS) << "NGC/IC cache is out of date, rebuilding it";
+        return false;
+    }
 
-        // JM: VERY INEFFICIENT. Disabling for now until we figure out how to deal with dups. QSet?
-        //if ( ! name.isEmpty() && !objectNames(type).contains(name))
-        if (!name.isEmpty())
-        {
-            objectNames(type).append(name);
-            objectLists(type).append(QPair<QString, SkyObject *>(name, o));
-        }
+    if (file.size() != static_cast<qint64>(sizeof(CacheHeader) + header.count * sizeof(CacheRecord) +
+                                           header.stringsSize * sizeof(quint16)))
+    {
+        qCWarning(KSTARS) << "NGC/IC cache" << file_name << "is truncated, rebuilding it";
+        return false;
+    }
+
+    const CacheRecord *records = reinterpret_cast<const CacheRecord *>(data + sizeof(CacheHeader));
+    const quint16 *strings =
+        reinterpret_cast<const quint16 *>(data + sizeof(CacheHeader) + header.count * sizeof(CacheRecord));
 
-        //Add long name to the list of object names
-        //if ( ! longname.isEmpty() && longname != name  && !objectNames(type).contains(longname))
-        if (!longname.isEmpty() && longname != name)
+    auto isValid = [&](quint32 offset)
+    {
+        return offset < header.stringsSize && strings[offset] < header.stringsSize - offset;
+    };
+    auto string = [&](quint32 offset)
+    {
+        return QString(reinterpret_cast<const QChar *>(strings + offset + 1), strings[offset]);
+    };
+
+    // Check everything before creating any object, so that a damaged cache can still be rebuilt
+    for (quint32 i = 0; i < header.count; i++)
+    {
+        const CacheRecord &record = records[i];
+        if (!isValid(record.name) || !isValid(record.name2) || !isValid(record.longname) || !isValid(record.cat) ||
+            record.trixel < 0 || record.trixel >= m_skyMesh->size())
         {
-            objectNames(type).append(longname);
-            objectLists(type).append(QPair<QString, SkyObject *>(longname, o));
+            qCWarning(KSTARS) << "NGC/IC cache" << file_name << "is corrupted, rebuilding it";
+            return false;
         }
+    }
 
-        deep_sky_parser.ShowProgress();
+    qCInfo(KSTARS) << "Loading NGC/IC objects from" << file_name;
+
+    for (quint32 i = 0; i < header.count; i++)
+    {
+        const CacheRecord &record = records[i];
+
+        CatalogEntry entry;
+        entry.type     = record.type;
+        entry.ra       = record.ra;
+        entry.dec      = record.dec;
+        entry.mag      = record.mag;
+        entry.a        = record.a;
+        entry.b        = record.b;
+        entry.pa       = record.pa;
+        entry.pgc      = record.pgc;
+        entry.ugc      = record.ugc;
+        entry.name     = string(record.name);
+        entry.name2    = string(record.name2);
+        entry.longname = string(record.longname);
+        entry.cat      = string(record.cat);
+        entry.hasName  = record.hasName != 0;
+        entry.trixel   = record.trixel;
+
+        appendObject(entry);
     }
 
-    for (auto &list : objectNames())
-        list.removeDuplicates();
+    return true;
+}
+
+void DeepSkyComponent::writeCache(const QString &file_name, const QByteArray &checksum,
+                                  const QVector<CatalogEntry> &entries)
+{
+    // The string table starts with the empty string, and identical strings are stored once
+    QVector<quint16> strings(1, 0);
+    QHash<QString, quint32> offsets;
+
+    auto addString = [&](const QString &s) -> quint32
+    {
+        if (s.isEmpty())
+            return 0;
+
+        auto it = offsets.constFind(s);
+        if (it != offsets.constEnd())
+            return it.value();
+
+        const QString str = s.left(0xFFFF);
+        const quint32 offset = strings.size();
+        strings.append(static_cast<quint16>(str.size()));
+        for (const QChar c : str)
+            strings.append(c.unicode());
+        offsets.insert(s, offset);
+        return offset;
+    };
+
+    QVector<CacheRecord> records(entries.size());
+    for (int i = 0; i < entries.size(); i++)
+    {
+        const CatalogEntry &entry = entries[i];
+        CacheRecord &record       = records[i];
+
+        record.ra       = entry.ra;
+        record.dec      = entry.dec;
+        record.mag      = entry.mag;
+        record.a        = entry.a;
+        record.b        = entry.b;
+        record.type     = entry.type;
+        record.pa       = entry.pa;
+        record.pgc      = entry.pgc;
+        record.ugc      = entry.ugc;
+        record.trixel   = entry.trixel;
+        record.name     = addString(entry.name);
+        record.name2    = addString(entry.name2);
+        record.longname = addString(entry.longname);
+        record.cat      = addString(entry.cat);
+        record.hasName  = entry.hasName ? 1 : 0;
+        record.reserved = 0;
+    }
+
+    CacheHeader header;
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version     = CACHE_VERSION;
+    header.byteOrder   = QSysInfo::ByteOrder;
+    header.meshSize    = m_skyMesh->size();
+    header.meshLevel   = m_skyMesh->level();
+    header.count       = records.size();
+    header.stringsSize = strings.size();
+    memcpy(header.checksum, checksum.constData(), qMin<int>(checksum.size(), sizeof(header.checksum)));
+
+    // Written to a temporary file first, so that a cache is never left half written
+    QSaveFile file(file_name);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(KSTARS) << "Cannot write NGC/IC cache" << file_name << ":" << file.errorString();
+        return;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(CacheHeader));
+    file.write(reinterpret_cast<const char *>(records.constData()), records.size() * sizeof(CacheRecord));
+    file.write(reinterpret_cast<const char *>(strings.constData()), strings.size() * sizeof(quint16));
+
+    if (!file.commit())
+        qCWarning(KSTARS) << "Cannot write NGC/IC cache" << file_name << ":" << file.errorString();
 }
 
 void DeepSkyComponent::mergeSplitFiles()
@@ -750,10 +1041,14 @@ SkyObject *DeepSkyComponent::objectNearest(SkyPoint *p, double &maxrad)
 
 void DeepSkyComponent::clearList(QList<DeepSkyObject *> &list)
 {
+    ObjectNameIndex *index = getNameIndex();
+
     while (!list.isEmpty())
     {
         SkyObject *o = list.takeFirst();
         removeFromNames(o);
+        if (index)
+            index->remove(o->name(), o);
         delete o;
     }
 }
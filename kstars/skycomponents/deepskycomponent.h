@@ -102,6 +102,8 @@ class DeepSkyComponent : public SkyComponent
 
     const QList<DeepSkyObject *> &objectList() const { return m_DeepSkyList; }
 
+    int namePriority() const override;
+
     bool selected() override;
 
   private:
@@ -131,10 +133,52 @@ class DeepSkyComponent : public SkyComponent
      * @li 64-69    PGC Catalog number [int] can be blank
      * @li 71-75    UGC Catalog number [int] can be blank
      * @li 77-END   Common name [string] can be blank
-     * @return true if data file is successfully read.
+     *
+     * The parsed catalog is kept in a binary cache along with the trixel of each object, and
+     * is only parsed again when the MD5 checksum of ngcic.dat or the sky mesh changes.
      */
     void loadData();
 
+    /** @short Catalog fields of an object, as read from ngcic.dat or from the cache. Names are untranslated. */
+    struct CatalogEntry
+    {
+        int type { 1 };
+        /** J2000 coordinates, in degrees */
+        double ra { 0 };
+        double dec { 0 };
+        float mag { 99.9f };
+        float a { 0 };
+        float b { 0 };
+        int pa { 90 };
+        int pgc { 0 };
+        int ugc { 0 };
+        QString name, name2, longname, cat;
+        bool hasName { true };
+        /** Trixel of the object, -1 until it is computed */
+        Trixel trixel { -1 };
+    };
+
+    /** @short Parse all lines of ngcic.dat into catalog entries */
+    void parseCatalog(const QString &file_name, QVector<CatalogEntry> &entries);
+
+    /**
+     * @short Create the DeepSkyObject of a catalog entry and add it to the lists, indexes and object names.
+     * The trixel of the entry is computed if it is not known yet.
+     */
+    void appendObject(CatalogEntry &entry);
+
+    /**
+     * @short Load the objects from the binary cache of ngcic.dat.
+     * The cache is memory mapped and read in place.
+     * @param file_name path of the cache
+     * @param checksum MD5 checksum of ngcic.dat
+     * @return false, without loading anything, if the cache is missing, damaged or out of date.
+     */
+    bool loadCache(const QString &file_name, const QByteArray &checksum);
+
+    /** @short Write the binary cache of ngcic.dat, for the entries parsed from it with the given checksum */
+    void writeCache(const QString &file_name, const QByteArray &checksum, const QVector<CatalogEntry> &entries);
+
     void clearList(QList<DeepSkyObject *> &list);
 
     void mergeSplitFiles();
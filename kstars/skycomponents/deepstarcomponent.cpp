@@ -26,6 +26,7 @@
 #include "skymesh.h"
 #include "skypainter.h"
 #include "starblock.h"
+#include "starblockprefetcher.h"
 #include "starcomponent.h"
 #include "htmesh/MeshIterator.h"
 #include "projections/projector.h"
@@ -33,6 +34,9 @@
 #include <qplatformdefs.h>
 #include <QtConcurrent>
 #include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include <cmath>
 
 #include <kstars_debug.h>
 
@@ -48,11 +52,16 @@ DeepStarComponent::DeepStarComponent(SkyComposite *parent, QString fileName, flo
     openDataFile();
     if (staticStars)
         loadStaticStars();
+    else if (fileOpened)
+        m_Prefetcher.reset(new StarBlockPrefetcher(this));
     qCInfo(KSTARS) << "Loaded DSO catalog file: " << dataFileName;
 }
 
 DeepStarComponent::~DeepStarComponent()
 {
+    // Stop background loading before the data file goes away
+    m_Prefetcher.reset();
+
     if (fileOpened)
         starReader.closeFile();
     fileOpened = false;
@@ -107,6 +116,9 @@ bool DeepStarComponent::loadStaticStars()
     if (htm_level != m_skyMesh->level())
         qCWarning(KSTARS) << "HTM Level in shallow star data file and HTM Level in m_skyMesh do not match. EXPECT TROUBLE!";
 
+    // Records of consecutive trixels follow each other right after the 5-byte preamble read above
+    quint32 offset = starReader.getDataOffset() + 5;
+
     // JM 2012-12-05: Breaking into 2 loops instead of one previously with multiple IF checks for recordSize
     // While the CPU branch prediction might not suffer any penalties since the branch prediction after a few times
     // should always gets it right. It's better to do it this way to avoid any chances since the compiler might not optimize it.
@@ -124,34 +136,43 @@ bool DeepStarComponent::loadStaticStars()
 
             m_starBlockList.at(trixel)->setStaticBlock(SB);
 
-            for (quint64 j = 0; j < records; ++j)
-            {
-                bool fread_success = fread(&stardata, sizeof(StarData), 1, dataFile);
+            if (records == 0)
+                continue;
 
-                if (!fread_success)
-                {
-                    qCCritical(KSTARS) << "ERROR: Could not read StarData structure for star #" << j << " under trixel #"
-                             << trixel;
-                }
+            // Pull the whole trixel in one go
+            const StarData *trixelData = starReader.readRecords(offset, records, stardata);
+            offset += records * sizeof(StarData);
+
+            if (!trixelData)
+            {
+                qCCritical(KSTARS) << "ERROR: Could not read" << records << "StarData structures under trixel #"
+                         << trixel;
+                continue;
+            }
 
-                /* Swap Bytes when required */
-                if (starReader.getByteSwap())
-                    byteSwap(&stardata);
+            /* Swap Bytes when required */
+            if (starReader.getByteSwap())
+            {
+                byteSwap(stardata.data(), records);
+                trixelData = stardata.constData();
+            }
 
+            for (quint64 j = 0; j < records; ++j)
+            {
                 /* Initialize star with data just read. */
                 StarObject *star;
 #ifdef KSTARS_LITE
-                star = &(SB->addStar(stardata)->star);
+                star = &(SB->addStar(trixelData[j])->star);
 #else
-                star = SB->addStar(stardata);
+                star = SB->addStar(trixelData[j]);
 #endif
                 if (star)
                 {
                     //KStarsData* data = KStarsData::Instance();
                     //star->EquatorialToHorizontal( data->lst(), data->geo()->lat() );
                     //if( star->getHDIndex() != 0 )
-                    if (stardata.HD)
-                        m_CatalogNumber.insert(stardata.HD, star);
+                    if (trixelData[j].HD)
+                        m_CatalogNumber.insert(trixelData[j].HD, star);
                 }
                 else
                 {
@@ -175,37 +196,36 @@ bool DeepStarComponent::loadStaticStars()
 
             m_starBlockList.at(trixel)->setStaticBlock(SB);
 
-            for (quint64 j = 0; j < records; ++j)
-            {
-                bool fread_success = false;
-                fread_success      = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+            if (records == 0)
+                continue;
 
-                if (!fread_success)
-                {
-                    qCCritical(KSTARS) << "Could not read StarData structure for star #" << j << " under trixel #"
-                             << trixel;
-                }
+            // Pull the whole trixel in one go
+            const DeepStarData *trixelData = starReader.readRecords(offset, records, deepstardata);
+            offset += records * sizeof(DeepStarData);
 
-                /* Swap Bytes when required */
-                if (starReader.getByteSwap())
-                    byteSwap(&deepstardata);
+            if (!trixelData)
+            {
+                qCCritical(KSTARS) << "Could not read" << records << "DeepStarData structures under trixel #"
+                         << trixel;
+                continue;
+            }
 
-                /* Initialize star with data just read. */
-                StarObject *star;
+            /* Swap Bytes when required */
+            if (starReader.getByteSwap())
+            {
+                byteSwap(deepstardata.data(), records);
+                trixelData = deepstardata.constData();
+            }
+
+            for (quint64 j = 0; j < records; ++j)
+            {
+                /* Initialize star with data just read. Deep star records carry no HD number. */
 #ifdef KSTARS_LITE
-                star = &(SB->addStar(stardata)->star);
+                StarObject *star = &(SB->addStar(trixelData[j])->star);
 #else
-                star = SB->addStar(deepstardata);
+                StarObject *star = SB->addStar(trixelData[j]);
 #endif
-                if (star)
-                {
-                    //KStarsData* data = KStarsData::Instance();
-                    //star->EquatorialToHorizontal( data->lst(), data->geo()->lat() );
-                    //if( star->getHDIndex() != 0 )
-                    if (stardata.HD)
-                        m_CatalogNumber.insert(stardata.HD, star);
-                }
-                else
+                if (!star)
                 {
                     qCCritical(KSTARS) << "CODE ERROR: More unnamed static stars in trixel " << trixel
                              << " than we allocated space for!";
@@ -256,9 +276,7 @@ void DeepStarComponent::draw(SkyPainter *skyp)
     StarObject::updateCoordsCpuTime = 0.;
     StarObject::starsUpdated        = 0;
 #endif
-    SkyMap *map       = SkyMap::Instance();
-    KStarsData *data  = KStarsData::Instance();
-    UpdateID updateID = data->updateID();
+    SkyMap *map = SkyMap::Instance();
 
     //FIXME_FOV -- maybe not clamp like that...
     float radius = map->projector()->fov();
@@ -313,9 +331,15 @@ void DeepStarComponent::draw(SkyPainter *skyp)
 
     t.start();
 
+    // The background loader is kept out of the LRU cache and block lists while they are updated, but not while
+    // the stars are painted, so that it can load the next trixels during the frame
+    QMutexLocker locker(&m_StarBlockFactory->mutex());
+    locker.unlock();
+
     // Mark used blocks in the LRU Cache. Not required for static stars
     if (!staticStars)
     {
+        locker.relock();
         while (region.hasNext())
         {
             Trixel currentRegion = region.next();
@@ -333,6 +357,7 @@ void DeepStarComponent::draw(SkyPainter *skyp)
                     break;
             }
         }
+        locker.unlock();
         t_updateCache = t.elapsed();
         region.reset();
     }
@@ -351,6 +376,16 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         if ((int)currentRegion >= m_starBlockList.size())
             continue;
 
+        locker.relock();
+
+        if (m_Prefetcher)
+        {
+            if (m_starBlockList.at(currentRegion)->isFilledToMag(maglim))
+                m_Prefetcher->recordHit();
+            else
+                m_Prefetcher->recordMiss();
+        }
+
         if (!staticStars && !m_starBlockList.at(currentRegion)->fillToMag(maglim) &&
             maglim <= m_FaintMagnitude * (1 - 1.5 / 16))
         {
@@ -362,45 +397,63 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         //        qDebug() << "Drawing SBL for trixel " << currentRegion << ", SBL has "
         //                 <<  m_starBlockList[ currentRegion ]->getBlockCount() << " blocks";
 
-        // REMARK: The following should never carry state, except for const parameters like updateID and maglim
-        std::function<void(std::shared_ptr<StarBlock>)> mapFunction = [&updateID, &maglim](std::shared_ptr<StarBlock> myBlock) {
-            for (StarObject &star : myBlock->contents())
-            {
-                if (star.updateID != updateID)
-                    star.JITupdate();
-                if (star.mag() > maglim)
-                    break;
-            }
+        // REMARK: The following should never carry state, except for const parameters like maglim
+        // Blocks that start beyond the magnitude limit are not drawn, so they need not be updated either.
+        std::function<void(std::shared_ptr<StarBlock>)> mapFunction = [&maglim](std::shared_ptr<StarBlock> myBlock) {
+            if (myBlock->getStarCount() > 0 && myBlock->getBrightMag() <= maglim)
+                myBlock->JITupdate();
         };
 
         QtConcurrent::blockingMap(m_starBlockList.at(currentRegion)->contents(), mapFunction);
 
+        // Collect the stars of the whole trixel, so that the painter can cull, project and draw them in one go
+        m_DrawPoints.clear();
+        m_DrawMags.clear();
+        m_DrawSpectra.clear();
+
         for (int i = 0; i < m_starBlockList.at(currentRegion)->getBlockCount(); ++i)
         {
             std::shared_ptr<StarBlock> block = m_starBlockList.at(currentRegion)->block(i);
+            const Eigen::ArrayXf &mags       = block->magnitudes();
             //            qDebug() << "---> Drawing stars from block " << i << " of trixel " <<
             //                currentRegion << ". SB has " << block->getStarCount() << " stars";
             for (int j = 0; j < block->getStarCount(); j++)
             {
-                StarObject *curStar = block->star(j);
-
-                //                qDebug() << "We claim that he's from trixel " << currentRegion
-                //<< ", and indexStar says he's from " << m_skyMesh->indexStar( curStar );
-
-                float mag = curStar->mag();
+                float mag = mags[j];
 
                 if (mag > maglim)
                     break;
 
-                if (skyp->drawPointSource(curStar, mag, curStar->spchar()))
-                    visibleStarCount++;
+                StarObject *curStar = block->star(j);
+
+                m_DrawPoints.append(curStar);
+                m_DrawMags.append(mag);
+                m_DrawSpectra.append(curStar->spchar());
             }
         }
 
+        // The blocks of this trixel were just marked as most recently used, the loader recycles older ones
+        locker.unlock();
+
+        visibleStarCount += skyp->drawPointSources(m_DrawPoints.constData(), m_DrawMags.constData(),
+                                                   m_DrawSpectra.constData(), m_DrawPoints.size());
+
         // DEBUG: Uncomment to identify problems with Star Block Factory / preservation of Magnitude Order in the LRU Cache
         //        verifySBLIntegrity();
         t_drawUnnamed += t.restart();
     }
+
+    if (m_Prefetcher && Options::starPrefetch())
+    {
+        prefetchNeighbours(focus, radius, maglim);
+
+        if (m_Prefetcher->hits() + m_Prefetcher->misses() >= 1000)
+        {
+            qCDebug(KSTARS) << "Star block prefetch for" << dataFileName << ":" << m_Prefetcher->hits() << "hits,"
+                            << m_Prefetcher->misses() << "misses," << m_Prefetcher->prefetched() << "trixels prefetched";
+            m_Prefetcher->resetCounters();
+        }
+    }
     m_skyMesh->inDraw(false);
 #ifdef PROFILE_SINCOS
     trig_calls_here += dms::trig_function_calls;
@@ -439,6 +492,9 @@ bool DeepStarComponent::openDataFile()
         qCWarning(KSTARS) << "Header read error for deep star catalog " << dataFileName << "!! Disabling it!";
     else
     {
+        if (!starReader.mapFile())
+            qCInfo(KSTARS) << "Could not memory-map" << dataFileName << ", falling back to buffered reads";
+
         qint16 faintmag;
         quint8 htm_level;
         int ret = 0;
@@ -483,6 +539,62 @@ bool DeepStarComponent::openDataFile()
     return fileOpened;
 }
 
+void DeepStarComponent::prefetchNeighbours(SkyPoint *focus, float radius, float maglim)
+{
+    double ra     = focus->ra().Degrees();
+    double dec    = focus->dec().Degrees();
+    double margin = Options::starPrefetchMargin();
+    double dRA    = 0;
+    double dDec   = 0;
+
+    if (m_LastFocusRA >= 0)
+    {
+        dRA = ra - m_LastFocusRA;
+        if (dRA > 180.0)
+            dRA -= 360.0;
+        else if (dRA < -180.0)
+            dRA += 360.0;
+        dDec = dec - m_LastFocusDec;
+    }
+    m_LastFocusRA  = ra;
+    m_LastFocusDec = dec;
+
+    // Lead the focus along the slew, but never by more than the margin
+    dRA *= Options::starPrefetchSlewBias();
+    dDec *= Options::starPrefetchSlewBias();
+    double shift = std::hypot(dRA * cos(dec * dms::DegToRad), dDec);
+    if (shift > margin)
+    {
+        dRA *= margin / shift;
+        dDec *= margin / shift;
+    }
+
+    SkyPoint center(dms(ra + dRA).reduce(), dms(qBound(-90.0, dec + dDec, 90.0)));
+    center.apparentCoord(KStarsData::Instance()->updateNum()->julianDay(), J2000);
+    m_skyMesh->index(&center, radius + 1.0 + margin, PREFETCH_BUF);
+
+    // Trixels that are already loaded are passed too, so that the worker marks their blocks as used
+    MeshIterator region(m_skyMesh, PREFETCH_BUF);
+    QVector<Trixel> trixels;
+    trixels.reserve(region.size());
+    while (region.hasNext())
+    {
+        Trixel trixel = region.next();
+        if ((int)trixel < m_starBlockList.size())
+            trixels.append(trixel);
+    }
+
+    m_Prefetcher->prefetch(trixels, maglim);
+}
+
+std::shared_ptr<StarBlockList> DeepStarComponent::starBlockList(Trixel trixel) const
+{
+    if ((int)trixel >= m_starBlockList.size())
+        return std::shared_ptr<StarBlockList>();
+
+    return m_starBlockList.at(trixel);
+}
+
 StarObject *DeepStarComponent::findByHDIndex(int HDnum)
 {
     // Currently, we only handle HD catalog indexes
@@ -505,6 +617,8 @@ SkyObject *DeepStarComponent::objectNearest(SkyPoint *p, double &maxrad)
     if (!fileOpened)
         return nullptr;
 
+    QMutexLocker locker(&StarBlockFactory::Instance()->mutex());
+
     m_skyMesh->index(p, maxrad + 1.0, OBJ_NEAREST_BUF);
 
     MeshIterator region(m_skyMesh, OBJ_NEAREST_BUF);
@@ -574,6 +688,8 @@ bool DeepStarComponent::starsInAperture(QList<StarObject *> &list, const SkyPoin
     if (maglim < -28)
         maglim = m_FaintMagnitude;
 
+    QMutexLocker locker(&StarBlockFactory::Instance()->mutex());
+
     while (region.hasNext())
     {
         Trixel currentRegion = region.next();
@@ -612,6 +728,18 @@ void DeepStarComponent::byteSwap(DeepStarData *stardata)
     stardata->V    = bswap_16(stardata->V);
 }
 
+void DeepStarComponent::byteSwap(DeepStarData *stardata, quint32 count)
+{
+    for (quint32 i = 0; i < count; ++i)
+        byteSwap(stardata + i);
+}
+
+void DeepStarComponent::byteSwap(StarData *stardata, quint32 count)
+{
+    for (quint32 i = 0; i < count; ++i)
+        byteSwap(stardata + i);
+}
+
 void DeepStarComponent::byteSwap(StarData *stardata)
 {
     stardata->RA       = bswap_32(stardata->RA);
@@ -37,6 +37,7 @@ class SkyLabeler;
 class SkyMesh;
 class StarBlockFactory;
 class StarBlockList;
+class StarBlockPrefetcher;
 class StarObject;
 
 class DeepStarComponent : public ListComponent
@@ -87,6 +88,16 @@ class DeepStarComponent : public ListComponent
 
     inline BinFileHelper *getStarReader() { return &starReader; }
 
+    /**
+     * @return The StarBlockList of the given trixel, or an empty pointer if the trixel is out of range
+     */
+    std::shared_ptr<StarBlockList> starBlockList(Trixel trixel) const;
+
+    /**
+     * @return The background loader of this catalog, or nullptr if the catalog is static
+     */
+    inline StarBlockPrefetcher *prefetcher() const { return m_Prefetcher.get(); }
+
     bool verifySBLIntegrity();
 
     /**
@@ -110,9 +121,24 @@ class DeepStarComponent : public ListComponent
     static void byteSwap(DeepStarData *stardata);
     static void byteSwap(StarData *stardata);
 
+    /** @short Byte-swap @p count consecutive records in place */
+    static void byteSwap(DeepStarData *stardata, quint32 count);
+    static void byteSwap(StarData *stardata, quint32 count);
+
     static StarBlockFactory m_StarBlockFactory;
 
   private:
+    /**
+     * @short Queues the trixels around the aperture for background loading
+     *
+     * The prefetch aperture is the drawn aperture grown by Options::starPrefetchMargin(),
+     * and shifted in the direction the focus moved since the previous frame.
+     * @param focus Current focus of the sky map
+     * @param radius Radius of the drawn aperture in degrees
+     * @param maglim Magnitude limit to load the trixels to
+     */
+    void prefetchNeighbours(SkyPoint *focus, float radius, float maglim);
+
     SkyMesh *m_skyMesh { nullptr };
     KSNumbers m_reindexNum;
 
@@ -133,13 +159,21 @@ class DeepStarComponent : public ListComponent
     long unsigned t_updateCache { 0 };
 
     QVector<std::shared_ptr<StarBlockList>> m_starBlockList;
+    std::unique_ptr<StarBlockPrefetcher> m_Prefetcher;
+    /// Focus coordinates at the previous draw, used to bias prefetching in the slew direction
+    double m_LastFocusRA { -1 };
+    double m_LastFocusDec { 0 };
     QHash<int, StarObject *> m_CatalogNumber;
+    /// Stars of the trixel being drawn, reused across draw() calls
+    QVector<SkyPoint *> m_DrawPoints;
+    QVector<float> m_DrawMags;
+    QVector<char> m_DrawSpectra;
 
     bool staticStars { false };
 
     // Stuff required for reading data
-    DeepStarData deepstardata;
-    StarData stardata;
+    QVector<DeepStarData> deepstardata;
+    QVector<StarData> stardata;
     BinFileHelper starReader;
     QString dataFileName;
 };
@@ -18,6 +18,7 @@
 #include "listcomponent.h"
 
 #include "kstarsdata.h"
+#include "objectnameindex.h"
 #ifndef KSTARS_LITE
 #include "skymap.h"
 #endif
@@ -28,6 +29,13 @@ ListComponent::ListComponent(SkyComposite *parent) : SkyComponent(parent)
 
 ListComponent::~ListComponent()
 {
+    // The name index outlives the component, it must not keep pointers to the deleted objects
+    if (ObjectNameIndex *index = getNameIndex())
+    {
+        for (const SkyObject *o : m_ObjectList)
+            index->remove(o->name(), o);
+    }
+
     qDeleteAll(m_ObjectList);
     m_ObjectList.clear();
     m_ObjectHash.clear();
@@ -37,10 +45,14 @@ ListComponent::~ListComponent()
 
 void ListComponent::clear()
 {
+    ObjectNameIndex *index = getNameIndex();
+
     while (!m_ObjectList.isEmpty())
     {
         SkyObject *o = m_ObjectList.takeFirst();
         removeFromNames(o);
+        if (index)
+            index->remove(o->name(), o);
         delete o;
     }
 }
@@ -28,21 +28,16 @@
 #include "skypainter.h"
 #include "skycomponents/skiphashlist.h"
 
-#include <QtConcurrent>
-
 MilkyWay::MilkyWay(SkyComposite *parent) : LineListIndex(parent, i18n("Milky Way"))
 {
     intro();
+    // The contours are indexed into the shared buffers of the sky mesh, so they are loaded in sequence
     // Milky way
-    //loadContours("milkyway.dat", i18n("Loading Milky Way"));
+    loadContours("milkyway.dat", i18n("Loading Milky Way"));
     // Magellanic clouds
-    //loadContours("lmc.dat", i18n("Loading Large Magellanic Clouds"));
-    //loadContours("smc.dat", i18n("Loading Small Magellanic Clouds"));
+    loadContours("lmc.dat", i18n("Loading Large Magellanic Clouds"));
+    loadContours("smc.dat", i18n("Loading Small Magellanic Clouds"));
     //summary();
-
-    QtConcurrent::run(this, &MilkyWay::loadContours, QString("milkyway.dat"), i18n("Loading Milky Way"));
-    QtConcurrent::run(this, &MilkyWay::loadContours, QString("lmc.dat"), i18n("Loading Large Magellanic Clouds"));
-    QtConcurrent::run(this, &MilkyWay::loadContours, QString("smc.dat"), i18n("Loading Small Magellanic Clouds"));
 }
 
 const IndexHash &MilkyWay::getIndexHash(LineList *lineList)
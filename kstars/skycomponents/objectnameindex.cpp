@@ -0,0 +1,340 @@
+/***************************************************************************
+                  objectnameindex.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "objectnameindex.h"
+
+#include "skyobjects/skyobject.h"
+#include "skyobjects/starobject.h"
+
+#include <QSet>
+#include <QStringList>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+/** @return the name an object is listed under, followed by its aliases */
+QStringList aliases(const QString &name, const SkyObject *object)
+{
+    QStringList names(name);
+
+    if (object->hasName())
+        names.append(object->name());
+    if (object->hasLongName())
+        names.append(object->longname());
+    if (object->hasName2())
+    {
+        names.append(object->name2());
+
+        if (object->type() == SkyObject::STAR)
+        {
+            const StarObject *star = static_cast<const StarObject *>(object);
+            names.append(star->gname(true));
+            names.append(star->gname(false));
+        }
+    }
+
+    return names;
+}
+
+/**
+ * @return the optimal string alignment distance between two strings, or maxDistance + 1 if it is larger than
+ * maxDistance. Rows are passed in so that they are allocated once per search.
+ */
+int distance(const QString &a, const QString &b, int maxDistance, std::vector<int> &previous2,
+             std::vector<int> &previous, std::vector<int> &current)
+{
+    int const n = a.size(), m = b.size();
+
+    previous2.assign(m + 1, 0);
+    previous.resize(m + 1);
+    current.resize(m + 1);
+
+    for (int j = 0; j <= m; j++)
+        previous[j] = j;
+
+    for (int i = 1; i <= n; i++)
+    {
+        current[0]  = i;
+        int rowBest = i;
+
+        for (int j = 1; j <= m; j++)
+        {
+            int const cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
+            int d          = std::min(std::min(previous[j] + 1, current[j - 1] + 1), previous[j - 1] + cost);
+
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+                d = std::min(d, previous2[j - 2] + 1);
+
+            current[j] = d;
+            rowBest    = std::min(rowBest, d);
+        }
+
+        // Distances never decrease from one row to the next
+        if (rowBest > maxDistance)
+            return maxDistance + 1;
+
+        std::swap(previous2, previous);
+        std::swap(previous, current);
+    }
+
+    return previous[m];
+}
+}
+
+void ObjectNameIndex::insert(int type, const QString &name, const SkyObject *object, int priority)
+{
+    if (object == nullptr)
+        return;
+
+    Entry entry;
+    entry.object   = object;
+    entry.type     = type;
+    entry.priority = priority;
+
+    for (const QString &alias : aliases(name, object))
+    {
+        QString const k = key(alias);
+        if (k.isEmpty())
+            continue;
+
+        bool indexed = false;
+        for (auto it = m_Entries.constFind(k); it != m_Entries.constEnd() && it.key() == k; ++it)
+        {
+            if (it->object == object)
+            {
+                indexed = true;
+                break;
+            }
+        }
+
+        if (!indexed)
+        {
+            entry.name = alias;
+            m_Entries.insert(k, entry);
+        }
+    }
+
+    m_SortedValid = false;
+}
+
+void ObjectNameIndex::remove(const QString &name, const SkyObject *object)
+{
+    for (const QString &alias : aliases(name, object))
+    {
+        QString const k = key(alias);
+        auto it         = m_Entries.find(k);
+        while (it != m_Entries.end() && it.key() == k)
+        {
+            if (it->object == object)
+                it = m_Entries.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    m_SortedValid = false;
+}
+
+void ObjectNameIndex::removeType(int type)
+{
+    for (auto it = m_Entries.begin(); it != m_Entries.end();)
+    {
+        if (it->type == type)
+            it = m_Entries.erase(it);
+        else
+            ++it;
+    }
+
+    m_SortedValid = false;
+}
+
+void ObjectNameIndex::clear()
+{
+    m_Entries.clear();
+    m_Sorted.clear();
+    m_SortedValid = false;
+}
+
+void ObjectNameIndex::merge(const ObjectNameIndex &other)
+{
+    // Inserted last first, so that objects sharing a name keep their order
+    for (auto it = other.m_Entries.constEnd(); it != other.m_Entries.constBegin();)
+    {
+        --it;
+        m_Entries.insert(it.key(), it.value());
+    }
+
+    m_SortedValid = false;
+}
+
+const SkyObject *ObjectNameIndex::find(const QString &name) const
+{
+    QString const k       = key(name);
+    const SkyObject *best = nullptr;
+    int bestPriority      = INT_MAX;
+
+    // Objects sharing a name are iterated most recent first, the most recent one wins as in the hashes of the
+    // components
+    for (auto it = m_Entries.constFind(k); it != m_Entries.constEnd() && it.key() == k; ++it)
+    {
+        if (it->priority < bestPriority)
+        {
+            best         = it->object;
+            bestPriority = it->priority;
+        }
+    }
+
+    return best;
+}
+
+void ObjectNameIndex::sort()
+{
+    if (m_SortedValid)
+        return;
+
+    m_Sorted.clear();
+    m_Sorted.reserve(m_Entries.size());
+
+    for (auto it = m_Entries.constBegin(); it != m_Entries.constEnd(); ++it)
+    {
+        SortedEntry sorted;
+        sorted.key   = it.key();
+        sorted.entry = it.value();
+        m_Sorted.append(sorted);
+    }
+
+    std::sort(m_Sorted.begin(), m_Sorted.end(),
+              [](const SortedEntry &a, const SortedEntry &b) { return a.key < b.key; });
+
+    m_SortedValid = true;
+}
+
+QVector<ObjectNameIndex::Match> ObjectNameIndex::findPrefix(const QString &prefix, int limit)
+{
+    QVector<Match> matches;
+    QString const k = key(prefix);
+
+    if (k.isEmpty() || limit <= 0)
+        return matches;
+
+    sort();
+
+    auto first = std::lower_bound(m_Sorted.constBegin(), m_Sorted.constEnd(), k,
+                                  [](const SortedEntry &e, const QString &value) { return e.key < value; });
+
+    QVector<const SortedEntry *> candidates;
+    for (auto it = first; it != m_Sorted.constEnd() && it->key.startsWith(k); ++it)
+        candidates.append(&*it);
+
+    std::sort(candidates.begin(), candidates.end(), [](const SortedEntry *a, const SortedEntry *b)
+    {
+        if (a->key.size() != b->key.size())
+            return a->key.size() < b->key.size();
+        if (a->entry.priority != b->entry.priority)
+            return a->entry.priority < b->entry.priority;
+        return a->key < b->key;
+    });
+
+    QSet<const SkyObject *> found;
+    for (const SortedEntry *candidate : candidates)
+    {
+        if (found.contains(candidate->entry.object))
+            continue;
+        found.insert(candidate->entry.object);
+
+        Match match;
+        match.name   = candidate->entry.name;
+        match.object = candidate->entry.object;
+        matches.append(match);
+
+        if (matches.size() == limit)
+            break;
+    }
+
+    return matches;
+}
+
+QVector<ObjectNameIndex::Match> ObjectNameIndex::findFuzzy(const QString &text, int maxDistance, int limit)
+{
+    QVector<Match> matches;
+    QString const k = key(text);
+
+    if (k.isEmpty() || limit <= 0)
+        return matches;
+
+    sort();
+
+    struct Candidate
+    {
+        const SortedEntry *sorted;
+        int distance;
+    };
+    QVector<Candidate> candidates;
+    std::vector<int> previous2, previous, current;
+
+    for (int i = 0; i < m_Sorted.size();)
+    {
+        const QString &name = m_Sorted[i].key;
+
+        // Entries sharing a name are adjacent, compute the distance once for all of them
+        int next = i + 1;
+        while (next < m_Sorted.size() && m_Sorted[next].key == name)
+            next++;
+
+        if (std::abs(name.size() - k.size()) <= maxDistance)
+        {
+            int const d = distance(k, name, maxDistance, previous2, previous, current);
+            if (d <= maxDistance)
+            {
+                for (int j = i; j < next; j++)
+                    candidates.append({ &m_Sorted[j], d });
+            }
+        }
+
+        i = next;
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b)
+    {
+        if (a.distance != b.distance)
+            return a.distance < b.distance;
+        if (a.sorted->entry.priority != b.sorted->entry.priority)
+            return a.sorted->entry.priority < b.sorted->entry.priority;
+        return a.sorted->key < b.sorted->key;
+    });
+
+    QSet<const SkyObject *> found;
+    for (const Candidate &candidate : candidates)
+    {
+        if (found.contains(candidate.sorted->entry.object))
+            continue;
+        found.insert(candidate.sorted->entry.object);
+
+        Match match;
+        match.name     = candidate.sorted->entry.name;
+        match.object   = candidate.sorted->entry.object;
+        match.distance = candidate.distance;
+        matches.append(match);
+
+        if (matches.size() == limit)
+            break;
+    }
+
+    return matches;
+}
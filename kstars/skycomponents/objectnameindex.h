@@ -0,0 +1,136 @@
+/***************************************************************************
+                   objectnameindex.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class SkyObject;
+
+/**
+ * @class ObjectNameIndex
+ *
+ * Index of the names of all the objects of the sky map.
+ *
+ * Every name registered in the object lists of SkyMapComposite is indexed, lower-cased, together with the
+ * aliases of the object: its name, long name and second name, and for stars the genetive name spelled
+ * with Greek letters and with Latin names of the letters. Lookups by exact name are a hash lookup. Prefix and
+ * fuzzy lookups use a sorted copy of the names, rebuilt on the first such lookup after a change.
+ *
+ * When several objects share a name, the one belonging to the component SkyMapComposite::findByName()
+ * searches first is returned first. Each component gives its place in that order, see
+ * SkyComponent::namePriority().
+ *
+ * Like the object lists, the index is only used from the main thread.
+ */
+class ObjectNameIndex
+{
+  public:
+    /** @short Search order of the components in SkyMapComposite::findByName(), lower first */
+    enum Priority
+    {
+        SolarSystemPriority,
+        DeepSkyPriority,
+        CustomCatalogPriority,
+        SyncedCatalogPriority,
+        ConstellationPriority,
+        StarPriority,
+        SupernovaPriority,
+        SatellitePriority,
+        UnknownPriority
+    };
+
+    /** @short Result of a prefix or fuzzy lookup */
+    struct Match
+    {
+        /** Name or alias that matched, as registered */
+        QString name;
+        const SkyObject *object { nullptr };
+        /** Edit distance to the searched text, 0 for prefix matches */
+        int distance { 0 };
+    };
+
+    /**
+     * @brief insert Index an object under a name and all its aliases.
+     * @param type type under which the object is listed, used by removeType()
+     * @param priority search order of the component holding the object, see Priority
+     */
+    void insert(int type, const QString &name, const SkyObject *object, int priority);
+
+    /** @brief remove Remove an object from the index, under a name and all its aliases. */
+    void remove(const QString &name, const SkyObject *object);
+
+    /**
+     * @brief removeType Remove all objects listed under a type.
+     * The objects themselves are not accessed, they may already be deleted.
+     */
+    void removeType(int type);
+
+    void clear();
+
+    /** @brief merge Add all the names of another index, which must not index the same objects. */
+    void merge(const ObjectNameIndex &other);
+
+    int size() const { return m_Entries.size(); }
+
+    /** @return the object with a name or alias, case insensitive, or nullptr */
+    const SkyObject *find(const QString &name) const;
+
+    /**
+     * @brief findPrefix Find the objects with a name or alias starting with some text, case insensitive.
+     * Exact matches come first, then shorter names, each object being returned once.
+     * @param prefix text to search for
+     * @param limit maximum number of matches returned
+     */
+    QVector<Match> findPrefix(const QString &prefix, int limit = 20);
+
+    /**
+     * @brief findFuzzy Find the objects with a name or alias close to some text, to suggest names for misspelt
+     * searches. Names are compared with the optimal string alignment distance, counting insertions, deletions,
+     * substitutions and transpositions of adjacent characters, case insensitive.
+     * @param text text to search for
+     * @param maxDistance maximum edit distance
+     * @param limit maximum number of matches returned, closest first
+     */
+    QVector<Match> findFuzzy(const QString &text, int maxDistance = 2, int limit = 20);
+
+    /** @return the key of a name in the index, lower-cased with whitespace simplified */
+    static QString key(const QString &name) { return name.simplified().toLower(); }
+
+  private:
+    struct Entry
+    {
+        QString name;
+        const SkyObject *object { nullptr };
+        int type { 0 };
+        /** Search order of the component of the object, lower first */
+        int priority { 0 };
+    };
+
+    struct SortedEntry
+    {
+        QString key;
+        Entry entry;
+    };
+
+    /** Sort m_Sorted again if the index changed */
+    void sort();
+
+    QMultiHash<QString, Entry> m_Entries;
+    QVector<SortedEntry> m_Sorted;
+    bool m_SortedValid { false };
+};
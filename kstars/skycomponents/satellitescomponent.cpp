@@ -20,20 +20,22 @@
 #include "ksfilereader.h"
 #include "ksnotification.h"
 #include "kstarsdata.h"
+#include "objectnameindex.h"
 #include "Options.h"
 #include "skylabeler.h"
 #include "skymap.h"
+#include "skymesh.h"
 #include "skypainter.h"
+#include "htmesh/MeshIterator.h"
 #include "skyobjects/satellite.h"
 
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QProgressDialog>
-#include <QtConcurrent>
 
-SatellitesComponent::SatellitesComponent(SkyComposite *parent) : SkyComponent(parent)
+SatellitesComponent::SatellitesComponent(SkyComposite *parent) : SkyComponent(parent), m_skyMesh(SkyMesh::Instance())
 {
-    QtConcurrent::run(this, &SatellitesComponent::loadData);
+    loadData();
 }
 
 SatellitesComponent::~SatellitesComponent()
@@ -62,8 +64,10 @@ void SatellitesComponent::loadData()
         m_groups.append(new SatelliteGroup(group_infos.at(0), group_infos.at(1), QUrl(group_infos.at(2))));
     }
 
+    m_IndexValid = false;
+
     objectNames(SkyObject::SATELLITE).clear();
-    objectLists(SkyObject::SATELLITE).clear();
+    clearLists(SkyObject::SATELLITE);
 
     foreach (SatelliteGroup *group, m_groups)
     {
@@ -74,13 +78,18 @@ void SatellitesComponent::loadData()
             if (sat->selected() && nameHash.contains(sat->name().toLower()) == false)
             {
                 objectNames(SkyObject::SATELLITE).append(sat->name());
-                objectLists(SkyObject::SATELLITE).append(QPair<QString, const SkyObject *>(sat->name(), sat));
+                addToLists(SkyObject::SATELLITE, sat->name(), sat);
                 nameHash[sat->name().toLower()] = sat;
             }
         }
     }
 }
 
+int SatellitesComponent::namePriority() const
+{
+    return ObjectNameIndex::SatellitePriority;
+}
+
 bool SatellitesComponent::selected()
 {
     return Options::showSatellites();
@@ -92,10 +101,17 @@ void SatellitesComponent::update(KSNumbers *)
     if (!selected())
         return;
 
+    // The observer and the Sun are the same for all satellites
+    KStarsData *data             = KStarsData::Instance();
+    Satellite::Observer observer = Satellite::observer(data->geo(), data->clock()->utc().djd());
+    observer.LST                 = *data->lst();
+
     foreach (SatelliteGroup *group, m_groups)
     {
-        group->updateSatellitesPos();
+        group->updateSatellitesPos(observer);
     }
+
+    m_IndexValid = false;
 }
 
 void SatellitesComponent::draw(SkyPainter *skyp)
@@ -105,30 +121,19 @@ void SatellitesComponent::draw(SkyPainter *skyp)
     if (!selected())
         return;
 
-    bool hideLabels = (!Options::showSatellitesLabels() || (SkyMap::Instance()->isSlewing() && Options::hideLabels()));
+    bool hideLabels  = (!Options::showSatellitesLabels() || (SkyMap::Instance()->isSlewing() && Options::hideLabels()));
+    bool visibleOnly = Options::showVisibleSatellites();
 
+    // Only the positions of the selected satellites are listed
     foreach (SatelliteGroup *group, m_groups)
     {
-        for (int i = 0; i < group->size(); i++)
+        for (const SatelliteGroup::SatellitePosition &position : group->positions())
         {
-            Satellite *sat = group->at(i);
+            if (visibleOnly && !position.visible)
+                continue;
 
-            if (sat->selected())
-            {
-                bool drawn = false;
-                if (Options::showVisibleSatellites())
-                {
-                    if (sat->isVisible())
-                        drawn = skyp->drawSatellite(sat);
-                }
-                else
-                {
-                    drawn = skyp->drawSatellite(sat);
-                }
-
-                if (drawn && !hideLabels)
-                    SkyLabeler::AddLabel(sat, SkyLabeler::SATELLITE_LABEL);
-            }
+            if (skyp->drawSatellite(position.satellite) && !hideLabels)
+                SkyLabeler::AddLabel(position.satellite, SkyLabeler::SATELLITE_LABEL);
         }
     }
 #else
@@ -183,6 +188,7 @@ void SatellitesComponent::updateTLEs()
                 file.close();
                 group->readTLE();
                 group->updateSatellitesPos();
+                m_IndexValid = false;
                 progressDlg.setValue(++i);
             }
             else
@@ -219,29 +225,48 @@ Satellite *SatellitesComponent::findSatellite(QString name)
     return nullptr;
 }
 
+const QHash<Trixel, QVector<Satellite *>> &SatellitesComponent::satelliteIndex()
+{
+    if (!m_IndexValid)
+    {
+        m_SatelliteIndex.clear();
+
+        foreach (SatelliteGroup *group, m_groups)
+        {
+            for (const SatelliteGroup::SatellitePosition &position : group->positions())
+                m_SatelliteIndex[m_skyMesh->HTMesh::index(position.ra, position.dec)].append(position.satellite);
+        }
+
+        m_IndexValid = true;
+    }
+
+    return m_SatelliteIndex;
+}
+
 SkyObject *SatellitesComponent::objectNearest(SkyPoint *p, double &maxrad)
 {
     if (!selected())
         return nullptr;
 
-    //KStarsData* data = KStarsData::Instance();
+    const QHash<Trixel, QVector<Satellite *>> &index = satelliteIndex();
 
     SkyObject *oBest = nullptr;
     double rBest     = maxrad;
     double r;
 
-    foreach (SatelliteGroup *group, m_groups)
+    MeshIterator region(m_skyMesh, OBJ_NEAREST_BUF);
+    while (region.hasNext())
     {
-        for (int i = 0; i < group->size(); i++)
+        auto it = index.constFind(region.next());
+        if (it == index.constEnd())
+            continue;
+
+        for (Satellite *sat : *it)
         {
-            Satellite *sat = group->at(i);
             if (!sat->selected())
                 continue;
 
             r = sat->angularDistanceTo(p).Degrees();
-            //qDebug() << sat->name();
-            //qDebug() << "r = " << r << " - max = " << rBest;
-            //qDebug() << "ra2=" << sat->ra().Degrees() << " - dec2=" << sat->dec().Degrees();
             if (r < rBest)
             {
                 rBest = r;
@@ -254,6 +279,27 @@ SkyObject *SatellitesComponent::objectNearest(SkyPoint *p, double &maxrad)
     return oBest;
 }
 
+void SatellitesComponent::objectsInArea(QList<SkyObject *> &list, const SkyRegion &region)
+{
+    if (!selected())
+        return;
+
+    const QHash<Trixel, QVector<Satellite *>> &index = satelliteIndex();
+
+    for (SkyRegion::const_iterator it = region.constBegin(); it != region.constEnd(); ++it)
+    {
+        auto satellites = index.constFind(it.key());
+        if (satellites == index.constEnd())
+            continue;
+
+        for (Satellite *sat : *satellites)
+        {
+            if (sat->selected())
+                list.append(sat);
+        }
+    }
+}
+
 SkyObject *SatellitesComponent::findByName(const QString &name)
 {
     return nameHash[name.toLower()];
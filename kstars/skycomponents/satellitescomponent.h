@@ -20,10 +20,13 @@
 #include "satellitegroup.h"
 #include "skycomponent.h"
 
+#include <QHash>
 #include <QList>
+#include <QVector>
 
 class QPointF;
 class Satellite;
+class SkyMesh;
 
 /**
  * @class SatellitesComponent
@@ -45,6 +48,8 @@ class SatellitesComponent : public SkyComponent
          */
         ~SatellitesComponent() override;
 
+        int namePriority() const override;
+
         /**
          * @return true if satellites must be draw.
          */
@@ -93,6 +98,8 @@ class SatellitesComponent : public SkyComponent
          */
         SkyObject *objectNearest(SkyPoint *p, double &maxrad) override;
 
+        void objectsInArea(QList<SkyObject *> &list, const SkyRegion &region) override;
+
         /**
          * Return object given name
          * @param name object name
@@ -106,6 +113,16 @@ class SatellitesComponent : public SkyComponent
         void drawTrails(SkyPainter *skyp) override;
 
     private:
+        /**
+         * @return the selected satellites bucketed by the trixel of their apparent position, rebuilt if they moved.
+         * Precession of the apparent position is well within the margin of the OBJ_NEAREST_BUF aperture.
+         */
+        const QHash<Trixel, QVector<Satellite *>> &satelliteIndex();
+
         QList<SatelliteGroup *> m_groups; // List of all groups
         QHash<QString, Satellite *> nameHash;
+
+        SkyMesh *m_skyMesh { nullptr };
+        QHash<Trixel, QVector<Satellite *>> m_SatelliteIndex;
+        bool m_IndexValid { false };
 };
@@ -17,6 +17,7 @@
 
 #include "skycomponent.h"
 
+#include "objectnameindex.h"
 #include "Options.h"
 #include "skycomposite.h"
 #include "skyobjects/skyobject.h"
@@ -73,6 +74,36 @@ QHash<int, QVector<QPair<QString, const SkyObject *>>> &SkyComponent::getObjectL
     return parent()->objectLists();
 }
 
+ObjectNameIndex *SkyComponent::getNameIndex()
+{
+    if (!parent())
+        return nullptr;
+    return parent()->nameIndex();
+}
+
+int SkyComponent::namePriority() const
+{
+    if (!m_parent)
+        return ObjectNameIndex::UnknownPriority;
+    return m_parent->namePriority();
+}
+
+void SkyComponent::addToLists(int type, const QString &name, const SkyObject *obj)
+{
+    getObjectLists()[type].append(QPair<QString, const SkyObject *>(name, obj));
+
+    if (ObjectNameIndex *index = getNameIndex())
+        index->insert(type, name, obj, namePriority());
+}
+
+void SkyComponent::clearLists(int type)
+{
+    getObjectLists()[type].clear();
+
+    if (ObjectNameIndex *index = getNameIndex())
+        index->removeType(type);
+}
+
 void SkyComponent::removeFromNames(const SkyObject *obj)
 {
     QStringList &names = getObjectNames()[obj->type()];
@@ -97,4 +128,7 @@ void SkyComponent::removeFromLists(const SkyObject *obj)
     i = names.indexOf(QPair<QString, const SkyObject *>(obj->longname(), obj));
     if (i >= 0)
         names.removeAt(i);
+
+    if (ObjectNameIndex *index = getNameIndex())
+        index->remove(obj->name(), obj);
 }
@@ -22,6 +22,7 @@
 
 class QString;
 
+class ObjectNameIndex;
 class SkyObject;
 class SkyPoint;
 class SkyComposite;
@@ -196,12 +197,30 @@ class SkyComponent
 
     inline QVector<QPair<QString, const SkyObject *>> &objectLists(int type) { return getObjectLists()[type]; }
 
+    /** @return the index of the names in the object lists, nullptr if there is none */
+    inline ObjectNameIndex *nameIndex() { return getNameIndex(); }
+
+    /**
+     * @return place of the component in the search order of SkyMapComposite::findByName(), see
+     * ObjectNameIndex::Priority. Components inherit the order of their parent by default.
+     * @note Names are often registered from constructors, so the component whose constructor registers
+     * names must reimplement it.
+     */
+    virtual int namePriority() const;
+
+    /** @short Append a name of an object to the object lists, and index it */
+    void addToLists(int type, const QString &name, const SkyObject *obj);
+
+    /** @short Remove all the objects of a type from the object lists and from the name index */
+    void clearLists(int type);
+
     void removeFromNames(const SkyObject *obj);
     void removeFromLists(const SkyObject *obj);
 
   private:
     virtual QHash<int, QStringList> &getObjectNames();
     virtual QHash<int, QVector<QPair<QString, const SkyObject *>>> &getObjectLists();
+    virtual ObjectNameIndex *getNameIndex();
 
     // Disallow copying and assignment
     SkyComponent(const SkyComponent &);
@@ -18,7 +18,9 @@
 #include "skymapcomposite.h"
 
 #include "artificialhorizoncomponent.h"
+#include "asteroidscomponent.h"
 #include "catalogcomponent.h"
+#include "cometscomponent.h"
 #include "constellationartcomponent.h"
 #include "constellationboundarylines.h"
 #include "constellationlines.h"
@@ -41,6 +43,7 @@
 #include "milkyway.h"
 #include "satellitescomponent.h"
 #include "skylabeler.h"
+#include "skymaploader.h"
 #include "skypainter.h"
 #include "solarsystemcomposite.h"
 #include "starcomponent.h"
@@ -57,10 +60,12 @@
 #include "ksutils.h"
 #include "observinglist.h"
 #include "skymap.h"
+#include "skyqpainter.h"
 #include "hipscomponent.h"
 #endif
 
 #include <QApplication>
+#include <QThread>
 
 #include <kstars_debug.h>
 
@@ -75,90 +80,134 @@ SkyMapComposite::SkyMapComposite(SkyComposite *parent) : SkyComposite(parent), m
     // You can also set the debug level of individual
     // appendLine() and appendPoly() calls.
 
-    //Add all components
-    //Stars must come before constellation lines
-#ifdef KSTARS_LITE
-    addComponent(m_MilkyWay = new MilkyWay(this), 50);
-    addComponent(m_Stars = StarComponent::Create(this), 10);
-    addComponent(m_EquatorialCoordinateGrid = new EquatorialCoordinateGrid(this));
-    addComponent(m_HorizontalCoordinateGrid = new HorizontalCoordinateGrid(this));
-
-    // Do add to components.
-    addComponent(m_CBoundLines = new ConstellationBoundaryLines(this), 80);
+    // Components that take long to load are built concurrently, see SkyMapLoader. The others are cheap,
+    // create QObjects, or index lines into the sky mesh, whose buffers are not thread-safe, so they are
+    // built here beforehand. Components are then added in the usual order once everything is loaded.
+    m_EquatorialCoordinateGrid = new EquatorialCoordinateGrid(this);
+    m_HorizontalCoordinateGrid = new HorizontalCoordinateGrid(this);
+#ifndef KSTARS_LITE
+    m_LocalMeridianComponent = new LocalMeridianComponent(this);
+#endif
     m_Cultures.reset(new CultureList());
-    addComponent(m_CLines = new ConstellationLines(this, m_Cultures.get()), 85);
-    addComponent(m_CNames = new ConstellationNamesComponent(this, m_Cultures.get()), 90);
-    addComponent(m_Equator = new Equator(this), 95);
-    addComponent(m_Ecliptic = new Ecliptic(this), 95);
-    addComponent(m_Horizon = new HorizonComponent(this), 100);
-    addComponent(m_DeepSky = new DeepSkyComponent(this), 5);
-    addComponent(m_ConstellationArt = new ConstellationArtComponent(this, m_Cultures.get()), 100);
-
-    addComponent(m_ArtificialHorizon = new ArtificialHorizonComponent(this), 110);
+    m_Equator  = new Equator(this);
+    m_Ecliptic = new Ecliptic(this);
+    m_Horizon  = new HorizonComponent(this);
+#ifndef KSTARS_LITE
+    m_HiPS = new HIPSComponent(this);
+#endif
+    m_ArtificialHorizon = new ArtificialHorizonComponent(this);
+#ifndef KSTARS_LITE
+    m_Flags = new FlagComponent(this);
+    m_ObservingList = new TargetListComponent(this, nullptr, QPen(), &Options::obsListSymbol, &Options::obsListText);
+#endif
+    m_StarHopRouteList = new TargetListComponent(this, nullptr, QPen());
+    m_Supernovae       = new SupernovaeComponent(this);
 
     m_internetResolvedCat = "_Internet_Resolved";
     m_manualAdditionsCat  = "_Manual_Additions";
-    addComponent(m_internetResolvedComponent = new SyncedCatalogComponent(this, m_internetResolvedCat, true, 0), 6);
-    addComponent(m_manualAdditionsComponent = new SyncedCatalogComponent(this, m_manualAdditionsCat, true, 0), 6);
     m_CustomCatalogs.reset(new SkyComposite(this));
-    QStringList allcatalogs = Options::showCatalogNames();
 
-    if (!allcatalogs.contains(m_internetResolvedCat))
-    {
-        allcatalogs.append(m_internetResolvedCat);
-    }
-    if (!allcatalogs.contains(m_manualAdditionsCat))
-    {
-        allcatalogs.append(m_manualAdditionsCat);
-    }
-    Options::setShowCatalogNames(allcatalogs);
+    SkyMapLoader loader;
 
-    for (int i = 0; i < allcatalogs.size(); ++i)
+    // Milky Way, constellation boundaries and lines index lines into the sky mesh, so they are chained
+    SkyMapLoader::TaskId milkyWay = loader.addTask("Milky Way", [this]() { m_MilkyWay = new MilkyWay(this); });
+    SkyMapLoader::TaskId stars = loader.addTask("stars", [this]() { m_Stars = StarComponent::Create(this); });
+    SkyMapLoader::TaskId boundaries = loader.addTask(
+        "constellation boundaries", [this]() { m_CBoundLines = new ConstellationBoundaryLines(this); }, { milkyWay });
+    //Stars must come before constellation lines
+    loader.addTask("constellation lines", [this]() { m_CLines = new ConstellationLines(this, m_Cultures.get()); },
+                   { stars, boundaries });
+    loader.addTask("constellation names",
+                   [this]() { m_CNames = new ConstellationNamesComponent(this, m_Cultures.get()); });
+    loader.addTask("deep sky objects", [this]() { m_DeepSky = new DeepSkyComponent(this); });
+    loader.addTask("constellation art",
+                   [this]() { m_ConstellationArt = new ConstellationArtComponent(this, m_Cultures.get()); },
+                   QVector<SkyMapLoader::TaskId>(), SkyMapLoader::CallingThread);
+    loader.addTask("custom catalogs", [this]() { loadCustomCatalogs(); }, QVector<SkyMapLoader::TaskId>(),
+                   SkyMapLoader::CallingThread);
+    loader.addTask("solar system", [this]()
     {
-        if (allcatalogs.at(i) == m_internetResolvedCat ||
-                allcatalogs.at(i) == m_manualAdditionsCat) // This is a special catalog
-            continue;
-        m_CustomCatalogs->addComponent(new CatalogComponent(this, allcatalogs.at(i), false, i),
-                                       6); // FIXME: Should this be 6 or 5? See SkyMapComposite::reloadDeepSky()
-    }
+        m_SolarSystem = new SolarSystemComposite(this);
+        // Slots and network replies of the asteroids and comets are handled by the main thread
+        m_SolarSystem->asteroidsComponent()->moveToThread(qApp->thread());
+        m_SolarSystem->cometsComponent()->moveToThread(qApp->thread());
+    });
+    loader.addTask("satellites", [this]() { m_Satellites = new SatellitesComponent(this); });
 
-    addComponent(m_SolarSystem = new SolarSystemComposite(this), 2);
+    m_NameIndex.clear();
+    loader.run(m_ObjectNames, m_ObjectLists, m_NameIndex);
+    qCInfo(KSTARS) << "Indexed" << m_NameIndex.size() << "object names";
 
-    //addComponent( m_ObservingList = new TargetListComponent( this , 0, QPen(),
-    //                                                       &Options::obsListSymbol, &Options::obsListText ), 120 );
-    addComponent(m_StarHopRouteList = new TargetListComponent(this, 0, QPen()), 130);
-    addComponent(m_Satellites = new SatellitesComponent(this), 7);
-    addComponent(m_Supernovae = new SupernovaeComponent(this), 7);
-    SkyMapLite::Instance()->loadingFinished();
-#else
-    addComponent(m_MilkyWay = new MilkyWay(this), 50);
-    addComponent(m_Stars = StarComponent::Create(this), 10);
-    addComponent(m_EquatorialCoordinateGrid = new EquatorialCoordinateGrid(this));
-    addComponent(m_HorizontalCoordinateGrid = new HorizontalCoordinateGrid(this));
-    addComponent(m_LocalMeridianComponent = new LocalMeridianComponent(this));
+#ifndef KSTARS_LITE
+    // Star images are pixmaps, which can only be created on the main thread
+    SkyQPainter::initStarImages();
+#endif
+
+    //Add all components
+    addComponent(m_MilkyWay, 50);
+    addComponent(m_Stars, 10);
+    addComponent(m_EquatorialCoordinateGrid);
+    addComponent(m_HorizontalCoordinateGrid);
+#ifndef KSTARS_LITE
+    addComponent(m_LocalMeridianComponent);
+#endif
 
     // Do add to components.
-    addComponent(m_CBoundLines = new ConstellationBoundaryLines(this), 80);
-    m_Cultures.reset(new CultureList());
-    addComponent(m_CLines = new ConstellationLines(this, m_Cultures.get()), 85);
-    addComponent(m_CNames = new ConstellationNamesComponent(this, m_Cultures.get()), 90);
-    addComponent(m_Equator = new Equator(this), 95);
-    addComponent(m_Ecliptic = new Ecliptic(this), 95);
-    addComponent(m_Horizon = new HorizonComponent(this), 100);
-    addComponent(m_DeepSky = new DeepSkyComponent(this), 5);
-    addComponent(m_ConstellationArt = new ConstellationArtComponent(this, m_Cultures.get()), 100);
+    addComponent(m_CBoundLines, 80);
+    addComponent(m_CLines, 85);
+    addComponent(m_CNames, 90);
+    addComponent(m_Equator, 95);
+    addComponent(m_Ecliptic, 95);
+    addComponent(m_Horizon, 100);
+    addComponent(m_DeepSky, 5);
+    addComponent(m_ConstellationArt, 100);
 
+#ifndef KSTARS_LITE
     // Hips
-    addComponent(m_HiPS = new HIPSComponent(this));
+    addComponent(m_HiPS);
+#endif
 
-    addComponent(m_ArtificialHorizon = new ArtificialHorizonComponent(this), 110);
+    addComponent(m_ArtificialHorizon, 110);
+
+    addComponent(m_internetResolvedComponent, 6);
+    addComponent(m_manualAdditionsComponent, 6);
+
+    addComponent(m_SolarSystem, 2);
+
+#ifndef KSTARS_LITE
+    addComponent(m_Flags, 4);
+
+    addComponent(m_ObservingList, 120);
+#else
+    //addComponent( m_ObservingList = new TargetListComponent( this , 0, QPen(),
+    //                                                       &Options::obsListSymbol, &Options::obsListText ), 120 );
+#endif
+    addComponent(m_StarHopRouteList, 130);
+    addComponent(m_Satellites, 7);
+    addComponent(m_Supernovae, 7);
+#ifdef KSTARS_LITE
+    SkyMapLite::Instance()->loadingFinished();
+#endif
+    connect(this, SIGNAL(progressText(QString)), KStarsData::Instance(), SIGNAL(progressText(QString)));
+}
+
+void SkyMapComposite::loadCustomCatalogs()
+{
+    m_internetResolvedComponent = new SyncedCatalogComponent(this, m_internetResolvedCat, true, 0);
+    m_manualAdditionsComponent  = new SyncedCatalogComponent(this, m_manualAdditionsCat, true, 0);
+    QStringList allcatalogs     = Options::showCatalogNames();
+#ifdef KSTARS_LITE
+    if (!allcatalogs.contains(m_internetResolvedCat))
+    {
+        allcatalogs.append(m_internetResolvedCat);
+    }
+    if (!allcatalogs.contains(m_manualAdditionsCat))
+    {
+        allcatalogs.append(m_manualAdditionsCat);
+    }
+    Options::setShowCatalogNames(allcatalogs);
+#endif
 
-    m_internetResolvedCat = "_Internet_Resolved";
-    m_manualAdditionsCat  = "_Manual_Additions";
-    addComponent(m_internetResolvedComponent = new SyncedCatalogComponent(this, m_internetResolvedCat, true, 0), 6);
-    addComponent(m_manualAdditionsComponent = new SyncedCatalogComponent(this, m_manualAdditionsCat, true, 0), 6);
-    m_CustomCatalogs.reset(new SkyComposite(this));
-    QStringList allcatalogs = Options::showCatalogNames();
     for (int i = 0; i < allcatalogs.size(); ++i)
     {
         if (allcatalogs.at(i) == m_internetResolvedCat ||
@@ -167,19 +216,6 @@ SkyMapComposite::SkyMapComposite(SkyComposite *parent) : SkyComposite(parent), m
         m_CustomCatalogs->addComponent(new CatalogComponent(this, allcatalogs.at(i), false, i),
                                        6); // FIXME: Should this be 6 or 5? See SkyMapComposite::reloadDeepSky()
     }
-
-    addComponent(m_SolarSystem = new SolarSystemComposite(this), 2);
-
-    addComponent(m_Flags = new FlagComponent(this), 4);
-
-    addComponent(m_ObservingList =
-                     new TargetListComponent(this, nullptr, QPen(), &Options::obsListSymbol, &Options::obsListText),
-                 120);
-    addComponent(m_StarHopRouteList = new TargetListComponent(this, nullptr, QPen()), 130);
-    addComponent(m_Satellites = new SatellitesComponent(this), 7);
-    addComponent(m_Supernovae = new SupernovaeComponent(this), 7);
-#endif
-    connect(this, SIGNAL(progressText(QString)), KStarsData::Instance(), SIGNAL(progressText(QString)));
 }
 
 void SkyMapComposite::update(KSNumbers *num)
@@ -304,7 +340,7 @@ void SkyMapComposite::draw(SkyPainter *skyp)
             for (auto &obj_clone : obsList)
             {
                 // Find the "original" obj
-                SkyObject *o = findByName(obj_clone->name()); // FIXME: This is slow.... and can also fail!!!
+                SkyObject *o = findByName(obj_clone->name()); // FIXME: This can fail!!!
                 if (!o)
                     continue;
                 SkyLabeler::AddLabel(o, SkyLabeler::RUDE_LABEL);
@@ -562,14 +598,27 @@ bool SkyMapComposite::removeNameLabel(SkyObject *o)
 
 QHash<int, QStringList> &SkyMapComposite::getObjectNames()
 {
+    // Components being loaded at startup register their names apart, see SkyMapLoader
+    if (QHash<int, QStringList> *names = SkyMapLoader::currentObjectNames())
+        return *names;
     return m_ObjectNames;
 }
 
 QHash<int, QVector<QPair<QString, const SkyObject *>>> &SkyMapComposite::getObjectLists()
 {
+    if (SkyMapLoader::ObjectLists *lists = SkyMapLoader::currentObjectLists())
+        return *lists;
     return m_ObjectLists;
 }
 
+ObjectNameIndex *SkyMapComposite::getNameIndex()
+{
+    // Components being loaded at startup index their names apart, see SkyMapLoader
+    if (ObjectNameIndex *index = SkyMapLoader::currentNameIndex())
+        return index;
+    return &m_NameIndex;
+}
+
 QList<SkyObject *> SkyMapComposite::findObjectsInArea(const SkyPoint &p1, const SkyPoint &p2)
 {
     const SkyRegion &region = m_skyMesh->skyRegion(p1, p2);
@@ -580,6 +629,9 @@ QList<SkyObject *> SkyMapComposite::findObjectsInArea(const SkyPoint &p1, const
         m_Stars->objectsInArea(list, region);
     if (m_DeepSky->selected())
         m_DeepSky->objectsInArea(list, region);
+    m_SolarSystem->asteroidsComponent()->objectsInArea(list, region);
+    m_SolarSystem->cometsComponent()->objectsInArea(list, region);
+    m_Satellites->objectsInArea(list, region);
     return list;
 }
 
@@ -590,6 +642,11 @@ SkyObject *SkyMapComposite::findByName(const QString &name)
         return nullptr;
 #endif
 
+    // Objects are listed as const in the object lists, but owned by the components
+    if (const SkyObject *indexed = m_NameIndex.find(name))
+        return const_cast<SkyObject *>(indexed);
+
+    //Not all the names known to the components are listed, so fall back to the components.
     //We search the children in an "intelligent" order (most-used
     //object types first), in order to avoid wasting too much time
     //looking for a match.  The most important part of this ordering
@@ -677,6 +734,9 @@ void SkyMapComposite::removeCustomCatalog(const QString &name)
 
         if (ccc->name() == name)
         {
+            // Names of the removed catalog must not be found anymore
+            for (const SkyObject *o : ccc->objectList())
+                m_NameIndex.remove(o->name(), o);
             m_CustomCatalogs->removeComponent(ccc);
             return;
         }
@@ -708,7 +768,7 @@ void SkyMapComposite::reloadCNames()
     //     m_CNames = new ConstellationNamesComponent( this, m_Cultures.get() );
     //     SkyMapDrawAbstract::setDrawLock( false );
     objectNames(SkyObject::CONSTELLATION).clear();
-    objectLists(SkyObject::CONSTELLATION).clear();
+    clearLists(SkyObject::CONSTELLATION);
     removeComponent(m_CNames);
     delete m_CNames;
     addComponent(m_CNames = new ConstellationNamesComponent(this, m_Cultures.get()));
@@ -786,7 +846,9 @@ void SkyMapComposite::emitProgressText(const QString &message)
     emit progressText(message);
 #ifndef Q_OS_ANDROID
     //Can cause crashes on Android, investigate it
-    qApp->processEvents(); // -jbb: this seemed to make it work.
+    //Components loaded by worker threads at startup only emit the signal, see SkyMapLoader
+    if (QThread::currentThread() == qApp->thread())
+        qApp->processEvents(); // -jbb: this seemed to make it work.
 #endif
     //qCDebug(KSTARS) << QString("PROGRESS TEXT: %1\n").arg( message );
 }
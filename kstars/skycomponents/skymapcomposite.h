@@ -19,6 +19,7 @@
 
 #include "culturelist.h"
 #include "ksnumbers.h"
+#include "objectnameindex.h"
 #include "skycomposite.h"
 #include "skylabeler.h"
 #include "skymesh.h"
@@ -237,8 +238,12 @@ class SkyMapComposite : public QObject, public SkyComposite
     void progressText(const QString &message);
 
   private:
+    /** @short Create the synced catalogs and the custom catalogs, which are read from the catalog database */
+    void loadCustomCatalogs();
+
     QHash<int, QStringList> &getObjectNames() override;
     QHash<int, QVector<QPair<QString, const SkyObject *>>> &getObjectLists() override;
+    ObjectNameIndex *getNameIndex() override;
 
     std::unique_ptr<CultureList> m_Cultures;
     ConstellationBoundaryLines *m_CBoundLines { nullptr };
@@ -255,6 +260,8 @@ class SkyMapComposite : public QObject, public SkyComposite
     HorizonComponent *m_Horizon { nullptr };
     MilkyWay *m_MilkyWay { nullptr };
     SolarSystemComposite *m_SolarSystem { nullptr };
+    // Declared before the custom catalogs, whose components remove their objects from it when destroyed
+    ObjectNameIndex m_NameIndex;
     std::unique_ptr<SkyComposite> m_CustomCatalogs;
     StarComponent *m_Stars { nullptr };
 #ifndef KSTARS_LITE
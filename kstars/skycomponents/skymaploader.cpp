@@ -0,0 +1,168 @@
+/***************************************************************************
+                  skymaploader.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "skymaploader.h"
+
+#include "kstars_debug.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+
+namespace
+{
+// Names of the task running on each thread
+thread_local QHash<int, QStringList> *currentNames   = nullptr;
+thread_local SkyMapLoader::ObjectLists *currentLists = nullptr;
+thread_local ObjectNameIndex *currentIndex           = nullptr;
+}
+
+SkyMapLoader::~SkyMapLoader()
+{
+    qDeleteAll(m_Tasks);
+}
+
+SkyMapLoader::TaskId SkyMapLoader::addTask(const QString &name, const std::function<void()> &function,
+                                           const QVector<TaskId> &dependencies, Affinity affinity)
+{
+    const TaskId id = m_Tasks.size();
+
+    Task *task     = new Task;
+    task->name     = name;
+    task->function = function;
+    task->affinity = affinity;
+    task->pending  = dependencies.size();
+
+    for (TaskId dependency : dependencies)
+    {
+        // Tasks can only depend on earlier ones, which keeps the graph acyclic
+        Q_ASSERT(dependency >= 0 && dependency < id);
+        m_Tasks[dependency]->dependents.append(id);
+    }
+
+    m_Tasks.append(task);
+    return id;
+}
+
+QHash<int, QStringList> *SkyMapLoader::currentObjectNames()
+{
+    return currentNames;
+}
+
+SkyMapLoader::ObjectLists *SkyMapLoader::currentObjectLists()
+{
+    return currentLists;
+}
+
+ObjectNameIndex *SkyMapLoader::currentNameIndex()
+{
+    return currentIndex;
+}
+
+void SkyMapLoader::run(QHash<int, QStringList> &objectNames, ObjectLists &objectLists, ObjectNameIndex &nameIndex)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker locker(&m_Mutex);
+
+    for (TaskId id = 0; id < m_Tasks.size(); id++)
+    {
+        if (m_Tasks[id]->pending == 0)
+            start(id);
+    }
+
+    while (m_Finished < m_Tasks.size())
+    {
+        if (!m_CallingThreadQueue.isEmpty())
+        {
+            const TaskId id = m_CallingThreadQueue.dequeue();
+            locker.unlock();
+            execute(id);
+            locker.relock();
+        }
+        else
+        {
+            m_Done.wait(&m_Mutex, 100);
+
+            // Keep the splash screen updated while the workers are loading
+            locker.unlock();
+#ifndef Q_OS_ANDROID
+            qApp->processEvents();
+#endif
+            locker.relock();
+        }
+    }
+
+    locker.unlock();
+
+    qint64 total = 0;
+    for (Task *task : m_Tasks)
+    {
+        total += task->elapsed;
+
+        for (auto it = task->objectNames.cbegin(); it != task->objectNames.cend(); ++it)
+            objectNames[it.key()] += it.value();
+        for (auto it = task->objectLists.cbegin(); it != task->objectLists.cend(); ++it)
+            objectLists[it.key()] += it.value();
+        nameIndex.merge(task->nameIndex);
+    }
+
+    qCInfo(KSTARS) << QString("Loaded sky components in %1 ms, tasks took %2 ms in total")
+                   .arg(timer.elapsed())
+                   .arg(total);
+}
+
+void SkyMapLoader::start(TaskId id)
+{
+    if (m_Tasks[id]->affinity == CallingThread)
+    {
+        m_CallingThreadQueue.enqueue(id);
+        m_Done.wakeAll();
+    }
+    else
+        QtConcurrent::run(this, &SkyMapLoader::execute, id);
+}
+
+void SkyMapLoader::execute(TaskId id)
+{
+    Task *task = m_Tasks[id];
+
+    currentNames = &task->objectNames;
+    currentLists = &task->objectLists;
+    currentIndex = &task->nameIndex;
+
+    QElapsedTimer timer;
+    timer.start();
+    task->function();
+    task->elapsed = timer.elapsed();
+
+    currentNames = nullptr;
+    currentLists = nullptr;
+    currentIndex = nullptr;
+
+    qCInfo(KSTARS) << QString("Loaded %1 in %2 ms").arg(task->name).arg(task->elapsed);
+
+    QMutexLocker locker(&m_Mutex);
+
+    for (TaskId dependent : task->dependents)
+    {
+        if (--m_Tasks[dependent]->pending == 0)
+            start(dependent);
+    }
+
+    m_Finished++;
+    m_Done.wakeAll();
+}
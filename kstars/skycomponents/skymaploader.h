@@ -0,0 +1,119 @@
+/***************************************************************************
+                   skymaploader.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include "objectnameindex.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <functional>
+
+class SkyObject;
+
+/**
+ * @class SkyMapLoader
+ *
+ * Task graph loading the components of the sky map at startup.
+ *
+ * Each task builds one or more components. A task starts as soon as all the tasks it depends on are
+ * done, on the global thread pool, or on the thread calling run() for tasks that use the SQLite
+ * databases or create QObjects. run() returns once all tasks are done, and the time spent in each
+ * task is logged.
+ *
+ * Tasks must not share state, beyond what their dependencies order. In particular the buffers of
+ * the sky mesh used to index lines and polygons are not thread-safe, so all the tasks indexing lines
+ * must depend on each other. The object names registered by each task are kept apart, see
+ * currentObjectNames(), and merged in the order the tasks were added, so that the result does not
+ * depend on scheduling. So are the names indexed by each task, see currentNameIndex().
+ */
+class SkyMapLoader
+{
+  public:
+    typedef int TaskId;
+    typedef QHash<int, QVector<QPair<QString, const SkyObject *>>> ObjectLists;
+
+    /** Thread a task runs on */
+    enum Affinity
+    {
+        AnyThread,
+        CallingThread
+    };
+
+    SkyMapLoader() = default;
+    ~SkyMapLoader();
+
+    /**
+     * @brief addTask Add a task to the graph.
+     * @param name name of the task, for the logs
+     * @param function builds the components
+     * @param dependencies tasks that must be done before this one starts
+     * @param affinity thread the task must run on
+     * @return identifier of the task, to be used as a dependency of later tasks
+     */
+    TaskId addTask(const QString &name, const std::function<void()> &function,
+                   const QVector<TaskId> &dependencies = QVector<TaskId>(), Affinity affinity = AnyThread);
+
+    /**
+     * @brief run Run all tasks and wait until they are done, processing events meanwhile.
+     * The object names and lists registered by the tasks are then appended to the given ones, and the
+     * names indexed by the tasks are merged into the given index.
+     */
+    void run(QHash<int, QStringList> &objectNames, ObjectLists &objectLists, ObjectNameIndex &nameIndex);
+
+    /** @return object names of the task running on the calling thread, nullptr if there is none */
+    static QHash<int, QStringList> *currentObjectNames();
+
+    /** @return object lists of the task running on the calling thread, nullptr if there is none */
+    static ObjectLists *currentObjectLists();
+
+    /** @return name index of the task running on the calling thread, nullptr if there is none */
+    static ObjectNameIndex *currentNameIndex();
+
+  private:
+    struct Task
+    {
+        QString name;
+        std::function<void()> function;
+        Affinity affinity { AnyThread };
+        /** Tasks to start once this one is done */
+        QVector<TaskId> dependents;
+        /** Number of dependencies not done yet */
+        int pending { 0 };
+        qint64 elapsed { 0 };
+        QHash<int, QStringList> objectNames;
+        ObjectLists objectLists;
+        ObjectNameIndex nameIndex;
+    };
+
+    /** Starts a task whose dependencies are done. Called with m_Mutex locked. */
+    void start(TaskId id);
+    void execute(TaskId id);
+
+    QVector<Task *> m_Tasks;
+
+    QMutex m_Mutex;
+    QWaitCondition m_Done;
+    /** Tasks ready to run on the calling thread */
+    QQueue<TaskId> m_CallingThreadQueue;
+    int m_Finished { 0 };
+};
@@ -26,6 +26,8 @@
 #include "projections/projector.h"
 #include "skyobjects/starobject.h"
 
+#include <QMutex>
+#include <QMutexLocker>
 #include <QPainter>
 #include <QPolygonF>
 #include <QPointF>
@@ -33,8 +35,15 @@
 QMap<int, SkyMesh *> SkyMesh::pinstances;
 int SkyMesh::defaultLevel = -1;
 
+namespace
+{
+// Deep star catalogs create their meshes while other components are loading, see SkyMapLoader
+QMutex instancesMutex;
+}
+
 SkyMesh *SkyMesh::Create(int level)
 {
+    QMutexLocker locker(&instancesMutex);
     SkyMesh *newInstance = pinstances.value(level, nullptr);
 
     delete newInstance;
@@ -48,11 +57,13 @@ SkyMesh *SkyMesh::Create(int level)
 
 SkyMesh *SkyMesh::Instance()
 {
+    QMutexLocker locker(&instancesMutex);
     return pinstances.value(defaultLevel, nullptr);
 }
 
 SkyMesh *SkyMesh::Instance(int level)
 {
+    QMutexLocker locker(&instancesMutex);
     return pinstances.value(level, nullptr);
 }
 
@@ -20,6 +20,7 @@
 #include "asteroidscomponent.h"
 #include "cometscomponent.h"
 #include "kstarsdata.h"
+#include "objectnameindex.h"
 #include "Options.h"
 #ifndef KSTARS_LITE
 #include "skymap.h"
@@ -95,7 +96,7 @@ SolarSystemComposite::SolarSystemComposite(SkyComposite *parent) : SkyComposite(
         PlanetMoons *moons = pMoons->getMoons();
         for(int i = 0; i < moons->nMoons(); ++i) {
             SkyObject *moon = moons->moon(i);
-            objectLists(SkyObject::MOON).append(QPair<QString, const SkyObject*>(moon->name(), moon));
+            addToLists(SkyObject::MOON, moon->name(), moon);
         }
     }*/
 
@@ -108,6 +109,11 @@ SolarSystemComposite::~SolarSystemComposite()
     delete (m_EarthShadow);
 }
 
+int SolarSystemComposite::namePriority() const
+{
+    return ObjectNameIndex::SolarSystemPriority;
+}
+
 bool SolarSystemComposite::selected()
 {
 #ifndef KSTARS_LITE
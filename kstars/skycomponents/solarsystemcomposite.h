@@ -55,6 +55,8 @@ class SolarSystemComposite : public SkyComposite
     const QList<SkyObject *> &planetObjects() const;
     const QList<SkyObject *> &moons() const;
 
+    int namePriority() const override;
+
     bool selected() override;
 
     void update(KSNumbers *num) override;
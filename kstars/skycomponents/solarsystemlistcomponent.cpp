@@ -22,7 +22,9 @@
 #ifndef KSTARS_LITE
 #include "skymap.h"
 #endif
+#include "skymesh.h"
 #include "solarsystemcomposite.h"
+#include "htmesh/MeshIterator.h"
 #include "skyobjects/ksplanet.h"
 #include "skyobjects/ksplanetbase.h"
 
@@ -30,7 +32,8 @@
 
 #include <QPen>
 
-SolarSystemListComponent::SolarSystemListComponent(SolarSystemComposite *p) : ListComponent(p), m_Earth(p->earth())
+SolarSystemListComponent::SolarSystemListComponent(SolarSystemComposite *p)
+    : ListComponent(p), m_Earth(p->earth()), m_skyMesh(SkyMesh::Instance())
 {
 }
 
@@ -69,6 +72,78 @@ void SolarSystemListComponent::updateSolarSystemBodies(KSNumbers *num)
             if (p->hasTrail())
                 p->updateTrail(data->lst(), data->geo()->lat());
         }
+
+        // Objects are bucketed again on the next search
+        invalidateIndex();
+    }
+}
+
+const QHash<Trixel, QVector<SkyObject *>> &SolarSystemListComponent::objectIndex()
+{
+    if (!m_IndexValid)
+    {
+        m_ObjectIndex.clear();
+
+        // Positions are indexed by their J2000 coordinates, like the apertures of the sky mesh
+        for (auto o : m_ObjectList)
+            m_ObjectIndex[m_skyMesh->index(o)].append(o);
+
+        m_IndexValid = true;
+    }
+
+    return m_ObjectIndex;
+}
+
+SkyObject *SolarSystemListComponent::objectNearest(SkyPoint *p, double &maxrad)
+{
+    if (!selected())
+        return nullptr;
+
+    const QHash<Trixel, QVector<SkyObject *>> &index = objectIndex();
+    SkyObject *oBest = nullptr;
+
+    MeshIterator region(m_skyMesh, OBJ_NEAREST_BUF);
+    while (region.hasNext())
+    {
+        auto it = index.constFind(region.next());
+        if (it == index.constEnd())
+            continue;
+
+        for (SkyObject *o : *it)
+        {
+            if (!isSearchable(o))
+                continue;
+
+            double r = o->angularDistanceTo(p).Degrees();
+            if (r < maxrad)
+            {
+                oBest  = o;
+                maxrad = r;
+            }
+        }
+    }
+
+    return oBest;
+}
+
+void SolarSystemListComponent::objectsInArea(QList<SkyObject *> &list, const SkyRegion &region)
+{
+    if (!selected())
+        return;
+
+    const QHash<Trixel, QVector<SkyObject *>> &index = objectIndex();
+
+    for (SkyRegion::const_iterator it = region.constBegin(); it != region.constEnd(); ++it)
+    {
+        auto objects = index.constFind(it.key());
+        if (objects == index.constEnd())
+            continue;
+
+        for (SkyObject *o : *objects)
+        {
+            if (isSearchable(o))
+                list.append(o);
+        }
     }
 }
 
@@ -19,7 +19,11 @@
 
 #include "listcomponent.h"
 
+#include <QHash>
+#include <QVector>
+
 class KSPlanet;
+class SkyMesh;
 class SolarSystemComposite;
 
 /**
@@ -46,9 +50,33 @@ class SolarSystemListComponent : public ListComponent
      */
     void updateSolarSystemBodies(KSNumbers *num) override;
 
+    /**
+     * @short Find the nearest object among the trixels of the OBJ_NEAREST_BUF aperture.
+     * @see SkyComponent::objectNearest()
+     */
+    SkyObject *objectNearest(SkyPoint *p, double &maxrad) override;
+
+    void objectsInArea(QList<SkyObject *> &list, const SkyRegion &region) override;
+
   protected:
     void drawTrails(SkyPainter *skyp) override;
 
+    /** @return true if the object can be found by objectNearest() and objectsInArea() */
+    virtual bool isSearchable(SkyObject *) { return true; }
+
+    /**
+     * @short Forget the trixel index of the objects.
+     * Must be called whenever m_ObjectList changes. The index is rebuilt on the next search.
+     */
+    void invalidateIndex() { m_IndexValid = false; }
+
   private:
+    /** @return the objects bucketed by the trixel of their position, rebuilt if they moved */
+    const QHash<Trixel, QVector<SkyObject *>> &objectIndex();
+
     KSPlanet *m_Earth { nullptr };
+    SkyMesh *m_skyMesh { nullptr };
+
+    QHash<Trixel, QVector<SkyObject *>> m_ObjectIndex;
+    bool m_IndexValid { false };
 };
@@ -18,11 +18,16 @@
 #include <QDebug>
 
 #include "starblock.h"
+#include "kstarsdata.h"
+#include "ksnumbers.h"
+#include "Options.h"
 #include "skyobjects/starobject.h"
 #include "starcomponent.h"
 #include "skyobjects/stardata.h"
 #include "skyobjects/deepstardata.h"
 
+#include <cmath>
+
 #ifdef KSTARS_LITE
 #include "skymaplite.h"
 #include "kstarslite/skyitems/skynodes/pointsourcenode.h"
@@ -49,6 +54,18 @@ StarBlock::StarBlock(int nstars)
       stars(nstars, StarObject())
 #endif
 {
+    m_X0.resize(nstars);
+    m_Y0.resize(nstars);
+    m_Z0.resize(nstars);
+    m_TX.resize(nstars);
+    m_TY.resize(nstars);
+    m_TZ.resize(nstars);
+    m_PM.resize(nstars);
+    m_SinRA.resize(nstars);
+    m_CosRA.resize(nstars);
+    m_SinDec.resize(nstars);
+    m_CosDec.resize(nstars);
+    m_Mag.resize(nstars);
 }
 
 void StarBlock::reset()
@@ -60,8 +77,211 @@ void StarBlock::reset()
     faintMag  = -5.0;
     brightMag = 35.0;
     nStars    = 0;
+
+    m_UpdateID      = 0;
+    m_UpdateNumID   = 0;
+    m_LastPrecessJD = 0;
+}
+
+void StarBlock::storeCatalogData(int i)
+{
+    const StarObject &star = object(i);
+    double sinRA0, cosRA0, sinDec0, cosDec0;
+
+    star.ra0().SinCos(sinRA0, cosRA0);
+    star.dec0().SinCos(sinDec0, cosDec0);
+
+    m_X0[i] = cosDec0 * cosRA0;
+    m_Y0[i] = cosDec0 * sinRA0;
+    m_Z0[i] = sinDec0;
+
+    // The proper motion moves the star along a great circle with bearing atan2( pmRA, pmDec ),
+    // see StarObject::getIndexCoords(). Store the unit tangent vector along that bearing.
+    double pm     = star.pmMagnitude();
+    double length = std::hypot(star.pmRA(), star.pmDec());
+
+    if (std::isnan(pm) || !(length > 0))
+    {
+        m_PM[i] = 0;
+        m_TX[i] = m_TY[i] = m_TZ[i] = 0;
+    }
+    else
+    {
+        double cosBearing = star.pmDec() / length;
+        double sinBearing = star.pmRA() / length;
+
+        m_PM[i] = pm;
+        m_TX[i] = -sinDec0 * cosRA0 * cosBearing - sinRA0 * sinBearing;
+        m_TY[i] = -sinDec0 * sinRA0 * cosBearing + cosRA0 * sinBearing;
+        m_TZ[i] = cosDec0 * cosBearing;
+    }
+
+    m_Mag[i] = star.mag();
+
+    // Force a full update of the block the next time it is drawn
+    m_UpdateID      = 0;
+    m_UpdateNumID   = 0;
+    m_LastPrecessJD = 0;
 }
 
+void StarBlock::JITupdate()
+{
+    static KStarsData *data = KStarsData::Instance();
+
+    if (nStars == 0 || m_UpdateID == data->updateID())
+        return;
+
+    // Light bending depends on the distance of each star to the Sun, leave that to the scalar code
+    if (Options::useRelativistic())
+    {
+        for (int i = 0; i < nStars; ++i)
+        {
+            if (object(i).updateID != data->updateID())
+                object(i).JITupdate();
+        }
+        m_UpdateID = data->updateID();
+        return;
+    }
+
+    if (m_UpdateNumID != data->updateNumID())
+    {
+        // Same short circuit as in StarObject::JITupdate(): recompute once per solar minute
+        if (Options::alwaysRecomputeCoordinates() || std::abs(m_LastPrecessJD - data->updateNum()->getJD()) >= 0.00069444)
+            updateEquatorial(data->updateNum());
+
+        m_UpdateNumID = data->updateNumID();
+    }
+
+    updateHorizontal(data->lst(), data->geo()->lat());
+
+    m_UpdateID = data->updateID();
+    for (int i = 0; i < nStars; ++i)
+    {
+        object(i).updateNumID = m_UpdateNumID;
+        object(i).updateID    = m_UpdateID;
+    }
+}
+
+void StarBlock::updateEquatorial(const KSNumbers *num)
+{
+    const int n     = nStars;
+    const double jd = num->getJD();
+
+    // Proper motion, along a great circle. Corrections below one arcsecond are ignored,
+    // like in StarObject::getIndexCoords()
+    Eigen::ArrayXd pm  = m_PM.head(n) * num->julianMillenia(); // arcsec
+    Eigen::ArrayXd dst = (pm.abs() < 1.0).select(0.0, pm * (dms::PI / (180.0 * 3600.0)));
+    Eigen::ArrayXd sinDst = dst.sin();
+    Eigen::ArrayXd cosDst = dst.cos();
+
+    Eigen::ArrayXd sx = m_X0.head(n) * cosDst + m_TX.head(n) * sinDst;
+    Eigen::ArrayXd sy = m_Y0.head(n) * cosDst + m_TY.head(n) * sinDst;
+    Eigen::ArrayXd sz = m_Z0.head(n) * cosDst + m_TZ.head(n) * sinDst;
+
+    // Precession, see SkyPoint::precess()
+    const Eigen::Matrix3d &P = num->p2();
+    Eigen::ArrayXd vx = P(0, 0) * sx + P(0, 1) * sy + P(0, 2) * sz;
+    Eigen::ArrayXd vy = P(1, 0) * sx + P(1, 1) * sy + P(1, 2) * sz;
+    Eigen::ArrayXd vz = (P(2, 0) * sx + P(2, 1) * sy + P(2, 2) * sz).max(-1.0).min(1.0);
+
+    Eigen::ArrayXd cosDec = (vx.square() + vy.square()).sqrt();
+    Eigen::ArrayXd sinDec = vz;
+    Eigen::ArrayXd cosRA  = vx / cosDec;
+    Eigen::ArrayXd sinRA  = vy / cosDec;
+    Eigen::ArrayXd tanDec = sinDec / cosDec;
+
+    double sinOb, cosOb;
+    num->obliquity()->SinCos(sinOb, cosOb);
+
+    // Nutation, approximate method of SkyPoint::nutate(), in degrees
+    Eigen::ArrayXd dRA  = num->dEcLong() * (cosOb + sinOb * sinRA * tanDec) - num->dObliq() * cosRA * tanDec;
+    Eigen::ArrayXd dDec = num->dEcLong() * sinOb * cosRA + num->dObliq() * sinRA;
+
+    // Rotate the sines and cosines by the (small) nutation offsets
+    Eigen::ArrayXd sinD = (dRA * dms::DegToRad).sin(), cosD = (dRA * dms::DegToRad).cos();
+    Eigen::ArrayXd sinRA1 = sinRA * cosD + cosRA * sinD;
+    Eigen::ArrayXd cosRA1 = cosRA * cosD - sinRA * sinD;
+    sinD = (dDec * dms::DegToRad).sin();
+    cosD = (dDec * dms::DegToRad).cos();
+    Eigen::ArrayXd sinDec1 = sinDec * cosD + cosDec * sinD;
+    Eigen::ArrayXd cosDec1 = cosDec * cosD - sinDec * sinD;
+
+    // Aberration, see SkyPoint::aberrate()
+    double K = num->constAberr().Degrees();
+    double e = num->earthEccentricity();
+    double sinL, cosL, sinP, cosP;
+    num->sunTrueLongitude().SinCos(sinL, cosL);
+    num->earthPerihelionLongitude().SinCos(sinP, cosP);
+
+    Eigen::ArrayXd dRA2  = K * (cosRA1 * cosOb / cosDec1) * (e * cosP - cosL);
+    Eigen::ArrayXd dDec2 = K * (sinRA1 * (sinOb * cosDec1 - cosOb * sinDec1) * (e * cosP - cosL) +
+                                cosRA1 * sinDec1 * (e * sinP - sinL));
+
+    sinD = (dRA2 * dms::DegToRad).sin();
+    cosD = (dRA2 * dms::DegToRad).cos();
+    m_SinRA.head(n) = sinRA1 * cosD + cosRA1 * sinD;
+    m_CosRA.head(n) = cosRA1 * cosD - sinRA1 * sinD;
+    sinD = (dDec2 * dms::DegToRad).sin();
+    cosD = (dDec2 * dms::DegToRad).cos();
+    m_SinDec.head(n) = sinDec1 * cosD + cosDec1 * sinD;
+    m_CosDec.head(n) = cosDec1 * cosD - sinDec1 * sinD;
+
+    Eigen::ArrayXd precessedDec = sinDec.asin() / dms::DegToRad;
+
+    // Write the results back to the stars
+    for (int i = 0; i < n; ++i)
+    {
+        StarObject &star = object(i);
+
+        // SkyPoint::nutate() switches to an exact method close to the poles, let the star handle that
+        if (std::abs(precessedDec[i]) >= 80.0)
+        {
+            star.updateCoords(num);
+            star.ra().SinCos(m_SinRA[i], m_CosRA[i]);
+            star.dec().SinCos(m_SinDec[i], m_CosDec[i]);
+            continue;
+        }
+
+        double ra = std::atan2(vy[i], vx[i]);
+        if (ra < 0)
+            ra += 2.0 * dms::PI;
+
+        star.setApparentCoords(CachingDms(ra / dms::DegToRad + dRA[i] + dRA2[i], m_SinRA[i], m_CosRA[i]),
+                               CachingDms(precessedDec[i] + dDec[i] + dDec2[i], m_SinDec[i], m_CosDec[i]), jd);
+    }
+
+    m_LastPrecessJD = jd;
+}
+
+void StarBlock::updateHorizontal(const CachingDms *LST, const CachingDms *lat)
+{
+    const int n = nStars;
+    double sinLST, cosLST, sinLat, cosLat;
+
+    LST->SinCos(sinLST, cosLST);
+    lat->SinCos(sinLat, cosLat);
+
+    // Hour angle = LST - RA, see SkyPoint::EquatorialToHorizontal()
+    Eigen::ArrayXd sinHA = sinLST * m_CosRA.head(n) - cosLST * m_SinRA.head(n);
+    Eigen::ArrayXd cosHA = cosLST * m_CosRA.head(n) + sinLST * m_SinRA.head(n);
+
+    Eigen::ArrayXd sinAlt = (m_SinDec.head(n) * sinLat + m_CosDec.head(n) * cosLat * cosHA).max(-1.0).min(1.0);
+    Eigen::ArrayXd alt    = sinAlt.asin();
+    Eigen::ArrayXd cosAlt = (1.0 - sinAlt.square()).sqrt();
+    Eigen::ArrayXd arg    = ((m_SinDec.head(n) - sinLat * sinAlt) / (cosLat * cosAlt)).max(-1.0).min(1.0);
+    Eigen::ArrayXd az     = arg.acos();
+
+    az = (sinHA > 0.0).select(2.0 * dms::PI - az, az); // resolve acos() ambiguity
+
+    for (int i = 0; i < n; ++i)
+    {
+        StarObject &star = object(i);
+        star.setAlt(alt[i] / dms::DegToRad);
+        star.setAz(az[i] / dms::DegToRad);
+    }
+}
+
+
 #ifdef KSTARS_LITE
 StarNode *StarBlock::addStar(const StarData &data)
 {
@@ -71,6 +291,7 @@ StarNode *StarBlock::addStar(const StarData &data)
     StarObject &star = node.star;
 
     star.init(&data);
+    storeCatalogData(nStars - 1);
     if (star.mag() > faintMag)
         faintMag = star.mag();
     if (star.mag() < brightMag)
@@ -86,6 +307,7 @@ StarNode *StarBlock::addStar(const DeepStarData &data)
     StarObject &star = node.star;
 
     star.init(&data);
+    storeCatalogData(nStars - 1);
     if (star.mag() > faintMag)
         faintMag = star.mag();
     if (star.mag() < brightMag)
@@ -100,6 +322,7 @@ StarObject *StarBlock::addStar(const StarData &data)
     StarObject &star = stars[nStars++];
 
     star.init(&data);
+    storeCatalogData(nStars - 1);
     if (star.mag() > faintMag)
         faintMag = star.mag();
     if (star.mag() < brightMag)
@@ -114,6 +337,7 @@ StarObject *StarBlock::addStar(const DeepStarData &data)
     StarObject &star = stars[nStars++];
 
     star.init(&data);
+    storeCatalogData(nStars - 1);
     if (star.mag() > faintMag)
         faintMag = star.mag();
     if (star.mag() < brightMag)
@@ -22,6 +22,10 @@
 
 #include <QVector>
 
+#include <Eigen/Core>
+
+class CachingDms;
+class KSNumbers;
 class StarObject;
 class StarBlockList;
 class PointSourceNode;
@@ -143,6 +147,24 @@ class StarBlock
     /** @short  Reset this StarBlock's data, for reuse of the StarBlock */
     void reset();
 
+    /**
+     * @short  Brings the coordinates of all stars in this block up to date
+     *
+     * This is the block-wise equivalent of calling StarObject::JITupdate() on every star. Proper motion,
+     * precession, nutation and aberration are applied to the structure-of-arrays copy of the catalog
+     * data in a few vectorized passes, followed by the conversion to horizontal coordinates. The results
+     * are then written back to the StarObjects. Stars close to the celestial poles, and all stars if
+     * relativistic light bending is enabled, go through the regular StarObject code path.
+     */
+    void JITupdate();
+
+    /**
+     * @short  Return the magnitudes of the stars in this StarBlock
+     *
+     * Only the first getStarCount() entries are valid.
+     */
+    inline const Eigen::ArrayXf &magnitudes() const { return m_Mag; }
+
     float faintMag { 0 };
     float brightMag { 0 };
     StarBlockList *parent;
@@ -151,10 +173,45 @@ class StarBlock
     quint32 drawID { 0 };
 
   private:
+#ifdef UNIT_TEST
+    friend class TestStarBlock;
+#endif
+
     // Disallow copying and assignment. Just in case.
     StarBlock(const StarBlock &);
     StarBlock &operator=(const StarBlock &);
 
+    /** @short Returns the StarObject of the i-th entry */
+#ifdef KSTARS_LITE
+    inline StarObject &object(int i) { return stars[i].star; }
+#else
+    inline StarObject &object(int i) { return stars[i]; }
+#endif
+
+    /** @short Copies the catalog data of the i-th star into the structure-of-arrays storage */
+    void storeCatalogData(int i);
+
+    /** @short Applies proper motion, precession, nutation and aberration to all stars */
+    void updateEquatorial(const KSNumbers *num);
+
+    /** @short Computes the horizontal coordinates of all stars */
+    void updateHorizontal(const CachingDms *LST, const CachingDms *lat);
+
+    /** Catalog position as a J2000 unit vector */
+    Eigen::ArrayXd m_X0, m_Y0, m_Z0;
+    /** Unit vector tangent to the sky in the direction of the proper motion */
+    Eigen::ArrayXd m_TX, m_TY, m_TZ;
+    /** Magnitude of the proper motion in milliarcsec per year */
+    Eigen::ArrayXd m_PM;
+    /** Sine and cosine of the apparent RA and Dec, as of the last update */
+    Eigen::ArrayXd m_SinRA, m_CosRA, m_SinDec, m_CosDec;
+    /** Star magnitudes */
+    Eigen::ArrayXf m_Mag;
+
+    quint64 m_UpdateID { 0 };
+    quint64 m_UpdateNumID { 0 };
+    double m_LastPrecessJD { 0 };
+
     /** Number of initialized stars in StarBlock. */
     int nStars { 0 };
     /** Array of stars. */
@@ -19,6 +19,8 @@
 
 #include "typedef.h"
 
+#include <QMutex>
+
 class StarBlock;
 
 /**
@@ -94,6 +96,14 @@ class StarBlockFactory
      */
     void printStructure() const;
 
+    /**
+     * @short  Lock guarding the LRU cache and the StarBlockLists that own its blocks
+     *
+     * Star blocks can be loaded from a worker thread (see StarBlockPrefetcher), so anything
+     * that fills, releases or iterates over dynamically loaded StarBlocks must hold this lock.
+     */
+    inline QMutex &mutex() { return m_Mutex; }
+
     quint32 drawID; // A number identifying the current draw cycle
 
   private:
@@ -115,5 +125,7 @@ class StarBlockFactory
     int nBlocks;             // Number of blocks we currently have in the cache
     int nCache;              // Number of blocks to start recycling cached blocks at
 
+    QMutex m_Mutex;
+
     static StarBlockFactory *pInstance;
 };
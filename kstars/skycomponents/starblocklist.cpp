@@ -21,6 +21,8 @@
 #include "deepstarcomponent.h"
 #include "starblock.h"
 #include "starcomponent.h"
+#include "skyobjects/deepstardata.h"
+#include "skyobjects/stardata.h"
 
 #ifdef KSTARS_LITE
 #include "skymaplite.h"
@@ -70,17 +72,62 @@ int StarBlockList::releaseBlock(StarBlock *block)
     return 0;
 }
 
+template <typename T>
+int StarBlockList::addRecords(StarBlock *block, quint32 count, float maglim)
+{
+    BinFileHelper *dSReader = parent->getStarReader();
+    QVector<T> buffer;
+
+    const T *records = dSReader->readRecords(readOffset, count, buffer);
+    if (!records)
+        return -1;
+
+    if (dSReader->getByteSwap())
+    {
+        DeepStarComponent::byteSwap(buffer.data(), count);
+        records = buffer.constData();
+    }
+
+    quint32 added = 0;
+    while (added < count && maglim >= faintMag)
+    {
+        block->addStar(records[added++]);
+        faintMag = block->getFaintMag();
+    }
+
+    readOffset += added * sizeof(T);
+    nStars += added;
+
+    return added;
+}
+
+bool StarBlockList::isFilledToMag(float maglim) const
+{
+    return staticStars || faintMag >= maglim || nStars >= parent->getStarReader()->getRecordCount(trixel);
+}
+
+void StarBlockList::markUsed()
+{
+    StarBlockFactory *SBFactory = StarBlockFactory::Instance();
+
+    if (staticStars || nBlocks == 0)
+        return;
+
+    SBFactory->markFirst(blocks[0]);
+    for (unsigned int i = 1; i < nBlocks; ++i)
+    {
+        if (!SBFactory->markNext(blocks[i - 1], blocks[i]))
+            qWarning() << "ERROR: markNext() failed on block #" << i + 1 << "in trixel" << trixel;
+    }
+}
+
 bool StarBlockList::fillToMag(float maglim)
 {
     // TODO: Remove staticity of BinFileHelper
     BinFileHelper *dSReader;
     StarBlockFactory *SBFactory;
-    StarData stardata;
-    DeepStarData deepstardata;
-    FILE *dataFile;
 
     dSReader  = parent->getStarReader();
-    dataFile  = dSReader->getFileHandle();
     SBFactory = StarBlockFactory::Instance();
 
     if (staticStars)
@@ -89,7 +136,7 @@ bool StarBlockList::fillToMag(float maglim)
     if (faintMag >= maglim)
         return true;
 
-    if (!dataFile)
+    if (!dSReader->getFileHandle())
     {
         qDebug() << "dataFile not opened!";
         return false;
@@ -103,18 +150,16 @@ bool StarBlockList::fillToMag(float maglim)
 
     Q_ASSERT(nBlocks == (unsigned int)blocks.size());
 
-    BinFileHelper::unsigned_KDE_fseek(dataFile, readOffset, SEEK_SET);
-
     /*
     qDebug() << "Reading trixel" << trixel << ", id on disk =" << trixelId << ", currently nStars =" << nStars
              << ", record count =" << dSReader->getRecordCount( trixelId ) << ", first block = " << blocks[0]->getStarCount()
              << "to maglim =" << maglim << "with current faintMag =" << faintMag;
     */
 
-    while (maglim >= faintMag && nStars < dSReader->getRecordCount(trixelId))
-    {
-        int ret = 0;
+    const unsigned long recordCount = dSReader->getRecordCount(trixelId);
 
+    while (maglim >= faintMag && nStars < recordCount)
+    {
         if (nBlocks == 0 || blocks[nBlocks - 1]->isFull())
         {
             std::shared_ptr<StarBlock> newBlock = SBFactory->getBlock();
@@ -134,22 +179,22 @@ bool StarBlockList::fillToMag(float maglim)
 
             ++nBlocks;
         }
+
+        // Read as many records as the current block can take in one go, instead of one star at a time
+        StarBlock *block = blocks[nBlocks - 1].get();
+        quint32 count    = qMin<unsigned long>(recordCount - nStars, block->size() - block->getStarCount());
+        int added;
+
         // TODO: Make this more general
         if (dSReader->guessRecordSize() == 32)
-        {
-            ret = fread(&stardata, sizeof(StarData), 1, dataFile);
-            if (dSReader->getByteSwap())
-                DeepStarComponent::byteSwap(&stardata);
-            readOffset += sizeof(StarData);
-            blocks[nBlocks - 1]->addStar(stardata);
-        }
+            added = addRecords<StarData>(block, count, maglim);
         else
+            added = addRecords<DeepStarData>(block, count, maglim);
+
+        if (added < 0)
         {
-            ret = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
-            if (dSReader->getByteSwap())
-                DeepStarComponent::byteSwap(&deepstardata);
-            readOffset += sizeof(DeepStarData);
-            blocks[nBlocks - 1]->addStar(deepstardata);
+            qWarning() << "ERROR: Could not read" << count << "records at offset" << readOffset << "in trixel" << trixel;
+            return false;
         }
 
         /*
@@ -158,8 +203,6 @@ bool StarBlockList::fillToMag(float maglim)
           << blocks[nBlocks - 1]->getFaintMag() << "in trixel" << trixel;
           }
         */
-        faintMag = blocks[nBlocks - 1]->getFaintMag();
-        nStars++;
     }
 
     return ((maglim < faintMag) ? true : false);
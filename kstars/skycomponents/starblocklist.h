@@ -48,6 +48,22 @@ class StarBlockList
      */
     bool fillToMag(float maglim);
 
+    /**
+     * @short  Checks whether the list already holds all stars up to the given magnitude limit
+     *
+     * @param  maglim Magnitude limit
+     * @return true if fillToMag(maglim) would not need to read anything from the data file
+     */
+    bool isFilledToMag(float maglim) const;
+
+    /**
+     * @short  Marks the blocks of the list as the most recently used ones in the StarBlockFactory
+     *
+     * Keeps the blocks of a list that is about to be drawn from being recycled first.
+     * The caller must hold StarBlockFactory::mutex().
+     */
+    void markUsed();
+
     /**
      * @short Sets the first StarBlock in the list to point to the given StarBlock
      *
@@ -104,6 +120,16 @@ class StarBlockList
     inline Trixel getTrixel() const { return trixel; }
 
   private:
+    /**
+     * @short Reads up to @p count records of type T at readOffset into @p block
+     *
+     * The records are fetched from the data file in a single read, and stars are added
+     * to the block until the block is full or the magnitude limit is exceeded.
+     * @return The number of stars added, or -1 if the records could not be read
+     */
+    template <typename T>
+    int addRecords(StarBlock *block, quint32 count, float maglim);
+
     Trixel trixel;
     unsigned long nStars { 0 };
     long readOffset { 0 };
@@ -0,0 +1,84 @@
+/***************************************************************************
+                starblockprefetcher.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "starblockprefetcher.h"
+
+#include "deepstarcomponent.h"
+#include "starblockfactory.h"
+#include "starblocklist.h"
+
+#include <QMutexLocker>
+#include <QtConcurrent>
+
+StarBlockPrefetcher::StarBlockPrefetcher(DeepStarComponent *parent) : m_Parent(parent)
+{
+    // A single worker is enough: the loads are serialized by the StarBlockFactory lock anyway
+    m_Pool.setMaxThreadCount(1);
+}
+
+StarBlockPrefetcher::~StarBlockPrefetcher()
+{
+    cancel();
+}
+
+void StarBlockPrefetcher::prefetch(const QVector<Trixel> &trixels, float maglim)
+{
+    int generation = m_Generation.fetchAndAddOrdered(1) + 1;
+
+    if (trixels.isEmpty())
+        return;
+
+    QtConcurrent::run(&m_Pool, this, &StarBlockPrefetcher::fill, generation, trixels, maglim);
+}
+
+void StarBlockPrefetcher::cancel()
+{
+    m_Generation.fetchAndAddOrdered(1);
+    m_Pool.waitForDone();
+}
+
+void StarBlockPrefetcher::resetCounters()
+{
+    m_Hits   = 0;
+    m_Misses = 0;
+    m_Prefetched.store(0);
+}
+
+void StarBlockPrefetcher::fill(int generation, QVector<Trixel> trixels, float maglim)
+{
+    for (Trixel trixel : trixels)
+    {
+        // A newer request supersedes this one
+        if (m_Generation.load() != generation)
+            return;
+
+        QMutexLocker locker(&StarBlockFactory::Instance()->mutex());
+
+        std::shared_ptr<StarBlockList> sbl = m_Parent->starBlockList(trixel);
+        if (!sbl)
+            continue;
+
+        // Trixels loaded by an earlier request are marked again, or their blocks would be the next to be recycled
+        if (sbl->isFilledToMag(maglim))
+        {
+            sbl->markUsed();
+            continue;
+        }
+
+        sbl->fillToMag(maglim);
+        sbl->markUsed();
+        m_Prefetched.fetchAndAddRelaxed(1);
+    }
+}
@@ -0,0 +1,85 @@
+/***************************************************************************
+                 starblockprefetcher.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include "typedef.h"
+
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QVector>
+
+class DeepStarComponent;
+
+/**
+ * @class StarBlockPrefetcher
+ *
+ * Loads star blocks of trixels that are about to become visible from a worker thread,
+ * so that DeepStarComponent::draw() does not block on disk I/O when the map is slewed.
+ *
+ * The prefetcher keeps a single worker thread. Each call to prefetch() supersedes the
+ * previous request; the worker stops as soon as it notices that its request is stale.
+ * All StarBlockList and StarBlockFactory accesses are serialized with StarBlockFactory::mutex().
+ *
+ * The draw loop reports cache hits and misses for visible trixels via recordHit() and
+ * recordMiss(), which can be used to tune the prefetch margin.
+ */
+class StarBlockPrefetcher
+{
+  public:
+    explicit StarBlockPrefetcher(DeepStarComponent *parent);
+
+    /** Cancels any pending request and waits for the worker thread to finish */
+    ~StarBlockPrefetcher();
+
+    /**
+     * @short Loads the given trixels to the given magnitude limit in the background
+     * @param trixels Trixels to fill, in order of priority. The blocks of trixels that are already
+     * filled are marked as most recently used instead.
+     * @param maglim Magnitude limit to fill the trixels to
+     */
+    void prefetch(const QVector<Trixel> &trixels, float maglim);
+
+    /** @short Drops the pending request and waits until the worker is idle */
+    void cancel();
+
+    /** @short Records a visible trixel that was already loaded when it had to be drawn */
+    inline void recordHit() { ++m_Hits; }
+
+    /** @short Records a visible trixel that had to be loaded on the GUI thread */
+    inline void recordMiss() { ++m_Misses; }
+
+    /** @return Number of visible trixels that were already loaded */
+    inline quint64 hits() const { return m_Hits; }
+
+    /** @return Number of visible trixels that had to be loaded on the GUI thread */
+    inline quint64 misses() const { return m_Misses; }
+
+    /** @return Number of trixels filled by the worker thread */
+    inline int prefetched() const { return m_Prefetched.load(); }
+
+    /** @short Resets the hit, miss and prefetch counters */
+    void resetCounters();
+
+  private:
+    void fill(int generation, QVector<Trixel> trixels, float maglim);
+
+    DeepStarComponent *m_Parent { nullptr };
+    QThreadPool m_Pool;
+    QAtomicInt m_Generation { 0 };
+    QAtomicInt m_Prefetched { 0 };
+    quint64 m_Hits { 0 };
+    quint64 m_Misses { 0 };
+};
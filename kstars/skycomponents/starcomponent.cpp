@@ -25,19 +25,18 @@
 #endif
 #include "kstarsdata.h"
 #include "kstarssplash.h"
+#include "objectnameindex.h"
 #include "Options.h"
 #include "skylabeler.h"
 #include "skymap.h"
 #include "skymesh.h"
-#ifndef KSTARS_LITE
-#include "skyqpainter.h"
-#endif
 #include "htmesh/MeshIterator.h"
 #include "projections/projector.h"
 
 #include "kstars_debug.h"
 
 #include <qplatformdefs.h>
+#include <QMutexLocker>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -79,10 +78,8 @@ StarComponent::StarComponent(SkyComposite *parent)
     // The following works but can cause crashes sometimes
     //QtConcurrent::run(this, &StarComponent::loadDeepStarCatalogs);
 
-    //In KStars Lite star images are initialized in SkyMapLite
-#ifndef KSTARS_LITE
-    SkyQPainter::initStarImages();
-#endif
+    // Star images are initialized by SkyMapComposite once all components are loaded,
+    // in KStars Lite by SkyMapLite
 }
 
 StarComponent::~StarComponent()
@@ -104,6 +101,11 @@ StarComponent *StarComponent::Create(SkyComposite *parent)
     return pinstance;
 }
 
+int StarComponent::namePriority() const
+{
+    return ObjectNameIndex::StarPriority;
+}
+
 bool StarComponent::selected()
 {
     return Options::showStars();
@@ -312,7 +314,10 @@ void StarComponent::draw(SkyPainter *skyp)
     if (hideFaintStars && maglim > hideStarsMag)
         maglim = hideStarsMag;
 
-    m_StarBlockFactory->drawID = m_skyMesh->drawID();
+    {
+        QMutexLocker locker(&m_StarBlockFactory->mutex());
+        m_StarBlockFactory->drawID = m_skyMesh->drawID();
+    }
 
     int nTrixels = 0;
 
@@ -322,6 +327,10 @@ void StarComponent::draw(SkyPainter *skyp)
         Trixel currentRegion = region.next();
         StarList *starList   = m_starIndex->at(currentRegion);
 
+        m_DrawStars.clear();
+        m_DrawMags.clear();
+        m_DrawSpectra.clear();
+
         for (auto &star : *starList)
         {
             if (!star)
@@ -336,11 +345,25 @@ void StarComponent::draw(SkyPainter *skyp)
             if (star->updateID != updateID)
                 star->JITupdate();
 
-            bool drawn = skyp->drawPointSource(star, mag, star->spchar());
+            m_DrawStars.append(star);
+            m_DrawMags.append(mag);
+            m_DrawSpectra.append(star->spchar());
+        }
+
+        int count = m_DrawStars.size();
 
-            //FIXME_SKYPAINTER: find a better way to do this.
-            if (drawn && !(m_hideLabels || mag > labelMagLim))
-                addLabel(proj->toScreen(star), star);
+        m_DrawStarDrawn.resize(count);
+        skyp->drawPointSources(m_DrawStars.constData(), m_DrawMags.constData(), m_DrawSpectra.constData(), count,
+                               m_DrawStarDrawn.data());
+
+        //FIXME_SKYPAINTER: find a better way to do this.
+        if (!m_hideLabels)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                if (m_DrawStarDrawn[i] && m_DrawMags[i] <= labelMagLim)
+                    addLabel(proj->toScreen(m_DrawStars[i]), static_cast<StarObject *>(m_DrawStars[i]));
+            }
         }
     }
 
@@ -549,14 +572,14 @@ bool StarComponent::loadStaticData()
             if (named)
             {
                 objectNames(SkyObject::STAR).append(name);
-                objectLists(SkyObject::STAR).append(QPair<QString, const SkyObject *>(name, star));
+                addToLists(SkyObject::STAR, name, star);
             }
 
             if (!visibleName.isEmpty() && gname != name)
             {
                 QString gName = star->gname(false);
                 objectNames(SkyObject::STAR).append(gName);
-                objectLists(SkyObject::STAR).append(QPair<QString, const SkyObject *>(gName, star));
+                addToLists(SkyObject::STAR, gName, star);
             }
 
             appendListObject(star);
@@ -644,9 +667,11 @@ StarObject *StarComponent::findByHDIndex(int HDnum)
         if (offset <= 0)
             return nullptr;
         dataFile = m_DeepStarComponents.at(1)->getStarReader()->getFileHandle();
-        //KDE_fseek( dataFile, offset, SEEK_SET );
-        QT_FSEEK(dataFile, offset, SEEK_SET);
         {
+            // The star prefetcher may be reading from the same file handle
+            QMutexLocker locker(&m_StarBlockFactory->mutex());
+            //KDE_fseek( dataFile, offset, SEEK_SET );
+            QT_FSEEK(dataFile, offset, SEEK_SET);
             int rc = fread(&stardata, sizeof(StarData), 1, dataFile);
             Q_UNUSED(rc)
         }
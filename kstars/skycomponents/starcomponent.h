@@ -78,6 +78,8 @@ class StarComponent : public ListComponent
     //is the only one being used.
     void update(KSNumbers *num) override;
 
+    int namePriority() const override;
+
     bool selected() override;
 
     void draw(SkyPainter *skyp) override;
@@ -194,6 +196,12 @@ class StarComponent : public ListComponent
     QHash<int, StarObject *> m_HDHash;
     QVector<DeepStarComponent *> m_DeepStarComponents;
 
+    /// Stars of the trixel being drawn, reused across draw() calls
+    QVector<SkyPoint *> m_DrawStars;
+    QVector<float> m_DrawMags;
+    QVector<char> m_DrawSpectra;
+    QVector<bool> m_DrawStarDrawn;
+
     /**
      * @struct starName
      * @brief Structure that holds star name information, to be read as-is from the
@@ -21,6 +21,7 @@
 #include "kstars_debug.h"
 #include "ksnotification.h"
 #include "kstarsdata.h"
+#include "objectnameindex.h"
 #include "Options.h"
 #include "skylabeler.h"
 #include "skymesh.h"
@@ -53,6 +54,11 @@ void SupernovaeComponent::update(KSNumbers *num)
     }
 }
 
+int SupernovaeComponent::namePriority() const
+{
+    return ObjectNameIndex::SupernovaPriority;
+}
+
 bool SupernovaeComponent::selected()
 {
     return Options::showSupernovae();
@@ -64,7 +70,7 @@ void SupernovaeComponent::loadData()
     m_ObjectList.clear();
 
     objectNames(SkyObject::SUPERNOVA).clear();
-    objectLists(SkyObject::SUPERNOVA).clear();
+    clearLists(SkyObject::SUPERNOVA);
 
     QString name, type, host, date, ra, de;
     float z, mag;
@@ -134,7 +140,7 @@ void SupernovaeComponent::loadData()
         objectNames(SkyObject::SUPERNOVA).append(name);
 
         appendListObject(sup);
-        objectLists(SkyObject::SUPERNOVA).append(QPair<QString, const SkyObject *>(name, sup));
+        addToLists(SkyObject::SUPERNOVA, name, sup);
     }
 
     m_DataLoading = false;
@@ -38,6 +38,8 @@ class SupernovaeComponent : public QObject, public ListComponent
         explicit SupernovaeComponent(SkyComposite *parent);
         virtual ~SupernovaeComponent() override = default;
 
+        int namePriority() const override;
+
         bool selected() override;
         void update(KSNumbers *num = nullptr) override;
         SkyObject *objectNearest(SkyPoint *p, double &maxrad) override;
@@ -21,6 +21,7 @@
 #include "catalogdata.h"
 #include "deepskyobject.h"
 #include "kstarsdata.h"
+#include "objectnameindex.h"
 #include "Options.h"
 #include "tools/nameresolver.h"
 
@@ -72,6 +73,11 @@ void SyncedCatalogComponent::draw( SkyPainter *skyp ) {
 }
 */
 
+int SyncedCatalogComponent::namePriority() const
+{
+    return ObjectNameIndex::SyncedCatalogPriority;
+}
+
 DeepSkyObject *SyncedCatalogComponent::addObject(CatalogEntryData &catalogEntry)
 {
     if (std::isnan(catalogEntry.major_axis))
@@ -102,15 +108,16 @@ DeepSkyObject *SyncedCatalogComponent::addObject(CatalogEntryData &catalogEntry)
     {
         //        newObj->setName( newObj->longname() );
         objectNames()[newObj->type()].append(newObj->longname());
-        objectLists()[newObj->type()].append(QPair<QString, const SkyObject *>(newObj->longname(), newObj));
+        addToLists(newObj->type(), newObj->longname(), newObj);
     }
     else
     {
         qWarning() << "Created object with name " << newObj->name() << " which is probably fake!";
         objectNames()[newObj->type()].append(newObj->name());
-        objectLists()[newObj->type()].append(QPair<QString, const SkyObject *>(newObj->name(), newObj));
+        addToLists(newObj->type(), newObj->name(), newObj);
     }
     m_ObjectList.append(newObj);
+    appendIndex(newObj);
     qDebug() << "Added new SkyObject " << newObj->name() << " to synced catalog " << m_catName << " which now contains "
              << m_ObjectList.count() << " objects.";
     return newObj;
@@ -150,11 +157,14 @@ bool SyncedCatalogComponent::removeObject(SkyObject &object)
     {
         objectNames()[object.type()].removeAll(name);
         objectLists()[object.type()].removeAll(QPair<QString, const SkyObject *>(name, &object));
+        if (nameIndex())
+            nameIndex()->remove(name, &object);
     } else {
         qWarning() << "Can't find SkyObject " << name << " in the synced catalog " << m_catName;
         return false;
     }
     m_ObjectList.removeAll(&object);
+    removeIndex(&object);
     qDebug() << "Remove SkyObject " << name << " from synced catalog " << m_catName;
     // Remove the catalog entry
     CatalogEntryData cedata = NameResolver::resolveName(name);
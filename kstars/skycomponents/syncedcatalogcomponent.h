@@ -78,6 +78,8 @@ class SyncedCatalogComponent : public CatalogComponent
 
     void loadData() override { _loadData(false); }
 
+    int namePriority() const override;
+
     //    virtual bool selected();
 
   private:
@@ -148,6 +148,12 @@ bool SkyGLPainter::addItem(SkyPoint *p, int type, float width, char sp)
     if (!visible)
         return false;
 
+    addItem(vec, type, width, sp);
+    return true;
+}
+
+void SkyGLPainter::addItem(const Vector2f &vec, int type, float width, char sp)
+{
     // Prevent crash if type > UNKNOWN
     if (type > SkyObject::TYPE_UNKNOWN)
         type = SkyObject::TYPE_UNKNOWN;
@@ -244,7 +250,6 @@ bool SkyGLPainter::addItem(SkyPoint *p, int type, float width, char sp)
     }
 
     ++m_idx[type];
-    return true;
 }
 
 void SkyGLPainter::drawTexturedRectangle(const QImage &img, const Vector2f &pos, const float angle, const float sizeX,
@@ -413,6 +418,13 @@ bool SkyGLPainter::drawPointSource(SkyPoint *loc, float mag, char sp)
     return addItem(loc, SkyObject::STAR, starWidth(mag), sp);
 }
 
+void SkyGLPainter::drawPointSources(const QPointF *pos, const float *mags, const char *sp, int count)
+{
+    // Stars already end up in the vertex buffer of their type, which is drawn in one go when full
+    for (int i = 0; i < count; ++i)
+        addItem(Vector2f(pos[i].x(), pos[i].y()), SkyObject::STAR, starWidth(mags[i]), sp[i]);
+}
+
 void SkyGLPainter::drawSkyPolygon(LineList *list)
 {
     SkyList *points = list->points();
@@ -37,6 +37,8 @@ class SkyGLPainter : public SkyPainter
     bool drawPlanet(KSPlanetBase *planet) override;
     bool drawDeepSkyObject(DeepSkyObject *obj, bool drawImage = false) override;
     bool drawPointSource(SkyPoint *loc, float mag, char sp = 'A') override;
+    using SkyPainter::drawPointSources;
+    void drawPointSources(const QPointF *pos, const float *mags, const char *sp, int count) override;
     void drawSkyPolygon(LineList *list, bool forceClip = true) override;
     void drawSkyPolyline(LineList *list, SkipHashList *skipList = nullptr, LineListLabel *label = nullptr) override;
     void drawSkyLine(SkyPoint *a, SkyPoint *b) override;
@@ -56,6 +58,7 @@ class SkyGLPainter : public SkyPainter
 
   private:
     bool addItem(SkyPoint *p, int type, float width, char sp = 'a');
+    void addItem(const Vector2f &vec, int type, float width, char sp = 'a');
     void drawBuffer(int type);
     void drawPolygon(const QVector<Vector2f> &poly, bool convex = true, bool flush_buffers = true);
 
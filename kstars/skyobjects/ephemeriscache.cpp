@@ -0,0 +1,398 @@
+/***************************************************************************
+                  ephemeriscache.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ephemeriscache.h"
+
+#include "kspaths.h"
+#include "kstars_debug.h"
+#include "ksmoon.h"
+#include "ksnumbers.h"
+#include "ksplanet.h"
+#include "kspluto.h"
+#include "kstarsdatetime.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+constexpr double EphemerisCache::BLOCK_DAYS;
+constexpr double EphemerisCache::MAX_RANGE_DAYS;
+constexpr double EphemerisCache::MAX_ERROR;
+
+namespace
+{
+const quint32 CACHE_MAGIC = 0x4b534550; // "KSEP"
+// Bump when the layout of the cache or the theory of a body changes
+const quint32 CACHE_VERSION = 1;
+
+// Segments are not halved below this length, in days. The light-time iterations of the theories leave a jitter
+// of a fraction of an arcsecond that no segment length would smooth out.
+const double MIN_SEGMENT_DAYS = 1.0;
+
+const double ARCSEC_PER_RADIAN = 206264.806;
+
+/** Initial length and degree of the segments fitting a body */
+void initialSegments(const QString &key, double &segmentDays, int &degree)
+{
+    if (key == "Moon")
+    {
+        segmentDays = 4.0;
+        degree      = 13;
+    }
+    else if (key == "Mercury")
+    {
+        segmentDays = 8.0;
+        degree      = 12;
+    }
+    else
+    {
+        segmentDays = 16.0;
+        degree      = 12;
+    }
+}
+
+/** @return block index of a date */
+int blockIndex(long double jd)
+{
+    return static_cast<int>(std::floor(static_cast<double>(jd - J2000) / EphemerisCache::BLOCK_DAYS));
+}
+
+/** @return value at x in [-1, 1] of a Chebyshev series, by Clenshaw's recurrence */
+double chebyshev(const double *c, int n, double x)
+{
+    double b1 = 0, b2 = 0;
+    for (int k = n - 1; k >= 1; k--)
+    {
+        double const b0 = 2 * x * b1 - b2 + c[k];
+        b2              = b1;
+        b1              = b0;
+    }
+    return x * b1 - b2 + c[0];
+}
+}
+
+bool EphemerisCache::Ephemeris::contains(long double jd) const
+{
+    int const i = blockIndex(jd) - m_FirstBlock;
+    return i >= 0 && i < m_Blocks.size();
+}
+
+bool EphemerisCache::Ephemeris::state(long double jd, State &state) const
+{
+    int const index = blockIndex(jd);
+    int const i     = index - m_FirstBlock;
+    if (i < 0 || i >= m_Blocks.size())
+        return false;
+
+    const Block &block = *m_Blocks[i];
+    double const t     = static_cast<double>(jd - J2000) - index * BLOCK_DAYS;
+    int const segment  = std::min(static_cast<int>(t / block.segmentDays), block.segments - 1);
+    double const x     = 2 * (t - segment * block.segmentDays) / block.segmentDays - 1;
+
+    int const n      = block.degree + 1;
+    const double *c  = block.coefficients.constData() + segment * 3 * n;
+    double const px  = chebyshev(c, n, x);
+    double const py  = chebyshev(c + n, n, x);
+    double const pz  = chebyshev(c + 2 * n, n, x);
+    double const rxy = std::sqrt(px * px + py * py);
+
+    state.ra.setRadians(std::atan2(py, px));
+    state.ra.reduceToRange(dms::ZERO_TO_2PI);
+    state.dec.setRadians(std::atan2(pz, rxy));
+    state.rearth = std::sqrt(rxy * rxy + pz * pz);
+    return true;
+}
+
+double EphemerisCache::Ephemeris::maxError() const
+{
+    double error = 0;
+    for (const auto &block : m_Blocks)
+        error = std::max(error, block->maxError);
+    return error;
+}
+
+EphemerisCache *EphemerisCache::Instance()
+{
+    static EphemerisCache cache;
+    return &cache;
+}
+
+QString EphemerisCache::key(const KSPlanetBase *body)
+{
+    if (dynamic_cast<const KSMoon *>(body) != nullptr)
+        return "Moon";
+
+    // Pluto is computed from orbital elements, like the asteroids that are not cached
+    if (dynamic_cast<const KSPluto *>(body) != nullptr)
+        return "Pluto";
+
+    // The Sun is a KSPlanet too
+    const KSPlanet *planet = dynamic_cast<const KSPlanet *>(body);
+    if (planet != nullptr && planet->untranslatedName() != "Earth")
+        return planet->untranslatedName();
+
+    return QString();
+}
+
+bool EphemerisCache::isSupported(const KSPlanetBase *body)
+{
+    return !key(body).isEmpty();
+}
+
+std::shared_ptr<const EphemerisCache::Ephemeris> EphemerisCache::prepare(const KSPlanetBase *body, long double startJD,
+                                                                         long double stopJD)
+{
+    QString const k = key(body);
+    if (k.isEmpty() || stopJD < startJD || stopJD - startJD > MAX_RANGE_DAYS)
+        return nullptr;
+
+    int const first = blockIndex(startJD);
+    int const last  = blockIndex(stopJD);
+
+    QVector<int> missing;
+    {
+        QMutexLocker locker(&m_Mutex);
+        Body &cached = m_Bodies[k];
+        if (!cached.loaded)
+        {
+            load(k, cached);
+            cached.loaded = true;
+        }
+        for (int i = first; i <= last; i++)
+        {
+            if (!cached.blocks.contains(i))
+                missing.append(i);
+        }
+    }
+
+    // Fitted without the lock, so that other bodies and dates remain available meanwhile
+    QHash<int, std::shared_ptr<const Block>> fitted;
+    if (!missing.isEmpty())
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        std::unique_ptr<KSPlanetBase> copy(static_cast<KSPlanetBase *>(body->clone()));
+        copy->clearTrail();
+        copy->loadData();
+
+        for (int index : missing)
+            fitted.insert(index, fit(k, copy.get(), index));
+
+        qCInfo(KSTARS) << QString("Fitted %1 blocks of the ephemeris of %2 in %3 ms.")
+                              .arg(missing.size())
+                              .arg(k)
+                              .arg(timer.elapsed());
+    }
+
+    std::shared_ptr<Ephemeris> ephemeris(new Ephemeris());
+    ephemeris->m_FirstBlock = first;
+    ephemeris->m_Blocks.reserve(last - first + 1);
+
+    QHash<int, std::shared_ptr<const Block>> blocks;
+    {
+        QMutexLocker locker(&m_Mutex);
+        Body &cached = m_Bodies[k];
+        for (auto it = fitted.constBegin(); it != fitted.constEnd(); ++it)
+            cached.blocks.insert(it.key(), it.value());
+        for (int i = first; i <= last; i++)
+            ephemeris->m_Blocks.append(cached.blocks.value(i));
+        if (!fitted.isEmpty())
+            blocks = cached.blocks;
+    }
+
+    if (!fitted.isEmpty())
+        save(k, blocks);
+
+    return ephemeris;
+}
+
+std::shared_ptr<const EphemerisCache::Block> EphemerisCache::fit(const QString &key, KSPlanetBase *body, int index)
+{
+    KSPlanet earth(i18n("Earth"), QString(), QColor("white"), 12756.28 /*diameter in km*/);
+    double const blockStart = J2000 + index * BLOCK_DAYS;
+    KSNumbers num(blockStart);
+
+    double segmentDays;
+    int degree;
+    initialSegments(key, segmentDays, degree);
+
+    while (true)
+    {
+        std::shared_ptr<Block> block(new Block());
+        block->segments    = static_cast<int>(std::lround(BLOCK_DAYS / segmentDays));
+        block->degree      = degree;
+        block->segmentDays = segmentDays;
+
+        // Positions are sampled at the Chebyshev nodes of each segment, the coefficients are then exact sums
+        int const n = degree + 1;
+        QVector<double> nodes(n), cosines(n * n), values(3 * n);
+        for (int j = 0; j < n; j++)
+        {
+            nodes[j] = std::cos(dms::PI * (j + 0.5) / n);
+            for (int k = 0; k < n; k++)
+                cosines[k * n + j] = std::cos(dms::PI * k * (j + 0.5) / n);
+        }
+
+        block->coefficients.resize(block->segments * 3 * n);
+
+        // The heliocentric positions of the Earth at all the nodes of the block are computed at once
+        int const count = block->segments * n;
+        QVector<double> dates(count), millenia(count);
+        QVector<EclipticPosition> earthPositions(count);
+        for (int s = 0; s < block->segments; s++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                num.updateValues(blockStart + segmentDays * (s + 0.5 * (nodes[j] + 1)));
+                dates[s * n + j]    = num.julianDay();
+                millenia[s * n + j] = num.julianMillenia();
+            }
+        }
+        earth.calcEcliptic(millenia.constData(), earthPositions.data(), count);
+
+        for (int s = 0; s < block->segments; s++)
+        {
+            double rmin = std::numeric_limits<double>::max();
+
+            for (int j = 0; j < n; j++)
+            {
+                num.updateValues(dates[s * n + j]);
+                earth.setEclipticPosition(earthPositions[s * n + j]);
+                body->findPosition(&num, nullptr, nullptr, &earth);
+
+                double sinRA, cosRA, sinDec, cosDec;
+                body->ra().SinCos(sinRA, cosRA);
+                body->dec().SinCos(sinDec, cosDec);
+                double const r = body->rearth();
+
+                values[j]         = r * cosDec * cosRA;
+                values[n + j]     = r * cosDec * sinRA;
+                values[2 * n + j] = r * sinDec;
+                rmin              = std::min(rmin, r);
+            }
+
+            double *c    = block->coefficients.data() + s * 3 * n;
+            double tail2 = 0;
+            for (int axis = 0; axis < 3; axis++)
+            {
+                for (int k = 0; k < n; k++)
+                {
+                    double sum = 0;
+                    for (int j = 0; j < n; j++)
+                        sum += values[axis * n + j] * cosines[k * n + j];
+                    c[axis * n + k] = (k == 0 ? 1.0 : 2.0) * sum / n;
+                }
+
+                // The series converge quickly, the last two terms bound the error of the truncated series
+                double const tail = std::fabs(c[axis * n + n - 2]) + std::fabs(c[axis * n + n - 1]);
+                tail2 += tail * tail;
+            }
+
+            block->maxError = std::max(block->maxError, std::sqrt(tail2) / rmin * ARCSEC_PER_RADIAN);
+        }
+
+        if (block->maxError <= MAX_ERROR || segmentDays <= MIN_SEGMENT_DAYS)
+        {
+            if (block->maxError > MAX_ERROR)
+                qCWarning(KSTARS) << "Ephemeris of" << key << "fitted with an error of" << block->maxError
+                                  << "arcseconds in block" << index;
+            return block;
+        }
+
+        segmentDays /= 2;
+    }
+}
+
+QString EphemerisCache::fileName(const QString &key)
+{
+    return KSPaths::writableLocation(QStandardPaths::GenericDataLocation) + "ephemeris/" + key.toLower() + ".cache";
+}
+
+void EphemerisCache::load(const QString &key, Body &body)
+{
+    QFile file(fileName(key));
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version;
+    qint32 count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_VERSION || count < 0)
+    {
+        qCWarning(KSTARS) << "Ignoring outdated ephemeris cache" << file.fileName();
+        return;
+    }
+
+    QHash<int, std::shared_ptr<const Block>> blocks;
+    for (int i = 0; i < count; i++)
+    {
+        qint32 index, segments, degree;
+        std::shared_ptr<Block> block(new Block());
+        in >> index >> segments >> degree >> block->segmentDays >> block->maxError >> block->coefficients;
+
+        if (in.status() != QDataStream::Ok || segments <= 0 || degree <= 0 ||
+            block->coefficients.size() != segments * 3 * (degree + 1))
+        {
+            qCWarning(KSTARS) << "Ignoring corrupted ephemeris cache" << file.fileName();
+            return;
+        }
+
+        block->segments = segments;
+        block->degree   = degree;
+        blocks.insert(index, block);
+    }
+
+    body.blocks = blocks;
+}
+
+void EphemerisCache::save(const QString &key, const QHash<int, std::shared_ptr<const Block>> &blocks)
+{
+    QString const file_name = fileName(key);
+    QDir().mkpath(QFileInfo(file_name).absolutePath());
+
+    // Written to a temporary file first, so that a cache is never left half written
+    QSaveFile file(file_name);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(KSTARS) << "Cannot write ephemeris cache" << file_name << ":" << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << CACHE_MAGIC << CACHE_VERSION << static_cast<qint32>(blocks.size());
+
+    for (auto it = blocks.constBegin(); it != blocks.constEnd(); ++it)
+    {
+        const Block &block = *it.value();
+        out << static_cast<qint32>(it.key()) << static_cast<qint32>(block.segments)
+            << static_cast<qint32>(block.degree) << block.segmentDays << block.maxError << block.coefficients;
+    }
+
+    if (!file.commit())
+        qCWarning(KSTARS) << "Cannot write ephemeris cache" << file_name << ":" << file.errorString();
+}
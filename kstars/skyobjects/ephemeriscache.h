@@ -0,0 +1,148 @@
+/***************************************************************************
+                   ephemeriscache.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : Fri 16 Oct 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include "dms.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+class KSPlanetBase;
+
+/**
+ * @class EphemerisCache
+ *
+ * Chebyshev ephemerides of the Sun, the Moon, the major planets and Pluto.
+ *
+ * The geocentric apparent position of a body, as computed by KSPlanetBase::findPosition() without
+ * figure-of-the-Earth correction, is fitted with piecewise Chebyshev polynomials in equatorial cartesian
+ * coordinates. Time is split in blocks of BLOCK_DAYS days aligned on J2000, and each block in segments of
+ * equal length. A position is then found with a block lookup and the evaluation of three polynomials, whatever
+ * the date, instead of a full evaluation of the theory of the body.
+ *
+ * Blocks are fitted the first time a range of dates covering them is prepared, and saved to disk so that later
+ * sessions reuse them. The error of each segment is estimated from its last coefficients while fitting, and the
+ * segments of a block are halved until the estimate is below MAX_ERROR.
+ *
+ * The cache may be used from any thread. The ephemerides it returns are immutable.
+ */
+class EphemerisCache
+{
+  public:
+    /** Length of a block, in days */
+    static constexpr double BLOCK_DAYS = 256.0;
+    /** Longest range of dates that may be prepared at once, in days */
+    static constexpr double MAX_RANGE_DAYS = 200 * 365.25;
+    /** Error allowed on the fitted positions, in arcseconds */
+    static constexpr double MAX_ERROR = 0.1;
+
+    /** @short Geocentric apparent position of a body */
+    struct State
+    {
+        dms ra;
+        dms dec;
+        /** Distance from Earth, in AU */
+        double rearth { 0 };
+    };
+
+    /** @short Chebyshev fit of the position of a body during a block */
+    struct Block
+    {
+        int segments { 0 };
+        int degree { 0 };
+        double segmentDays { 0 };
+        /** Largest error estimated for a segment, in arcseconds */
+        double maxError { 0 };
+        /** degree + 1 coefficients of x, then of y and z, for each segment in turn */
+        QVector<double> coefficients;
+    };
+
+    /**
+     * @class Ephemeris
+     * Ephemeris of a body over a range of dates, as returned by EphemerisCache::prepare().
+     */
+    class Ephemeris
+    {
+      public:
+        /** @return true if the ephemeris covers a date */
+        bool contains(long double jd) const;
+
+        /**
+         * @brief state Position of the body at a date.
+         * @return false if the date is not covered, state is then unchanged
+         */
+        bool state(long double jd, State &state) const;
+
+        /** @return the largest error estimated for the ephemeris, in arcseconds */
+        double maxError() const;
+
+      private:
+        friend class EphemerisCache;
+
+        int m_FirstBlock { 0 };
+        QVector<std::shared_ptr<const Block>> m_Blocks;
+    };
+
+    static EphemerisCache *Instance();
+
+    /**
+     * @return true if the positions of a body can be cached, i.e. if it is the Sun, the Moon, a major planet or
+     * Pluto
+     */
+    static bool isSupported(const KSPlanetBase *body);
+
+    /**
+     * @brief prepare Ephemeris of a body over a range of dates. The blocks covering the range are loaded from the
+     * cache, or fitted.
+     * @param body body, not modified
+     * @param startJD start of the range, as a Julian Day
+     * @param stopJD end of the range, as a Julian Day
+     * @return the ephemeris, or nullptr if the body is not supported or the range is longer than MAX_RANGE_DAYS
+     */
+    std::shared_ptr<const Ephemeris> prepare(const KSPlanetBase *body, long double startJD, long double stopJD);
+
+  private:
+#ifdef UNIT_TEST
+    friend class TestEphemerisCache;
+#endif
+
+    struct Body
+    {
+        bool loaded { false };
+        QHash<int, std::shared_ptr<const Block>> blocks;
+    };
+
+    EphemerisCache() = default;
+
+    /** @return key of a body, its untranslated name, or an empty string if the body is not supported */
+    static QString key(const KSPlanetBase *body);
+
+    /** Fit a block of the ephemeris of a body, which must be a copy private to the caller */
+    static std::shared_ptr<const Block> fit(const QString &key, KSPlanetBase *body, int index);
+
+    /** Load the blocks of a body saved by save(). Called with m_Mutex locked. */
+    static void load(const QString &key, Body &body);
+    static void save(const QString &key, const QHash<int, std::shared_ptr<const Block>> &blocks);
+
+    static QString fileName(const QString &key);
+
+    QMutex m_Mutex;
+    QHash<QString, Body> m_Bodies;
+};
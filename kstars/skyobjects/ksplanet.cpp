@@ -21,19 +21,177 @@
 #include "ksutils.h"
 #include "ksfilereader.h"
 
+#include <QMutexLocker>
+
+#include <algorithm>
 #include <cmath>
 #include <typeinfo>
 
 #include "kstars_debug.h"
 
+namespace
+{
+// 2*PI split in a part with 33 significant bits and the rest, so that k*TWO_PI_HI is exact in the reduction
+const double TWO_PI_HI  = 6.2831853069365025;
+const double TWO_PI_LO  = 2.430840202602477e-10;
+const double INV_TWO_PI = 0.15915494309189535;
+// Adding then subtracting 1.5*2^52 rounds a double of magnitude below 2^51 to the nearest integer
+const double ROUND_SHIFT = 0x1.8p52;
+
+/**
+ * Cosine without branches nor calls to the math library, so that loops over terms are vectorized.
+ * The argument is reduced to [-PI, PI], then to [0, PI/2] by symmetry, where the Taylor series up to
+ * the 20th power is accurate to a few 1e-16, like cos().
+ * @note The rounding trick needs strict IEEE arithmetic, it does not survive -ffast-math.
+ */
+inline double termCosine(double x)
+{
+    double const t = x * INV_TWO_PI + ROUND_SHIFT;
+    double const k = t - ROUND_SHIFT;
+    double y       = std::fabs((x - k * TWO_PI_HI) - k * TWO_PI_LO);
+    // cos(y) = -cos(PI - y) above PI/2, written with fabs() and copysign() as GCC turns ?: into branches
+    double const s = std::copysign(1.0, dms::PI / 2 - y);
+    y              = dms::PI / 2 - std::fabs(dms::PI / 2 - y);
+
+    double const z = y * y;
+    double p       = 1.0 / 2432902008176640000.0;
+    p              = p * z - 1.0 / 6402373705728000.0;
+    p              = p * z + 1.0 / 20922789888000.0;
+    p              = p * z - 1.0 / 87178291200.0;
+    p              = p * z + 1.0 / 479001600.0;
+    p              = p * z - 1.0 / 3628800.0;
+    p              = p * z + 1.0 / 40320.0;
+    p              = p * z - 1.0 / 720.0;
+    p              = p * z + 1.0 / 24.0;
+    p              = p * z - 1.0 / 2.0;
+    p              = p * z + 1.0;
+
+    return s * p;
+}
+
+// Terms are evaluated by blocks, the cosines of a block being computed before they are summed
+const int BLOCK_SIZE = 64;
+}
+
 KSPlanet::OrbitDataManager KSPlanet::odm;
 
+double KSPlanet::OrbitSeries::evaluate(double Tau) const
+{
+    const double *a = A.constData(), *b = B.constData(), *c = C.constData();
+    int const n     = A.size();
+    double cosines[BLOCK_SIZE];
+    double sums[4] = { 0, 0, 0, 0 };
+
+    for (int first = 0; first < n; first += BLOCK_SIZE)
+    {
+        int const m = std::min(BLOCK_SIZE, n - first);
+
+        for (int j = 0; j < m; ++j)
+            cosines[j] = termCosine(b[first + j] + c[first + j] * Tau);
+
+        // Independent partial sums, so that additions are not serialized
+        int j = 0;
+        for (; j + 4 <= m; j += 4)
+        {
+            sums[0] += a[first + j] * cosines[j];
+            sums[1] += a[first + j + 1] * cosines[j + 1];
+            sums[2] += a[first + j + 2] * cosines[j + 2];
+            sums[3] += a[first + j + 3] * cosines[j + 3];
+        }
+        for (; j < m; ++j)
+            sums[0] += a[first + j] * cosines[j];
+    }
+
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+void KSPlanet::OrbitSeries::evaluate(const double *Tau, double *sums, int count) const
+{
+    const double *a = A.constData(), *b = B.constData(), *c = C.constData();
+
+    // Each term is loaded once, and evaluated at all times by a vectorized loop
+    for (int j = 0; j < A.size(); ++j)
+    {
+        double const aj = a[j], bj = b[j], cj = c[j];
+
+        for (int t = 0; t < count; ++t)
+            sums[t] += aj * termCosine(bj + cj * Tau[t]);
+    }
+}
+
+void KSPlanet::OrbitDataColl::calcEcliptic(double Tau, EclipticPosition &ret) const
+{
+    // Computes the meta-sum of six series, the ith series being multiplied by Tau^i
+    auto metaSum = [Tau](const OBArray &series)
+    {
+        double total = 0.0, Tpow = 1.0;
+        for (int i = 0; i < 6; ++i)
+        {
+            total += series[i].evaluate(Tau) * Tpow;
+            Tpow *= Tau;
+        }
+        return total;
+    };
+
+    //Ecliptic Longitude
+    ret.longitude.setRadians(metaSum(Lon));
+    ret.longitude.setD(ret.longitude.reduce().Degrees());
+
+    //Compute Ecliptic Latitude
+    ret.latitude.setRadians(metaSum(Lat));
+
+    //Compute Heliocentric Distance
+    ret.radius = metaSum(Dst);
+}
+
+void KSPlanet::OrbitDataColl::calcEcliptic(const double *Tau, EclipticPosition *ret, int count) const
+{
+    QVector<double> Tpow(count), sum(count), total(count);
+
+    // Computes the meta-sum of six series, the ith series being multiplied by Tau^i
+    auto metaSum = [&](const OBArray &series)
+    {
+        std::fill(total.begin(), total.end(), 0.0);
+        std::fill(Tpow.begin(), Tpow.end(), 1.0);
+
+        for (int i = 0; i < 6; ++i)
+        {
+            std::fill(sum.begin(), sum.end(), 0.0);
+            series[i].evaluate(Tau, sum.data(), count);
+
+            for (int t = 0; t < count; ++t)
+            {
+                total[t] += sum[t] * Tpow[t];
+                Tpow[t] *= Tau[t];
+            }
+        }
+    };
+
+    //Ecliptic Longitude
+    metaSum(Lon);
+    for (int t = 0; t < count; ++t)
+    {
+        ret[t].longitude.setRadians(total[t]);
+        ret[t].longitude.setD(ret[t].longitude.reduce().Degrees());
+    }
+
+    //Compute Ecliptic Latitude
+    metaSum(Lat);
+    for (int t = 0; t < count; ++t)
+        ret[t].latitude.setRadians(total[t]);
+
+    //Compute Heliocentric Distance
+    metaSum(Dst);
+    for (int t = 0; t < count; ++t)
+        ret[t].radius = total[t];
+}
+
 KSPlanet::OrbitDataManager::OrbitDataManager()
 {
     //EMPTY
 }
 
-bool KSPlanet::OrbitDataManager::readOrbitData(const QString &fname, QVector<OrbitData> *vector)
+bool KSPlanet::OrbitDataManager::readOrbitData(const QString &fname, OrbitSeries *vector)
 {
     QFile f;
 
@@ -50,7 +208,7 @@ bool KSPlanet::OrbitDataManager::readOrbitData(const QString &fname, QVector<Orb
                 double A = fields[0].toDouble();
                 double B = fields[1].toDouble();
                 double C = fields[2].toDouble();
-                vector->append(OrbitData(A, B, C));
+                vector->append(A, B, C);
             }
         }
     }
@@ -61,18 +219,19 @@ bool KSPlanet::OrbitDataManager::readOrbitData(const QString &fname, QVector<Orb
     return true;
 }
 
-bool KSPlanet::OrbitDataManager::loadData(KSPlanet::OrbitDataColl &odc, const QString &n)
+const KSPlanet::OrbitDataColl *KSPlanet::OrbitDataManager::loadData(const QString &n)
 {
     QString fname, snum;
     QFile f;
     int nCount = 0;
     QString nl = n.toLower();
 
-    if (hash.contains(nl))
-    {
-        odc = hash[nl];
-        return true; //orbit data already loaded
-    }
+    // Planets are created by several threads at startup
+    QMutexLocker locker(&mutex);
+
+    auto it = hash.constFind(nl);
+    if (it != hash.constEnd())
+        return &it.value(); //orbit data already loaded
 
     //Create a new OrbitDataColl
     OrbitDataColl ret;
@@ -87,7 +246,7 @@ bool KSPlanet::OrbitDataManager::loadData(KSPlanet::OrbitDataColl &odc, const QS
     }
 
     if (nCount == 0)
-        return false;
+        return nullptr;
 
     //Ecliptic Latitude
     for (int i = 0; i < 6; ++i)
@@ -99,7 +258,7 @@ bool KSPlanet::OrbitDataManager::loadData(KSPlanet::OrbitDataColl &odc, const QS
     }
 
     if (nCount == 0)
-        return false;
+        return nullptr;
 
     //Heliocentric Distance
     for (int i = 0; i < 6; ++i)
@@ -111,12 +270,10 @@ bool KSPlanet::OrbitDataManager::loadData(KSPlanet::OrbitDataColl &odc, const QS
     }
 
     if (nCount == 0)
-        return false;
-
-    hash[nl] = ret;
-    odc      = hash[nl];
+        return nullptr;
 
-    return true;
+    // Values of a QHash are not moved by later insertions, so the pointer stays valid
+    return &hash.insert(nl, ret).value();
 }
 
 KSPlanet::KSPlanet(const QString &s, const QString &imfile, const QColor &c, double pSize)
@@ -190,26 +347,23 @@ QString KSPlanet::untranslatedName() const
         return name();
 }
 
-//we don't need the reference to the ODC, so just give it a junk variable
 bool KSPlanet::loadData()
 {
-    OrbitDataColl odc;
-    return odm.loadData(odc, untranslatedName());
+    return orbitData() != nullptr;
 }
 
-void KSPlanet::calcEcliptic(double Tau, EclipticPosition &epret) const
+const KSPlanet::OrbitDataColl *KSPlanet::orbitData() const
 {
-    double sum[6];
-    OrbitDataColl odc;
-    double Tpow[6];
+    if (m_OrbitData == nullptr)
+        m_OrbitData = odm.loadData(untranslatedName());
+    return m_OrbitData;
+}
 
-    Tpow[0] = 1.0;
-    for (int i = 1; i < 6; ++i)
-    {
-        Tpow[i] = Tpow[i - 1] * Tau;
-    }
+void KSPlanet::calcEcliptic(double Tau, EclipticPosition &epret) const
+{
+    const OrbitDataColl *odc = orbitData();
 
-    if (!odm.loadData(odc, untranslatedName()))
+    if (odc == nullptr)
     {
         epret.longitude = dms(0.0);
         epret.latitude  = dms(0.0);
@@ -218,56 +372,32 @@ void KSPlanet::calcEcliptic(double Tau, EclipticPosition &epret) const
         return;
     }
 
-    //Ecliptic Longitude
-    for (int i = 0; i < 6; ++i)
-    {
-        sum[i] = 0.0;
-        for (int j = 0; j < odc.Lon[i].size(); ++j)
-        {
-            sum[i] += odc.Lon[i][j].A * cos(odc.Lon[i][j].B + odc.Lon[i][j].C * Tau);
-            /*
-            qDebug() << "sum[" << i <<"] =" << sum[i] <<
-                " A = " << odc.Lon[i][j].A << " B = " << odc.Lon[i][j].B <<
-                " C = " << odc.Lon[i][j].C;
-                */
-        }
-        sum[i] *= Tpow[i];
-        //qDebug() << name() << " : sum[" << i << "] = " << sum[i];
-    }
-
-    epret.longitude.setRadians(sum[0] + sum[1] + sum[2] + sum[3] + sum[4] + sum[5]);
-    epret.longitude.setD(epret.longitude.reduce().Degrees());
-
-    //Compute Ecliptic Latitude
-    for (uint i = 0; i < 6; ++i)
-    {
-        sum[i] = 0.0;
-        for (int j = 0; j < odc.Lat[i].size(); ++j)
-        {
-            sum[i] += odc.Lat[i][j].A * cos(odc.Lat[i][j].B + odc.Lat[i][j].C * Tau);
-        }
-        sum[i] *= Tpow[i];
-    }
+    odc->calcEcliptic(Tau, epret);
+}
 
-    epret.latitude.setRadians(sum[0] + sum[1] + sum[2] + sum[3] + sum[4] + sum[5]);
+void KSPlanet::calcEcliptic(const double *Tau, EclipticPosition *epret, int count) const
+{
+    const OrbitDataColl *odc = orbitData();
 
-    //Compute Heliocentric Distance
-    for (uint i = 0; i < 6; ++i)
+    if (odc == nullptr)
     {
-        sum[i] = 0.0;
-        for (int j = 0; j < odc.Dst[i].size(); ++j)
+        for (int t = 0; t < count; ++t)
         {
-            sum[i] += odc.Dst[i][j].A * cos(odc.Dst[i][j].B + odc.Dst[i][j].C * Tau);
+            epret[t].longitude = dms(0.0);
+            epret[t].latitude  = dms(0.0);
+            epret[t].radius    = 0.0;
         }
-        sum[i] *= Tpow[i];
+        qCWarning(KSTARS) << "Could not get data for name:" << name() << "(" << untranslatedName() << ")";
+        return;
     }
 
-    epret.radius = sum[0] + sum[1] + sum[2] + sum[3] + sum[4] + sum[5];
+    odc->calcEcliptic(Tau, epret, count);
+}
 
-    /*
-    qDebug() << name() << " pre: Lat = " << epret.latitude.toDMSString() << " Long = " <<
-        epret.longitude.toDMSString() << " Dist = " << epret.radius;
-    */
+void KSPlanet::setEclipticPosition(const EclipticPosition &position)
+{
+    ep       = position;
+    helEcPos = position;
 }
 
 bool KSPlanet::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *Earth)
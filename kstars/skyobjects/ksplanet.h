@@ -20,6 +20,7 @@
 #include "ksplanetbase.h"
 
 #include <QHash>
+#include <QMutex>
 #include <QString>
 #include <QVector>
 
@@ -84,6 +85,22 @@ class KSPlanet : public KSPlanetBase
      */
     virtual void calcEcliptic(double jm, EclipticPosition &ret) const;
 
+    /**
+     * Calculate the heliocentric ecliptic coordinates of the planet at several dates at once,
+     * which is faster than one date at a time when computing positions over a range of dates.
+     * @param jm dates, in Julian Millenia
+     * @param ret the ecliptic coordinates at each date are returned through this array
+     * @param count number of dates
+     */
+    void calcEcliptic(const double *jm, EclipticPosition *ret, int count) const;
+
+    /**
+     * Set the heliocentric ecliptic coordinates of the planet, as computed by calcEcliptic(), without
+     * computing the rest of its position. This is all the Earth passed to KSPlanetBase::findPosition()
+     * of another body needs.
+     */
+    void setEclipticPosition(const EclipticPosition &position);
+
   protected:
     /**
      * Calculate the geocentric RA, Dec coordinates of the Planet.
@@ -95,36 +112,47 @@ class KSPlanet : public KSPlanetBase
     bool findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *Earth = nullptr) override;
 
     /**
-     * @class OrbitData
-     * This class contains doubles A,B,C which represent a single term in a planet's
-     * positional expansion sums (each sum-term is A*COS(B+C*T)).
+     * @class OrbitSeries
+     * This class contains the terms of a single sum used in computing a planet's
+     * position (each sum-term is A*COS(B+C*T)).
      *
-     * @author Mark Hollomon
-     * @version 1.0
+     * The A, B and C values of the terms are stored in three contiguous arrays, so that the
+     * cosines of many terms, or of one term at many times, are computed by vectorized loops.
      */
-    class OrbitData
+    class OrbitSeries
     {
       public:
-        /** Default constructor */
-        OrbitData() : A(0.), B(0.), C(0.) {}
+        /** Append the term A*COS(B+C*T) */
+        void append(double a, double b, double c)
+        {
+            A.append(a);
+            B.append(b);
+            C.append(c);
+        }
+
+        int size() const { return A.size(); }
+
+        /** @return the sum of the terms at time Tau, in Julian millenia */
+        double evaluate(double Tau) const;
+
         /**
-         * Constructor
-         * @param a the A value
-         * @param b the B value
-         * @param c the C value
+         * Add the sums of the terms at several times to an array.
+         * @param Tau times, in Julian millenia
+         * @param sums sums of the terms at each time are added to this array
+         * @param count number of times
          */
-        OrbitData(double a, double b, double c) : A(a), B(b), C(c) {}
+        void evaluate(const double *Tau, double *sums, int count) const;
 
-        double A, B, C;
+        QVector<double> A, B, C;
     };
 
-    typedef QVector<OrbitData> OBArray[6];
+    typedef OrbitSeries OBArray[6];
 
     /**
-     * OrbitDataColl contains three groups of six QVectors.  Each QVector is a
-     * list of OrbitData objects, representing a single sum used in computing
-     * the planet's position.  A set of six of these vectors comprises the large
-     * "meta-sum" which yields the planet's Longitude, Latitude, or Distance value.
+     * OrbitDataColl contains three groups of six series. Each series is a
+     * sum used in computing the planet's position. A set of six of these series
+     * comprises the large "meta-sum" which yields the planet's Longitude, Latitude,
+     * or Distance value.
      *
      * @author Mark Hollomon
      * @version 1.0
@@ -135,6 +163,21 @@ class KSPlanet : public KSPlanetBase
         /** Constructor */
         OrbitDataColl() = default;
 
+        /**
+         * Compute the ecliptic coordinates at one time.
+         * @param Tau time, in Julian millenia
+         * @param ret the ecliptic coordinates are returned by reference through this argument.
+         */
+        void calcEcliptic(double Tau, EclipticPosition &ret) const;
+
+        /**
+         * Compute the ecliptic coordinates at several times.
+         * @param Tau times, in Julian millenia
+         * @param ret the ecliptic coordinates at each time are returned through this array
+         * @param count number of times
+         */
+        void calcEcliptic(const double *Tau, EclipticPosition *ret, int count) const;
+
         OBArray Lon;
         OBArray Lat;
         OBArray Dst;
@@ -154,33 +197,41 @@ class KSPlanet : public KSPlanetBase
         OrbitDataManager();
 
         /**
-         * Load orbital data for a planet from disk.
-       	 * The data is stored on disk in a series of files named
+         * Load orbital data for a planet from disk, if not done already.
+         * The data is stored on disk in a series of files named
          * "name.[LBR][0...5].vsop", where "L"=Longitude data, "B"=Latitude data,
          * and R=Radius data.
          * @param n the name of the planet whose data is to be loaded from disk.
-         * @param odc reference to the OrbitDataColl containing the planet's orbital data.
-         * @return true if data successfully loaded
+         * @return the planet's orbital data, which stays valid for the lifetime of the program, or
+         * nullptr if it could not be loaded.
          */
-        bool loadData(OrbitDataColl &odc, const QString &n);
+        const OrbitDataColl *loadData(const QString &n);
 
       private:
         /**
-         * Read a single orbital data file from disk into an OrbitData vector.
+         * Read a single orbital data file from disk into an OrbitSeries.
          * The data files are named "name.[LBR][0...5].vsop", where
          * "L"=Longitude data, "B"=Latitude data, and R=Radius data.
          * @param fname the filename to be read.
-         * @param vector pointer to the OrbitData vector to be filled with these data.
+         * @param vector pointer to the OrbitSeries to be filled with these data.
          */
-        bool readOrbitData(const QString &fname, QVector<KSPlanet::OrbitData> *vector);
+        bool readOrbitData(const QString &fname, OrbitSeries *vector);
 
+        QMutex mutex;
         QHash<QString, OrbitDataColl> hash;
     };
 
+    /** @return the orbital data of the planet, loaded on first use, or nullptr if it could not be loaded */
+    const OrbitDataColl *orbitData() const;
+
   private:
     void findMagnitude(const KSNumbers *) override;
 
   protected:
     bool data_loaded { false };
     static OrbitDataManager odm;
+
+  private:
+    /** Orbital data of the planet, cached to avoid a lookup by name for each position */
+    mutable const OrbitDataColl *m_OrbitData { nullptr };
 };
@@ -152,6 +152,27 @@ void KSPlanetBase::findPosition(const KSNumbers *num, const CachingDms *lat, con
     }
 }
 
+bool KSPlanetBase::findCachedPosition(const EphemerisCache::Ephemeris &ephemeris, const KSNumbers *num,
+                                      const CachingDms *lat, const CachingDms *LST)
+{
+    EphemerisCache::State state;
+    if (!ephemeris.state(num->julianDay(), state))
+        return false;
+
+    lastPrecessJD = num->julianDay();
+
+    setRA(state.ra);
+    setDec(state.dec);
+    Rearth = state.rearth;
+    EquatorialToEcliptic(num->obliquity());
+    setAngularSize(findAngularSize());
+
+    if (lat && LST)
+        localizeCoords(num, lat, LST);
+
+    return true;
+}
+
 bool KSPlanetBase::isMajorPlanet() const
 {
     if (name() == i18n("Mercury") || name() == i18n("Venus") || name() == i18n("Mars") || name() == i18n("Jupiter") ||
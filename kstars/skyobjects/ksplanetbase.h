@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "ephemeriscache.h"
 #include "trailobject.h"
 #include "kstarsdata.h"
 
@@ -182,6 +183,20 @@ class KSPlanetBase : public TrailObject
     void findPosition(const KSNumbers *num, const CachingDms *lat = nullptr, const CachingDms *LST = nullptr,
                       const KSPlanetBase *Earth = nullptr);
 
+    /**
+     * @short Find position from an ephemeris of the body, instead of its theory.
+     * The geocentric equatorial and ecliptic coordinates, the distance from Earth and the angular size are
+     * set, then corrected for figure-of-the-Earth as in findPosition(). The phase, magnitude and heliocentric
+     * coordinates are left unchanged, and no point is added to the trail.
+     * @param ephemeris ephemeris of this body, as prepared by EphemerisCache
+     * @param num KSNumbers pointer for the target date/time
+     * @param lat pointer to the geographic latitude; if nullptr, we skip localizeCoords()
+     * @param LST pointer to the local sidereal time; if nullptr, we skip localizeCoords()
+     * @return false if the ephemeris does not cover the date, the position is then unchanged
+     */
+    bool findCachedPosition(const EphemerisCache::Ephemeris &ephemeris, const KSNumbers *num,
+                            const CachingDms *lat = nullptr, const CachingDms *LST = nullptr);
+
     /** @return the Planet's position angle. */
     double pa() const override { return PositionAngle; }
 
@@ -17,18 +17,19 @@
 
 #include "satellite.h"
 
+#include "geolocation.h"
 #include "ksplanetbase.h"
 #ifndef KSTARS_LITE
 #include "kspopupmenu.h"
 #endif
 #include "kstarsdata.h"
-#include "kssun.h"
 #include "Options.h"
-#include "skymapcomposite.h"
 
 #include <QDebug>
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
 #include <typeinfo>
 
 // Define some constants
@@ -713,16 +714,191 @@ void Satellite::init()
     }
 }
 
+Satellite::Observer Satellite::observer(GeoLocation *geo, double jd)
+{
+    Observer o;
+    o.jd  = jd;
+    o.lat = *geo->lat();
+    o.lat.SinCos(o.sinLat, o.cosLat);
+    o.theta = geo->LMST(jd);
+    o.LST.setRadians(o.theta);
+
+    // Find ECI coordinates of the sun
+    double mjd, year, T, M, L, e, C, O, Lsa, nu, R, eps;
+
+    mjd  = jd - 2415020.0;
+    year = 1900.0 + mjd / 365.25;
+    T    = (mjd + deltaET(year) / (MINPD * 60.0)) / 36525.0;
+    M    = DEG2RAD * (Modulus(358.47583 + Modulus(35999.04975 * T, 360.0) - (0.000150 + 0.0000033 * T) * T * T, 360.0));
+    L    = DEG2RAD * (Modulus(279.69668 + Modulus(36000.76892 * T, 360.0) + 0.0003025 * T * T, 360.0));
+    e    = 0.01675104 - (0.0000418 + 0.000000126 * T) * T;
+    C    = DEG2RAD * ((1.919460 - (0.004789 + 0.000014 * T) * T) * sin(M) + (0.020094 - 0.000100 * T) * sin(2 * M) +
+                      0.000293 * sin(3 * M));
+    O    = DEG2RAD * (Modulus(259.18 - 1934.142 * T, 360.0));
+    Lsa  = Modulus(L + C - DEG2RAD * (0.00569 - 0.00479 * sin(O)), TWOPI);
+    nu   = Modulus(M + C, TWOPI);
+    R    = 1.0000002 * (1.0 - e * e) / (1.0 + e * cos(nu));
+    eps  = DEG2RAD * (23.452294 - (0.0130125 + (0.00000164 - 0.000000503 * T) * T) * T + 0.00256 * cos(O));
+    R    = AU * R;
+
+    o.sunX = R * cos(Lsa);
+    o.sunY = R * sin(Lsa) * cos(eps);
+    o.sunZ = R * sin(Lsa) * sin(eps);
+    o.sunW = R;
+
+    // Altitude of the Sun, the parallax of the observer is negligible
+    double const sintheta = sin(o.theta), costheta = cos(o.theta);
+    double const sun_z    = o.cosLat * costheta * o.sunX + o.cosLat * sintheta * o.sunY + o.sinLat * o.sunZ;
+    o.sunAltitude         = arcSin(sun_z / o.sunW) / DEG2RAD;
+
+    return o;
+}
+
 int Satellite::updatePos()
 {
     KStarsData *data = KStarsData::Instance();
-    return sgp4((data->clock()->utc().djd() - m_tle_jd) * MINPD);
+
+    Observer o = observer(data->geo(), data->clock()->utc().djd());
+    o.LST      = *data->lst();
+    return updatePos(o);
 }
 
-int Satellite::sgp4(double tsince)
+int Satellite::updatePos(const Observer &observer)
 {
-    KStarsData *data = KStarsData::Instance();
+    Position p;
+    return updatePos(observer, p);
+}
+
+int Satellite::updatePos(const Observer &observer, Position &p)
+{
+    int rc = position(observer, p);
+    if (rc != 0)
+        return rc;
+
+    m_velocity = p.velocity;
+    m_altitude = p.altitude;
+    m_range    = p.range;
+
+    setAz(p.azimuth);
+    setAlt(p.elevation);
+    HorizontalToEquatorial(&observer.LST, &observer.lat);
+
+    m_is_eclipsed = p.eclipsed;
+    m_is_visible  = !m_is_eclipsed && observer.sunAltitude <= -12.0 && p.elevation >= 0.0;
+
+    return 0;
+}
+
+int Satellite::position(const Observer &observer, Position &position)
+{
+    return sgp4((observer.jd - m_tle_jd) * MINPD, observer, position);
+}
 
+QVector<Satellite::Pass> Satellite::findPasses(const QVector<Observer> &samples, GeoLocation *geo,
+                                                double minElevation) const
+{
+    QVector<Pass> passes;
+
+    // Propagating updates the state of the deep space integrator, work on a copy
+    std::unique_ptr<Satellite> copy(clone());
+
+    auto elevationAt = [&](double jd)
+    {
+        Position p;
+        if (copy->position(observer(geo, jd), p) != 0)
+            return -90.0;
+        return p.elevation;
+    };
+
+    // Bisection of a crossing of minElevation between two dates, to about a second
+    auto crossing = [&](double before, double after)
+    {
+        bool const rising = elevationAt(before) < minElevation;
+        while (after - before > 1.0 / (MINPD * 60))
+        {
+            double const middle = 0.5 * (before + after);
+            if ((elevationAt(middle) < minElevation) == rising)
+                before = middle;
+            else
+                after = middle;
+        }
+        return 0.5 * (before + after);
+    };
+
+    Pass pass;
+    bool up        = false;
+    double step    = 0;
+    double previous = 0;
+
+    for (const Observer &o : samples)
+    {
+        Position p;
+        if (copy->position(o, p) != 0)
+            break;
+
+        if (step == 0 && previous != 0)
+            step = o.jd - previous;
+
+        bool const above = p.elevation >= minElevation;
+
+        if (above && !up)
+        {
+            pass               = Pass();
+            pass.satellite     = const_cast<Satellite *>(this);
+            pass.riseJD        = (previous == 0) ? o.jd : crossing(previous, o.jd);
+            pass.maxElevation  = p.elevation;
+            pass.culminationJD = o.jd;
+            up                 = true;
+        }
+
+        if (above)
+        {
+            if (p.elevation > pass.maxElevation)
+            {
+                pass.maxElevation  = p.elevation;
+                pass.culminationJD = o.jd;
+            }
+            if (!p.eclipsed && o.sunAltitude <= -12.0)
+                pass.visible = true;
+        }
+        else if (up)
+        {
+            pass.setJD = crossing(previous, o.jd);
+            passes.append(pass);
+            up = false;
+        }
+
+        previous = o.jd;
+    }
+
+    if (up)
+    {
+        pass.setJD = previous;
+        passes.append(pass);
+    }
+
+    // Refine the culminations, by ternary search around the highest sample
+    for (Pass &found : passes)
+    {
+        double low  = std::max(found.riseJD, found.culminationJD - step);
+        double high = std::min(found.setJD, found.culminationJD + step);
+        while (high - low > 1.0 / (MINPD * 60))
+        {
+            double const a = low + (high - low) / 3, b = high - (high - low) / 3;
+            if (elevationAt(a) < elevationAt(b))
+                low = a;
+            else
+                high = b;
+        }
+        found.culminationJD = 0.5 * (low + high);
+        found.maxElevation  = std::max(found.maxElevation, elevationAt(found.culminationJD));
+    }
+
+    return passes;
+}
+
+int Satellite::sgp4(double tsince, const Observer &observer, Position &position)
+{
     int ktr;
     double am, axnl, aynl, betal, cosim, cnod, cos2u, coseo1 = 0, cosi, cosip, cosisq, cossu, cosu, delm, delomg, em,
                                                       ecose, el2, eo1, ep, esine, argpm, argpp, argpdf, pl,
@@ -735,8 +911,6 @@ int Satellite::sgp4(double tsince)
 
     const double temp4 = 1.5e-12;
 
-    double jul_utc = data->clock()->utc().djd();
-
     vkmpersec = RADIUSEARTHKM * XKE / 60.0;
 
     // Update for secular gravity and atmospheric drag
@@ -1129,7 +1303,7 @@ int Satellite::sgp4(double tsince)
     sat_velx   = (mvt * ux + rvdot * vx) * vkmpersec;
     sat_vely   = (mvt * uy + rvdot * vy) * vkmpersec;
     sat_velz   = (mvt * uz + rvdot * vz) * vkmpersec;
-    m_velocity = sqrt(sat_velx * sat_velx + sat_vely * sat_vely + sat_velz * sat_velz);
+    position.velocity = sqrt(sat_velx * sat_velx + sat_vely * sat_vely + sat_velz * sat_velz);
 
     //     printf("tsince=%.15f\n", tsince);
     //     printf("sat_posx=%.15f\n", sat_posx);
@@ -1146,9 +1320,9 @@ int Satellite::sgp4(double tsince)
     }
 
     // Observer ECI position and velocity
-    sinlat   = sin(data->geo()->lat()->radians());
-    coslat   = cos(data->geo()->lat()->radians());
-    thetageo = data->geo()->LMST(jul_utc);
+    sinlat   = observer.sinLat;
+    coslat   = observer.cosLat;
+    thetageo = observer.theta;
     sintheta = sin(thetageo);
     costheta = cos(thetageo);
     c        = 1.0 / sqrt(1.0 + F * (F - 2.0) * sinlat * sinlat);
@@ -1162,13 +1336,13 @@ int Satellite::sgp4(double tsince)
     obs_vely = MFACTOR * obs_posx;
     obs_velz = 0.;*/
 
-    m_altitude = sat_posw - obs_posw + MEANALT;
+    position.altitude = sat_posw - obs_posw + MEANALT;
 
     // Az and Dec
     double range_posx = sat_posx - obs_posx;
     double range_posy = sat_posy - obs_posy;
     double range_posz = sat_posz - obs_posz;
-    m_range           = sqrt(range_posx * range_posx + range_posy * range_posy + range_posz * range_posz);
+    position.range    = sqrt(range_posx * range_posx + range_posy * range_posy + range_posz * range_posz);
     //     double range_velx = sat_velx - obs_velx;
     //     double range_vely = sat_velx - obs_vely;
     //     double range_velz = sat_velx - obs_velz;
@@ -1182,59 +1356,34 @@ int Satellite::sgp4(double tsince)
         azimuth += M_PI;
     if (azimuth < 0.)
         azimuth += TWOPI;
-    double elevation = arcSin(top_z / m_range);
+    double elevation = arcSin(top_z / position.range);
 
     //     printf("azimuth=%.15f\n\r", azimuth / DEG2RAD);
     //     printf("elevation=%.15f\n\r", elevation / DEG2RAD);
 
-    setAz(azimuth / DEG2RAD);
-    setAlt(elevation / DEG2RAD);
-    HorizontalToEquatorial(data->lst(), data->geo()->lat());
+    position.azimuth   = azimuth / DEG2RAD;
+    position.elevation = elevation / DEG2RAD;
 
     // is the satellite visible ?
-    // Find ECI coordinates of the sun
-    double mjd, year, T, M, L, e, C, O, Lsa, nu, R, eps;
-
-    mjd  = jul_utc - 2415020.0;
-    year = 1900.0 + mjd / 365.25;
-    T    = (mjd + deltaET(year) / (MINPD * 60.0)) / 36525.0;
-    M    = DEG2RAD * (Modulus(358.47583 + Modulus(35999.04975 * T, 360.0) - (0.000150 + 0.0000033 * T) * T * T, 360.0));
-    L    = DEG2RAD * (Modulus(279.69668 + Modulus(36000.76892 * T, 360.0) + 0.0003025 * T * T, 360.0));
-    e    = 0.01675104 - (0.0000418 + 0.000000126 * T) * T;
-    C    = DEG2RAD * ((1.919460 - (0.004789 + 0.000014 * T) * T) * sin(M) + (0.020094 - 0.000100 * T) * sin(2 * M) +
-                      0.000293 * sin(3 * M));
-    O    = DEG2RAD * (Modulus(259.18 - 1934.142 * T, 360.0));
-    Lsa  = Modulus(L + C - DEG2RAD * (0.00569 - 0.00479 * sin(O)), TWOPI);
-    nu   = Modulus(M + C, TWOPI);
-    R    = 1.0000002 * (1.0 - e * e) / (1.0 + e * cos(nu));
-    eps  = DEG2RAD * (23.452294 - (0.0130125 + (0.00000164 - 0.000000503 * T) * T) * T + 0.00256 * cos(O));
-    R    = AU * R;
-
-    double sun_posx = R * cos(Lsa);
-    double sun_posy = R * sin(Lsa) * cos(eps);
-    double sun_posz = R * sin(Lsa) * sin(eps);
-    double sun_posw = R;
-
     // Calculates satellite's eclipse status and depth
     double sd_sun, sd_earth, delta, depth;
 
     // Determine partial eclipse
     sd_earth       = arcSin(RADIUSEARTHKM / sat_posw);
-    double rho_x   = sun_posx - sat_posx;
-    double rho_y   = sun_posy - sat_posy;
-    double rho_z   = sun_posz - sat_posz;
+    double rho_x   = observer.sunX - sat_posx;
+    double rho_y   = observer.sunY - sat_posy;
+    double rho_z   = observer.sunZ - sat_posz;
     double rho_w   = sqrt(rho_x * rho_x + rho_y * rho_y + rho_z * rho_z);
     sd_sun         = arcSin(SR / rho_w);
     double earth_x = -1.0 * sat_posx;
     double earth_y = -1.0 * sat_posy;
     double earth_z = -1.0 * sat_posz;
     double earth_w = sat_posw;
-    delta      = PIO2 - arcSin((sun_posx * earth_x + sun_posy * earth_y + sun_posz * earth_z) / (sun_posw * earth_w));
-    depth      = sd_earth - sd_sun - delta;
-    KSSun *sun = dynamic_cast<KSSun *>(data->skyComposite()->findByName(i18n("Sun")));
+    delta = PIO2 - arcSin((observer.sunX * earth_x + observer.sunY * earth_y + observer.sunZ * earth_z) /
+                          (observer.sunW * earth_w));
+    depth = sd_earth - sd_sun - delta;
 
-    m_is_eclipsed = sd_earth >= sd_sun && depth >= 0;
-    m_is_visible  = !m_is_eclipsed && sun->alt().Degrees() <= -12.0 && elevation >= 0.0;
+    position.eclipsed = sd_earth >= sd_sun && depth >= 0;
 
     return (0);
 }
@@ -20,7 +20,9 @@
 #include "skyobject.h"
 
 #include <QString>
+#include <QVector>
 
+class GeoLocation;
 class KSPopupMenu;
 
 /**
@@ -33,6 +35,57 @@ class KSPopupMenu;
 class Satellite : public SkyObject
 {
   public:
+    /**
+     * @short Observer and date for which satellites are propagated.
+     * It holds what does not depend on the satellite, so that it is computed once for a whole group.
+     */
+    struct Observer
+    {
+        /** Julian Day, UTC */
+        double jd { 0 };
+        dms lat;
+        /** Sidereal time used to convert the horizontal coordinates to equatorial ones */
+        dms LST;
+        double sinLat { 0 };
+        double cosLat { 0 };
+        /** Local mean sidereal time, in radians */
+        double theta { 0 };
+        /** ECI position of the Sun, in km */
+        double sunX { 0 }, sunY { 0 }, sunZ { 0 }, sunW { 0 };
+        /** Altitude of the Sun, in degrees */
+        double sunAltitude { 0 };
+    };
+
+    /** @short Position of a satellite as seen by an observer */
+    struct Position
+    {
+        /** Horizontal coordinates, in degrees */
+        double azimuth { 0 };
+        double elevation { 0 };
+        /** Range from the observer, in km */
+        double range { 0 };
+        /** Altitude, in km */
+        double altitude { 0 };
+        /** Velocity, in km/s */
+        double velocity { 0 };
+        /** True if the satellite is in the shadow of the Earth */
+        bool eclipsed { false };
+    };
+
+    /** @short Pass of a satellite above the horizon */
+    struct Pass
+    {
+        Satellite *satellite { nullptr };
+        /** Julian Days, UTC, of the rise, culmination and set of the satellite */
+        double riseJD { 0 };
+        double culminationJD { 0 };
+        double setJD { 0 };
+        /** Elevation at culmination, in degrees */
+        double maxElevation { 0 };
+        /** True if the satellite is sunlit while the sky is dark at some point of the pass */
+        bool visible { false };
+    };
+
     /** @short Constructor */
     Satellite(const QString &name, const QString &line1, const QString &line2);
 
@@ -48,6 +101,38 @@ class Satellite : public SkyObject
     /** @short Update satellite position */
     int updatePos();
 
+    /**
+     * @short Update satellite position for an observer and a date.
+     * Satellites may be updated in parallel, as long as each one is updated by a single thread.
+     * @return 0, or an error code, see sgp4ErrorString()
+     */
+    int updatePos(const Observer &observer);
+
+    /**
+     * @short Update satellite position for an observer and a date, and return the position.
+     * @return 0, or an error code, see sgp4ErrorString()
+     */
+    int updatePos(const Observer &observer, Position &position);
+
+    /**
+     * @short Compute the position of the satellite for an observer and a date, without updating the satellite.
+     * @return 0, or an error code, see sgp4ErrorString()
+     */
+    int position(const Observer &observer, Position &position);
+
+    /**
+     * @brief findPasses Find the passes of the satellite above some elevation.
+     * The elevation is sampled at the dates of the observers, which should be a minute apart at most, then rises
+     * and sets are refined to about a second. The satellite itself is not modified.
+     * @param samples observers for evenly spaced dates, in chronological order
+     * @param geo location of the observers, used to refine the passes
+     * @param minElevation elevation above which the satellite is passing, in degrees
+     */
+    QVector<Pass> findPasses(const QVector<Observer> &samples, GeoLocation *geo, double minElevation) const;
+
+    /** @return the observer at a location for a date, given as a UTC Julian Day */
+    static Observer observer(GeoLocation *geo, double jd);
+
     /**
      * @return True if the satellite is visible (above horizon, in the sunlight and sun at least 12° under horizon)
      */
@@ -85,10 +170,10 @@ class Satellite : public SkyObject
     void init();
 
     /** @short Compute satellite position */
-    int sgp4(double tsince);
+    int sgp4(double tsince, const Observer &observer, Position &position);
 
     /** @return Arcsine of the argument */
-    double arcSin(double arg);
+    static double arcSin(double arg);
 
     /**
      * Provides the difference between UT (approximately the same as UTC)
@@ -96,10 +181,10 @@ class Satellite : public SkyObject
      * This function is based on a least squares fit of data from 1950
      * to 1991 and will need to be updated periodically.
      */
-    double deltaET(double year);
+    static double deltaET(double year);
 
     /** @return arg1 mod arg2 */
-    double Modulus(double arg1, double arg2);
+    static double Modulus(double arg1, double arg2);
 
     // TLE
     /// Satellite Number
@@ -19,9 +19,14 @@
 
 #include "ksutils.h"
 #include "kspaths.h"
+#include "kstarsdata.h"
 #include "skyobjects/satellite.h"
 
 #include <QTextStream>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <functional>
 
 SatelliteGroup::SatelliteGroup(const QString& name, const QString& tle_filename, const QUrl& update_url)
 {
@@ -41,6 +46,7 @@ void SatelliteGroup::readTLE()
     // Delete all satellites
     qDeleteAll(*this);
     clear();
+    m_Positions.clear();
 
     // Read TLE file
     if (KSUtils::openDataFile(file, m_tle_file))
@@ -62,20 +68,121 @@ void SatelliteGroup::readTLE()
 
 void SatelliteGroup::updateSatellitesPos()
 {
-    QMutableListIterator<Satellite *> sats(*this);
+    KStarsData *data = KStarsData::Instance();
 
-    while (sats.hasNext())
-    {
-        Satellite *sat = sats.next();
+    Satellite::Observer observer = Satellite::observer(data->geo(), data->clock()->utc().djd());
+    observer.LST                 = *data->lst();
+    updateSatellitesPos(observer);
+}
 
+void SatelliteGroup::updateSatellitesPos(const Satellite::Observer &observer)
+{
+    QVector<Satellite *> selected;
+    for (Satellite *sat : *this)
+    {
         if (sat->selected())
+            selected.append(sat);
+    }
+
+    m_Positions.resize(selected.size());
+    if (selected.isEmpty())
+        return;
+
+    // Chunks are large enough for the overhead of the thread pool to be negligible
+    const int CHUNK_SIZE = 256;
+
+    struct Chunk
+    {
+        int begin;
+        int end;
+        QVector<Satellite *> failed;
+    };
+    QVector<Chunk> chunks;
+    for (int i = 0; i < selected.size(); i += CHUNK_SIZE)
+        chunks.append({ i, std::min(i + CHUNK_SIZE, selected.size()), QVector<Satellite *>() });
+
+    // Each chunk writes its own range of the positions
+    SatellitePosition *positions                = m_Positions.data();
+    std::function<void(Chunk &)> updateFunction = [&selected, &observer, positions](Chunk &chunk)
+    {
+        for (int i = chunk.begin; i < chunk.end; i++)
+        {
+            Satellite *sat              = selected[i];
+            SatellitePosition &position = positions[i];
+
+            position.satellite = sat;
+            if (sat->updatePos(observer, position.position) != 0)
+            {
+                position.satellite = nullptr;
+                chunk.failed.append(sat);
+                continue;
+            }
+
+            position.ra      = sat->ra().Degrees();
+            position.dec     = sat->dec().Degrees();
+            position.visible = sat->isVisible();
+        }
+    };
+    QtConcurrent::blockingMap(chunks, updateFunction);
+
+    // If position cannot be calculated, remove it from list
+    bool failed = false;
+    for (const Chunk &chunk : chunks)
+    {
+        for (Satellite *sat : chunk.failed)
         {
-            int rc = sat->updatePos();
-            // If position cannot be calculated, remove it from list
-            if (rc != 0)
-                sats.remove();
+            removeOne(sat);
+            failed = true;
         }
     }
+
+    if (failed)
+    {
+        m_Positions.erase(std::remove_if(m_Positions.begin(), m_Positions.end(),
+                                         [](const SatellitePosition &position) { return position.satellite == nullptr; }),
+                          m_Positions.end());
+    }
+}
+
+QVector<Satellite::Pass> SatelliteGroup::findPasses(GeoLocation *geo, double startJD, double stopJD,
+                                                    double minElevation, bool visibleOnly) const
+{
+    // Passes of low orbits last a few minutes, sample every minute and let Satellite refine them
+    const double STEP = 1.0 / (24 * 60);
+
+    QVector<Satellite::Observer> samples;
+    for (double jd = startJD; jd <= stopJD; jd += STEP)
+        samples.append(Satellite::observer(geo, jd));
+
+    struct Search
+    {
+        const Satellite *satellite;
+        QVector<Satellite::Pass> passes;
+    };
+    QVector<Search> searches;
+    for (const Satellite *sat : *this)
+        searches.append({ sat, QVector<Satellite::Pass>() });
+
+    std::function<void(Search &)> searchFunction = [&](Search &search)
+    {
+        search.passes = search.satellite->findPasses(samples, geo, minElevation);
+    };
+    QtConcurrent::blockingMap(searches, searchFunction);
+
+    QVector<Satellite::Pass> passes;
+    for (const Search &search : searches)
+    {
+        for (const Satellite::Pass &pass : search.passes)
+        {
+            if (pass.visible || !visibleOnly)
+                passes.append(pass);
+        }
+    }
+
+    std::sort(passes.begin(), passes.end(),
+              [](const Satellite::Pass &a, const Satellite::Pass &b) { return a.riseJD < b.riseJD; });
+
+    return passes;
 }
 
 QUrl SatelliteGroup::tleFilename()
@@ -17,10 +17,14 @@
 
 #pragma once
 
+#include "satellite.h"
+
+#include <QList>
 #include <QString>
 #include <QUrl>
+#include <QVector>
 
-class Satellite;
+class GeoLocation;
 
 /**
  * @class SatelliteGroup
@@ -31,6 +35,18 @@ class Satellite;
 class SatelliteGroup : public QList<Satellite *>
 {
   public:
+    /** @short Position of a selected satellite, as computed by the last call to updateSatellitesPos() */
+    struct SatellitePosition
+    {
+        Satellite *satellite { nullptr };
+        Satellite::Position position;
+        /** Equatorial coordinates, in degrees */
+        double ra { 0 };
+        double dec { 0 };
+        /** See Satellite::isVisible() */
+        bool visible { false };
+    };
+
     /**
      * @short Constructor
      */
@@ -48,6 +64,33 @@ class SatelliteGroup : public QList<Satellite *>
      */
     void updateSatellitesPos();
 
+    /**
+     * Compute position of the selected satellites of the group for an observer and a date.
+     * Satellites are propagated in parallel, in chunks. Satellites whose position cannot be computed are
+     * removed from the group.
+     */
+    void updateSatellitesPos(const Satellite::Observer &observer);
+
+    /**
+     * @return the positions of the selected satellites of the group computed by the last call to
+     * updateSatellitesPos(), stored contiguously so that drawing and indexing the satellites do not need to
+     * access each satellite
+     */
+    const QVector<SatellitePosition> &positions() const { return m_Positions; }
+
+    /**
+     * @brief findPasses Find the passes of all the satellites of the group, selected or not, during a range of
+     * dates, e.g. a night.
+     * @param geo location of the observer
+     * @param startJD start of the range, as a UTC Julian Day
+     * @param stopJD end of the range, as a UTC Julian Day
+     * @param minElevation elevation above which a satellite is passing, in degrees
+     * @param visibleOnly if true, only passes during which the satellite is sunlit in a dark sky are returned
+     * @return the passes, sorted by rise time
+     */
+    QVector<Satellite::Pass> findPasses(GeoLocation *geo, double startJD, double stopJD, double minElevation = 10.0,
+                                        bool visibleOnly = true) const;
+
     /**
      * @return TLE filename
      */
@@ -70,4 +113,6 @@ class SatelliteGroup : public QList<Satellite *>
     QString m_tle_file;
     /// URL used to update TLE file
     QUrl m_tle_url;
+    /// Positions of the selected satellites
+    QVector<SatellitePosition> m_Positions;
 };
@@ -196,6 +196,21 @@ class StarObject : public SkyObject
     /** @short added for JIT updates from both StarComponent and ConstellationLines */
     void JITupdate();
 
+    /**
+     * @short Stores apparent coordinates that were computed elsewhere
+     *
+     * Used by StarBlock::JITupdate(), which computes the coordinates of a whole block of stars at once.
+     * @param ra  Apparent right ascension
+     * @param dec Apparent declination
+     * @param jd  Julian day the coordinates were computed for
+     */
+    inline void setApparentCoords(const CachingDms &ra, const CachingDms &dec, double jd)
+    {
+        setRA(ra);
+        setDec(dec);
+        lastPrecessJD = jd;
+    }
+
     /** @short returns the magnitude of the proper motion correction in milliarcsec/year */
     inline double pmMagnitude() const
     {
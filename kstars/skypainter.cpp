@@ -23,6 +23,7 @@
 #include "skymap.h"
 #include "Options.h"
 #include "kstarsdata.h"
+#include "projections/projector.h"
 #include "skycomponents/skiphashlist.h"
 #include "skycomponents/linelistlabel.h"
 #include "skyobjects/deepskyobject.h"
@@ -42,6 +43,62 @@ void SkyPainter::setSizeMagLimit(float sizeMagLim)
     m_sizeMagLim = sizeMagLim;
 }
 
+int SkyPainter::drawPointSources(SkyPoint *const *points, const float *mags, const char *sp, int count, bool *drawn)
+{
+    if (count <= 0)
+        return 0;
+
+    const Projector *proj = m_sm->projector();
+    const bool useAltAz   = proj->viewParams().useAltAz;
+    PointSourceBatch &b   = m_PointSources;
+
+    b.lon.resize(count);
+    b.lat.resize(count);
+    b.alt.resize(count);
+    b.x.resize(count);
+    b.y.resize(count);
+    b.candidate.resize(count);
+    b.onVisibleHemisphere.resize(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        const SkyPoint *p = points[i];
+
+        b.lon[i] = useAltAz ? p->az().radians() : p->ra().radians();
+        b.lat[i] = useAltAz ? p->alt().radians() : p->dec().radians();
+        b.alt[i] = p->alt().radians();
+    }
+
+    proj->checkVisibilityBatch(b.lon.constData(), b.lat.constData(), b.alt.constData(), count, b.candidate.data());
+    proj->toScreenBatch(b.lon.constData(), b.lat.constData(), count, b.x.data(), b.y.data(), true,
+                        b.onVisibleHemisphere.data());
+
+    b.pos.clear();
+    b.mags.clear();
+    b.sp.clear();
+
+    for (int i = 0; i < count; ++i)
+    {
+        QPointF pos(b.x[i], b.y[i]);
+        // FIXME: onScreen here should use canvas size rather than SkyMap size, see SkyQPainter::drawPointSource()
+        bool visible = b.candidate[i] && b.onVisibleHemisphere[i] && proj->onScreen(pos);
+
+        if (drawn)
+            drawn[i] = visible;
+        if (!visible)
+            continue;
+
+        b.pos.append(pos);
+        b.mags.append(mags[i]);
+        b.sp.append(sp[i]);
+    }
+
+    if (!b.pos.isEmpty())
+        drawPointSources(b.pos.constData(), b.mags.constData(), b.sp.constData(), b.pos.size());
+
+    return b.pos.size();
+}
+
 float SkyPainter::starWidth(float mag) const
 {
     //adjust maglimit for ZoomLevel
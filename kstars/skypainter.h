@@ -24,6 +24,7 @@
 
 #include <QList>
 #include <QPainter>
+#include <QVector>
 
 class ConstellationsArt;
 class DeepSkyObject;
@@ -128,6 +129,31 @@ class SkyPainter
      */
     virtual bool drawPointSource(SkyPoint *loc, float mag, char sp = 'A') = 0;
 
+    /**
+     * @short Draw a block of point sources (e.g., the stars of a trixel) at once.
+     *
+     * The sources are culled and projected together, and the visible ones are handed
+     * to the backend in a single drawPointSources() call. This is much cheaper than
+     * calling drawPointSource() for every star in dense fields.
+     * @param points the locations of the sources in the sky, already updated for the current time
+     * @param mags the magnitudes of the sources
+     * @param sp the spectral classes of the sources
+     * @param count the number of sources
+     * @param drawn optional output array, set to true for every source that was drawn
+     * @return the number of sources drawn
+     */
+    int drawPointSources(SkyPoint *const *points, const float *mags, const char *sp, int count,
+                         bool *drawn = nullptr);
+
+    /**
+     * @short Draw a block of point sources at already projected screen positions.
+     * @param pos the screen positions of the sources
+     * @param mags the magnitudes of the sources
+     * @param sp the spectral classes of the sources
+     * @param count the number of sources
+     */
+    virtual void drawPointSources(const QPointF *pos, const float *mags, const char *sp, int count) = 0;
+
     /**
      * @short Draw a deep sky object
      * @param obj the object to draw
@@ -188,4 +214,15 @@ class SkyPainter
 
   private:
     float m_sizeMagLim { 10.0f };
+
+    /** Scratch buffers for drawPointSources(), kept around to avoid reallocating them for every block */
+    struct PointSourceBatch
+    {
+        QVector<double> lon, lat, alt;
+        QVector<float> x, y;
+        QVector<bool> candidate, onVisibleHemisphere;
+        QVector<QPointF> pos;
+        QVector<float> mags;
+        QVector<char> sp;
+    } m_PointSources;
 };
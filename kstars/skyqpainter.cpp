@@ -21,6 +21,8 @@
 
 #include <QPointer>
 
+#include <algorithm>
+
 #include "kstarsdata.h"
 #include "Options.h"
 #include "skymap.h"
@@ -578,6 +580,56 @@ bool SkyQPainter::drawPointSource(SkyPoint *loc, float mag, char sp)
     }
 }
 
+void SkyQPainter::drawPointSources(const QPointF *pos, const float *mags, const char *sp, int count)
+{
+    if (count <= 0)
+        return;
+
+    if (m_vectorStars && starColorMode != 0)
+    {
+        // Vector stars are only used for printing and SVG export, so there is nothing to gain from batching
+        for (int i = 0; i < count; ++i)
+            drawPointSource(pos[i], starWidth(mags[i]), sp[i]);
+        return;
+    }
+
+    // Bucket sort the sources by sprite, so that every pixmap is drawn with a single call
+    const int nSprites = nSPclasses * nStarSizes;
+    int start[nSprites + 1] = { 0 };
+
+    m_starSprites.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        int isize = qMin(static_cast<int>(starWidth(mags[i])), nStarSizes - 1);
+
+        m_starSprites[i] = harvardToIndex(sp[i]) * nStarSizes + isize;
+        ++start[m_starSprites[i] + 1];
+    }
+    for (int k = 0; k < nSprites; ++k)
+        start[k + 1] += start[k];
+
+    int next[nSprites];
+    std::copy(start, start + nSprites, next);
+
+    m_starFragments.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        int sprite  = m_starSprites[i];
+        QPixmap *im  = imageCache[sprite / nStarSizes][sprite % nStarSizes];
+
+        // Fragments are positioned by their center, which is where drawPointSource() centers the pixmap too
+        m_starFragments[next[sprite]++] = QPainter::PixmapFragment::create(pos[i], QRectF(im->rect()));
+    }
+
+    for (int k = 0; k < nSprites; ++k)
+    {
+        int n = start[k + 1] - start[k];
+
+        if (n > 0)
+            drawPixmapFragments(m_starFragments.constData() + start[k], n, *imageCache[k / nStarSizes][k % nStarSizes]);
+    }
+}
+
 void SkyQPainter::drawPointSource(const QPointF &pos, float size, char sp)
 {
     int isize = qMin(static_cast<int>(size), 14);
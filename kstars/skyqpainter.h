@@ -87,6 +87,8 @@ class SkyQPainter : public SkyPainter, public QPainter
                          LineListLabel *label = nullptr) override;
     void drawSkyPolygon(LineList *list, bool forceClip = true) override;
     bool drawPointSource(SkyPoint *loc, float mag, char sp = 'A') override;
+    using SkyPainter::drawPointSources;
+    void drawPointSources(const QPointF *pos, const float *mags, const char *sp, int count) override;
     bool drawDeepSkyObject(DeepSkyObject *obj, bool drawImage = false) override;
     bool drawPlanet(KSPlanetBase *planet) override;
     bool drawEarthShadow(KSEarthShadow *shadow) override;
@@ -110,6 +112,9 @@ private:
     bool m_vectorStars { false };
     HIPSRenderer *m_hipsRender { nullptr };
     QSize m_size;
+    /// Sprite of each source and the sources grouped by sprite, reused by drawPointSources()
+    QVector<int> m_starSprites;
+    QVector<QPainter::PixmapFragment> m_starFragments;
     static int starColorMode;
     static QColor m_starColor;
     static QMap<char, QColor> ColorMap;
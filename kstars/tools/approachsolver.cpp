@@ -16,6 +16,8 @@
  ***************************************************************************/
 
 #include "approachsolver.h"
+
+#include "ksnumbers.h"
 #include <kstars_debug.h>
 
 ApproachSolver::ApproachSolver(QObject *parent) : QObject(parent)
@@ -50,6 +52,10 @@ QMap<long double, dms> ApproachSolver::findClosestApproach(long double startJD,
     //  qCDebug(KSTARS) << m_object2->name() << ": RA = " << m_object2->ra() -> toHMSString() << "; Dec = " << m_object2->dec() -> toDMSString() << "\n";
     prevSign = 0;
 
+    m_Ephemerides.clear();
+    m_EarthJD = 0;
+    prepareEphemerides(startJD, stopJD);
+
     step0 = findInitialStep(startJD, stopJD);
     step = step0;
     //	qCDebug(KSTARS) << "Initial Separation between " << m_object1->name() << " and " << m_object2->name() << " = " << (prevDist.toDMSString());
@@ -164,6 +170,35 @@ bool ApproachSolver::findPrecise(QPair<long double, dms> *out, long double jd,
     }
 }
 
+void ApproachSolver::prepareEphemeris(const KSPlanetBase *body, long double startJD, long double stopJD)
+{
+    if (!EphemerisCache::isSupported(body))
+        return;
+
+    auto ephemeris = EphemerisCache::Instance()->prepare(body, startJD, stopJD);
+    if (ephemeris)
+        m_Ephemerides.insert(body, ephemeris);
+}
+
+void ApproachSolver::findPosition(KSPlanetBase *body, const KSNumbers *num, const CachingDms *LST)
+{
+    auto ephemeris = m_Ephemerides.value(body);
+    if (ephemeris && body->findCachedPosition(*ephemeris, num, m_geoPlace->lat(), LST))
+        return;
+
+    findEarthPosition(num);
+    body->findPosition(num, m_geoPlace->lat(), LST, &m_Earth);
+}
+
+void ApproachSolver::findEarthPosition(const KSNumbers *num)
+{
+    if (m_EarthJD == num->julianDay())
+        return;
+
+    m_Earth.findPosition(num);
+    m_EarthJD = num->julianDay();
+}
+
 dms ApproachSolver::findSkyPointDistance(SkyPoint * obj1, SkyPoint * obj2)
 {
     dms dist;
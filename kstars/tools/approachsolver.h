@@ -20,6 +20,7 @@
 #include "skyobjects/ksplanet.h"
 #include "skycomponents/typedef.h"
 
+#include <QHash>
 #include <QObject>
 #include <QMap>
 #include <memory>
@@ -134,6 +135,33 @@ protected:
     bool findPrecise(QPair<long double, dms> *out, long double jd,
                      double step, int prevSign);
 
+    /**
+     * @short Prepare the ephemerides of the objects involved, for the range being searched.
+     * Called by findClosestApproach() before the first call to updatePositions(). Subclasses call
+     * prepareEphemeris() for their objects.
+     */
+    virtual void prepareEphemerides(long double startJD, long double stopJD)
+    {
+        Q_UNUSED(startJD);
+        Q_UNUSED(stopJD);
+    }
+
+    /**
+     * @short Fit or load the ephemeris of a body over a range of dates, see EphemerisCache.
+     * Does nothing if the body is not supported by the cache.
+     */
+    void prepareEphemeris(const KSPlanetBase *body, long double startJD, long double stopJD);
+
+    /**
+     * @short Find the position of a body, including correction for Figure-of-the-Earth.
+     * The position is taken from the ephemeris of the body if it was prepared and covers the date,
+     * otherwise it is computed by KSPlanetBase::findPosition() with m_Earth.
+     */
+    void findPosition(KSPlanetBase *body, const KSNumbers *num, const CachingDms *LST);
+
+    /** @short Update m_Earth to a date, unless it is already there */
+    void findEarthPosition(const KSNumbers *num);
+
     KSPlanet m_Earth;
 
 private:
@@ -158,4 +186,7 @@ private:
 
     GeoLocation * m_geoPlace { nullptr };
     double m_maxSeparation;
+
+    QHash<const KSPlanetBase *, std::shared_ptr<const EphemerisCache::Ephemeris>> m_Ephemerides;
+    long double m_EarthJD { 0 };
 };
@@ -147,12 +147,18 @@ void LunarEclipseHandler::updatePositions(long double jd)
     CachingDms LST(getGeoLocation()->GSTtoLST(t.gst()));
     const CachingDms * LAT = getGeoLocation()->lat();
 
-    m_Earth.findPosition(&num);
-    m_sun.findPosition(&num, LAT, &LST, &m_Earth);
-    m_moon.findPosition(&num, LAT, &LST, &m_Earth);
+    findPosition(&m_sun, &num, &LST);
+    findPosition(&m_moon, &num, &LST);
+    findEarthPosition(&num);
     m_shadow.findPosition(&num, LAT, &LST, &m_Earth);
 }
 
+void LunarEclipseHandler::prepareEphemerides(long double startJD, long double stopJD)
+{
+    prepareEphemeris(&m_sun, startJD, stopJD);
+    prepareEphemeris(&m_moon, startJD, stopJD);
+}
+
 dms LunarEclipseHandler::findDistance()
 {
     dms moon_rad = dms(m_moon.angSize() / 120);
@@ -194,6 +200,10 @@ QVector<long double> LunarEclipseHandler::getFullMoons(long double startJD, long
     const long double INTERVAL = 26.5l;
     long double &currentJD = startJD;
 
+    // The phase only depends on the ecliptic longitudes, which the ephemerides provide
+    auto sunEphemeris = EphemerisCache::Instance()->prepare(&m_sun, startJD, endJD);
+    auto moonEphemeris = EphemerisCache::Instance()->prepare(&m_moon, startJD, endJD);
+
     QVector<long double> fullMoons;
     while(currentJD <= endJD)
     {
@@ -201,8 +211,10 @@ QVector<long double> LunarEclipseHandler::getFullMoons(long double startJD, long
         KSNumbers num(currentJD);
         CachingDms LST = getGeoLocation()->GSTtoLST(t.gst());
 
-        m_sun.updateCoords(&num, true, getGeoLocation()->lat(), &LST, true);
-        m_moon.updateCoords(&num, true, getGeoLocation()->lat(), &LST, true);
+        if (!sunEphemeris || !m_sun.findCachedPosition(*sunEphemeris, &num, getGeoLocation()->lat(), &LST))
+            m_sun.updateCoords(&num, true, getGeoLocation()->lat(), &LST, true);
+        if (!moonEphemeris || !m_moon.findCachedPosition(*moonEphemeris, &num, getGeoLocation()->lat(), &LST))
+            m_moon.updateCoords(&num, true, getGeoLocation()->lat(), &LST, true);
         m_moon.findPhase(&m_sun);
 
         if(m_moon.illum() > 0.9)
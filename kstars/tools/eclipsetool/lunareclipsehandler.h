@@ -105,6 +105,7 @@ protected:
         { return (m_mode == CLOSEST_APPROACH) ? INITIAL_STEP : DETAIL_STEP; }
 
     void updatePositions(long double jd) override;
+    void prepareEphemerides(long double startJD, long double stopJD) override;
 
     // NOTE: This method depends on m_mode!
     dms findDistance() override;
@@ -45,16 +45,24 @@ void KSConjunct::updatePositions(long double jd)
     KStarsDateTime t(jd);
     KSNumbers num(jd);
 
-    m_Earth.findPosition(&num);
     CachingDms LST(getGeoLocation()->GSTtoLST(t.gst()));
 
     KSPlanetBase *p = dynamic_cast<KSPlanetBase*>(m_object1.get());
     if (p)
-        p->findPosition(&num, getGeoLocation()->lat(), &LST, &m_Earth);
+        findPosition(p, &num, &LST);
     else
         m_object1->updateCoordsNow(&num);
 
-    m_object2->findPosition(&num, getGeoLocation()->lat(), &LST, &m_Earth);
+    findPosition(m_object2.get(), &num, &LST);
+}
+
+void KSConjunct::prepareEphemerides(long double startJD, long double stopJD)
+{
+    KSPlanetBase *p = dynamic_cast<KSPlanetBase*>(m_object1.get());
+    if (p)
+        prepareEphemeris(p, startJD, stopJD);
+
+    prepareEphemeris(m_object2.get(), startJD, stopJD);
 }
 
 double KSConjunct::findInitialStep(long double startJD, long double stopJD)
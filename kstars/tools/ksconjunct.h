@@ -49,6 +49,7 @@ signals:
 protected:
     double findInitialStep(long double startJD, long double stopJD) override;
     void updatePositions(long double jd) override;
+    void prepareEphemerides(long double startJD, long double stopJD) override;
 
 private:
     dms findDistance() override;
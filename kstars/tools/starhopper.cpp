@@ -24,6 +24,12 @@
 
 #include <kstars_debug.h>
 
+#include <QSet>
+
+#include <cmath>
+#include <queue>
+#include <vector>
+
 QList<StarObject *> *StarHopper::computePath(const SkyPoint &src, const SkyPoint &dest, float fov__, float maglim__,
                                              QStringList *metadata_)
 {
@@ -46,11 +52,25 @@ QList<const StarObject *> StarHopper::computePath_const(const SkyPoint &src, con
 
     came_from.clear();
     result_path.clear();
+    starCosts.clear();
+
+    // Implements the A* search algorithm, with a binary heap of open nodes. Nodes whose f_score
+    // improved are pushed again, the outdated entries are skipped when popped.
 
-    // Implements the A* search algorithm
+    struct OpenNode
+    {
+        double f_score;
+        quint64 order; // Ties are broken in insertion order
+        SkyPoint const *node;
+    };
+    auto worse = [](const OpenNode &a, const OpenNode &b)
+    {
+        return a.f_score > b.f_score || (a.f_score == b.f_score && a.order > b.order);
+    };
+    std::priority_queue<OpenNode, std::vector<OpenNode>, decltype(worse)> oSet(worse);
+    quint64 order = 0;
 
-    QList<SkyPoint const *> cSet;
-    QList<SkyPoint const *> oSet;
+    QSet<SkyPoint const *> cSet;
     QHash<SkyPoint const *, double> g_score;
     QHash<SkyPoint const *, double> f_score;
     QHash<SkyPoint const *, double> h_score;
@@ -59,27 +79,25 @@ QList<const StarObject *> StarHopper::computePath_const(const SkyPoint &src, con
              << src.dec().toDMSString() << " to destination: " << dest.ra().toHMSString() << dest.dec().toDMSString()
              << "; a starhop of " << src.angularDistanceTo(&dest).Degrees() << " degrees!";
 
-    oSet.append(&src);
     g_score[&src] = 0;
     h_score[&src] = src.angularDistanceTo(&dest).Degrees() / fov;
     f_score[&src] = h_score[&src];
+    oSet.push({ f_score[&src], order++, &src });
 
-    while (!oSet.isEmpty())
+    // Nodes farther than 1.2 times the start from the destination are not expanded, so their
+    // neighbours, and the neighbours of those for the cost, are all within this radius.
+    indexStars(dest, 1.2 * src.angularDistanceTo(&dest).Degrees() + 2 * fov);
+
+    while (!oSet.empty())
     {
         qCDebug(KSTARS) << "Next step";
         // Find the node with the lowest f_score value
-        SkyPoint const *curr_node = nullptr;
-        double lowfscore          = 1.0e8;
+        OpenNode const open = oSet.top();
+        oSet.pop();
 
-        foreach (const SkyPoint *sp, oSet)
-        {
-            if (f_score[sp] < lowfscore)
-            {
-                lowfscore = f_score[sp];
-                curr_node = sp;
-            }
-        }
-        if (curr_node == nullptr)
+        SkyPoint const *curr_node = open.node;
+        double lowfscore          = open.f_score;
+        if (cSet.contains(curr_node) || lowfscore != f_score[curr_node])
             continue;
 
         qCDebug(KSTARS) << "Lowest fscore (vertex distance-plus-cost score) is " << lowfscore
@@ -132,8 +150,7 @@ QList<const StarObject *> StarHopper::computePath_const(const SkyPoint &src, con
             return result_path;
         }
 
-        oSet.removeOne(curr_node);
-        cSet.append(curr_node);
+        cSet.insert(curr_node);
 
         // FIXME: Make sense. If current node ---> dest distance is
         // larger than src --> dest distance by more than 20%, don't
@@ -148,15 +165,7 @@ QList<const StarObject *> StarHopper::computePath_const(const SkyPoint &src, con
 
         // Get the list of stars that are neighbours of this node
         QList<StarObject *> neighbors;
-
-        // FIXME: Actually, this should be done in
-        // HorizontalToEquatorial, but we do it here because SkyPoint
-        // needs a lot of fixing to handle unprecessed and precessed,
-        // equatorial and horizontal coordinates nicely
-        SkyPoint *CurrentNode = const_cast<SkyPoint *>(curr_node);
-        CurrentNode->deprecess(KStarsData::Instance()->updateNum());
-        //qCDebug(KSTARS) << "Calling starsInAperture";
-        StarComponent::Instance()->starsInAperture(neighbors, *curr_node, fov, maglim);
+        starsInAperture(neighbors, *curr_node, fov, maglim);
         qCDebug(KSTARS) << "Choosing next node from a set of " << neighbors.count();
         // Look for the potential next node
         double curr_g_score = g_score[curr_node];
@@ -169,11 +178,8 @@ QList<const StarObject *> StarHopper::computePath_const(const SkyPoint &src, con
             // Compute the tentative g_score
             double tentative_g_score = curr_g_score + cost(curr_node, nhd_node);
             bool tentative_better;
-            if (!oSet.contains(nhd_node))
-            {
-                oSet.append(nhd_node);
+            if (!g_score.contains(nhd_node))
                 tentative_better = true;
-            }
             else if (tentative_g_score < g_score[nhd_node])
                 tentative_better = true;
             else
@@ -185,6 +191,7 @@ QList<const StarObject *> StarHopper::computePath_const(const SkyPoint &src, con
                 g_score[nhd_node]   = tentative_g_score;
                 h_score[nhd_node]   = nhd_node->angularDistanceTo(&dest).Degrees() / fov;
                 f_score[nhd_node]   = g_score[nhd_node] + h_score[nhd_node];
+                oSet.push({ f_score[nhd_node], order++, nhd_node });
             }
         }
     }
@@ -192,6 +199,74 @@ QList<const StarObject *> StarHopper::computePath_const(const SkyPoint &src, con
     return QList<StarObject const *>(); // Return an empty QList
 }
 
+void StarHopper::indexStars(const SkyPoint &dest, double radius)
+{
+    starCells.clear();
+    cellSize = 2 * sin(0.5 * fov * dms::DegToRad);
+
+    // StarComponent looks up trixels with the catalog coordinates of the center
+    SkyPoint center(dest);
+    center.deprecess(KStarsData::Instance()->updateNum());
+
+    QList<StarObject *> stars;
+    StarComponent::Instance()->starsInAperture(stars, center, radius, maglim + 1.0);
+
+    for (StarObject *star : stars)
+    {
+        double sinRA, cosRA, sinDec, cosDec;
+        star->ra().SinCos(sinRA, cosRA);
+        star->dec().SinCos(sinDec, cosDec);
+
+        IndexedStar indexed { star, cosDec * cosRA, cosDec * sinRA, sinDec };
+        starCells[cellKey(floor(indexed.x / cellSize), floor(indexed.y / cellSize), floor(indexed.z / cellSize))]
+            .append(indexed);
+    }
+
+    qCDebug(KSTARS) << "Indexed" << stars.count() << "stars within" << radius << "degrees of the destination in"
+                    << starCells.count() << "cells";
+}
+
+qint64 StarHopper::cellKey(int ix, int iy, int iz) const
+{
+    // Cell coordinates are within +/- 1 / cellSize, far less than 2^20 for any sensible field of view
+    const qint64 offset = 1 << 20;
+    return ((ix + offset) << 42) | ((iy + offset) << 21) | (iz + offset);
+}
+
+void StarHopper::starsInAperture(QList<StarObject *> &list, const SkyPoint &center, float radius, float maglim) const
+{
+    double sinRA, cosRA, sinDec, cosDec;
+    center.ra().SinCos(sinRA, cosRA);
+    center.dec().SinCos(sinDec, cosDec);
+    double const x = cosDec * cosRA, y = cosDec * sinRA, z = sinDec;
+
+    // Cells within the chord of the aperture of the center, the distance is then checked exactly
+    double const chord = 2 * sin(0.5 * radius * dms::DegToRad);
+    int const span     = int(ceil(chord / cellSize));
+    int const cx = floor(x / cellSize), cy = floor(y / cellSize), cz = floor(z / cellSize);
+
+    for (int ix = cx - span; ix <= cx + span; ix++)
+    {
+        for (int iy = cy - span; iy <= cy + span; iy++)
+        {
+            for (int iz = cz - span; iz <= cz + span; iz++)
+            {
+                auto cell = starCells.constFind(cellKey(ix, iy, iz));
+                if (cell == starCells.constEnd())
+                    continue;
+
+                for (const IndexedStar &indexed : *cell)
+                {
+                    if (indexed.star->mag() > maglim)
+                        continue;
+                    if (indexed.star->angularDistanceTo(&center).Degrees() <= radius)
+                        list.append(indexed.star);
+                }
+            }
+        }
+    }
+}
+
 void StarHopper::reconstructPath(SkyPoint const *curr_node)
 {
     if (curr_node != start)
@@ -216,6 +291,37 @@ float StarHopper::cost(const SkyPoint *curr, const SkyPoint *next)
         // If the next hop is back to square one, junk it
         return 1e8;
     }
+
+    // Test 4: How far is the hop?
+    double distcost =
+        (curr->angularDistanceTo(next).Degrees() /
+         fov); // 1 "magnitude" incremental cost for 1 FOV. Is this even required, or is it just equivalent to halving our distance unit? I think it is required since the hop is not necessarily in the direction of the object -- asimha
+
+    // Test 5: How effective is the hop? [Might not be required with A*]
+    //    double distredcost = -((src->angularDistanceTo( dest ).Degrees() - next->angularDistanceTo( dest ).Degrees()) * 60 / fov)*3; // 3 "magnitudes" for 1 FOV closer
+
+    // The other tests only depend on the star hopped to, which is reached from many nodes
+    auto cached = starCosts.constFind(next);
+    float starcost;
+    if (cached != starCosts.constEnd())
+    {
+        starcost = cached.value();
+    }
+    else
+    {
+        starcost = starCost(next);
+        starCosts.insert(next, starcost);
+    }
+
+    netcost = starcost + distcost;
+    if (netcost < 0)
+        netcost = 0.1; // FIXME: Heuristics aren't supposed to be entirely random. This one is.
+    qCDebug(KSTARS) << "Dist cost: " << distcost << "; Net cost: " << netcost;
+    return netcost;
+}
+
+float StarHopper::starCost(const SkyPoint *next)
+{
     bool isThisTheEnd = (next == end);
 
     float magcost, speccost;
@@ -257,17 +363,9 @@ float StarHopper::cost(const SkyPoint *curr, const SkyPoint *next)
         */
     }
 
-    // Test 4: How far is the hop?
-    double distcost =
-        (curr->angularDistanceTo(next).Degrees() /
-         fov); // 1 "magnitude" incremental cost for 1 FOV. Is this even required, or is it just equivalent to halving our distance unit? I think it is required since the hop is not necessarily in the direction of the object -- asimha
-
-    // Test 5: How effective is the hop? [Might not be required with A*]
-    //    double distredcost = -((src->angularDistanceTo( dest ).Degrees() - next->angularDistanceTo( dest ).Degrees()) * 60 / fov)*3; // 3 "magnitudes" for 1 FOV closer
-
     // Test 6: Is the destination an asterism? Are there bright stars clustered nearby?
     QList<StarObject *> localNeighbors;
-    StarComponent::Instance()->starsInAperture(localNeighbors, *next, fov / 10, maglim + 1.0);
+    starsInAperture(localNeighbors, *next, fov / 10, maglim + 1.0);
     double stardensitycost = 1 - localNeighbors.count(); // -1 "magnitude" for every neighbouring star
 
 // Test 7: Identify star patterns
@@ -287,7 +385,7 @@ float StarHopper::cost(const SkyPoint *curr, const SkyPoint *next)
         while (factor <= 10.0)
         {
             localNeighbors.clear();
-            StarComponent::Instance()->starsInAperture(
+            starsInAperture(
                 localNeighbors, *next, fov / factor,
                 nextstar->mag() + 1.0); // Use a larger aperture for pattern identification; max 1.0 mag difference
             foreach (StarObject *star, localNeighbors)
@@ -352,11 +450,8 @@ float StarHopper::cost(const SkyPoint *curr, const SkyPoint *next)
         }
     }
 
-    netcost = magcost + speccost + distcost + stardensitycost + patterncost;
-    if (netcost < 0)
-        netcost = 0.1; // FIXME: Heuristics aren't supposed to be entirely random. This one is.
-    qCDebug(KSTARS) << "Mag cost: " << magcost << "; Spec Cost: " << speccost << "; Dist Cost: " << distcost
-             << "; Density cost: " << stardensitycost << "; Pattern cost: " << patterncost << "; Net cost: " << netcost
+    qCDebug(KSTARS) << "Mag cost: " << magcost << "; Spec Cost: " << speccost
+             << "; Density cost: " << stardensitycost << "; Pattern cost: " << patterncost
              << "; Pattern: " << patternName;
-    return netcost;
+    return magcost + speccost + stardensitycost + patterncost;
 }
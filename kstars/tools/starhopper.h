@@ -19,6 +19,7 @@
 
 #include <QHash>
 #include <QList>
+#include <QVector>
 
 class QStringList;
 
@@ -64,12 +65,40 @@ class StarHopper
      */
     float cost(const SkyPoint *curr, const SkyPoint *next);
 
+    /**
+     * @short The part of the cost of hopping to a given star that does not depend on the previous hop:
+     * its brightness, color, and the patterns it forms with its neighbours
+     */
+    float starCost(const SkyPoint *next);
+
     /**
      * @short For internal use by the A* Search Algorithm. Completes
      * the star-hop path. See https://en.wikipedia.org/wiki/A*_search_algorithm for details
      */
     void reconstructPath(SkyPoint const *curr_node);
 
+    /**
+     * @short Index the stars the search may query: those within some radius of the destination
+     * that are brighter than maglim + 1
+     */
+    void indexStars(const SkyPoint &dest, double radius);
+
+    /**
+     * @short Find the indexed stars within an aperture, like StarComponent::starsInAperture()
+     * @note Stars are compared to the current coordinates of the center, it need not be deprecessed
+     */
+    void starsInAperture(QList<StarObject *> &list, const SkyPoint &center, float radius, float maglim) const;
+
+    /** @return key of the index cell holding a point of the unit sphere */
+    qint64 cellKey(int ix, int iy, int iz) const;
+
+    struct IndexedStar
+    {
+        StarObject *star;
+        /** Position of the star on the unit sphere */
+        double x, y, z;
+    };
+
     float fov { 0 };
     float maglim { 0 };
     QString starHopDirections;
@@ -79,4 +108,9 @@ class StarHopper
     QHash<const SkyPoint *, const SkyPoint *> came_from; // Used by the A* search algorithm
     QList<StarObject const *> result_path;
     QHash<SkyPoint const *, QString> patternNames; // if patterns were identified, they are added to this hash.
+    // Stars around the route, bucketed in cubic cells as wide as the field of view
+    QHash<qint64, QVector<IndexedStar>> starCells;
+    double cellSize { 0 };
+    // Part of the cost of hopping to a star that does not depend on the previous hop
+    QHash<SkyPoint const *, float> starCosts;
 };